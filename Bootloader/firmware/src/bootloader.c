@@ -82,10 +82,11 @@ typedef struct {
 } DFUConfiguration;
 
 DFUConfiguration DFU_CONFIGURATION[2] = {
-  // The firmware, 484kB
+  // The firmware, 468kB. The last 16kB of flash hold the application's
+  // settings store, which must survive an update.
   {
     .start_address = 0x9d007000,
-    .end_address = 0x9d07ffff
+    .end_address = 0x9d07bfff
   }
 #ifdef CFG_ALLOW_DFU_UID_UPDATES
   ,
@@ -43,4 +43,13 @@
 #define PIPELINE_RDMRESPONDER_SEND(include_break, iov, iov_len) \
   Transceiver_QueueRDMResponse(include_break, iov, iov_len);
 
+#define PIPELINE_RDMRESPONDER_ACQUIRE_BUFFER() \
+  Transceiver_AcquireRDMResponseBuffer()
+
+#define PIPELINE_RDMRESPONDER_COMMIT(include_break, size) \
+  Transceiver_CommitRDMResponse(include_break, size);
+
+#define PIPELINE_RDMRESPONDER_RELEASE_BUFFER() \
+  Transceiver_ReleaseRDMResponseBuffer();
+
 #endif  // BOARDCFG_DEFAULT_APP_PIPELINE_H_
@@ -19,6 +19,7 @@
 
 #include "flash.h"
 #include "peripheral/nvm/plib_nvm.h"
+#include "system/int/sys_int.h"
 #include <sys/kmem.h>
 
 enum { NVM_PROGRAM_UNLOCK_KEY1 = 0xAA996655 };
@@ -33,12 +34,21 @@ static void PerformOperation(uint32_t nvmop) {
   // Allow memory modifications
   PLIB_NVM_MemoryModifyEnable(NVM_ID_0);
 
+  // The application calls this with the UART, timer & USB interrupts live.
+  // An interrupt between the key writes and WR causes the unlock to fail, so
+  // interrupts are disabled until the operation has started.
+  const bool interrupts_enabled = SYS_INT_Disable();
+
   /* Unlock the Flash */
   PLIB_NVM_FlashWriteKeySequence(NVM_ID_0, 0);
   PLIB_NVM_FlashWriteKeySequence(NVM_ID_0, NVM_PROGRAM_UNLOCK_KEY1);
   PLIB_NVM_FlashWriteKeySequence(NVM_ID_0, NVM_PROGRAM_UNLOCK_KEY2);
 
   PLIB_NVM_FlashWriteStart(NVM_ID_0);
+
+  if (interrupts_enabled) {
+    SYS_INT_Enable();
+  }
 }
 
 bool Flash_ErasePage(uint32_t address) {
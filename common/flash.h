@@ -17,8 +17,8 @@
  * Copyright (C) 2015 Simon Newton
  */
 
-#ifndef BOOTLOADER_FIRMWARE_SRC_FLASH_H_
-#define BOOTLOADER_FIRMWARE_SRC_FLASH_H_
+#ifndef COMMON_FLASH_H_
+#define COMMON_FLASH_H_
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -71,4 +71,4 @@ uint32_t Flash_ReadWord(uint32_t address);
 }
 #endif
 
-#endif  // BOOTLOADER_FIRMWARE_SRC_FLASH_H_
+#endif  // COMMON_FLASH_H_
@@ -1,8 +1,13 @@
 noinst_LTLIBRARIES += firmware/src/libcoarsetimer.la \
                       firmware/src/libdimmermodel.la \
+                      firmware/src/libdmxforwarder.la \
+                      firmware/src/libdmxinput.la \
+                      firmware/src/libfader.la \
                       firmware/src/libflags.la \
                       firmware/src/libledmodel.la \
                       firmware/src/libmessagehandler.la \
+                      firmware/src/libmodelsettings.la \
+                      firmware/src/libmonotonicclock.la \
                       firmware/src/libmovinglightmodel.la \
                       firmware/src/libnetworkmodel.la \
                       firmware/src/libproxymodel.la \
@@ -14,9 +19,16 @@ noinst_LTLIBRARIES += firmware/src/libcoarsetimer.la \
                       firmware/src/libreceivercounters.la \
                       firmware/src/libresponder.la \
                       firmware/src/libsensormodel.la \
+                      firmware/src/libsettingsstore.la \
                       firmware/src/libspi.la \
+                      firmware/src/libspidma.la \
                       firmware/src/libspirgb.la \
+                      firmware/src/libstackmonitor.la \
+                      firmware/src/libstats.la \
+                      firmware/src/libstatusqueue.la \
                       firmware/src/libstreamdecoder.la \
+                      firmware/src/libtemperatureconversion.la \
+                      firmware/src/libtimerwheel.la \
                       firmware/src/libtransceiver.la \
                       firmware/src/libusbtransport.la
 
@@ -26,6 +38,15 @@ firmware_src_libcoarsetimer_la_CFLAGS = $(BUILD_FLAGS)
 firmware_src_libdimmermodel_la_SOURCES = firmware/src/dimmer_model.c
 firmware_src_libdimmermodel_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libdmxforwarder_la_SOURCES = firmware/src/dmx_forwarder.c
+firmware_src_libdmxforwarder_la_CFLAGS = $(BUILD_FLAGS)
+
+firmware_src_libdmxinput_la_SOURCES = firmware/src/dmx_input.c
+firmware_src_libdmxinput_la_CFLAGS = $(BUILD_FLAGS)
+
+firmware_src_libfader_la_SOURCES = firmware/src/fader.c
+firmware_src_libfader_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libflags_la_SOURCES = firmware/src/flags.c
 firmware_src_libflags_la_CFLAGS = $(BUILD_FLAGS)
 
@@ -35,12 +56,18 @@ firmware_src_libledmodel_la_CFLAGS = $(BUILD_FLAGS)
 firmware_src_libmessagehandler_la_SOURCES = firmware/src/message_handler.c
 firmware_src_libmessagehandler_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libmodelsettings_la_SOURCES = firmware/src/model_settings.c
+firmware_src_libmodelsettings_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libnetworkmodel_la_SOURCES = firmware/src/network_model.c
 firmware_src_libnetworkmodel_la_CFLAGS = $(BUILD_FLAGS)
 
 firmware_src_libproxymodel_la_SOURCES = firmware/src/proxy_model.c
 firmware_src_libproxymodel_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libmonotonicclock_la_SOURCES = firmware/src/monotonic_clock.c
+firmware_src_libmonotonicclock_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libmovinglightmodel_la_SOURCES = firmware/src/moving_light.c
 firmware_src_libmovinglightmodel_la_CFLAGS = $(BUILD_FLAGS)
 
@@ -68,15 +95,38 @@ firmware_src_libresponder_la_CFLAGS = $(BUILD_FLAGS)
 firmware_src_libsensormodel_la_SOURCES = firmware/src/sensor_model.c
 firmware_src_libsensormodel_la_CFLAGS = $(BUILD_FLAGS)
 
-firmware_src_libspirgb_la_SOURCES = firmware/src/spi_rgb.c
+firmware_src_libsettingsstore_la_SOURCES = firmware/src/settings_store.c
+firmware_src_libsettingsstore_la_CFLAGS = $(BUILD_FLAGS)
+
+firmware_src_libspirgb_la_SOURCES = firmware/src/gamma_tables.c \
+                                    firmware/src/spi_rgb.c
 firmware_src_libspirgb_la_CFLAGS = $(BUILD_FLAGS)
 
 firmware_src_libspi_la_SOURCES = firmware/src/spi.c
 firmware_src_libspi_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libspidma_la_SOURCES = firmware/src/spi_dma.c
+firmware_src_libspidma_la_CFLAGS = $(BUILD_FLAGS)
+
+firmware_src_libstackmonitor_la_SOURCES = firmware/src/stack_monitor.c
+firmware_src_libstackmonitor_la_CFLAGS = $(BUILD_FLAGS)
+
+firmware_src_libstats_la_SOURCES = firmware/src/stats.c
+firmware_src_libstats_la_CFLAGS = $(BUILD_FLAGS)
+
+firmware_src_libstatusqueue_la_SOURCES = firmware/src/status_queue.c
+firmware_src_libstatusqueue_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libstreamdecoder_la_SOURCES = firmware/src/stream_decoder.c
 firmware_src_libstreamdecoder_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libtemperatureconversion_la_SOURCES = \
+    firmware/src/temperature_conversion.c
+firmware_src_libtemperatureconversion_la_CFLAGS = $(BUILD_FLAGS)
+
+firmware_src_libtimerwheel_la_SOURCES = firmware/src/timer_wheel.c
+firmware_src_libtimerwheel_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libtransceiver_la_SOURCES = firmware/src/transceiver.c
 firmware_src_libtransceiver_la_CFLAGS = $(BUILD_FLAGS)
 firmware_src_libtransceiver_la_LIBADD = firmware/src/librandom.la
@@ -23,8 +23,11 @@
 
 #include "coarse_timer.h"
 #include "dimmer_model.h"
+#include "dmx_forwarder.h"
 #include "led_model.h"
 #include "message_handler.h"
+#include "model_settings.h"
+#include "monotonic_clock.h"
 #include "moving_light.h"
 #include "network_model.h"
 #include "proxy_model.h"
@@ -32,13 +35,18 @@
 #include "rdm_handler.h"
 #include "rdm_responder.h"
 #include "receiver_counters.h"
+#include "responder.h"
 #include "sensor_model.h"
 #include "setting_macros.h"
+#include "settings_store.h"
 #include "spi_rgb.h"
+#include "stack_monitor.h"
+#include "stats.h"
 #include "stream_decoder.h"
 #include "syslog.h"
 #include "system_definitions.h"
 #include "temperature.h"
+#include "timer_wheel.h"
 #include "transceiver.h"
 #include "uid_store.h"
 #include "usb_descriptors.h"
@@ -47,8 +55,24 @@
 
 #include "app_settings.h"
 
+// The bounds of the stack, from the XC32 linker script.
+extern uint32_t _splim;
+extern uint32_t _stack;
+
+// The flash reserved for the settings store, from the linker script.
+extern uint8_t __attribute__((space(prog))) _settings_store;
+extern uint8_t __attribute__((space(prog))) _settings_store_end;
+
+// The flash page size on the 5xx/6xx/7xx series.
+static const uint32_t SETTINGS_STORE_PAGE_SIZE = 0x1000;
+
+// Compaction erases flash, which stalls the CPU for ~20ms. Only compact once
+// the line has been quiet for 100ms.
+static const uint16_t SETTINGS_STORE_IDLE_TIME = 1000;
+
 void __ISR(AS_TIMER_ISR_VECTOR(COARSE_TIMER_ID), ipl6AUTO) TimerEvent() {
   CoarseTimer_TimerEvent();
+  MonotonicClock_Update();
 }
 
 void APP_Initialize(void) {
@@ -56,6 +80,13 @@ void APP_Initialize(void) {
   PRE_APP_INIT_HOOK();
 #endif
 
+  // Paint the stack before anything else uses it.
+  StackMonitor_Settings stack_settings = {
+    .limit = &_splim,
+    .top = &_stack
+  };
+  StackMonitor_Initialize(&stack_settings);
+
   // We can do this after USB_DEVICE_Initialize() has been called since it's
   // not used until we reach the tasks function.
   UIDStore_Init();
@@ -67,7 +98,10 @@ void APP_Initialize(void) {
   };
   SYS_INT_VectorPrioritySet(AS_TIMER_INTERRUPT_VECTOR(COARSE_TIMER_ID),
                             INT_PRIORITY_LEVEL6);
+  Stats_Initialize();
+  MonotonicClock_Initialize();
   CoarseTimer_Initialize(&timer_settings);
+  TimerWheel_Initialize();
 
   // Initialize the Logging system, bottom up
   USBTransport_Initialize(NULL);
@@ -96,6 +130,7 @@ void APP_Initialize(void) {
     .input_capture_timer = AS_IC_TMR_ID(TRANSCEIVER_TIMER),
   };
   Transceiver_Initialize(&transceiver_settings, NULL, NULL);
+  Responder_Initialize();
 
   // Base RDM Responder
   RDMResponderSettings responder_settings = {
@@ -134,8 +169,21 @@ void APP_Initialize(void) {
   DimmerModel_Initialize();
   RDMHandler_AddModel(&DIMMER_MODEL_ENTRY);
 
+  // Restore the active model & its settings.
+  SettingsStoreConfiguration store_config = {
+    .base_address = (uint32_t) &_settings_store,
+    .page_size = SETTINGS_STORE_PAGE_SIZE,
+    .page_count = ((uint32_t) &_settings_store_end -
+                   (uint32_t) &_settings_store) / SETTINGS_STORE_PAGE_SIZE
+  };
+  if (!SettingsStore_Initialize(&store_config)) {
+    SysLog_Message(SYSLOG_ERROR, "Failed to init settings");
+  }
+  ModelSettings_Initialize();
+
   // Initialize the Host message layers.
   MessageHandler_Initialize(NULL);
+  DMXForwarder_Initialize(NULL);
   StreamDecoder_Initialize(NULL);
 
   Flags_Initialize();
@@ -145,6 +193,8 @@ void APP_Initialize(void) {
   spi_config.module_id = SPI_MODULE_ID;
   spi_config.baud_rate = SPI_BAUD_RATE;
   spi_config.use_enhanced_buffering = SPI_USE_ENHANCED_BUFFERING;
+  spi_config.use_dma = SPI_USE_DMA;
+  spi_config.dma_channel = SPI_DMA_CHANNEL;
   SPIRGB_Init(&spi_config);
 
   // Send a frame with all pixels set to 0.
@@ -156,10 +206,16 @@ void APP_Tasks(void) {
   USBTransport_Tasks();
   Transceiver_Tasks();
   USBConsole_Tasks();
+  StackMonitor_Tasks();
+  if (Transceiver_IsIdle(SETTINGS_STORE_IDLE_TIME)) {
+    SettingsStore_Tasks();
+  }
 
   if (Transceiver_GetMode() == T_MODE_RESPONDER) {
-    RDMResponder_Tasks();
+    TimerWheel_Tasks();
     RDMHandler_Tasks();
+    ModelSettings_Tasks();
+    DMXForwarder_Tasks();
     SPIRGB_Tasks();
     Temperature_Tasks();
   }
@@ -110,6 +110,18 @@ typedef enum {
    */
   COMMAND_RUN_SELF_TEST = 0x03,
 
+  /**
+   * @brief Fetch the runtime statistics.
+   * @sa @ref message-commands-getstats.
+   */
+  COMMAND_GET_STATS = 0x04,
+
+  /**
+   * @brief Fetch the peak stack usage and free RAM.
+   * @sa @ref message-commands-getmemoryinfo.
+   */
+  COMMAND_GET_MEMORY_INFO = 0x05,
+
   // User Configuration
   /**
    * @brief Set the break time of the transceiver.
@@ -199,6 +211,25 @@ typedef enum {
   // DMX
   TX_DMX = 0x30,  //!< Transmit a DMX frame. See @ref message-commands-txdmx.
 
+  /**
+   * @brief Configure forwarding of received DMX frames to the Host.
+   * See @ref message-commands-setdmxforwarding.
+   */
+  COMMAND_SET_DMX_FORWARDING = 0x31,
+
+  /**
+   * @brief A received DMX frame, sent by the device when forwarding is on.
+   * See @ref message-commands-rxdmxframe.
+   */
+  COMMAND_RX_DMX_FRAME = 0x32,
+
+  /**
+   * @brief The changed slots of a received DMX frame, sent by the device when
+   * forwarding is on.
+   * See @ref message-commands-rxdmxchanges.
+   */
+  COMMAND_RX_DMX_CHANGES = 0x33,
+
   // RDM
   /**
    * @brief Send an RDM Discovery Unique Branch and wait for a response.
@@ -250,6 +281,13 @@ typedef enum {
   RC_CANCELLED = 10  //!< The request was preempted or cancelled
 } ReturnCode;
 
+/**
+ * @brief The flags in a COMMAND_GET_STATS request.
+ */
+typedef enum {
+  STATS_FLAG_RESET = 0x01  //!< Reset the counters once they've been read.
+} StatsFlag;
+
 /**
  * @brief The Start of Message identifier.
  */
@@ -19,14 +19,18 @@
 #include "dimmer_model.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "coarse_timer.h"
 #include "constants.h"
+#include "fader.h"
 #include "macros.h"
 #include "rdm_frame.h"
 #include "rdm_buffer.h"
 #include "rdm_responder.h"
 #include "rdm_util.h"
+#include "status_queue.h"
+#include "timer_wheel.h"
 #include "utils.h"
 
 #include <syslog.h>
@@ -34,23 +38,32 @@
 #include <system_config.h>
 
 // Various constants
+#ifdef DIMMER_MODEL_SUB_DEVICE_COUNT
+enum { NUMBER_OF_SUB_DEVICES = DIMMER_MODEL_SUB_DEVICE_COUNT };
+#else
 enum { NUMBER_OF_SUB_DEVICES = 4 };
+#endif
 enum { NUMBER_OF_SCENES = 3 };
 enum { NUMBER_OF_LOCK_STATES = 3 };
 enum { NUMBER_OF_CURVES = 4 };
+enum { NUMBER_OF_DMX_LEVELS = 256 };
+enum { COARSE_TIMER_TICKS_PER_DECISECOND = 1000 };
 enum { NUMBER_OF_OUTPUT_RESPONSE_TIMES = 2 };
 enum { NUMBER_OF_MODULATION_FREQUENCIES = 4 };
 enum { NUMBER_OF_SELF_TESTS = 2 };
-enum { STATUS_MESSAGE_QUEUE_SIZE = 4 };
+enum { STATUS_MESSAGES_PER_RESPONSE = 4 };
+enum { STATUS_MESSAGE_RING_SIZE = 8 };
 enum { PERSONALITY_COUNT = 1 };
 enum { SOFTWARE_VERSION = 0x00000000 };
 static const char DEVICE_MODEL_DESCRIPTION[] = "Ja Rule Dimmer Device";
 static const char SOFTWARE_LABEL[] = "Alpha";
 static const char DEFAULT_DEVICE_LABEL[] = "Ja Rule";
 static const char PERSONALITY_DESCRIPTION[] = "Dimmer";
-static const uint8_t STATUS_TYPE_MASK = 0xf;
 static const uint16_t INITIAL_START_ADDRESSS = 1u;
 static const uint32_t STATUS_MESSAGE_TRIGGER_INTERVAL = 300000;  // 30s
+static const uint32_t FADE_UPDATE_INTERVAL = 200;  // 20ms
+// The slow output response moves across the full range in 1s.
+static const uint16_t SLOW_RESPONSE_STEP = 1311;
 
 static const char LOCK_STATE_DESCRIPTION_UNLOCKED[] = "Unlocked";
 static const char LOCK_STATE_DESCRIPTION_SUBDEVICES_LOCKED[] =
@@ -92,17 +105,9 @@ typedef struct {
   uint16_t down_fade_time;
   uint16_t wait_time;
   uint8_t programmed_state;
+  uint8_t levels[NUMBER_OF_SUB_DEVICES];
 } Scene;
 
-typedef struct {
-  uint16_t sub_device;
-  uint16_t message_id;
-  uint16_t data_value1;
-  uint16_t data_value2;
-  RDMStatusType status_type;
-  bool is_active;
-} StatusMessage;
-
 typedef struct {
   uint32_t duration;
   const char *description;
@@ -115,9 +120,9 @@ typedef struct {
    * Remember this when using the array.
    */
   Scene scenes[NUMBER_OF_SCENES];
-  CoarseTimer_Value status_message_timer;
-  CoarseTimer_Value self_test_timer;
-  StatusMessage status_message;
+  TimerWheel_Timer status_message_timer;
+  TimerWheel_Timer self_test_timer;
+  TimerWheel_Timer response_timer;  //!< Slews the slow response outputs.
 
   uint16_t playback_mode;
   uint16_t startup_scene;
@@ -136,31 +141,118 @@ typedef struct {
 
   bool power_on_self_test;
   uint8_t running_self_test;
+
+  /*
+   * @brief Used to generate the status messages for each sub device.
+   */
+  uint8_t status_cycle;
+  uint16_t status_complete_cycles;
 } RootDevice;
 
+enum {
+  SUBDEVICE_FLAG_IDENTIFY_ON = 0x01,
+  SUBDEVICE_FLAG_ON_BELOW_MIN = 0x02,
+  SUBDEVICE_FLAG_DMX_LATEST = 0x04,  //!< DMX changed since the preset started.
+  SUBDEVICE_FLAG_FACTORY_DEFAULTS = 0x08,  //!< Using factory defaults.
+};
+
+enum {
+  OUTPUT_RESPONSE_FAST = 1,
+  OUTPUT_RESPONSE_SLOW = 2,
+};
+
+enum {
+  CURVE_LINEAR = 1,
+  CURVE_MODIFIED_LINEAR = 2,
+  CURVE_SQUARE = 3,
+  CURVE_MODIFIED_SQUARE = 4,
+};
+
+/*
+ * @brief The modified curves reach full output at this DMX level (~95%).
+ */
+enum { MODIFIED_CURVE_FULL_LEVEL = 242 };
+
+/*
+ * @brief The index into the output tables for the direction of the last
+ * change.
+ */
+enum {
+  DIRECTION_INCREASING = 0,
+  DIRECTION_DECREASING = 1,
+  NUMBER_OF_DIRECTIONS = 2
+};
+
+/*
+ * @brief The mutable state for the sub-devices.
+ *
+ * This is stored as a structure of arrays, indexed by SubDeviceIndex(). The
+ * sub-devices share a single RDMResponder, see LoadSubDevice().
+ */
 typedef struct {
-  RDMResponder responder;
-  StatusMessage status_message;
-
-  uint16_t index;
-  uint16_t min_level_increasing;
-  uint16_t min_level_decreasing;
-  uint16_t max_level;
-  uint8_t on_below_min;
-  uint8_t identify_mode;
-  uint8_t burn_in;
-  uint8_t curve;
-  uint8_t output_response_time;
-  uint8_t modulation_frequency;
-  RDMStatusType sd_report_threshold;
-} DimmerSubDevice;
+  uint16_t dmx_start_address[NUMBER_OF_SUB_DEVICES];
+  uint16_t min_level_increasing[NUMBER_OF_SUB_DEVICES];
+  uint16_t min_level_decreasing[NUMBER_OF_SUB_DEVICES];
+  uint16_t max_level[NUMBER_OF_SUB_DEVICES];
+  uint8_t identify_mode[NUMBER_OF_SUB_DEVICES];
+  uint8_t burn_in[NUMBER_OF_SUB_DEVICES];
+  uint8_t curve[NUMBER_OF_SUB_DEVICES];
+  uint8_t output_response_time[NUMBER_OF_SUB_DEVICES];
+  uint8_t modulation_frequency[NUMBER_OF_SUB_DEVICES];
+  uint8_t sd_report_threshold[NUMBER_OF_SUB_DEVICES];
+  uint8_t flags[NUMBER_OF_SUB_DEVICES];  //!< SUBDEVICE_FLAG_* bits
+  uint16_t output_level[NUMBER_OF_SUB_DEVICES];
+  uint16_t target_level[NUMBER_OF_SUB_DEVICES];  //!< Before the response time.
+  uint8_t dmx_level[NUMBER_OF_SUB_DEVICES];  //!< The last DMX level received.
+  uint8_t level[NUMBER_OF_SUB_DEVICES];  //!< The level after merging presets.
+  uint8_t direction[NUMBER_OF_SUB_DEVICES];  //!< DIRECTION_* of the last change
+  /*
+   * @brief (max - min) / 0xffff in 16.16 fixed point, for each direction.
+   */
+  uint32_t output_scale[NUMBER_OF_DIRECTIONS][NUMBER_OF_SUB_DEVICES];
+  /*
+   * @brief The minimum level, limited to the maximum, for each direction.
+   */
+  uint16_t output_offset[NUMBER_OF_DIRECTIONS][NUMBER_OF_SUB_DEVICES];
+  /*
+   * @brief The output at level 0, for each direction.
+   */
+  uint16_t zero_output[NUMBER_OF_DIRECTIONS][NUMBER_OF_SUB_DEVICES];
+} DimmerSubDevices;
 
+/*
+ * @brief The messages returned in the last STATUS_MESSAGES response.
+ */
 typedef struct {
-  StatusMessage last[STATUS_MESSAGE_QUEUE_SIZE];
+  StatusMessage last[STATUS_MESSAGES_PER_RESPONSE];
   uint8_t count;
 } StatusMessages;
 
-static DimmerSubDevice g_subdevices[NUMBER_OF_SUB_DEVICES];
+static DimmerSubDevices g_subdevices;
+
+/*
+ * @brief The curve output, from 0 to 0xffff, for each DMX level.
+ *
+ * The tables are shared by all sub-devices; the min / max levels are applied
+ * with the per sub-device output_offset & output_scale, see OutputLevel().
+ * Folding those into per sub-device tables would cost 1 KB of RAM for each
+ * sub-device.
+ */
+static uint16_t g_curve_tables[NUMBER_OF_CURVES][NUMBER_OF_DMX_LEVELS];
+
+/*
+ * @brief The first slot of the window returned by IOCTL_GET_DMX_WINDOW.
+ *
+ * The DMX data passed to ApplyDMXData() starts at this slot.
+ */
+static uint16_t g_dmx_window_start = 0u;
+
+/*
+ * @brief The responder shared by all sub-devices.
+ *
+ * Sub-devices don't support DEVICE_LABEL so they all share the default label.
+ */
+static RDMResponder g_subdevice_responder;
 
 static const char* LOCK_STATES[NUMBER_OF_LOCK_STATES] = {
   LOCK_STATE_DESCRIPTION_UNLOCKED,
@@ -214,15 +306,432 @@ static const SelfTest SELF_TESTS[NUMBER_OF_SELF_TESTS] = {
 static const ResponderDefinition ROOT_RESPONDER_DEFINITION;
 static const ResponderDefinition SUBDEVICE_RESPONDER_DEFINITION;
 
+static StatusMessage
+    g_status_message_storage[STATUS_QUEUE_TYPE_COUNT *
+                             STATUS_MESSAGE_RING_SIZE];
+static StatusQueue g_status_queue;
 static StatusMessages g_status_messages;
 
 
 static RootDevice g_root_device;
-static DimmerSubDevice *g_active_device = NULL;
+
+/*
+ * @brief The state of preset playback.
+ */
+typedef struct {
+  Fader fader;
+  FaderChannel channels[NUMBER_OF_SUB_DEVICES];
+  uint8_t levels[NUMBER_OF_SUB_DEVICES];  //!< The preset level, indexed by
+                                          //!< sub-device.
+  CoarseTimer_Value start_time;  //!< When the current scene started.
+  TimerWheel_Timer timer;  //!< Runs every FADE_UPDATE_INTERVAL during playback.
+  uint32_t hold_time;  //!< The fade time plus the wait time.
+  uint16_t scene;  //!< The scene being played, or PRESET_PLAYBACK_OFF.
+} Playback;
+
+static Playback g_playback;
+
+/*
+ * @brief The range of sub-devices the current request applies to.
+ *
+ * This is a single sub-device, unless a SET to SUBDEVICE_ALL is being handled
+ * by one of the SUBDEVICE_SET_ALL_PID_DESCRIPTORS, in which case it covers all
+ * the sub-devices.
+ */
+static unsigned int g_active_index = 0u;
+static unsigned int g_active_end = 1u;
 
 // Helper functions
 // ----------------------------------------------------------------------------
 
+/*
+ * @brief Map a sub-device number to an index into the sub-device arrays.
+ * @param sub_device The sub-device number.
+ * @returns The index of the sub-device or NUMBER_OF_SUB_DEVICES if the
+ *   sub-device doesn't exist.
+ *
+ * Sub-device 2 is skipped, since sub devices aren't required to be contiguous.
+ */
+static inline unsigned int SubDeviceIndex(uint16_t sub_device) {
+  if (sub_device == 1u) {
+    return 0u;
+  }
+  if (sub_device < 3u || sub_device - 2u >= NUMBER_OF_SUB_DEVICES) {
+    return NUMBER_OF_SUB_DEVICES;
+  }
+  return sub_device - 2u;
+}
+
+/*
+ * @brief Map an index into the sub-device arrays to the sub-device number.
+ */
+static inline uint16_t SubDeviceNumber(unsigned int index) {
+  return index == 0u ? 1u : index + 2u;
+}
+
+/*
+ * @brief The number of slots used by each sub-device.
+ */
+static inline uint16_t SubDeviceFootprint() {
+  return SUBDEVICE_RESPONDER_DEFINITION.personalities[0].slot_count;
+}
+
+/*
+ * @brief Evaluate a dimmer curve.
+ * @param curve The curve, one of CURVE_*.
+ * @param level The DMX level.
+ * @returns The output, from 0 to 0xffff.
+ */
+static uint32_t CurveValue(uint8_t curve, uint8_t level) {
+  uint32_t value = level;
+  uint32_t full = UINT8_MAX;
+  if (curve == CURVE_MODIFIED_LINEAR || curve == CURVE_MODIFIED_SQUARE) {
+    full = MODIFIED_CURVE_FULL_LEVEL;
+    if (value > full) {
+      value = full;
+    }
+  }
+
+  if (curve == CURVE_SQUARE || curve == CURVE_MODIFIED_SQUARE) {
+    value *= value;
+    full *= full;
+  }
+  return (value * UINT16_MAX + full / 2u) / full;
+}
+
+/*
+ * @brief Fill in the curve tables.
+ */
+static void BuildCurveTables() {
+  unsigned int curve = 0u;
+  for (; curve < NUMBER_OF_CURVES; curve++) {
+    unsigned int level = 0u;
+    for (; level < NUMBER_OF_DMX_LEVELS; level++) {
+      g_curve_tables[curve][level] = CurveValue(curve + 1u, level);
+    }
+  }
+}
+
+/*
+ * @brief Get the minimum output level of a sub-device.
+ * @param index The index of the sub-device.
+ * @param direction The direction of the last change.
+ * @returns The minimum level, limited to the maximum level.
+ */
+static inline uint16_t MinimumOutput(unsigned int index, uint8_t direction) {
+  const uint16_t min_level = direction == DIRECTION_DECREASING ?
+      g_subdevices.min_level_decreasing[index] :
+      g_subdevices.min_level_increasing[index];
+  return min_level > g_subdevices.max_level[index] ?
+      g_subdevices.max_level[index] : min_level;
+}
+
+/*
+ * @brief Compute the output for a level.
+ * @param index The index of the sub-device.
+ * @param level The level, after merging presets.
+ * @returns The output level, with the curve and min / max applied.
+ */
+static inline uint16_t OutputLevel(unsigned int index, uint8_t level) {
+  const uint8_t direction = g_subdevices.direction[index];
+  if (level == 0u) {
+    return g_subdevices.zero_output[direction][index];
+  }
+  const uint32_t value =
+      g_curve_tables[g_subdevices.curve[index] - 1u][level];
+  return g_subdevices.output_offset[direction][index] +
+      ((value * g_subdevices.output_scale[direction][index] + 0x8000u) >> 16);
+}
+
+static void ResponseTimer(void *data);
+
+/*
+ * @brief Set the target output of a sub-device.
+ * @param index The index of the sub-device.
+ * @param target The output level to move to.
+ *
+ * Sub-devices with the slow output response time are moved towards the target
+ * by ResponseTimer().
+ */
+static inline void SetTargetLevel(unsigned int index, uint16_t target) {
+  g_subdevices.target_level[index] = target;
+  if (g_subdevices.output_response_time[index] == OUTPUT_RESPONSE_FAST) {
+    g_subdevices.output_level[index] = target;
+  } else if (g_subdevices.output_level[index] != target &&
+             !TimerWheel_IsScheduled(&g_root_device.response_timer)) {
+    TimerWheel_Schedule(&g_root_device.response_timer, FADE_UPDATE_INTERVAL,
+                        ResponseTimer, NULL);
+  }
+}
+
+/*
+ * @brief Move the slow response outputs towards their targets.
+ */
+static void ResponseTimer(UNUSED void *data) {
+  bool pending = false;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    const uint16_t output = g_subdevices.output_level[i];
+    const uint16_t target = g_subdevices.target_level[i];
+    if (output < target) {
+      g_subdevices.output_level[i] = target - output > SLOW_RESPONSE_STEP ?
+          output + SLOW_RESPONSE_STEP : target;
+    } else if (output > target) {
+      g_subdevices.output_level[i] = output - target > SLOW_RESPONSE_STEP ?
+          output - SLOW_RESPONSE_STEP : target;
+    }
+    pending |= g_subdevices.output_level[i] != target;
+  }
+  if (pending) {
+    TimerWheel_Schedule(&g_root_device.response_timer, FADE_UPDATE_INTERVAL,
+                        ResponseTimer, NULL);
+  }
+}
+
+/*
+ * @brief Move all the outputs to their targets, ignoring the response time.
+ */
+static void SnapToTargetLevels() {
+  TimerWheel_Cancel(&g_root_device.response_timer);
+  memcpy(g_subdevices.output_level, g_subdevices.target_level,
+         sizeof(g_subdevices.output_level));
+}
+
+/*
+ * @brief Recompute the output offset & scale for a sub-device.
+ * @param index The index of the sub-device.
+ *
+ * This must be called whenever the curve or min / max levels change.
+ */
+static void UpdateOutputScale(unsigned int index) {
+  unsigned int direction = 0u;
+  for (; direction < NUMBER_OF_DIRECTIONS; direction++) {
+    const uint16_t min_level = MinimumOutput(index, direction);
+    const uint32_t range = g_subdevices.max_level[index] - min_level;
+    g_subdevices.output_offset[direction][index] = min_level;
+    g_subdevices.zero_output[direction][index] =
+        (g_subdevices.flags[index] & SUBDEVICE_FLAG_ON_BELOW_MIN) ?
+        min_level : 0u;
+    g_subdevices.output_scale[direction][index] =
+        ((range << 16) + UINT16_MAX / 2u) / UINT16_MAX;
+  }
+  SetTargetLevel(index, OutputLevel(index, g_subdevices.level[index]));
+}
+
+/*
+ * @brief Merge the DMX and preset levels for a sub-device.
+ * @param index The index of the sub-device.
+ * @returns The level to output, before the curve is applied.
+ */
+static inline uint8_t MergedLevel(unsigned int index) {
+  const uint8_t dmx_level = g_subdevices.dmx_level[index];
+  if (g_playback.scene == PRESET_PLAYBACK_OFF) {
+    return dmx_level;
+  }
+
+  const uint8_t preset_level = g_playback.levels[index];
+  switch (g_root_device.merge_mode) {
+    case MERGE_MODE_HTP:
+      return preset_level > dmx_level ? preset_level : dmx_level;
+    case MERGE_MODE_LTP:
+      return (g_subdevices.flags[index] & SUBDEVICE_FLAG_DMX_LATEST) ?
+          dmx_level : preset_level;
+    case MERGE_MODE_DMX_ONLY:
+      return dmx_level;
+    case MERGE_MODE_DEFAULT:
+    default:
+      // The preset overrides DMX.
+      return preset_level;
+  }
+}
+
+/*
+ * @brief Update the output level of a sub-device.
+ * @param index The index of the sub-device.
+ */
+static inline void UpdateOutput(unsigned int index) {
+  const uint8_t level = MergedLevel(index);
+  if (level != g_subdevices.level[index]) {
+    g_subdevices.direction[index] = level < g_subdevices.level[index] ?
+        DIRECTION_DECREASING : DIRECTION_INCREASING;
+    g_subdevices.level[index] = level;
+  }
+  SetTargetLevel(index, OutputLevel(index, level));
+}
+
+/*
+ * @brief Compute the range of slots that covers all the sub-devices.
+ * @param[out] window The window to populate.
+ */
+static void GetDMXWindow(DMXWindow *window) {
+  uint16_t start = MAX_DMX_START_ADDRESS;
+  uint16_t end = 0u;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    const uint16_t address = g_subdevices.dmx_start_address[i];
+    if (address == 0u || address > MAX_DMX_START_ADDRESS) {
+      continue;
+    }
+    if (address - 1u < start) {
+      start = address - 1u;
+    }
+    if (address > end) {
+      end = address;
+    }
+  }
+  g_dmx_window_start = end ? start : 0u;
+  window->start_slot = g_dmx_window_start;
+  window->footprint = end ? (uint16_t) (end - start) : 0u;
+}
+
+/*
+ * @brief Update the sub-device outputs from a DMX frame.
+ * @param slots The slot data, starting at g_dmx_window_start.
+ * @param slot_count The number of slots received.
+ */
+static void ApplyDMXData(const uint8_t *slots, unsigned int slot_count) {
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    const unsigned int slot =
+        g_subdevices.dmx_start_address[i] - 1u - g_dmx_window_start;
+    if (slot >= slot_count) {
+      continue;
+    }
+    const uint8_t level = slots[slot];
+    if (level != g_subdevices.dmx_level[i]) {
+      g_subdevices.dmx_level[i] = level;
+      g_subdevices.flags[i] |= SUBDEVICE_FLAG_DMX_LATEST;
+    }
+    UpdateOutput(i);
+  }
+}
+
+static void PlaybackTimer(void *data);
+
+/*
+ * @brief Start fading to a scene.
+ * @param scene_index The scene to play, indexed from 1.
+ *
+ * The scene levels are scaled by the playback level.
+ */
+static void StartScene(uint16_t scene_index) {
+  const Scene *scene = &g_root_device.scenes[scene_index - 1u];
+  const uint32_t playback_level = g_root_device.playback_level;
+  uint8_t targets[NUMBER_OF_SUB_DEVICES];
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    if (g_playback.scene == PRESET_PLAYBACK_OFF) {
+      // Fade from whatever is being output now.
+      g_playback.levels[i] = g_subdevices.level[i];
+    }
+    targets[i] = (scene->levels[i] * playback_level + UINT8_MAX / 2u) /
+                 UINT8_MAX;
+    g_subdevices.flags[i] &= ~SUBDEVICE_FLAG_DMX_LATEST;
+  }
+
+  const uint32_t up_time =
+      scene->up_fade_time * COARSE_TIMER_TICKS_PER_DECISECOND;
+  const uint32_t down_time =
+      scene->down_fade_time * COARSE_TIMER_TICKS_PER_DECISECOND;
+  Fader_Start(&g_playback.fader, targets, up_time, down_time);
+  g_playback.scene = scene_index;
+  g_playback.start_time = CoarseTimer_GetTime();
+  TimerWheel_Schedule(&g_playback.timer, FADE_UPDATE_INTERVAL, PlaybackTimer,
+                      NULL);
+  g_playback.hold_time = (up_time > down_time ? up_time : down_time) +
+      scene->wait_time * COARSE_TIMER_TICKS_PER_DECISECOND;
+}
+
+/*
+ * @brief Stop preset playback, the outputs return to DMX.
+ */
+static void StopPlayback() {
+  Fader_Stop(&g_playback.fader);
+  TimerWheel_Cancel(&g_playback.timer);
+  g_playback.scene = PRESET_PLAYBACK_OFF;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    UpdateOutput(i);
+  }
+}
+
+/*
+ * @brief Find the next programmed scene, used for PRESET_PLAYBACK_ALL.
+ * @param scene_index The current scene, or PRESET_PLAYBACK_OFF.
+ * @returns The next programmed scene, or PRESET_PLAYBACK_OFF if no scenes are
+ *   programmed.
+ */
+static uint16_t NextProgrammedScene(uint16_t scene_index) {
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SCENES; i++) {
+    scene_index = scene_index % NUMBER_OF_SCENES + 1u;
+    if (g_root_device.scenes[scene_index - 1u].programmed_state !=
+        PRESET_NOT_PROGRAMMED) {
+      return scene_index;
+    }
+  }
+  return PRESET_PLAYBACK_OFF;
+}
+
+/*
+ * @brief Advance the preset playback.
+ *
+ * This interpolates the preset levels and re-merges them with the DMX levels.
+ */
+static void PlaybackTimer(UNUSED void *data) {
+  TimerWheel_Schedule(&g_playback.timer, FADE_UPDATE_INTERVAL, PlaybackTimer,
+                      NULL);
+
+  const uint32_t elapsed = CoarseTimer_ElapsedTime(g_playback.start_time);
+  if (g_playback.fader.active) {
+    Fader_Update(&g_playback.fader, elapsed);
+    unsigned int i = 0u;
+    for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+      UpdateOutput(i);
+    }
+  } else if (g_root_device.playback_mode == PRESET_PLAYBACK_ALL &&
+             elapsed >= g_playback.hold_time) {
+    const uint16_t next_scene = NextProgrammedScene(g_playback.scene);
+    if (next_scene == PRESET_PLAYBACK_OFF) {
+      StopPlayback();
+    } else {
+      StartScene(next_scene);
+    }
+  }
+}
+
+/*
+ * @brief Load the state of a sub-device into the shared responder.
+ * @param index The index of the sub-device.
+ */
+static void LoadSubDevice(unsigned int index) {
+  g_active_index = index;
+  g_active_end = index + 1u;
+  g_subdevice_responder.dmx_start_address =
+      g_subdevices.dmx_start_address[index];
+  g_subdevice_responder.identify_on =
+      g_subdevices.flags[index] & SUBDEVICE_FLAG_IDENTIFY_ON;
+  g_subdevice_responder.using_factory_defaults =
+      g_subdevices.flags[index] & SUBDEVICE_FLAG_FACTORY_DEFAULTS;
+  RDMResponder_SwitchResponder(&g_subdevice_responder);
+}
+
+/*
+ * @brief Save the state of the shared responder back to the active sub-device.
+ */
+static void StoreSubDevice() {
+  g_subdevices.dmx_start_address[g_active_index] =
+      g_subdevice_responder.dmx_start_address;
+  if (g_subdevice_responder.identify_on) {
+    g_subdevices.flags[g_active_index] |= SUBDEVICE_FLAG_IDENTIFY_ON;
+  } else {
+    g_subdevices.flags[g_active_index] &= ~SUBDEVICE_FLAG_IDENTIFY_ON;
+  }
+  if (!g_subdevice_responder.using_factory_defaults) {
+    g_subdevices.flags[g_active_index] &= ~SUBDEVICE_FLAG_FACTORY_DEFAULTS;
+  }
+}
+
 /*
  * @brief Set a block address for all the sub devices.
  * @param start_address the new start address
@@ -230,25 +739,17 @@ static DimmerSubDevice *g_active_device = NULL;
  *   footprint of the sub devices would exceed the last slot (512).
  */
 bool ResetToBlockAddress(uint16_t start_address) {
-  unsigned int footprint = 0u;
-  unsigned int i = 0u;
-  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
-    RDMResponder *responder = &g_subdevices[i].responder;
-    footprint +=
-        responder->def->personalities[responder->current_personality - 1u]
-            .slot_count;
-  }
+  const uint16_t slot_count = SubDeviceFootprint();
+  unsigned int footprint = NUMBER_OF_SUB_DEVICES * slot_count;
 
-  if ((uint16_t) (MAX_DMX_START_ADDRESS - start_address + 1u) < footprint) {
+  if (MAX_DMX_START_ADDRESS - start_address + 1u < footprint) {
     return false;
   }
 
-  for (i = 0u; i < NUMBER_OF_SUB_DEVICES; i++) {
-    RDMResponder *responder = &g_subdevices[i].responder;
-    responder->dmx_start_address = start_address;
-    const PersonalityDefinition *personality =
-        &responder->def->personalities[responder->current_personality - 1u];
-    start_address += personality->slot_count;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    g_subdevices.dmx_start_address[i] = start_address;
+    start_address += slot_count;
   }
   return true;
 }
@@ -263,48 +764,90 @@ uint8_t *AddStatusMessageToResponse(uint8_t *ptr,
   return ptr;
 }
 
-void QueueStatusMessage(StatusMessage *message,
-                        uint16_t sub_device_index,
+void QueueStatusMessage(uint16_t sub_device,
+                        uint8_t report_threshold,
                         RDMStatusType status_type,
                         RDMStatusMessageId status_id,
                         uint16_t data_value1,
                         uint16_t data_value2) {
-  message->is_active = true;
-  message->sub_device = sub_device_index;
-  message->status_type = status_type;
-  message->message_id = status_id;
-  message->data_value1 = data_value1;
-  message->data_value2 = data_value2;
+  StatusMessage message = {
+    .sub_device = sub_device,
+    .message_id = status_id,
+    .data_value1 = data_value1,
+    .data_value2 = data_value2,
+    .status_type = status_type
+  };
+  StatusQueue_Enqueue(&g_status_queue, &message, report_threshold);
 }
 
-void QueueSubDeviceStatusMessage(DimmerSubDevice *device,
+void QueueSubDeviceStatusMessage(unsigned int index,
                                  RDMStatusType status_type,
                                  RDMStatusMessageId status_id,
                                  uint16_t data_value1,
                                  uint16_t data_value2) {
-  if (device->sd_report_threshold == STATUS_NONE ||
-      (status_type & STATUS_TYPE_MASK) < device->sd_report_threshold) {
-    return;
-  }
+  QueueStatusMessage(SubDeviceNumber(index),
+                     g_subdevices.sd_report_threshold[index], status_type,
+                     status_id, data_value1, data_value2);
+}
+
+/*
+ * @brief Report the result of the running self test.
+ */
+static void SelfTestComplete(UNUSED void *data) {
+  // Queue a status message for the root.
+  QueueStatusMessage(
+      SUBDEVICE_ROOT, STATUS_ADVISORY, STATUS_ADVISORY,
+      (uint16_t) (g_root_device.running_self_test == 1u ?
+          STS_OLP_SELFTEST_PASSED : STS_OLP_SELFTEST_FAILED),
+      g_root_device.running_self_test, 0u);
 
-  QueueStatusMessage(&device->status_message, device->index,
-                     status_type, status_id, data_value1, data_value2);
+  g_root_device.running_self_test = SELF_TEST_OFF;
 }
 
 /*
- * @brief Dequeue a status message if it's at or above the threshold.
- * @pre There is at least one message slot available in g_status_messages.
- * @returns true if the message was added, false otherwise.
+ * @brief We generate status messages for each device, based on a periodic
+ * timer. This makes it easier to reproduce problems (and test!).
  */
-bool MaybeDequeueStatusMessage(StatusMessage *message, uint8_t threshold) {
-  if (!message->is_active ||
-      threshold < (message->status_type & STATUS_TYPE_MASK)) {
-    return false;
+static void StatusMessageTimer(UNUSED void *data) {
+  TimerWheel_Schedule(&g_root_device.status_message_timer,
+                      STATUS_MESSAGE_TRIGGER_INTERVAL, StatusMessageTimer,
+                      NULL);
+
+  unsigned int index = SubDeviceIndex(1u);
+  if (index != NUMBER_OF_SUB_DEVICES) {
+    // The cycle for the first device is:
+    //  - 0, NOOP
+    //  - 1, Queue breaker trip warning
+    //  - 2, NOOP
+    //  - 3, Clear breaker trip warning
+    //  - 4, NOOP
+    if (g_root_device.status_cycle == 1u) {
+      // Queue a message
+      QueueSubDeviceStatusMessage(index, STATUS_WARNING,
+                                  STS_BREAKER_TRIP, 0u, 0u);
+    } else if (g_root_device.status_cycle == 3u) {
+      if (StatusQueue_RemoveSubDevices(&g_status_queue, 1u, 1u) == 0u) {
+        // Queue a 'cleared' message
+        QueueSubDeviceStatusMessage(index, STATUS_WARNING_CLEARED,
+                                    STS_BREAKER_TRIP, 0u, 0u);
+      }
+    }
   }
 
-  message->is_active = false;
-  g_status_messages.last[g_status_messages.count] = *message;
-  return true;
+  index = SubDeviceIndex(3u);
+  if (index != NUMBER_OF_SUB_DEVICES) {
+    // This subdevice just queues a manufacturer-defined advisory message
+    // each cycle.
+    QueueSubDeviceStatusMessage(index, STATUS_ADVISORY,
+                                (uint16_t) STS_OLP_TESTING,
+                                g_root_device.status_complete_cycles,
+                                g_root_device.status_cycle);
+  }
+  g_root_device.status_cycle++;
+  g_root_device.status_cycle %= 5u;
+  if (g_root_device.status_cycle == 0u) {
+    g_root_device.status_complete_cycles++;
+  }
 }
 
 // Root PID Handlers
@@ -328,27 +871,14 @@ int DimmerModel_GetStatusMessages(const RDMHeader *header,
   } else {
     // Build the list of status messages.
     g_status_messages.count = 0u;
-
-    // Check the root
-    if (g_root_device.status_message.is_active &&
-        MaybeDequeueStatusMessage(&g_root_device.status_message, threshold)) {
+    while (g_status_messages.count < STATUS_MESSAGES_PER_RESPONSE &&
+           StatusQueue_Dequeue(
+               &g_status_queue, threshold,
+               &g_status_messages.last[g_status_messages.count])) {
       ptr = AddStatusMessageToResponse(
                 ptr, &g_status_messages.last[g_status_messages.count]);
       g_status_messages.count++;
     }
-
-    // Check the sub devices.
-    unsigned int i = 0u;
-    for (; i < NUMBER_OF_SUB_DEVICES &&
-           g_status_messages.count < STATUS_MESSAGE_QUEUE_SIZE; i++) {
-      DimmerSubDevice *subdevice = &g_subdevices[i];
-
-      if (MaybeDequeueStatusMessage(&subdevice->status_message, threshold)) {
-        ptr = AddStatusMessageToResponse(
-                  ptr, &g_status_messages.last[g_status_messages.count]);
-        g_status_messages.count++;
-      }
-    }
   }
 
   return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
@@ -389,13 +919,16 @@ int DimmerModel_PerformSelfTest(const RDMHeader *header,
 
   if (self_test_id == SELF_TEST_OFF) {
     g_root_device.running_self_test = SELF_TEST_OFF;
+    TimerWheel_Cancel(&g_root_device.self_test_timer);
   } else {
     if (g_root_device.running_self_test) {
       return RDMResponder_BuildNack(header, NR_ACTION_NOT_SUPPORTED);
     }
 
     g_root_device.running_self_test = self_test_id;
-    g_root_device.self_test_timer = CoarseTimer_GetTime();
+    TimerWheel_Schedule(&g_root_device.self_test_timer,
+                        SELF_TESTS[self_test_id - 1].duration,
+                        SelfTestComplete, NULL);
   }
   return RDMResponder_BuildSetAck(header);
 }
@@ -440,6 +973,7 @@ int DimmerModel_CapturePreset(const RDMHeader *header,
   scene->down_fade_time = down_fade_time;
   scene->wait_time = wait_time;
   scene->programmed_state = PRESET_PROGRAMMED;
+  memcpy(scene->levels, g_subdevices.level, NUMBER_OF_SUB_DEVICES);
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -463,39 +997,45 @@ int DimmerModel_SetPresetPlayback(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
 
+  uint16_t scene_index = playback_mode;
+  if (playback_mode == PRESET_PLAYBACK_ALL) {
+    scene_index = NextProgrammedScene(PRESET_PLAYBACK_OFF);
+    if (scene_index == PRESET_PLAYBACK_OFF) {
+      // There is nothing to play.
+      return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
+    }
+  }
+
   g_root_device.playback_mode = playback_mode;
   g_root_device.playback_level = param_data[2];
 
+  if (scene_index == PRESET_PLAYBACK_OFF) {
+    StopPlayback();
+  } else {
+    StartScene(scene_index);
+  }
   return RDMResponder_BuildSetAck(header);
 }
 
 int DimmerModel_GetDMXBlockAddress(const RDMHeader *header,
                                    UNUSED const uint8_t *param_data) {
-  uint16_t total_footprint = 0u;
-  uint16_t expected_start_address = 0u;
+  const uint16_t slot_count = SubDeviceFootprint();
+  uint16_t expected_start_address = g_subdevices.dmx_start_address[0];
   bool is_contiguous = true;
   unsigned int i = 0u;
   for (; i < NUMBER_OF_SUB_DEVICES; i++) {
-    RDMResponder *responder = &g_subdevices[i].responder;
-    uint16_t sub_device_footprint = responder->def
-        ->personalities[responder->current_personality - 1u].slot_count;
-    total_footprint += sub_device_footprint;
-    if (expected_start_address &&
-        expected_start_address != responder->dmx_start_address) {
+    if (expected_start_address != g_subdevices.dmx_start_address[i]) {
       is_contiguous = false;
-    } else if (expected_start_address) {
-      expected_start_address += sub_device_footprint;
-    } else {
-      expected_start_address = responder->dmx_start_address +
-                               sub_device_footprint;
+      break;
     }
+    expected_start_address += slot_count;
   }
 
   uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
-  ptr = PushUInt16(ptr, total_footprint);
+  ptr = PushUInt16(ptr, NUMBER_OF_SUB_DEVICES * slot_count);
   ptr = PushUInt16(
       ptr,
-      is_contiguous ? g_subdevices[0].responder.dmx_start_address :
+      is_contiguous ? g_subdevices.dmx_start_address[0] :
           INVALID_DMX_START_ADDRESS);
   return RDMResponder_AddHeaderAndChecksum(header, ACK,
                                            ptr - g_rdm_buffer);
@@ -733,6 +1273,7 @@ int DimmerModel_SetPresetStatus(const RDMHeader *header,
     scene->down_fade_time = 0u;
     scene->wait_time = 0u;
     scene->programmed_state = PRESET_NOT_PROGRAMMED;
+    memset(scene->levels, 0u, NUMBER_OF_SUB_DEVICES);
   } else {
     // don't change the state here, if we haven't been programmed, just update
     // the timing params
@@ -760,6 +1301,10 @@ int DimmerModel_SetPresetMergeMode(const RDMHeader *header,
   }
 
   g_root_device.merge_mode = merge_mode;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    UpdateOutput(i);
+  }
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -767,7 +1312,9 @@ int DimmerModel_SetPresetMergeMode(const RDMHeader *header,
 // ----------------------------------------------------------------------------
 int DimmerModel_ClearStatusId(const RDMHeader *header,
                               UNUSED const uint8_t *param_data) {
-  g_active_device->status_message.is_active = false;
+  StatusQueue_RemoveSubDevices(&g_status_queue,
+                               SubDeviceNumber(g_active_index),
+                               SubDeviceNumber(g_active_end - 1u));
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -775,7 +1322,7 @@ int DimmerModel_GetSubDeviceReportingThreshold(
     const RDMHeader *header,
     UNUSED const uint8_t *param_data) {
   return RDMResponder_GenericGetUInt8(
-      header, g_active_device->sd_report_threshold);
+      header, g_subdevices.sd_report_threshold[g_active_index]);
 }
 
 int DimmerModel_SetSubDeviceReportingThreshold(const RDMHeader *header,
@@ -790,13 +1337,17 @@ int DimmerModel_SetSubDeviceReportingThreshold(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
 
-  g_active_device->sd_report_threshold = threshold;
+  unsigned int i = g_active_index;
+  for (; i < g_active_end; i++) {
+    g_subdevices.sd_report_threshold[i] = threshold;
+  }
   return RDMResponder_BuildSetAck(header);
 }
 
 int DimmerModel_GetIdentifyMode(const RDMHeader *header,
                                 UNUSED const uint8_t *param_data) {
-  return RDMResponder_GenericGetUInt8(header, g_active_device->identify_mode);
+  return RDMResponder_GenericGetUInt8(
+      header, g_subdevices.identify_mode[g_active_index]);
 }
 
 int DimmerModel_SetIdentifyMode(const RDMHeader *header,
@@ -810,20 +1361,31 @@ int DimmerModel_SetIdentifyMode(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
 
-  g_active_device->identify_mode = mode;
+  unsigned int i = g_active_index;
+  for (; i < g_active_end; i++) {
+    g_subdevices.identify_mode[i] = mode;
+  }
   return RDMResponder_BuildSetAck(header);
 }
 
 int DimmerModel_GetBurnIn(const RDMHeader *header,
                           UNUSED const uint8_t *param_data) {
-  return RDMResponder_GenericGetUInt8(header, g_active_device->burn_in);
+  return RDMResponder_GenericGetUInt8(header,
+                                      g_subdevices.burn_in[g_active_index]);
 }
 
 int DimmerModel_SetBurnIn(const RDMHeader *header,
                           const uint8_t *param_data) {
   // TODO(simon): it would be nice to decrement this once an hour.
-  return RDMResponder_GenericSetUInt8(header, param_data,
-                                      &g_active_device->burn_in);
+  if (header->param_data_length != sizeof(uint8_t)) {
+    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
+  }
+
+  unsigned int i = g_active_index;
+  for (; i < g_active_end; i++) {
+    g_subdevices.burn_in[i] = param_data[0];
+  }
+  return RDMResponder_BuildSetAck(header);
 }
 
 int DimmerModel_GetDimmerInfo(const RDMHeader *header,
@@ -842,9 +1404,10 @@ int DimmerModel_GetDimmerInfo(const RDMHeader *header,
 int DimmerModel_GetMinimumLevel(const RDMHeader *header,
                                 UNUSED const uint8_t *param_data) {
   uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
-  ptr = PushUInt16(ptr, g_active_device->min_level_increasing);
-  ptr = PushUInt16(ptr, g_active_device->min_level_decreasing);
-  *ptr++ = g_active_device->on_below_min;
+  ptr = PushUInt16(ptr, g_subdevices.min_level_increasing[g_active_index]);
+  ptr = PushUInt16(ptr, g_subdevices.min_level_decreasing[g_active_index]);
+  *ptr++ = (g_subdevices.flags[g_active_index] & SUBDEVICE_FLAG_ON_BELOW_MIN) ?
+      1u : 0u;
   return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
 }
 
@@ -862,27 +1425,45 @@ int DimmerModel_SetMinimumLevel(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
 
-  g_active_device->min_level_increasing = min_level_increasing;
-  g_active_device->min_level_decreasing = min_level_decreasing;
-  g_active_device->on_below_min = on_below_min;
+  unsigned int i = g_active_index;
+  for (; i < g_active_end; i++) {
+    g_subdevices.min_level_increasing[i] = min_level_increasing;
+    g_subdevices.min_level_decreasing[i] = min_level_decreasing;
+    if (on_below_min) {
+      g_subdevices.flags[i] |= SUBDEVICE_FLAG_ON_BELOW_MIN;
+    } else {
+      g_subdevices.flags[i] &= ~SUBDEVICE_FLAG_ON_BELOW_MIN;
+    }
+    UpdateOutputScale(i);
+  }
   return RDMResponder_BuildSetAck(header);
 }
 
 int DimmerModel_GetMaximumLevel(const RDMHeader *header,
                                 UNUSED const uint8_t *param_data) {
-  return RDMResponder_GenericGetUInt16(header, g_active_device->max_level);
+  return RDMResponder_GenericGetUInt16(
+      header, g_subdevices.max_level[g_active_index]);
 }
 
 int DimmerModel_SetMaximumLevel(const RDMHeader *header,
                                 const uint8_t *param_data) {
-  return RDMResponder_GenericSetUInt16(header, param_data,
-                                       &g_active_device->max_level);
+  if (header->param_data_length != sizeof(uint16_t)) {
+    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
+  }
+
+  const uint16_t max_level = ExtractUInt16(param_data);
+  unsigned int i = g_active_index;
+  for (; i < g_active_end; i++) {
+    g_subdevices.max_level[i] = max_level;
+    UpdateOutputScale(i);
+  }
+  return RDMResponder_BuildSetAck(header);
 }
 
 int DimmerModel_GetCurve(const RDMHeader *header,
                          UNUSED const uint8_t *param_data) {
   uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
-  *ptr++ = g_active_device->curve;
+  *ptr++ = g_subdevices.curve[g_active_index];
   *ptr++ = NUMBER_OF_CURVES;
   return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
 }
@@ -899,11 +1480,12 @@ int DimmerModel_SetCurve(const RDMHeader *header,
   }
 
   // To make it interesting, not every sub-device supports each curve type.
-  if (curve % 2 && g_active_device->index % 2 == 0) {
+  if (curve % 2 && SubDeviceNumber(g_active_index) % 2 == 0) {
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
 
-  g_active_device->curve = curve;
+  g_subdevices.curve[g_active_index] = curve;
+  UpdateOutputScale(g_active_index);
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -925,7 +1507,7 @@ int DimmerModel_GetCurveDescription(const RDMHeader *header,
 int DimmerModel_GetOutputResponseTime(const RDMHeader *header,
                                       UNUSED const uint8_t *param_data) {
   uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
-  *ptr++ = g_active_device->output_response_time;
+  *ptr++ = g_subdevices.output_response_time[g_active_index];
   *ptr++ = NUMBER_OF_OUTPUT_RESPONSE_TIMES;
   return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
 }
@@ -941,7 +1523,11 @@ int DimmerModel_SetOutputResponseTime(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
 
-  g_active_device->output_response_time = setting;
+  unsigned int i = g_active_index;
+  for (; i < g_active_end; i++) {
+    g_subdevices.output_response_time[i] = setting;
+    SetTargetLevel(i, g_subdevices.target_level[i]);
+  }
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -963,7 +1549,7 @@ int DimmerModel_GetOutputResponseDescription(const RDMHeader *header,
 int DimmerModel_GetModulationFrequency(const RDMHeader *header,
                                        UNUSED const uint8_t *param_data) {
   uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
-  *ptr++ = g_active_device->modulation_frequency;
+  *ptr++ = g_subdevices.modulation_frequency[g_active_index];
   *ptr++ = NUMBER_OF_MODULATION_FREQUENCIES;
   return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
 }
@@ -979,7 +1565,10 @@ int DimmerModel_SetModulationFrequency(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
 
-  g_active_device->modulation_frequency = setting;
+  unsigned int i = g_active_index;
+  for (; i < g_active_end; i++) {
+    g_subdevices.modulation_frequency[i] = setting;
+  }
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -1001,6 +1590,54 @@ int DimmerModel_GetModulationFrequencyDescription(
   return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
 }
 
+int DimmerModel_SetAllDMXStartAddress(const RDMHeader *header,
+                                      const uint8_t *param_data) {
+  if (header->param_data_length != sizeof(uint16_t)) {
+    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
+  }
+
+  const uint16_t address = ExtractUInt16(param_data);
+  if (address == 0u || address > MAX_DMX_START_ADDRESS) {
+    return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
+  }
+
+  unsigned int i = g_active_index;
+  for (; i < g_active_end; i++) {
+    if (g_subdevices.dmx_start_address[i] != address) {
+      g_subdevices.flags[i] &= ~SUBDEVICE_FLAG_FACTORY_DEFAULTS;
+    }
+    g_subdevices.dmx_start_address[i] = address;
+  }
+  return RDMResponder_BuildSetAck(header);
+}
+
+int DimmerModel_SetAllIdentifyDevice(const RDMHeader *header,
+                                     const uint8_t *param_data) {
+  if (header->param_data_length != sizeof(uint8_t)) {
+    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
+  }
+
+  if (param_data[0] > 1u) {
+    return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
+  }
+
+  // Let the shared responder update the identify LED.
+  int response_size = RDMResponder_SetIdentifyDevice(header, param_data);
+  unsigned int i = g_active_index;
+  for (; i < g_active_end; i++) {
+    const bool identify_on = g_subdevices.flags[i] & SUBDEVICE_FLAG_IDENTIFY_ON;
+    if (identify_on != (param_data[0] != 0u)) {
+      g_subdevices.flags[i] &= ~SUBDEVICE_FLAG_FACTORY_DEFAULTS;
+    }
+    if (param_data[0]) {
+      g_subdevices.flags[i] |= SUBDEVICE_FLAG_IDENTIFY_ON;
+    } else {
+      g_subdevices.flags[i] &= ~SUBDEVICE_FLAG_IDENTIFY_ON;
+    }
+  }
+  return response_size;
+}
+
 // Public Functions
 // ----------------------------------------------------------------------------
 void DimmerModel_Initialize() {
@@ -1012,6 +1649,9 @@ void DimmerModel_Initialize() {
     g_root_device.scenes[i].wait_time = 0u;
     g_root_device.scenes[i].programmed_state = i == 0u ?
         PRESET_PROGRAMMED_READ_ONLY : PRESET_NOT_PROGRAMMED;
+    // The factory scene is all sub-devices at full.
+    memset(g_root_device.scenes[i].levels, i == 0u ? UINT8_MAX : 0u,
+           NUMBER_OF_SUB_DEVICES);
   }
 
   g_root_device.playback_mode = PRESET_PLAYBACK_OFF;
@@ -1029,64 +1669,246 @@ void DimmerModel_Initialize() {
   g_root_device.merge_mode = MERGE_MODE_DEFAULT;
   g_root_device.power_on_self_test = false;
   g_root_device.running_self_test = SELF_TEST_OFF;
+  g_root_device.status_cycle = 0u;
+  g_root_device.status_complete_cycles = 0u;
 
   // Initialize the subdevices.
   uint8_t parent_uid[UID_LENGTH];
   RDMResponder_GetUID(parent_uid);
 
-  uint16_t sub_device_index = 1u;
+  g_subdevice_responder.def = &SUBDEVICE_RESPONDER_DEFINITION;
+  RDMResponder_SwitchResponder(&g_subdevice_responder);
+  memcpy(g_responder->uid, parent_uid, UID_LENGTH);
+  RDMResponder_InitResponder();
+  g_responder->is_subdevice = true;
+  g_responder->sub_device_count = NUMBER_OF_SUB_DEVICES;
+  RDMResponder_RestoreResponder();
+
+  BuildCurveTables();
   for (i = 0u; i < NUMBER_OF_SUB_DEVICES; i++) {
-    if (i == 1) {
-      // Leave a gap at sub-device 2, since sub devices aren't required to be
-      // contiguous.
-      sub_device_index++;
-    }
+    g_subdevices.min_level_increasing[i] = 0u;
+    g_subdevices.min_level_decreasing[i] = 0u;
+    g_subdevices.max_level[i] = 0xfffe;
+    g_subdevices.identify_mode[i] = IDENTIFY_MODE_QUIET;
+    g_subdevices.burn_in[i] = 0u;
+    g_subdevices.curve[i] = CURVE_LINEAR;
+    g_subdevices.output_response_time[i] = OUTPUT_RESPONSE_FAST;
+    g_subdevices.modulation_frequency[i] = 1u;
+    g_subdevices.sd_report_threshold[i] = STATUS_ADVISORY;
+    g_subdevices.flags[i] = SUBDEVICE_FLAG_FACTORY_DEFAULTS;
+    g_subdevices.dmx_level[i] = 0u;
+    g_subdevices.level[i] = 0u;
+    g_subdevices.direction[i] = DIRECTION_INCREASING;
+    UpdateOutputScale(i);
+  }
+
+  memset(g_playback.levels, 0u, NUMBER_OF_SUB_DEVICES);
+  Fader_Initialize(&g_playback.fader, g_playback.channels, g_playback.levels,
+                   NUMBER_OF_SUB_DEVICES);
+  g_playback.scene = PRESET_PLAYBACK_OFF;
 
-    DimmerSubDevice *subdevice = &g_subdevices[i];
-    subdevice->responder.def = &SUBDEVICE_RESPONDER_DEFINITION;
-
-    subdevice->index = sub_device_index++;
-    subdevice->min_level_increasing = 0u;
-    subdevice->min_level_decreasing = 0u;
-    subdevice->max_level = 0u;
-    subdevice->on_below_min = 0u;
-    subdevice->identify_mode = IDENTIFY_MODE_QUIET;
-    subdevice->burn_in = 0u;
-    subdevice->curve = 1u;
-    subdevice->output_response_time = 1u;
-    subdevice->modulation_frequency = 1u;
-    subdevice->sd_report_threshold = STATUS_ADVISORY;
-    subdevice->status_message.is_active = false;
-
-    RDMResponder_SwitchResponder(&subdevice->responder);
-    memcpy(g_responder->uid, parent_uid, UID_LENGTH);
-    RDMResponder_InitResponder();
-    g_responder->is_subdevice = true;
-    g_responder->sub_device_count = NUMBER_OF_SUB_DEVICES;
-  }
-
-  // restore
-  RDMResponder_RestoreResponder();
   if (!ResetToBlockAddress(INITIAL_START_ADDRESSS)) {
     // Set them all to 1
     for (i = 0u; i < NUMBER_OF_SUB_DEVICES; i++) {
-      RDMResponder *responder = &g_subdevices[i].responder;
-      responder->dmx_start_address = INITIAL_START_ADDRESSS;
+      g_subdevices.dmx_start_address[i] = INITIAL_START_ADDRESSS;
     }
   }
+  g_dmx_window_start = 0u;
 
   // init status messages
+  StatusQueue_Initialize(&g_status_queue, g_status_message_storage,
+                         STATUS_MESSAGE_RING_SIZE);
   g_status_messages.count = 0u;
 }
 
+uint16_t DimmerModel_GetOutputLevel(uint16_t sub_device) {
+  const unsigned int index = SubDeviceIndex(sub_device);
+  if (index == NUMBER_OF_SUB_DEVICES) {
+    return 0u;
+  }
+  return g_subdevices.output_level[index];
+}
+
 static void DimmerModel_Activate() {
   g_responder->def = &ROOT_RESPONDER_DEFINITION;
   RDMResponder_InitResponder();
   g_responder->sub_device_count = NUMBER_OF_SUB_DEVICES;
-  g_root_device.status_message_timer = CoarseTimer_GetTime();
+  TimerWheel_Schedule(&g_root_device.status_message_timer,
+                      STATUS_MESSAGE_TRIGGER_INTERVAL, StatusMessageTimer,
+                      NULL);
+  if (g_playback.scene != PRESET_PLAYBACK_OFF) {
+    TimerWheel_Schedule(&g_playback.timer, FADE_UPDATE_INTERVAL,
+                        PlaybackTimer, NULL);
+  }
+}
+
+static void DimmerModel_Deactivate() {
+  TimerWheel_Cancel(&g_root_device.status_message_timer);
+  TimerWheel_Cancel(&g_root_device.self_test_timer);
+  TimerWheel_Cancel(&g_playback.timer);
+  SnapToTargetLevels();
 }
 
-static void DimmerModel_Deactivate() {}
+/*
+ * @brief The model specific settings blocks, see IOCTL_GET_SETTINGS.
+ *
+ * A block is only persisted if it fits in a ModelSettingsBlock, so racks with
+ * a large number of sub-devices only persist the root settings.
+ */
+enum {
+  SETTINGS_BLOCK_SUBDEVICES = 1,  //!< Start addresses & curves
+  SETTINGS_BLOCK_PRESETS = 2,  //!< Scene timing & levels
+};
+
+enum {
+  SUBDEVICE_SETTINGS_SIZE =
+      NUMBER_OF_SUB_DEVICES * (sizeof(uint16_t) + sizeof(uint8_t)),
+  SCENE_SETTINGS_SIZE =
+      3u * sizeof(uint16_t) + sizeof(uint8_t) + NUMBER_OF_SUB_DEVICES,
+  PRESET_SETTINGS_SIZE = NUMBER_OF_SCENES * SCENE_SETTINGS_SIZE,
+  MAX_SETTINGS_SIZE = MODEL_SETTINGS_BLOCK_SIZE,
+};
+
+/*
+ * @brief Serialize a settings block.
+ * @param block The block to populate.
+ * @returns true if the block was populated, false if it doesn't exist.
+ */
+static bool GetSettings(ModelSettingsBlock *block) {
+  uint8_t *ptr = block->data;
+  unsigned int i = 0u;
+  if (block->index == SETTINGS_BLOCK_SUBDEVICES &&
+      SUBDEVICE_SETTINGS_SIZE <= MAX_SETTINGS_SIZE) {
+    for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+      ptr = PushUInt16(ptr, g_subdevices.dmx_start_address[i]);
+      *ptr++ = g_subdevices.curve[i];
+    }
+  } else if (block->index == SETTINGS_BLOCK_PRESETS &&
+             PRESET_SETTINGS_SIZE <= MAX_SETTINGS_SIZE) {
+    for (; i < NUMBER_OF_SCENES; i++) {
+      const Scene *scene = &g_root_device.scenes[i];
+      ptr = PushUInt16(ptr, scene->up_fade_time);
+      ptr = PushUInt16(ptr, scene->down_fade_time);
+      ptr = PushUInt16(ptr, scene->wait_time);
+      *ptr++ = scene->programmed_state;
+      memcpy(ptr, scene->levels, NUMBER_OF_SUB_DEVICES);
+      ptr += NUMBER_OF_SUB_DEVICES;
+    }
+  } else {
+    return RDMResponder_Ioctl(IOCTL_GET_SETTINGS, (uint8_t*) block,
+                              sizeof(ModelSettingsBlock));
+  }
+  block->length = ptr - block->data;
+  return true;
+}
+
+/*
+ * @brief Restore the sub-device start addresses and curves.
+ */
+static bool SetSubDeviceSettings(const ModelSettingsBlock *block) {
+  if (block->length != SUBDEVICE_SETTINGS_SIZE) {
+    return false;
+  }
+
+  const uint8_t *ptr = block->data;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++, ptr += 3u) {
+    const uint16_t address = ExtractUInt16(ptr);
+    const uint8_t curve = ptr[2];
+    // Every sub-device starts with the linear curve, so allow it here even
+    // though a SET of it would be rejected.
+    if (address == 0u || address > MAX_DMX_START_ADDRESS ||
+        curve == 0u || curve > NUMBER_OF_CURVES ||
+        (curve % 2 && curve != CURVE_LINEAR && SubDeviceNumber(i) % 2 == 0)) {
+      return false;
+    }
+  }
+
+  for (i = 0u, ptr = block->data; i < NUMBER_OF_SUB_DEVICES; i++, ptr += 3u) {
+    const uint16_t address = ExtractUInt16(ptr);
+    if (g_subdevices.dmx_start_address[i] != address) {
+      g_subdevices.flags[i] &= ~SUBDEVICE_FLAG_FACTORY_DEFAULTS;
+    }
+    g_subdevices.dmx_start_address[i] = address;
+    g_subdevices.curve[i] = ptr[2];
+    UpdateOutputScale(i);
+  }
+  return true;
+}
+
+/*
+ * @brief Restore the scene timing and levels.
+ */
+static bool SetPresetSettings(const ModelSettingsBlock *block) {
+  if (block->length != PRESET_SETTINGS_SIZE) {
+    return false;
+  }
+
+  const uint8_t *ptr = block->data;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SCENES; i++, ptr += SCENE_SETTINGS_SIZE) {
+    if (ptr[6] > PRESET_PROGRAMMED_READ_ONLY) {
+      return false;
+    }
+  }
+
+  for (i = 0u, ptr = block->data; i < NUMBER_OF_SCENES; i++) {
+    Scene *scene = &g_root_device.scenes[i];
+    scene->up_fade_time = ExtractUInt16(ptr);
+    scene->down_fade_time = ExtractUInt16(ptr + 2u);
+    scene->wait_time = ExtractUInt16(ptr + 4u);
+    scene->programmed_state = ptr[6];
+    memcpy(scene->levels, ptr + 7u, NUMBER_OF_SUB_DEVICES);
+    ptr += SCENE_SETTINGS_SIZE;
+  }
+  return true;
+}
+
+/*
+ * @brief Restore a settings block.
+ * @param block The block to restore.
+ * @returns true if the block was valid and applied, false otherwise.
+ */
+static bool SetSettings(const ModelSettingsBlock *block) {
+  switch (block->index) {
+    case SETTINGS_BLOCK_SUBDEVICES:
+      return SUBDEVICE_SETTINGS_SIZE <= MAX_SETTINGS_SIZE &&
+          SetSubDeviceSettings(block);
+    case SETTINGS_BLOCK_PRESETS:
+      return PRESET_SETTINGS_SIZE <= MAX_SETTINGS_SIZE &&
+          SetPresetSettings(block);
+    default:
+      return RDMResponder_Ioctl(IOCTL_SET_SETTINGS, (uint8_t*) block,
+                                sizeof(ModelSettingsBlock));
+  }
+}
+
+static int DimmerModel_Ioctl(ModelIoctl command, uint8_t *data,
+                             unsigned int length) {
+  switch (command) {
+    case IOCTL_DMX_DATA:
+      ApplyDMXData(data, length);
+      return 1;
+    case IOCTL_GET_DMX_WINDOW:
+      if (length != sizeof(DMXWindow)) {
+        return 0;
+      }
+      GetDMXWindow((DMXWindow*) data);
+      return 1;
+    case IOCTL_GET_SETTINGS:
+      if (length != sizeof(ModelSettingsBlock)) {
+        return 0;
+      }
+      return GetSettings((ModelSettingsBlock*) data);
+    case IOCTL_SET_SETTINGS:
+      if (length != sizeof(ModelSettingsBlock)) {
+        return 0;
+      }
+      return SetSettings((const ModelSettingsBlock*) data);
+    default:
+      return RDMResponder_Ioctl(command, data, length);
+  }
+}
 
 static int DimmerModel_HandleRequest(const RDMHeader *header,
                                      const uint8_t *param_data) {
@@ -1126,110 +1948,56 @@ static int DimmerModel_HandleRequest(const RDMHeader *header,
     }
   }
 
-  unsigned int i = 0u;
-  bool handled = false;
-  int response_size = RDM_RESPONDER_NO_RESPONSE;
-  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
-    if (sub_device == g_subdevices[i].index || sub_device == SUBDEVICE_ALL) {
-      if (!locked) {
-        g_active_device = &g_subdevices[i];
-        RDMResponder_SwitchResponder(&g_subdevices[i].responder);
-        response_size = RDMResponder_DispatchPID(header, param_data);
-      }
-      handled = true;
+  unsigned int index = 0u;
+  if (sub_device != SUBDEVICE_ALL) {
+    index = SubDeviceIndex(sub_device);
+    if (index == NUMBER_OF_SUB_DEVICES) {
+      return RDMResponder_BuildNack(header, NR_SUB_DEVICE_OUT_OF_RANGE);
     }
   }
 
-  RDMResponder_RestoreResponder();
-
-  if (!handled) {
-    return RDMResponder_BuildNack(header, NR_SUB_DEVICE_OUT_OF_RANGE);
-  }
-
   if (locked) {
     return RDMResponder_BuildNack(header, NR_WRITE_PROTECT);
   }
 
-  // If it was an all-subdevices call, it's not really clear how to handle the
-  // response, in this case we return the last one.
-  return response_size;
-}
+  int response_size = RDM_RESPONDER_NO_RESPONSE;
+  if (sub_device == SUBDEVICE_ALL) {
+    LoadSubDevice(0u);
+    PIDCommandHandler handler = RDMResponder_GetSetAllHandler(
+        ntohs(header->param_id));
+    if (handler) {
+      // Validate once and apply to all sub-devices in a single pass. The
+      // handler writes to the arrays directly, so there is nothing to store.
+      g_active_end = NUMBER_OF_SUB_DEVICES;
+      response_size = handler(header, param_data);
+      RDMResponder_RestoreResponder();
+      return response_size;
+    }
 
-/*
- * @brief We generate status messages for each device, based on a periodic
- * timer. This makes it easier to reproduce problems (and test!).
- */
-static void DimmerModel_Tasks() {
-  // The cycle counter is used to generate status messages for each sub device.
-  static uint8_t cycle = 0u;
-  static uint16_t complete_cycles = 0u;
-
-  if (g_root_device.running_self_test &&
-      CoarseTimer_HasElapsed(
-          g_root_device.self_test_timer,
-          SELF_TESTS[g_root_device.running_self_test - 1].duration)) {
-    // Queue a status message for the root.
-    QueueStatusMessage(
-        &g_root_device.status_message, SUBDEVICE_ROOT, STATUS_ADVISORY,
-        (uint16_t) (g_root_device.running_self_test == 1u ?
-            STS_OLP_SELFTEST_PASSED : STS_OLP_SELFTEST_FAILED),
-        g_root_device.running_self_test, 0u);
-
-    g_root_device.running_self_test = 0u;
-  }
-
-  if (!CoarseTimer_HasElapsed(g_root_device.status_message_timer,
-                             STATUS_MESSAGE_TRIGGER_INTERVAL)) {
-    return;
-  }
-
-  g_root_device.status_message_timer = CoarseTimer_GetTime();
-
-  unsigned int subdevice_index = 0u;
-  for (; subdevice_index < NUMBER_OF_SUB_DEVICES; subdevice_index++) {
-    DimmerSubDevice *subdevice = &g_subdevices[subdevice_index];
-
-    if (subdevice->index == 1u) {
-      // The cycle for the first device is:
-      //  - 0, NOOP
-      //  - 1, Queue breaker trip warning
-      //  - 2, NOOP
-      //  - 3, Clear breaker trip warning
-      //  - 4, NOOP
-      if (cycle == 1) {
-        // Queue a message
-        QueueSubDeviceStatusMessage(subdevice, STATUS_WARNING,
-                                    STS_BREAKER_TRIP, 0u, 0u);
-      } else if (cycle == 3u) {
-        if (subdevice->status_message.is_active) {
-          // The previous message is still in the queue, cancel it.
-          subdevice->status_message.is_active = false;
-        } else {
-          // Queue a 'cleared' message
-          QueueSubDeviceStatusMessage(subdevice, STATUS_WARNING_CLEARED,
-                                      STS_BREAKER_TRIP, 0u, 0u);
-        }
-      }
-    } else if (subdevice->index == 3u) {
-      // This subdevice just queues a manufacturer-defined advisory message
-      // each cycle.
-      QueueSubDeviceStatusMessage(subdevice, STATUS_ADVISORY,
-                                  (uint16_t) STS_OLP_TESTING,
-                                  complete_cycles, cycle);
+    // If it was an all-subdevices call, it's not really clear how to handle
+    // the response, in this case we return the last one.
+    for (; index < NUMBER_OF_SUB_DEVICES; index++) {
+      LoadSubDevice(index);
+      response_size = RDMResponder_DispatchPID(header, param_data);
+      StoreSubDevice();
     }
+  } else {
+    LoadSubDevice(index);
+    response_size = RDMResponder_DispatchPID(header, param_data);
+    StoreSubDevice();
   }
-  cycle++;
-  cycle %= 5u;
-  if (cycle == 0u) {
-    complete_cycles++;
-  }
+
+  RDMResponder_RestoreResponder();
+  return response_size;
 }
 
+static void DimmerModel_Tasks() {}
+
 const ModelEntry DIMMER_MODEL_ENTRY = {
   .model_id = DIMMER_MODEL_ID,
   .activate_fn = DimmerModel_Activate,
   .deactivate_fn = DimmerModel_Deactivate,
-  .ioctl_fn = RDMResponder_Ioctl,
+  .ioctl_fn = DimmerModel_Ioctl,
   .request_fn = DimmerModel_HandleRequest,
   .tasks_fn = DimmerModel_Tasks
 };
@@ -1355,6 +2123,34 @@ static const PIDDescriptor SUBDEVICE_PID_DESCRIPTORS[] = {
     (PIDCommandHandler) NULL},
 };
 
+/*
+ * @brief The SET handlers used for requests to SUBDEVICE_ALL.
+ *
+ * PID_CURVE isn't included, since the supported curves vary between
+ * sub-devices.
+ */
+static const PIDDescriptor SUBDEVICE_SET_ALL_PID_DESCRIPTORS[] = {
+  {PID_CLEAR_STATUS_ID, (PIDCommandHandler) NULL, 0u,
+    DimmerModel_ClearStatusId},
+  {PID_SUB_DEVICE_STATUS_REPORT_THRESHOLD, (PIDCommandHandler) NULL, 0u,
+    DimmerModel_SetSubDeviceReportingThreshold},
+  {PID_DMX_START_ADDRESS, (PIDCommandHandler) NULL, 0u,
+    DimmerModel_SetAllDMXStartAddress},
+  {PID_IDENTIFY_DEVICE, (PIDCommandHandler) NULL, 0u,
+    DimmerModel_SetAllIdentifyDevice},
+  {PID_BURN_IN, (PIDCommandHandler) NULL, 0u, DimmerModel_SetBurnIn},
+  {PID_IDENTIFY_MODE, (PIDCommandHandler) NULL, 0u,
+    DimmerModel_SetIdentifyMode},
+  {PID_MINIMUM_LEVEL, (PIDCommandHandler) NULL, 0u,
+    DimmerModel_SetMinimumLevel},
+  {PID_MAXIMUM_LEVEL, (PIDCommandHandler) NULL, 0u,
+    DimmerModel_SetMaximumLevel},
+  {PID_OUTPUT_RESPONSE_TIME, (PIDCommandHandler) NULL, 0u,
+    DimmerModel_SetOutputResponseTime},
+  {PID_MODULATION_FREQUENCY, (PIDCommandHandler) NULL, 0u,
+    DimmerModel_SetModulationFrequency},
+};
+
 static const ProductDetailIds SUBDEVICE_PRODUCT_DETAIL_ID_LIST = {
   .ids = {PRODUCT_DETAIL_TEST, PRODUCT_DETAIL_CHANGEOVER_MANUAL},
   .size = 2u
@@ -1383,6 +2179,9 @@ static const PersonalityDefinition PERSONALITIES[PERSONALITY_COUNT] = {
 static const ResponderDefinition SUBDEVICE_RESPONDER_DEFINITION = {
   .descriptors = SUBDEVICE_PID_DESCRIPTORS,
   .descriptor_count = sizeof(SUBDEVICE_PID_DESCRIPTORS) / sizeof(PIDDescriptor),
+  .set_all_descriptors = SUBDEVICE_SET_ALL_PID_DESCRIPTORS,
+  .set_all_descriptor_count = sizeof(SUBDEVICE_SET_ALL_PID_DESCRIPTORS) /
+                              sizeof(PIDDescriptor),
   .sensors = NULL,
   .sensor_count = 0u,
   .personalities = PERSONALITIES,
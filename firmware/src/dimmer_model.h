@@ -34,12 +34,23 @@
  * DMX_BLOCK_ADDRESS can be used to set the start address of all sub-devices in
  * a single operation.
  *
+ * The number of sub-devices defaults to 4 and can be changed by defining
+ * DIMMER_MODEL_SUB_DEVICE_COUNT. The sub-devices share a single RDMResponder,
+ * the per-sub-device settings are stored as arrays to keep the memory use
+ * low.
+ *
  * ### Dimmer Settings
  *
  * Each sub-device implements the PIDs from Section 4 of E1.37-1. To make
  * things interesting, not all sub-devices support all the dimmer curves /
  * modulation frequencies.
  *
+ * The curve, minimum & maximum levels are baked into a 256 entry lookup table
+ * per sub-device, which is rebuilt when the settings change. This keeps the
+ * work done in the DMX receive path to a single table lookup per sub-device.
+ * The resulting 16 bit output level can be read with
+ * DimmerModel_GetOutputLevel().
+ *
  * ### Presets & Scenes.
  *
  * The root device provides 3 scenes. The first scene (index 1) is a factory
@@ -49,6 +60,11 @@
  * DMX_FAIL_MODE and DMX_STARTUP_MODE can be used to change the on-failure and
  * on-startup scenes.
  *
+ * PRESET_PLAYBACK crossfades the sub-devices to a scene, using the scene's up
+ * and down fade times. In PRESET_PLAYBACK_ALL mode, the programmed scenes are
+ * played in turn, holding each one for the wait time. The scene levels are
+ * merged with the DMX levels according to PRESET_MERGEMODE.
+ *
  * ### Status Messages
  *
  * Sub devices 1 & 3 will periodically queue status messages, which can be
@@ -92,6 +108,14 @@ extern const ModelEntry DIMMER_MODEL_ENTRY;
  */
 void DimmerModel_Initialize();
 
+/**
+ * @brief Get the current output level of a sub-device.
+ * @param sub_device The sub-device number.
+ * @returns The output level, from 0 to the maximum level, or 0 if the
+ *   sub-device doesn't exist.
+ */
+uint16_t DimmerModel_GetOutputLevel(uint16_t sub_device);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,329 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * dmx_forwarder.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "dmx_forwarder.h"
+
+#include <string.h>
+
+#include "app_pipeline.h"
+#include "coarse_timer.h"
+#include "constants.h"
+#include "dmx_input.h"
+
+enum { WORD_SIZE = sizeof(uint32_t) };
+
+/*
+ * @brief The size of the sequence number & slot count at the start of a
+ *   COMMAND_RX_DMX_CHANGES message.
+ */
+enum { CHANGES_HEADER_SIZE = 3 };
+
+/*
+ * @brief The size of the start slot & length before each range.
+ */
+enum { RANGE_HEADER_SIZE = 4 };
+
+typedef struct {
+  DMXForwardMode mode;
+  uint8_t token;
+  uint16_t interval;
+
+  /*
+   * @brief The sequence number of the last frame sent.
+   */
+  uint32_t last_sequence;
+
+  /*
+   * @brief The time the last frame was sent.
+   */
+  CoarseTimer_Value last_send_time;
+
+  /*
+   * @brief True if nothing has been sent since forwarding was configured.
+   */
+  bool first_frame;
+
+  /*
+   * @brief True if some of the changes didn't fit in the last message.
+   */
+  bool changes_pending;
+
+  /*
+   * @brief The number of slots in the last changes message.
+   */
+  uint16_t sent_slot_count;
+} DMXForwarderState;
+
+static DMXForwarderState g_forwarder;
+
+/*
+ * @brief The slot values the Host has been sent, in changes mode.
+ *
+ * Slots past sent_slot_count are 0.
+ */
+static uint32_t g_sent[DMX_FRAME_SIZE / WORD_SIZE];
+
+/*
+ * @brief The payload for COMMAND_RX_DMX_CHANGES messages.
+ */
+static uint8_t g_payload[PAYLOAD_SIZE];
+
+#ifndef PIPELINE_TRANSPORT_TX
+static TransportTXFunction g_forwarder_tx_cb = NULL;
+#endif
+
+static inline bool SendMessage(Command command, const IOVec* iov,
+                               unsigned int iov_size) {
+#ifdef PIPELINE_TRANSPORT_TX
+  bool ok = PIPELINE_TRANSPORT_TX(g_forwarder.token, command, RC_OK, iov,
+                                  iov_size);
+#else
+  bool ok = g_forwarder_tx_cb(g_forwarder.token, command, RC_OK, iov,
+                              iov_size);
+#endif
+  return ok;
+}
+
+/*
+ * @brief Load a word from a possibly unaligned address.
+ */
+static inline uint32_t LoadWord(const uint8_t *ptr) {
+  uint32_t word;
+  memcpy(&word, ptr, WORD_SIZE);
+  return word;
+}
+
+/*
+ * @brief Check if a chunk of up to a word differs.
+ * @param a The first chunk.
+ * @param b The second chunk.
+ * @param length The length of the chunks, from 1 to WORD_SIZE.
+ */
+static inline bool ChunkDiffers(const uint8_t *a, const uint8_t *b,
+                                unsigned int length) {
+  if (length == WORD_SIZE) {
+    return LoadWord(a) != LoadWord(b);
+  }
+  return memcmp(a, b, length) != 0;
+}
+
+static inline unsigned int ChunkLength(unsigned int offset,
+                                       unsigned int slot_count) {
+  return slot_count - offset < WORD_SIZE ? slot_count - offset : WORD_SIZE;
+}
+
+static bool SendFullFrame(const DMXInputFrame *frame) {
+  const uint8_t sequence = (uint8_t) frame->sequence;
+  IOVec iov[2];
+  iov[0].base = &sequence;
+  iov[0].length = sizeof(sequence);
+  iov[1].base = frame->slots;
+  iov[1].length = frame->slot_count;
+  return SendMessage(COMMAND_RX_DMX_FRAME, iov, 2u);
+}
+
+/*
+ * @brief Build a COMMAND_RX_DMX_CHANGES payload.
+ * @param frame The frame to compare against g_sent.
+ * @param[out] complete Set to false if the changes didn't fit in the payload.
+ * @returns The size of the payload, or 0 if there is nothing to send.
+ */
+static unsigned int BuildChanges(const DMXInputFrame *frame, bool *complete) {
+  const uint8_t *slots = frame->slots;
+  const uint8_t *sent = (const uint8_t*) g_sent;
+  const unsigned int slot_count = frame->slot_count;
+  unsigned int size = CHANGES_HEADER_SIZE;
+  unsigned int offset = 0u;
+
+  *complete = true;
+  while (offset < slot_count) {
+    // Skip over the unchanged words. offset is always word aligned here.
+    unsigned int chunk = ChunkLength(offset, slot_count);
+    if (!ChunkDiffers(slots + offset, sent + offset, chunk)) {
+      offset += chunk;
+      continue;
+    }
+
+    unsigned int start = offset;
+    while (slots[start] == sent[start]) {
+      start++;
+    }
+
+    // Extend the range over the changed words that follow.
+    unsigned int end = offset + chunk;
+    while (end < slot_count) {
+      chunk = ChunkLength(end, slot_count);
+      if (!ChunkDiffers(slots + end, sent + end, chunk)) {
+        break;
+      }
+      end += chunk;
+    }
+    offset = end;
+    while (slots[end - 1u] == sent[end - 1u]) {
+      end--;
+    }
+
+    if (size + RANGE_HEADER_SIZE >= PAYLOAD_SIZE) {
+      *complete = false;
+      break;
+    }
+    unsigned int length = end - start;
+    if (length > PAYLOAD_SIZE - size - RANGE_HEADER_SIZE) {
+      length = PAYLOAD_SIZE - size - RANGE_HEADER_SIZE;
+      *complete = false;
+    }
+    g_payload[size++] = start & 0xffu;
+    g_payload[size++] = start >> 8u;
+    g_payload[size++] = length & 0xffu;
+    g_payload[size++] = length >> 8u;
+    memcpy(g_payload + size, slots + start, length);
+    size += length;
+    if (!*complete) {
+      break;
+    }
+  }
+
+  if (size == CHANGES_HEADER_SIZE &&
+      slot_count == g_forwarder.sent_slot_count) {
+    return 0u;
+  }
+  g_payload[0] = (uint8_t) frame->sequence;
+  g_payload[1] = slot_count & 0xffu;
+  g_payload[2] = slot_count >> 8u;
+  return size;
+}
+
+/*
+ * @brief Update g_sent with the ranges in a COMMAND_RX_DMX_CHANGES payload.
+ */
+static void CommitChanges(unsigned int size) {
+  uint8_t *sent = (uint8_t*) g_sent;
+  const uint16_t slot_count = g_payload[1] + (g_payload[2] << 8u);
+  unsigned int offset = CHANGES_HEADER_SIZE;
+  while (offset < size) {
+    const uint16_t start = g_payload[offset] + (g_payload[offset + 1u] << 8u);
+    const uint16_t length =
+        g_payload[offset + 2u] + (g_payload[offset + 3u] << 8u);
+    offset += RANGE_HEADER_SIZE;
+    memcpy(sent + start, g_payload + offset, length);
+    offset += length;
+  }
+  if (slot_count < g_forwarder.sent_slot_count) {
+    memset(sent + slot_count, 0, g_forwarder.sent_slot_count - slot_count);
+  }
+  g_forwarder.sent_slot_count = slot_count;
+}
+
+/*
+ * @brief Send the changes between a frame and what the Host has.
+ * @param frame The frame to send.
+ * @param[out] sent Set to true if a message was sent, false if there were no
+ *   changes.
+ * @returns false if the message couldn't be sent.
+ */
+static bool SendChanges(const DMXInputFrame *frame, bool *sent) {
+  bool complete;
+  const unsigned int size = BuildChanges(frame, &complete);
+  *sent = false;
+  if (size == 0u) {
+    g_forwarder.changes_pending = false;
+    return true;
+  }
+
+  IOVec iov;
+  iov.base = g_payload;
+  iov.length = size;
+  if (!SendMessage(COMMAND_RX_DMX_CHANGES, &iov, 1u)) {
+    return false;
+  }
+  CommitChanges(size);
+  g_forwarder.changes_pending = !complete;
+  *sent = true;
+  return true;
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void DMXForwarder_Initialize(TransportTXFunction tx_cb) {
+#ifndef PIPELINE_TRANSPORT_TX
+  g_forwarder_tx_cb = tx_cb;
+#endif
+  DMXForwarder_Configure(0u, DMX_FORWARD_OFF, 0u);
+}
+
+bool DMXForwarder_Configure(uint8_t token, uint8_t mode, uint16_t interval) {
+  if (mode > DMX_FORWARD_CHANGES) {
+    return false;
+  }
+  g_forwarder.mode = mode;
+  g_forwarder.token = token;
+  g_forwarder.interval = interval;
+  g_forwarder.last_sequence = 0u;
+  g_forwarder.last_send_time = CoarseTimer_GetTime();
+  g_forwarder.first_frame = true;
+  g_forwarder.changes_pending = false;
+  g_forwarder.sent_slot_count = 0u;
+  memset(g_sent, 0, sizeof(g_sent));
+  return true;
+}
+
+void DMXForwarder_Tasks() {
+  if (g_forwarder.mode == DMX_FORWARD_OFF) {
+    return;
+  }
+#ifndef PIPELINE_TRANSPORT_TX
+  if (!g_forwarder_tx_cb) {
+    return;
+  }
+#endif
+
+  const bool continuation = g_forwarder.changes_pending;
+  if (!continuation) {
+    const uint32_t sequence = DMXInput_LatestSequence();
+    if (sequence == 0u || sequence == g_forwarder.last_sequence) {
+      return;
+    }
+    if (!g_forwarder.first_frame &&
+        !CoarseTimer_HasElapsed(g_forwarder.last_send_time,
+                                g_forwarder.interval)) {
+      return;
+    }
+  }
+
+  const DMXInputFrame *frame = DMXInput_GetFrame();
+  bool ok;
+  bool sent;
+  if (g_forwarder.mode == DMX_FORWARD_FULL_FRAMES) {
+    ok = SendFullFrame(frame);
+    sent = ok;
+  } else {
+    ok = SendChanges(frame, &sent);
+  }
+  if (!ok) {
+    // The transport was busy, try again on the next call.
+    return;
+  }
+
+  g_forwarder.last_sequence = frame->sequence;
+  if (sent && !continuation) {
+    // Frames with no changes don't count towards the rate limit.
+    g_forwarder.last_send_time = CoarseTimer_GetTime();
+    g_forwarder.first_frame = false;
+  }
+}
@@ -0,0 +1,107 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * dmx_forwarder.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup dmx_forwarder DMX Forwarder
+ * @brief Forward received DMX512 frames to the Host.
+ *
+ * Once the Host has subscribed with a COMMAND_SET_DMX_FORWARDING message, the
+ * frames published to the @ref dmx_input store are sent to the Host. There are
+ * two modes:
+ *  - Full frames, each new frame is sent as a COMMAND_RX_DMX_FRAME message.
+ *  - Changes, only the slots that differ from what was last sent to the Host
+ *    are sent, as a list of ranges in a COMMAND_RX_DMX_CHANGES message.
+ *
+ * In both modes a minimum interval between frames can be set, which caps the
+ * rate at which messages are sent. Frames received during the interval are
+ * dropped, the next message reflects the newest frame.
+ *
+ * In changes mode, the forwarder keeps a copy of the slot values the Host has
+ * been sent. New frames are compared against this a word at a time. If the
+ * changes don't fit in a single message, the remaining changes are sent in
+ * the following messages, without waiting for the interval.
+ *
+ * See @ref message-commands-setdmxforwarding for the message formats.
+ *
+ * @addtogroup dmx_forwarder
+ * @{
+ * @file dmx_forwarder.h
+ * @brief Forward received DMX512 frames to the Host.
+ */
+
+#ifndef FIRMWARE_SRC_DMX_FORWARDER_H_
+#define FIRMWARE_SRC_DMX_FORWARDER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "transport.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The forwarding mode.
+ */
+typedef enum {
+  DMX_FORWARD_OFF = 0,  //!< Don't forward frames.
+  DMX_FORWARD_FULL_FRAMES = 1,  //!< Send each frame in full.
+  DMX_FORWARD_CHANGES = 2,  //!< Send only the slots that have changed.
+} DMXForwardMode;
+
+/**
+ * @brief Initialize the DMX Forwarder.
+ * @param tx_cb The callback to use for sending messages.
+ *
+ * If PIPELINE_TRANSPORT_TX is defined in app_pipeline.h, the macro
+ * will override the tx_cb argument.
+ */
+void DMXForwarder_Initialize(TransportTXFunction tx_cb);
+
+/**
+ * @brief Configure forwarding.
+ * @param token The token to use for the forwarded messages.
+ * @param mode The DMXForwardMode.
+ * @param interval The minimum time between frames, in 10ths of a
+ *   millisecond.
+ * @returns true if the mode was valid, false otherwise.
+ *
+ * Changing the mode resets the forwarding state, the next message will
+ * contain the latest frame, or all non-0 slots in changes mode.
+ */
+bool DMXForwarder_Configure(uint8_t token, uint8_t mode, uint16_t interval);
+
+/**
+ * @brief Perform the periodic tasks.
+ *
+ * This should be called in the main event loop. At most one message is sent
+ * per call.
+ */
+void DMXForwarder_Tasks();
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_DMX_FORWARDER_H_
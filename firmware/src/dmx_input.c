@@ -0,0 +1,129 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * dmx_input.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "dmx_input.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+enum { FRAME_BUFFER_COUNT = 3 };
+
+/*
+ * @brief Set in g_middle when the middle buffer holds a frame the consumer
+ * hasn't seen.
+ */
+static const uint8_t FRESH_FRAME = 0x80u;
+
+/*
+ * @brief The mask for the buffer index in g_middle.
+ */
+static const uint8_t INDEX_MASK = 0x03u;
+
+static DMXInputFrame g_frames[FRAME_BUFFER_COUNT];
+
+/*
+ * @brief The index of the middle buffer, and the FRESH_FRAME flag.
+ *
+ * This is the only state shared between the producer and consumer, it's only
+ * ever modified with an atomic exchange.
+ */
+static uint8_t g_middle = 1u;
+
+// Owned by the producer
+static uint8_t g_write_index = 0u;
+static bool g_in_frame;
+static uint32_t g_sequence;
+
+/*
+ * @brief The sequence number of the last published frame.
+ *
+ * Written by the producer, read by the consumer. Aligned 32 bit loads and
+ * stores are atomic.
+ */
+static volatile uint32_t g_latest_sequence;
+
+// Owned by the consumer
+static uint8_t g_read_index = 2u;
+
+/*
+ * @brief Swap a new value into g_middle.
+ * @returns The previous value of g_middle.
+ */
+static inline uint8_t SwapMiddle(uint8_t value) {
+  return __atomic_exchange_n(&g_middle, value, __ATOMIC_ACQ_REL);
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void DMXInput_Initialize() {
+  unsigned int i = 0u;
+  for (; i < FRAME_BUFFER_COUNT; i++) {
+    g_frames[i].sequence = 0u;
+    g_frames[i].slot_count = 0u;
+  }
+  g_write_index = 0u;
+  g_middle = 1u;
+  g_read_index = 2u;
+  g_in_frame = false;
+  g_sequence = 0u;
+  g_latest_sequence = 0u;
+}
+
+void DMXInput_BeginFrame() {
+  g_frames[g_write_index].slot_count = 0u;
+  g_in_frame = true;
+}
+
+void DMXInput_AppendSlots(const uint8_t *data, unsigned int length) {
+  if (!g_in_frame) {
+    return;
+  }
+  DMXInputFrame *frame = &g_frames[g_write_index];
+  if (length > DMX_FRAME_SIZE - frame->slot_count) {
+    length = DMX_FRAME_SIZE - frame->slot_count;
+  }
+  memcpy(frame->slots + frame->slot_count, data, length);
+  frame->slot_count += length;
+}
+
+void DMXInput_EndFrame() {
+  if (!g_in_frame) {
+    return;
+  }
+  g_in_frame = false;
+  g_sequence++;
+  if (g_sequence == 0u) {
+    // 0 means no frame.
+    g_sequence++;
+  }
+  g_frames[g_write_index].sequence = g_sequence;
+  g_write_index = SwapMiddle(g_write_index | FRESH_FRAME) & INDEX_MASK;
+  g_latest_sequence = g_sequence;
+}
+
+const DMXInputFrame *DMXInput_GetFrame() {
+  if (__atomic_load_n(&g_middle, __ATOMIC_ACQUIRE) & FRESH_FRAME) {
+    g_read_index = SwapMiddle(g_read_index) & INDEX_MASK;
+  }
+  return &g_frames[g_read_index];
+}
+
+uint32_t DMXInput_LatestSequence() {
+  return g_latest_sequence;
+}
@@ -0,0 +1,142 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * dmx_input.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup dmx_input DMX Input
+ * @brief The most recent complete DMX512 frame received.
+ *
+ * The transceiver's receive buffer is reused for the next frame, so it can't
+ * be read once the frame has ended. The DMX input store holds a stable copy of
+ * the latest complete frame.
+ *
+ * There are three frame buffers. The producer (the responder) fills the write
+ * buffer as slots arrive. When the frame ends, the write buffer is published
+ * by atomically swapping it with the middle buffer. When a consumer asks for
+ * the latest frame, the read buffer is swapped with the middle buffer if a
+ * new frame was published since the last call.
+ *
+ * Neither side ever waits for the other, and the read buffer is never written
+ * to while it's held, so consumers get a complete, consistent frame without
+ * copying. Frames published faster than they are read are dropped, the
+ * consumer always sees the newest one.
+ *
+ * Each published frame has a sequence number. Consumers can store the
+ * sequence number of the last frame they processed and skip work if it
+ * hasn't changed.
+ *
+ * All consumers must run from the same context (the main loop), since
+ * acquiring the latest frame replaces the read buffer.
+ *
+ * @addtogroup dmx_input
+ * @{
+ * @file dmx_input.h
+ * @brief The most recent complete DMX512 frame received.
+ */
+
+#ifndef FIRMWARE_SRC_DMX_INPUT_H_
+#define FIRMWARE_SRC_DMX_INPUT_H_
+
+#include <stdint.h>
+
+#include "dmx_spec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A DMX512 frame.
+ */
+typedef struct {
+  /**
+   * @brief The sequence number of the frame.
+   *
+   * Frames are numbered from 1, a sequence number of 0 means no frame has
+   * been received.
+   */
+  uint32_t sequence;
+
+  /**
+   * @brief The slot data, starting at slot 1.
+   *
+   * This follows the sequence number so it's word aligned.
+   */
+  uint8_t slots[DMX_FRAME_SIZE];
+  uint16_t slot_count;  //!< The number of slots in the frame.
+} DMXInputFrame;
+
+/**
+ * @brief Initialize the DMX input store.
+ *
+ * This discards any frames that have been received.
+ */
+void DMXInput_Initialize();
+
+/**
+ * @brief Start a new frame.
+ *
+ * Any slots added since the last call to DMXInput_EndFrame() are discarded.
+ */
+void DMXInput_BeginFrame();
+
+/**
+ * @brief Append slots to the current frame.
+ * @param data The slot data.
+ * @param length The number of slots.
+ *
+ * Slots beyond DMX_FRAME_SIZE are ignored. This does nothing if there is no
+ * frame in progress.
+ */
+void DMXInput_AppendSlots(const uint8_t *data, unsigned int length);
+
+/**
+ * @brief End the current frame and publish it.
+ *
+ * This does nothing if there is no frame in progress, so it's safe to call
+ * more than once per frame.
+ */
+void DMXInput_EndFrame();
+
+/**
+ * @brief Get the latest complete frame.
+ * @returns The latest frame. This is never NULL, if no frame has been
+ *   received the frame will have a sequence number of 0 and no slots.
+ *
+ * The frame remains valid until the next call to DMXInput_GetFrame() or
+ * DMXInput_Initialize().
+ */
+const DMXInputFrame *DMXInput_GetFrame();
+
+/**
+ * @brief Get the sequence number of the latest published frame.
+ * @returns The sequence number, or 0 if no frame has been received.
+ *
+ * This can be used to check for a new frame without acquiring it.
+ */
+uint32_t DMXInput_LatestSequence();
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_DMX_INPUT_H_
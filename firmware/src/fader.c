@@ -0,0 +1,95 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ *
+ * fader.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "fader.h"
+
+/*
+ * @brief 1.0 in 16.16 fixed point.
+ */
+static const uint32_t FADER_ONE = 1u << 16;
+
+/*
+ * @brief Return the progress of a fade, in 16.16 fixed point.
+ * @param elapsed The time since the fade started.
+ * @param duration The length of the fade.
+ * @returns The progress, from 0 to FADER_ONE.
+ */
+static inline uint32_t Progress(uint32_t elapsed, uint32_t duration) {
+  if (elapsed >= duration) {
+    return FADER_ONE;
+  }
+  return (((uint64_t) elapsed) << 16) / duration;
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void Fader_Initialize(Fader *fader, FaderChannel *channels, uint8_t *levels,
+                      unsigned int channel_count) {
+  fader->channels = channels;
+  fader->levels = levels;
+  fader->channel_count = channel_count;
+  fader->up_time = 0u;
+  fader->down_time = 0u;
+  fader->active = false;
+}
+
+void Fader_Start(Fader *fader, const uint8_t *targets, uint32_t up_time,
+                 uint32_t down_time) {
+  unsigned int i = 0u;
+  for (; i < fader->channel_count; i++) {
+    fader->channels[i].start = fader->levels[i];
+    fader->channels[i].target = targets[i];
+  }
+  fader->up_time = up_time;
+  fader->down_time = down_time;
+  fader->active = true;
+}
+
+bool Fader_Update(Fader *fader, uint32_t elapsed) {
+  if (!fader->active) {
+    return false;
+  }
+
+  const uint32_t up = Progress(elapsed, fader->up_time);
+  const uint32_t down = Progress(elapsed, fader->down_time);
+  const FaderChannel *channel = fader->channels;
+  uint8_t *level = fader->levels;
+  unsigned int i = 0u;
+  for (; i < fader->channel_count; i++, channel++, level++) {
+    if (channel->target >= channel->start) {
+      *level = channel->start +
+          (((uint32_t) (channel->target - channel->start) * up + 0x8000u) >>
+           16);
+    } else {
+      *level = channel->start -
+          (((uint32_t) (channel->start - channel->target) * down + 0x8000u) >>
+           16);
+    }
+  }
+
+  if (up == FADER_ONE && down == FADER_ONE) {
+    fader->active = false;
+  }
+  return fader->active;
+}
+
+void Fader_Stop(Fader *fader) {
+  fader->active = false;
+}
@@ -0,0 +1,127 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ *
+ * fader.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup fader Fader
+ * @brief Crossfade a set of channels between two sets of levels.
+ *
+ * Each channel fades from the level it was at when the fade started to its
+ * target. Channels that are increasing use the up time, channels that are
+ * decreasing use the down time.
+ *
+ * Progress is tracked as a 16.16 fixed point fraction of each fade time,
+ * which is calculated once per update. Updating a channel is then a single
+ * multiply and shift, so a fader can be updated at the output refresh rate
+ * for hundreds of channels.
+ *
+ * The levels are derived from the elapsed time, rather than accumulated per
+ * update, so irregular updates don't cause any drift.
+ *
+ * The storage for the channels is provided by the caller.
+ *
+ * @addtogroup fader
+ * @{
+ * @file fader.h
+ * @brief Crossfade a set of channels between two sets of levels.
+ */
+
+#ifndef FIRMWARE_SRC_FADER_H_
+#define FIRMWARE_SRC_FADER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The start and target levels for a channel.
+ */
+typedef struct {
+  uint8_t start;  //!< The level when the fade started.
+  uint8_t target;  //!< The level at the end of the fade.
+} FaderChannel;
+
+/**
+ * @brief A fader.
+ */
+typedef struct {
+  FaderChannel *channels;  //!< The storage for the channels.
+  uint8_t *levels;  //!< The current levels.
+  unsigned int channel_count;  //!< The number of channels.
+  uint32_t up_time;  //!< The time to fade up over.
+  uint32_t down_time;  //!< The time to fade down over.
+  bool active;  //!< true if a fade is in progress.
+} Fader;
+
+/**
+ * @brief Initialize a fader.
+ * @param fader The fader to initialize.
+ * @param channels The storage for the channels, must have room for
+ *   channel_count entries.
+ * @param levels The current levels, must have room for channel_count entries.
+ *   This is updated by Fader_Update().
+ * @param channel_count The number of channels.
+ *
+ * The levels are left as is.
+ */
+void Fader_Initialize(Fader *fader, FaderChannel *channels, uint8_t *levels,
+                      unsigned int channel_count);
+
+/**
+ * @brief Start a fade from the current levels.
+ * @param fader The fader.
+ * @param targets The target level for each channel.
+ * @param up_time The time to take for channels that are increasing.
+ * @param down_time The time to take for channels that are decreasing.
+ *
+ * The time units are up to the caller, but must match the elapsed time passed
+ * to Fader_Update(). If a fade was already in progress, the new fade starts
+ * from wherever the previous one got to.
+ */
+void Fader_Start(Fader *fader, const uint8_t *targets, uint32_t up_time,
+                 uint32_t down_time);
+
+/**
+ * @brief Update the levels.
+ * @param fader The fader.
+ * @param elapsed The time since Fader_Start() was called.
+ * @returns true if the fade is still in progress, false if it has completed.
+ */
+bool Fader_Update(Fader *fader, uint32_t elapsed);
+
+/**
+ * @brief Stop the fade.
+ * @param fader The fader.
+ *
+ * The levels are left at wherever the fade got to.
+ */
+void Fader_Stop(Fader *fader);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_FADER_H_
@@ -0,0 +1,63 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * gamma_tables.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @addtogroup spi_dmx
+ * @{
+ * @file gamma_tables.h
+ * @brief Precomputed gamma curves.
+ *
+ * Each table maps an 8 bit input to a 16 bit output, i.e.
+ * 65535 * (input / 255) ^ gamma. The tables are generated by
+ * scripts/generate_gamma_tables.py.
+ */
+
+#ifndef FIRMWARE_SRC_GAMMA_TABLES_H_
+#define FIRMWARE_SRC_GAMMA_TABLES_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The number of entries in each gamma table.
+ */
+enum { GAMMA_TABLE_SIZE = 256 };
+
+/**
+ * @brief A gamma of 2.2.
+ */
+extern const uint16_t GAMMA_2_2[GAMMA_TABLE_SIZE];
+
+/**
+ * @brief A gamma of 2.8.
+ */
+extern const uint16_t GAMMA_2_8[GAMMA_TABLE_SIZE];
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_GAMMA_TABLES_H_
@@ -25,6 +25,7 @@
 #include "rdm_frame.h"
 #include "rdm_responder.h"
 #include "rdm_util.h"
+#include "spi_rgb.h"
 #include "utils.h"
 
 // Various constants
@@ -33,18 +34,19 @@ enum {SOFTWARE_VERSION = 0x00000000 };
 static const char DEVICE_MODEL_DESCRIPTION[] = "Ja Rule LED Driver";
 static const char SOFTWARE_LABEL[] = "Alpha";
 static const char DEFAULT_DEVICE_LABEL[] = "Ja Rule";
-enum { MAX_PIXEL_COUNT = 170u };
+enum { MAX_PIXEL_COUNT = SPIRGB_MAX_PIXEL_COUNT };
 enum { DEFAULT_PIXEL_COUNT = 2u };
+enum { SLOTS_PER_PIXEL = 3u };
 
 static const ResponderDefinition RESPONDER_DEFINITION;
 
 typedef enum {
   PIXEL_TYPE_LPD8806 = 0x0001,
-  /*
   PIXEL_TYPE_WS2801 = 0x0002,
+  /*
   PIXEL_TYPE_P9813 = 0x0003,
-  PIXEL_TYPE_APA102 = 0x0004,
   */
+  PIXEL_TYPE_APA102 = 0x0004,
 } PixelType;
 
 typedef struct {
@@ -57,6 +59,8 @@ typedef struct {
    * case we could have up to 512 of them.
    */
   uint16_t pixel_count;
+  uint16_t pixels_set;  //!< The number of pixels set from the current frame.
+  bool in_update;  //!< True if a SPIRGB update is in progress.
 } LEDModel;
 
 
@@ -70,7 +74,7 @@ static const ParameterDescription PIXEL_TYPE_DESCRIPTION = {
   .unit = UNITS_NONE,
   .prefix = PREFIX_NONE,
   .min_valid_value = PIXEL_TYPE_LPD8806,
-  .max_valid_value = PIXEL_TYPE_LPD8806,
+  .max_valid_value = PIXEL_TYPE_APA102,
   .default_value = PIXEL_TYPE_LPD8806,
   .description = PIXEL_TYPE_STRING,
 };
@@ -89,6 +93,72 @@ static const ParameterDescription PIXEL_COUNT_DESCRIPTION = {
 
 static LEDModel g_model;
 
+/*
+ * @brief Map a PixelType to the SPIRGB type.
+ * @returns false if the pixel type isn't supported.
+ */
+static bool SPIPixelType(uint16_t type, SPIRGB_PixelType *spi_type) {
+  switch (type) {
+    case PIXEL_TYPE_LPD8806:
+      *spi_type = SPIRGB_PIXEL_LPD8806;
+      return true;
+    case PIXEL_TYPE_WS2801:
+      *spi_type = SPIRGB_PIXEL_WS2801;
+      return true;
+    case PIXEL_TYPE_APA102:
+      *spi_type = SPIRGB_PIXEL_APA102;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void CompleteUpdate() {
+  if (g_model.in_update) {
+    SPIRGB_CompleteUpdate();
+    g_model.in_update = false;
+  }
+}
+
+/*
+ * @brief Handle the start of a DMX frame.
+ *
+ * A frame that was shorter than the footprint is sent now.
+ */
+static void StartDMXFrame() {
+  CompleteUpdate();
+  g_model.pixels_set = 0u;
+}
+
+/*
+ * @brief Copy DMX slots into the pixel framebuffer.
+ *
+ * Slots are copied a whole pixel at a time, as they arrive. Once the last
+ * pixel in the footprint has been received, the frame is sent.
+ */
+static void ApplyDMXData(const uint8_t *slots, unsigned int slot_count) {
+  uint16_t pixels = g_model.pixel_count;
+  if (slot_count / SLOTS_PER_PIXEL < pixels) {
+    pixels = slot_count / SLOTS_PER_PIXEL;
+  }
+  if (pixels <= g_model.pixels_set) {
+    return;
+  }
+
+  if (!g_model.in_update) {
+    SPIRGB_BeginUpdate();
+    g_model.in_update = true;
+  }
+  SPIRGB_SetPixels(g_model.pixels_set,
+                   slots + g_model.pixels_set * SLOTS_PER_PIXEL,
+                   pixels - g_model.pixels_set);
+  g_model.pixels_set = pixels;
+
+  if (g_model.pixels_set == g_model.pixel_count) {
+    CompleteUpdate();
+  }
+}
+
 // PID Handlers
 // ----------------------------------------------------------------------------
 int LEDModel_GetParameterDescription(const RDMHeader *header,
@@ -123,10 +193,12 @@ int LEDModel_SetPixelType(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
   }
   const uint16_t type = ExtractUInt16(param_data);
-  if (type != PIXEL_TYPE_LPD8806) {
+  SPIRGB_PixelType spi_type;
+  if (!SPIPixelType(type, &spi_type)) {
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
   g_model.pixel_type = type;
+  SPIRGB_SetPixelType(spi_type);
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -142,10 +214,11 @@ int LEDModel_SetPixelCount(const RDMHeader *header,
   }
 
   const uint16_t count = ExtractUInt16(param_data);
-  if (count > MAX_PIXEL_COUNT) {
+  if (count == 0u || count > MAX_PIXEL_COUNT) {
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
   g_model.pixel_count = count;
+  SPIRGB_SetPixelCount(count);
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -158,9 +231,37 @@ static void LEDModel_Activate() {
   RDMResponder_InitResponder();
   g_model.pixel_type = PIXEL_TYPE_LPD8806;
   g_model.pixel_count = DEFAULT_PIXEL_COUNT;
+  g_model.pixels_set = 0u;
+  g_model.in_update = false;
+  SPIRGB_SetPixelType(SPIRGB_PIXEL_LPD8806);
+  SPIRGB_SetPixelCount(DEFAULT_PIXEL_COUNT);
+}
+
+static void LEDModel_Deactivate() {
+  CompleteUpdate();
 }
 
-static void LEDModel_Deactivate() {}
+static int LEDModel_Ioctl(ModelIoctl command, uint8_t *data,
+                          unsigned int length) {
+  switch (command) {
+    case IOCTL_DMX_FRAME_START:
+      StartDMXFrame();
+      return 1;
+    case IOCTL_DMX_DATA:
+      ApplyDMXData(data, length);
+      return 1;
+    case IOCTL_GET_DMX_WINDOW:
+      if (length != sizeof(DMXWindow)) {
+        return 0;
+      }
+      // The pixels always start at slot 1.
+      ((DMXWindow*) data)->start_slot = 0u;
+      ((DMXWindow*) data)->footprint = g_model.pixel_count * SLOTS_PER_PIXEL;
+      return 1;
+    default:
+      return RDMResponder_Ioctl(command, data, length);
+  }
+}
 
 static int LEDModel_HandleRequest(const RDMHeader *header,
                                   const uint8_t *param_data) {
@@ -193,7 +294,7 @@ const ModelEntry LED_MODEL_ENTRY = {
   .model_id = LED_MODEL_ID,
   .activate_fn = LEDModel_Activate,
   .deactivate_fn = LEDModel_Deactivate,
-  .ioctl_fn = RDMResponder_Ioctl,
+  .ioctl_fn = LEDModel_Ioctl,
   .request_fn = LEDModel_HandleRequest,
   .tasks_fn = LEDModel_Tasks
 };
@@ -20,16 +20,20 @@
 #include "message_handler.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "system_definitions.h"
 
 #include "app.h"
 #include "app_pipeline.h"
 #include "constants.h"
+#include "dmx_forwarder.h"
 #include "flags.h"
 #include "peripheral/eth/plib_eth.h"
 #include "rdm_frame.h"
 #include "rdm_handler.h"
+#include "stack_monitor.h"
+#include "stats.h"
 #include "syslog.h"
 #include "transceiver.h"
 
@@ -111,6 +115,57 @@ static void RunSelfTest(uint8_t token, unsigned int length) {
   }
 }
 
+static void GetStats(uint8_t token,
+                     const uint8_t* payload,
+                     unsigned int length) {
+  if (length > 1u || (length == 1u && payload[0] & ~STATS_FLAG_RESET)) {
+    SendMessage(token, COMMAND_GET_STATS, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+
+  const bool reset = length == 1u && payload[0] & STATS_FLAG_RESET;
+  // Each counter is a 32-bit value, followed by the length of the name & the
+  // name.
+  uint8_t response[
+      1u + STATS_MAX_COUNTERS * (sizeof(uint32_t) + 1u + STATS_MAX_NAME_LENGTH)];
+  uint8_t *ptr = response;
+  const unsigned int count = Stats_Count();
+  *ptr++ = count;
+  unsigned int i = 0u;
+  for (; i < count; i++) {
+    const uint32_t value = Stats_Read(i, reset);
+    memcpy(ptr, &value, sizeof(value));
+    ptr += sizeof(value);
+    const char *name = Stats_Name(i);
+    const uint8_t name_length = strlen(name);
+    *ptr++ = name_length;
+    memcpy(ptr, name, name_length);
+    ptr += name_length;
+  }
+
+  IOVec iovec;
+  iovec.base = response;
+  iovec.length = ptr - response;
+  SendMessage(token, COMMAND_GET_STATS, RC_OK, &iovec, 1u);
+}
+
+static void GetMemoryInfo(uint8_t token, unsigned int length) {
+  if (length) {
+    SendMessage(token, COMMAND_GET_MEMORY_INFO, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+
+  uint32_t info[] = {
+    StackMonitor_StackSize(),
+    StackMonitor_PeakUsage(),
+    StackMonitor_FreeBytes()
+  };
+  IOVec iovec;
+  iovec.base = (uint8_t*) info;
+  iovec.length = sizeof(info);
+  SendMessage(token, COMMAND_GET_MEMORY_INFO, RC_OK, &iovec, 1u);
+}
+
 static void SetBreakTime(uint8_t token,
                          const uint8_t* payload,
                          unsigned int length) {
@@ -314,6 +369,20 @@ static void ReturnRDMResponderJitter(uint8_t token, unsigned int length) {
   SendMessage(token, COMMAND_GET_RDM_RESPONDER_JITTER, RC_OK, &iovec, 1u);
 }
 
+static void SetDMXForwarding(uint8_t token,
+                             const uint8_t* payload,
+                             unsigned int length) {
+  if (length != 3u) {
+    SendMessage(token, COMMAND_SET_DMX_FORWARDING, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+
+  uint16_t interval = JoinUInt16(payload[2], payload[1]);
+  bool ok = DMXForwarder_Configure(token, payload[0], interval);
+  SendMessage(token, COMMAND_SET_DMX_FORWARDING, ok ? RC_OK : RC_BAD_PARAM,
+              NULL, 0u);
+}
+
 static bool CheckForTXMode(const Message *message) {
   if (Transceiver_GetMode() == T_MODE_CONTROLLER) {
     return true;
@@ -342,6 +411,9 @@ void MessageHandler_HandleMessage(const Message *message) {
         SendMessage(message->token, message->command, RC_BUFFER_FULL, NULL, 0u);
       }
       break;
+    case COMMAND_SET_DMX_FORWARDING:
+      SetDMXForwarding(message->token, message->payload, message->length);
+      break;
     case GET_FLAGS:
       Flags_SendResponse(message->token);
       break;
@@ -355,6 +427,12 @@ void MessageHandler_HandleMessage(const Message *message) {
     case COMMAND_GET_HARDWARE_INFO:
       GetHardwareInfo(message->token, message->length);
       break;
+    case COMMAND_GET_STATS:
+      GetStats(message->token, message->payload, message->length);
+      break;
+    case COMMAND_GET_MEMORY_INFO:
+      GetMemoryInfo(message->token, message->length);
+      break;
     case COMMAND_RUN_SELF_TEST:
       RunSelfTest(message->token, message->length);
       break;
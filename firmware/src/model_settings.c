@@ -0,0 +1,134 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * model_settings.c
+ * Copyright (C) 2015 Simon Newton
+ */
+#include "model_settings.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "macros.h"
+#include "rdm_handler.h"
+#include "rdm_model.h"
+#include "settings_store.h"
+#include "timer_wheel.h"
+#include "utils.h"
+
+/*
+ * @brief The settings store key layout.
+ *
+ * Key 0 holds the active model, followed by MODEL_SETTINGS_MAX_BLOCKS keys for
+ * each model ID from LED_MODEL_ID to PROXY_CHILD_MODEL_ID.
+ */
+enum {
+  ACTIVE_MODEL_KEY = 0,
+  FIRST_BLOCK_KEY = 1,
+  MODEL_COUNT = PROXY_CHILD_MODEL_ID - LED_MODEL_ID + 1,
+};
+
+typedef struct {
+  TimerWheel_Timer save_timer;
+  uint16_t model_id;  //!< The model the settings were last loaded for.
+} ModelSettingsState;
+
+static ModelSettingsState g_model_settings;
+
+/*
+ * @brief Get the settings store key for a block.
+ * @param model_id The model.
+ * @param index The block index.
+ * @returns The key, or SETTINGS_STORE_MAX_KEYS if the model isn't persisted.
+ */
+static uint8_t BlockKey(uint16_t model_id, uint8_t index) {
+  if (model_id < LED_MODEL_ID || model_id >= LED_MODEL_ID + MODEL_COUNT ||
+      index >= MODEL_SETTINGS_MAX_BLOCKS) {
+    return SETTINGS_STORE_MAX_KEYS;
+  }
+  return FIRST_BLOCK_KEY +
+      (model_id - LED_MODEL_ID) * MODEL_SETTINGS_MAX_BLOCKS + index;
+}
+
+/*
+ * @brief Restore the settings blocks of the active model.
+ */
+static void LoadSettings() {
+  ModelSettingsBlock block;
+  uint8_t index = 0u;
+  for (; index < MODEL_SETTINGS_MAX_BLOCKS; index++) {
+    unsigned int length = MODEL_SETTINGS_BLOCK_SIZE;
+    if (SettingsStore_Get(BlockKey(g_model_settings.model_id, index),
+                          block.data, &length)) {
+      block.index = index;
+      block.length = length;
+      RDMHandler_SetSettings(&block);
+    }
+  }
+}
+
+/*
+ * @brief Save the settings blocks of the active model.
+ */
+static void SaveSettings() {
+  ModelSettingsBlock block;
+  uint8_t index = 0u;
+  for (; index < MODEL_SETTINGS_MAX_BLOCKS; index++) {
+    block.index = index;
+    block.length = 0u;
+    if (RDMHandler_GetSettings(&block) && block.length) {
+      SettingsStore_Set(BlockKey(g_model_settings.model_id, index),
+                        block.data, block.length);
+    }
+  }
+}
+
+/*
+ * @brief Periodically save the settings of the active model.
+ */
+static void SaveTimer(UNUSED void *data) {
+  TimerWheel_Schedule(&g_model_settings.save_timer,
+                      MODEL_SETTINGS_SAVE_INTERVAL, SaveTimer, NULL);
+  SaveSettings();
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void ModelSettings_Initialize() {
+  uint8_t data[sizeof(uint16_t)];
+  unsigned int length = sizeof(data);
+  if (SettingsStore_Get(ACTIVE_MODEL_KEY, data, &length) &&
+      length == sizeof(data)) {
+    RDMHandler_SetActiveModel(JoinShort(data[0], data[1]));
+  }
+
+  g_model_settings.model_id = RDMHandler_ActiveModel();
+  TimerWheel_Schedule(&g_model_settings.save_timer,
+                      MODEL_SETTINGS_SAVE_INTERVAL, SaveTimer, NULL);
+  LoadSettings();
+}
+
+void ModelSettings_Tasks() {
+  const uint16_t model_id = RDMHandler_ActiveModel();
+  if (model_id != g_model_settings.model_id) {
+    // Activating a model resets it to the factory defaults.
+    g_model_settings.model_id = model_id;
+    LoadSettings();
+
+    uint8_t data[sizeof(uint16_t)];
+    PushUInt16(data, model_id);
+    SettingsStore_Set(ACTIVE_MODEL_KEY, data, sizeof(data));
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * model_settings.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup model_settings Model Settings
+ * @brief Persist the RDM model settings in the settings store.
+ *
+ * The active model, and the settings blocks of each model (see
+ * IOCTL_GET_SETTINGS) are saved in the @ref settings_store. At startup the
+ * active model is restored, and when a model becomes active its settings are
+ * loaded.
+ *
+ * Rather than hooking each SET handler, a @ref timer_wheel callback fetches
+ * the blocks from the active model every MODEL_SETTINGS_SAVE_INTERVAL. The settings
+ * store only writes a block if it changed, so bursts of SETs are coalesced
+ * into a single write.
+ *
+ * @addtogroup model_settings
+ * @{
+ * @file model_settings.h
+ * @brief Persist the RDM model settings in the settings store.
+ */
+
+#ifndef FIRMWARE_SRC_MODEL_SETTINGS_H_
+#define FIRMWARE_SRC_MODEL_SETTINGS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The maximum number of settings blocks per model.
+ */
+enum { MODEL_SETTINGS_MAX_BLOCKS = 4 };
+
+/**
+ * @brief How often to check for changed settings, in 10ths of a millisecond.
+ */
+enum { MODEL_SETTINGS_SAVE_INTERVAL = 10000 };
+
+/**
+ * @brief Restore the active model and its settings.
+ *
+ * This must be called after SettingsStore_Initialize(),
+ * TimerWheel_Initialize() and after the models have been added to the
+ * RDMHandler.
+ */
+void ModelSettings_Initialize();
+
+/**
+ * @brief Perform the periodic tasks.
+ *
+ * This should be called in the main event loop. It loads the settings when
+ * the active model changes.
+ */
+void ModelSettings_Tasks();
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_MODEL_SETTINGS_H_
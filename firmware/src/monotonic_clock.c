@@ -0,0 +1,103 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * monotonic_clock.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "monotonic_clock.h"
+
+#include <xc.h>
+
+/*
+ * @brief A snapshot of the clock.
+ *
+ * The time at any point is base + (core timer - core_count), which is correct
+ * as long as the core timer hasn't wrapped since the snapshot was taken.
+ */
+typedef struct {
+  uint64_t base;
+  uint32_t core_count;
+} ClockSnapshot;
+
+/*
+ * @brief The clock state.
+ *
+ * The writer bumps the sequence number before updating each copy. While the
+ * sequence number is odd, copy 0 is being updated and readers use copy 1.
+ * While it's even, readers use copy 0. A reader retries if the sequence number
+ * changed while it was reading, which can only happen if it was preempted by
+ * the writer, so readers never spin waiting for the writer to finish.
+ */
+typedef struct {
+  uint32_t sequence;
+  ClockSnapshot snapshots[2];
+} MonotonicClockData;
+
+static MonotonicClockData g_clock;
+
+static void Write(uint64_t base, uint32_t core_count) {
+  __atomic_add_fetch(&g_clock.sequence, 1u, __ATOMIC_RELEASE);
+  g_clock.snapshots[0].base = base;
+  g_clock.snapshots[0].core_count = core_count;
+  __atomic_add_fetch(&g_clock.sequence, 1u, __ATOMIC_RELEASE);
+  g_clock.snapshots[1].base = base;
+  g_clock.snapshots[1].core_count = core_count;
+}
+
+static void Read(ClockSnapshot *snapshot) {
+  uint32_t sequence;
+  do {
+    sequence = __atomic_load_n(&g_clock.sequence, __ATOMIC_ACQUIRE);
+    *snapshot = g_clock.snapshots[sequence & 1u];
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  } while (sequence != __atomic_load_n(&g_clock.sequence, __ATOMIC_RELAXED));
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void MonotonicClock_Initialize() {
+  MonotonicClock_SetTime(0u);
+}
+
+void MonotonicClock_Update() {
+  const uint32_t now = _CP0_GET_COUNT();
+  const ClockSnapshot *current = &g_clock.snapshots[1];
+  // This works because of unsigned int math.
+  Write(current->base + (uint32_t) (now - current->core_count), now);
+}
+
+MonotonicClock_Value MonotonicClock_GetTime() {
+  ClockSnapshot snapshot;
+  Read(&snapshot);
+  // The core timer must be read after the snapshot, otherwise an update
+  // between the two could make the time go backwards.
+  const uint32_t now = _CP0_GET_COUNT();
+  return snapshot.base + (uint32_t) (now - snapshot.core_count);
+}
+
+uint64_t MonotonicClock_ElapsedTicks(MonotonicClock_Value start_time) {
+  return MonotonicClock_GetTime() - start_time;
+}
+
+bool MonotonicClock_HasElapsed(MonotonicClock_Value start_time,
+                               uint32_t interval) {
+  return MonotonicClock_ElapsedTicks(start_time) >=
+      MonotonicClock_MicroSecondsToTicks(interval);
+}
+
+void MonotonicClock_SetTime(MonotonicClock_Value ticks) {
+  Write(ticks, _CP0_GET_COUNT());
+}
@@ -0,0 +1,134 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * monotonic_clock.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup monotonic_clock Monotonic Clock
+ * @brief A high resolution, 64-bit monotonic clock.
+ *
+ * The clock is built on the 32-bit core timer, which runs at half the system
+ * clock rate (25ns per tick at 80MHz) and wraps roughly every 107 seconds.
+ * The wraps are accumulated into a 64-bit value by MonotonicClock_Update(),
+ * which must be called at least once per wrap period. Calling it from the
+ * coarse timer ISR is more than sufficient.
+ *
+ * Reading the clock doesn't disable interrupts. The 64-bit base is protected
+ * by a sequence counter, with two copies of the base so that a reader never
+ * has to wait for the writer. This means the clock can be read from any
+ * context, including ISRs that preempt MonotonicClock_Update().
+ *
+ * @addtogroup monotonic_clock
+ * @{
+ * @file monotonic_clock.h
+ * @brief A high resolution, 64-bit monotonic clock.
+ */
+
+#ifndef FIRMWARE_SRC_MONOTONIC_CLOCK_H_
+#define FIRMWARE_SRC_MONOTONIC_CLOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "system_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The number of clock ticks per microsecond.
+ */
+#define MONOTONIC_CLOCK_TICKS_PER_US (SYS_CLK_FREQ / 2000000u)
+
+/**
+ * @brief A time, in clock ticks.
+ */
+typedef uint64_t MonotonicClock_Value;
+
+/**
+ * @brief Initialize the clock.
+ *
+ * The clock starts from 0.
+ */
+void MonotonicClock_Initialize();
+
+/**
+ * @brief Accumulate the elapsed core timer ticks.
+ *
+ * This must only be called from a single context, usually the coarse timer
+ * ISR, and at least once every 2^32 core timer ticks.
+ */
+void MonotonicClock_Update();
+
+/**
+ * @brief Get the current time.
+ * @returns The number of ticks since MonotonicClock_Initialize() was called.
+ */
+MonotonicClock_Value MonotonicClock_GetTime();
+
+/**
+ * @brief Return the number of ticks since the start_time.
+ * @param start_time The time to measure from.
+ * @returns The elapsed time, in ticks.
+ */
+uint64_t MonotonicClock_ElapsedTicks(MonotonicClock_Value start_time);
+
+/**
+ * @brief Check if a time interval has passed.
+ * @param start_time The time to measure from.
+ * @param interval The time interval in microseconds.
+ * @returns true if the interval has elapsed since the start_time.
+ */
+bool MonotonicClock_HasElapsed(MonotonicClock_Value start_time,
+                               uint32_t interval);
+
+/**
+ * @brief Convert ticks to microseconds.
+ * @param ticks The number of ticks.
+ * @returns The number of whole microseconds.
+ */
+static inline uint64_t MonotonicClock_TicksToMicroSeconds(uint64_t ticks) {
+  return ticks / MONOTONIC_CLOCK_TICKS_PER_US;
+}
+
+/**
+ * @brief Convert microseconds to ticks.
+ * @param micro_seconds The number of microseconds.
+ * @returns The number of ticks.
+ */
+static inline uint64_t MonotonicClock_MicroSecondsToTicks(
+    uint64_t micro_seconds) {
+  return micro_seconds * MONOTONIC_CLOCK_TICKS_PER_US;
+}
+
+/**
+ * @brief Set the clock.
+ * @param ticks The new time.
+ * @note This function should be used for testing only.
+ */
+void MonotonicClock_SetTime(MonotonicClock_Value ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_MONOTONIC_CLOCK_H_
@@ -20,13 +20,13 @@
 
 #include <stdlib.h>
 
-#include "coarse_timer.h"
 #include "constants.h"
 #include "macros.h"
 #include "rdm_buffer.h"
 #include "rdm_frame.h"
 #include "rdm_responder.h"
 #include "rdm_util.h"
+#include "timer_wheel.h"
 #include "utils.h"
 
 // Various constants
@@ -55,8 +55,8 @@ typedef struct {
   uint32_t lamp_hours;
   uint32_t lamp_strikes;
   uint32_t device_power_cycles;
-  CoarseTimer_Value lamp_strike_time;
-  CoarseTimer_Value clock_timer;
+  TimerWheel_Timer lamp_strike_timer;
+  TimerWheel_Timer clock_timer;
   uint8_t lamp_state;
   uint8_t lamp_on_mode;
   uint8_t display_level;
@@ -132,6 +132,46 @@ uint8_t DaysInMonth(uint16_t year, uint8_t month) {
   }
 }
 
+/*
+ * @brief Called once the lamp strike delay has passed.
+ */
+static void LampStruck(UNUSED void *data) {
+  if (g_moving_light.lamp_state == LAMP_STRIKE) {
+    g_moving_light.lamp_state = LAMP_ON;
+    g_moving_light.lamp_strikes++;
+  }
+}
+
+/*
+ * @brief Called every second while the model is active.
+ */
+static void ClockTick(UNUSED void *data) {
+  TimerWheel_Schedule(&g_moving_light.clock_timer, ONE_SECOND, ClockTick,
+                      NULL);
+  g_moving_light.second++;
+  if (g_moving_light.second >= 60u) {
+    g_moving_light.second = 0u;
+    g_moving_light.minute++;
+  }
+  if (g_moving_light.minute >= 60u) {
+    g_moving_light.minute = 0u;
+    g_moving_light.hour++;
+  }
+  if (g_moving_light.hour >= 24u) {
+    g_moving_light.hour = 0u;
+    g_moving_light.day++;
+  }
+  if (g_moving_light.day >
+      DaysInMonth(g_moving_light.year, g_moving_light.month)) {
+    g_moving_light.day = 1u;
+    g_moving_light.month++;
+  }
+  if (g_moving_light.month > 12u) {
+    g_moving_light.month = 1u;
+    g_moving_light.year++;
+  }
+}
+
 // PID Handlers
 // ----------------------------------------------------------------------------
 int MovingLightModel_GetLanguageCapabilities(const RDMHeader *header,
@@ -321,7 +361,8 @@ int MovingLightModel_SetLampState(const RDMHeader *header,
   }
   g_moving_light.lamp_state = param_data[0];
   if (g_moving_light.lamp_state == LAMP_STRIKE) {
-    g_moving_light.lamp_strike_time = CoarseTimer_GetTime();
+    TimerWheel_Schedule(&g_moving_light.lamp_strike_timer, LAMP_STRIKE_DELAY,
+                        LampStruck, NULL);
   }
   return RDMResponder_BuildSetAck(header);
 }
@@ -459,10 +500,18 @@ void MovingLightModel_Initialize() {
 static void MovingLightModel_Activate() {
   g_responder->def = &RESPONDER_DEFINITION;
   RDMResponder_InitResponder();
-  g_moving_light.clock_timer = CoarseTimer_GetTime();
+  TimerWheel_Schedule(&g_moving_light.clock_timer, ONE_SECOND, ClockTick,
+                      NULL);
+  if (g_moving_light.lamp_state == LAMP_STRIKE) {
+    // Restart a strike that was interrupted by a model change.
+    TimerWheel_Schedule(&g_moving_light.lamp_strike_timer, LAMP_STRIKE_DELAY,
+                        LampStruck, NULL);
+  }
 }
 
 static void MovingLightModel_Deactivate() {
+  TimerWheel_Cancel(&g_moving_light.clock_timer);
+  TimerWheel_Cancel(&g_moving_light.lamp_strike_timer);
 }
 
 static int MovingLightModel_HandleRequest(const RDMHeader *header,
@@ -490,40 +539,7 @@ static int MovingLightModel_HandleRequest(const RDMHeader *header,
   return RDMResponder_DispatchPID(header, param_data);
 }
 
-static void MovingLightModel_Tasks() {
-  if (g_moving_light.lamp_state == LAMP_STRIKE &&
-      CoarseTimer_HasElapsed(g_moving_light.lamp_strike_time,
-                             LAMP_STRIKE_DELAY)) {
-    g_moving_light.lamp_state = LAMP_ON;
-    g_moving_light.lamp_strikes++;
-  }
-
-  if (CoarseTimer_HasElapsed(g_moving_light.clock_timer, ONE_SECOND)) {
-    g_moving_light.clock_timer = CoarseTimer_GetTime();
-    g_moving_light.second++;
-    if (g_moving_light.second >= 60u) {
-      g_moving_light.second = 0u;
-      g_moving_light.minute++;
-    }
-    if (g_moving_light.minute >= 60u) {
-      g_moving_light.minute = 0u;
-      g_moving_light.hour++;
-    }
-    if (g_moving_light.hour >= 24u) {
-      g_moving_light.hour = 0u;
-      g_moving_light.day++;
-    }
-    if (g_moving_light.day >
-        DaysInMonth(g_moving_light.year, g_moving_light.month)) {
-      g_moving_light.day = 1u;
-      g_moving_light.month++;
-    }
-    if (g_moving_light.month > 12u) {
-      g_moving_light.month = 1u;
-      g_moving_light.year++;
-    }
-  }
-}
+static void MovingLightModel_Tasks() {}
 
 const ModelEntry MOVING_LIGHT_MODEL_ENTRY = {
   .model_id = MOVING_LIGHT_MODEL_ID,
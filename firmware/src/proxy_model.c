@@ -26,12 +26,30 @@
 #include "rdm_buffer.h"
 #include "rdm_responder.h"
 #include "rdm_util.h"
+#include "stats.h"
 #include "utils.h"
 
 // Various constants
+#ifdef PROXY_MODEL_CHILD_COUNT
+enum { NUMBER_OF_CHILDREN = PROXY_MODEL_CHILD_COUNT };
+#else
 enum { NUMBER_OF_CHILDREN = 2 };
-// Must be at least 2.
-enum { PROXY_BUFFERS_PER_CHILD = 2 };
+#endif
+
+// The size of the shared buffer pool. Must be at least NUMBER_OF_CHILDREN
+// to guarantee each child can always queue a message.
+#ifdef PROXY_MODEL_BUFFER_POOL_SIZE
+enum { BUFFER_POOL_SIZE = PROXY_MODEL_BUFFER_POOL_SIZE };
+#else
+enum { BUFFER_POOL_SIZE = NUMBER_OF_CHILDREN + 2 };
+#endif
+
+// PROXIED_DEVICES is returned in a single frame, we don't support
+// ACK_OVERFLOW.
+_Static_assert(NUMBER_OF_CHILDREN * UID_LENGTH <= MAX_PARAM_DATA_SIZE,
+               "Too many children for a single PROXIED_DEVICES response");
+_Static_assert((int) BUFFER_POOL_SIZE >= (int) NUMBER_OF_CHILDREN,
+               "The buffer pool must hold at least one message per child");
 enum { SOFTWARE_VERSION = 0x00000000 };
 static const uint16_t ACK_TIMER_DELAY = 1u;
 static const char DEFAULT_CHILD_DEVICE_LABEL[] = "Ja Rule Child Device";
@@ -55,8 +73,15 @@ static const char SOFTWARE_LABEL[] = "Alpha";
  * queued message for device A, shouldn't change the last queued message for
  * device B.
  *
- * So as a result we allocate PROXY_BUFFERS_PER_CHILD * NUMBER_OF_CHILDREN
- * buffers, where PROXY_BUFFERS_PER_CHILD >= 2.
+ * Most of the time the majority of children won't have a message queued, so
+ * rather than allocating two buffers per child, the buffers come from a
+ * shared pool of BUFFER_POOL_SIZE. Each child holds at most two buffers, the
+ * next & last messages.
+ *
+ * Allocation is fair: if the pool is empty, the last message of the child
+ * that was least recently serviced is reclaimed. Queued (next) messages are
+ * never reclaimed, so as long as BUFFER_POOL_SIZE >= NUMBER_OF_CHILDREN a
+ * child can always queue a message.
  */
 
 /*
@@ -69,14 +94,25 @@ typedef struct {
 typedef struct {
   RDMResponder responder;
 
-  ProxyBuffer buffers[PROXY_BUFFERS_PER_CHILD];  // The buffers for this child
   ProxyBuffer *last;  // Pointer to the last message for the child.
   ProxyBuffer *next;  // Pointer to the next message for the child.
-  ProxyBuffer *free_list[PROXY_BUFFERS_PER_CHILD];  // Free list
-  unsigned int free_size_count;  // Number of items on the free list.
+  unsigned int last_sequence;  // When the last message was delivered.
 } ChildDevice;
 
+/*
+ * @brief The shared pool of buffers.
+ */
+typedef struct {
+  ProxyBuffer buffers[BUFFER_POOL_SIZE];
+  ProxyBuffer *free_list[BUFFER_POOL_SIZE];  // Free list
+  unsigned int free_size_count;  // Number of items on the free list.
+  unsigned int sequence;  // Incremented each time a message is delivered.
+  StatsCounter exhausted_count;  // The number of times the pool was empty.
+  StatsCounter nack_count;  // The number of requests NACKed due to no buffers.
+} BufferPool;
+
 static ChildDevice g_children[NUMBER_OF_CHILDREN];
+static BufferPool g_pool;
 
 static const ResponderDefinition ROOT_RESPONDER_DEFINITION;
 static const ResponderDefinition CHILD_DEVICE_RESPONDER_DEFINITION;
@@ -85,16 +121,88 @@ static const ResponderDefinition CHILD_DEVICE_RESPONDER_DEFINITION;
 // ----------------------------------------------------------------------------
 void ResetProxyBuffers() {
   unsigned int i = 0u;
-  for (; i < NUMBER_OF_CHILDREN; i++) {
+  for (; i < BUFFER_POOL_SIZE; i++) {
+    g_pool.free_list[i] = &g_pool.buffers[i];
+  }
+  g_pool.free_size_count = BUFFER_POOL_SIZE;
+  g_pool.sequence = 0u;
+  g_pool.exhausted_count = 0u;
+  g_pool.nack_count = 0u;
+
+  for (i = 0u; i < NUMBER_OF_CHILDREN; i++) {
     ChildDevice *device = &g_children[i];
-    unsigned int j = 0u;
-    for (; j != PROXY_BUFFERS_PER_CHILD; j++) {
-      device->free_list[j] = &device->buffers[j];
-    }
     device->next = NULL;
     device->last = NULL;
-    device->free_size_count = NUMBER_OF_CHILDREN;
+    device->last_sequence = 0u;
+  }
+}
+
+static inline void FreeBuffer(ProxyBuffer *buffer) {
+  g_pool.free_list[g_pool.free_size_count] = buffer;
+  g_pool.free_size_count++;
+}
+
+/*
+ * @brief Reclaim the last message from the least recently serviced child.
+ * @returns The reclaimed buffer, or NULL if no child has a last message.
+ */
+static ProxyBuffer *ReclaimLastBuffer() {
+  ChildDevice *oldest = NULL;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_CHILDREN; i++) {
+    ChildDevice *device = &g_children[i];
+    if (device->last &&
+        (oldest == NULL ||
+         g_pool.sequence - device->last_sequence >
+         g_pool.sequence - oldest->last_sequence)) {
+      oldest = device;
+    }
   }
+
+  if (oldest == NULL) {
+    return NULL;
+  }
+  ProxyBuffer *buffer = oldest->last;
+  oldest->last = NULL;
+  return buffer;
+}
+
+/*
+ * @brief Check if a buffer can be allocated, without reclaiming one.
+ */
+static bool CanAllocateBuffer() {
+  if (g_pool.free_size_count) {
+    return true;
+  }
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_CHILDREN; i++) {
+    if (g_children[i].last) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * @brief Allocate a buffer from the pool.
+ * @returns A buffer, or NULL if the pool is exhausted.
+ */
+static ProxyBuffer *AllocateBuffer() {
+  if (g_pool.free_size_count) {
+    g_pool.free_size_count--;
+    return g_pool.free_list[g_pool.free_size_count];
+  }
+
+  Stats_Increment(&g_pool.exhausted_count);
+  return ReclaimLastBuffer();
+}
+
+/*
+ * @brief NACK a request because there is no space to queue the response.
+ */
+static int BuildBufferFullNack(const RDMHeader *header) {
+  Stats_Increment(&g_pool.nack_count);
+  return RDMResponder_BuildNack(header, NR_PROXY_BUFFER_FULL);
 }
 
 static int HandleRequest(const RDMHeader *header, const uint8_t *param_data) {
@@ -127,10 +235,10 @@ static int MaybeRespondWithQueuedMessage(const RDMHeader *header,
   if (param_data[0] != STATUS_GET_LAST_MESSAGE && device->next) {
     // move next to last
     if (device->last) {
-      device->free_list[device->free_size_count] = device->last;
-      device->free_size_count++;
+      FreeBuffer(device->last);
     }
     device->last = device->next;
+    device->last_sequence = ++g_pool.sequence;
     device->responder.queued_message_count = 0u;
     device->next = NULL;
   } else if (param_data[0] == STATUS_GET_LAST_MESSAGE && device->last) {
@@ -170,7 +278,7 @@ static int HandleChildRequest(const RDMHeader *header,
   int response_size = RDM_RESPONDER_NO_RESPONSE;
   if (header->command_class == GET_COMMAND &&
       ntohs(header->param_id) == PID_QUEUED_MESSAGE &&
-      device->free_size_count != PROXY_BUFFERS_PER_CHILD &&
+      (device->next || device->last) &&
       RDMUtil_IsUnicast(header->dest_uid)) {
     response_size = MaybeRespondWithQueuedMessage(header, param_data,
                                                   child_index);
@@ -179,9 +287,11 @@ static int HandleChildRequest(const RDMHeader *header,
     }
   }
 
-  // If the request is unicast, and we're out of buffer space then NACK.
-  if (RDMUtil_IsUnicast(header->dest_uid) && device->next != NULL) {
-    return RDMResponder_BuildNack(header, NR_PROXY_BUFFER_FULL);
+  // If the request is unicast, check there will be space to queue the response
+  // before the child acts on the request. If not then NACK.
+  const bool is_unicast = RDMUtil_IsUnicast(header->dest_uid);
+  if (is_unicast && (device->next != NULL || !CanAllocateBuffer())) {
+    return BuildBufferFullNack(header);
   }
 
   // Let the child handle the request.
@@ -191,11 +301,12 @@ static int HandleChildRequest(const RDMHeader *header,
   if (response_size >= (int) sizeof(RDMHeader) + (int) RDM_CHECKSUM_LENGTH &&
       ((int) response_header->message_length + (int) RDM_CHECKSUM_LENGTH ==
        response_size)) {
-    if (device->next == NULL) {
+    // The buffer is only taken now, so an invalid response never costs another
+    // child its last message.
+    ProxyBuffer *buffer = is_unicast ? AllocateBuffer() : NULL;
+    if (buffer) {
       // Queue the response
-      device->next = device->free_list[device->free_size_count - 1];
-      device->free_size_count--;
-
+      device->next = buffer;
       memcpy(device->next->buffer, g_rdm_buffer, response_size);
       response_size = RDMResponder_BuildAckTimer(header, ACK_TIMER_DELAY);
       g_responder->queued_message_count = 1u;
@@ -247,11 +358,20 @@ int ProxyModelChild_GetQueuedMessage(const RDMHeader *header,
   return RDMUtil_AppendChecksum(g_rdm_buffer);
 }
 
+/*
+ * @brief Report the free buffer count to the stats module.
+ */
+static uint32_t FreeBufferStat(UNUSED bool reset) {
+  return g_pool.free_size_count;
+}
+
 // Public Functions
 // ----------------------------------------------------------------------------
 void ProxyModel_Initialize() {
   uint8_t parent_uid[UID_LENGTH];
   RDMResponder_GetUID(parent_uid);
+  const uint32_t parent_device_id = ExtractUInt32(
+      parent_uid + sizeof(uint16_t));
 
   // Initialize the child devices.
   unsigned int i = 0u;
@@ -260,15 +380,33 @@ void ProxyModel_Initialize() {
 
     RDMResponder_SwitchResponder(&device->responder);
     memcpy(g_responder->uid, parent_uid, UID_LENGTH);
-    g_responder->uid[UID_LENGTH - 1] += (i + 1u);
+    // Children take the following device ids, carrying across bytes.
+    PushUInt32(g_responder->uid + sizeof(uint16_t),
+               parent_device_id + i + 1u);
     g_responder->def = &CHILD_DEVICE_RESPONDER_DEFINITION;
     RDMResponder_InitResponder();
     g_responder->is_proxied_device = true;
   }
 
+  Stats_AddCounter("proxy.pool_exhausted", &g_pool.exhausted_count);
+  Stats_AddCounter("proxy.pool_nacks", &g_pool.nack_count);
+  Stats_AddValue("proxy.free_buffers", FreeBufferStat);
+
   RDMResponder_RestoreResponder();
 }
 
+uint32_t ProxyModel_BufferPoolExhaustedCount() {
+  return g_pool.exhausted_count;
+}
+
+uint32_t ProxyModel_BufferPoolNackCount() {
+  return g_pool.nack_count;
+}
+
+unsigned int ProxyModel_FreeBufferCount() {
+  return g_pool.free_size_count;
+}
+
 static void ProxyModel_Activate() {
   g_responder->def = &ROOT_RESPONDER_DEFINITION;
   RDMResponder_InitResponder();
@@ -278,6 +416,29 @@ static void ProxyModel_Activate() {
 
 static void ProxyModel_Deactivate() {}
 
+static int ProxyModel_Ioctl(ModelIoctl command, uint8_t *data,
+                            unsigned int length) {
+  if (command != IOCTL_REQUIRES_ACTION) {
+    return RDMResponder_Ioctl(command, data, length);
+  }
+
+  if (length != UID_LENGTH) {
+    return 0;
+  }
+
+  if (RDMUtil_RequiresAction(g_responder->uid, data)) {
+    return 1;
+  }
+
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_CHILDREN; i++) {
+    if (RDMUtil_RequiresAction(g_children[i].responder.uid, data)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
 static int ProxyModel_HandleRequest(const RDMHeader *header,
                                     const uint8_t *param_data) {
   int response_size = 0;
@@ -309,7 +470,7 @@ const ModelEntry PROXY_MODEL_ENTRY = {
   .model_id = PROXY_MODEL_ID,
   .activate_fn = ProxyModel_Activate,
   .deactivate_fn = ProxyModel_Deactivate,
-  .ioctl_fn = RDMResponder_Ioctl,
+  .ioctl_fn = ProxyModel_Ioctl,
   .request_fn = ProxyModel_HandleRequest,
   .tasks_fn = ProxyModel_Tasks
 };
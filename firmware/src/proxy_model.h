@@ -36,11 +36,18 @@
  *
  * The last message can be retrieved with GET QUEUED_MESSAGE
  * (STATUS_GET_LAST_MESSAGE).
+ *
+ * The message buffers are shared between all children. If the pool is
+ * exhausted the last message of the least recently serviced child is
+ * reclaimed, in which case a GET QUEUED_MESSAGE (STATUS_GET_LAST_MESSAGE) to
+ * that child will return an empty STATUS_MESSAGES response.
  */
 
 #ifndef FIRMWARE_SRC_PROXY_MODEL_H_
 #define FIRMWARE_SRC_PROXY_MODEL_H_
 
+#include <stdint.h>
+
 #include "rdm_model.h"
 
 #ifdef __cplusplus
@@ -57,6 +64,21 @@ extern const ModelEntry PROXY_MODEL_ENTRY;
  */
 void ProxyModel_Initialize();
 
+/**
+ * @brief The number of times a buffer was required and the pool was empty.
+ */
+uint32_t ProxyModel_BufferPoolExhaustedCount();
+
+/**
+ * @brief The number of requests that were NACKed with NR_PROXY_BUFFER_FULL.
+ */
+uint32_t ProxyModel_BufferPoolNackCount();
+
+/**
+ * @brief The number of buffers remaining in the pool.
+ */
+unsigned int ProxyModel_FreeBufferCount();
+
 #ifdef __cplusplus
 }
 #endif
@@ -74,6 +74,11 @@ static const uint8_t RDM_CHECKSUM_LENGTH = 2u;
  */
 static const uint8_t MESSAGE_LENGTH_OFFSET = 2u;
 
+/**
+ * @brief The location of the destination UID in a frame.
+ */
+static const uint8_t RDM_DEST_UID_OFFSET = 3u;
+
 /**
  * @brief The location of the parameter data length in a frame.
  */
@@ -36,7 +36,9 @@ extern "C" {
 /**
  * @brief The memory location used to build the RDM response.
  *
- * Guaranteed to be at least RDM_MAX_FRAME_SIZE bytes.
+ * Guaranteed to be at least RDM_MAX_FRAME_SIZE bytes. While a request is
+ * being handled this may point directly at the transceiver's transmit buffer,
+ * so the contents should not be relied on across requests.
  */
 extern uint8_t *g_rdm_buffer;
 
@@ -206,6 +206,22 @@ uint16_t RDMHandler_ActiveModel() {
 
 void RDMHandler_HandleRequest(const RDMHeader *header,
                               const uint8_t *param_data) {
+  if (ntohs(header->param_id) != PID_DEVICE_MODEL &&
+      ntohs(header->param_id) != PID_DEVICE_MODEL_LIST &&
+      !g_rdm_handler.active_model) {
+    return;
+  }
+
+#ifdef PIPELINE_RDMRESPONDER_ACQUIRE_BUFFER
+  // If we can, build the response directly in the transceiver's TX buffer,
+  // this saves copying the frame once it's complete.
+  uint8_t *rdm_buffer = g_rdm_buffer;
+  uint8_t *tx_buffer = PIPELINE_RDMRESPONDER_ACQUIRE_BUFFER();
+  if (tx_buffer) {
+    g_rdm_buffer = tx_buffer;
+  }
+#endif
+
   // We need to intercept calls to the SET_MODEL_ID pid, and use them to change
   // the active model.
   int response_size = RDM_RESPONDER_NO_RESPONSE;
@@ -215,13 +231,22 @@ void RDMHandler_HandleRequest(const RDMHeader *header,
   } else if (ntohs(header->param_id) == PID_DEVICE_MODEL_LIST) {
     response_size = GetModelList(header);
   } else {
-    if (!g_rdm_handler.active_model) {
-      return;
-    }
-
     response_size = g_rdm_handler.active_model->request_fn(header, param_data);
   }
 
+#ifdef PIPELINE_RDMRESPONDER_ACQUIRE_BUFFER
+  if (tx_buffer) {
+    g_rdm_buffer = rdm_buffer;
+    if (response_size) {
+      PIPELINE_RDMRESPONDER_COMMIT(response_size < 0 ? false : true,
+                                   abs(response_size));
+    } else {
+      PIPELINE_RDMRESPONDER_RELEASE_BUFFER();
+    }
+    return;
+  }
+#endif
+
   if (response_size) {
     IOVec iov;
     iov.base = g_rdm_buffer;
@@ -243,6 +268,56 @@ void RDMHandler_GetUID(uint8_t *uid) {
   }
 }
 
+bool RDMHandler_RequiresAction(const uint8_t uid[UID_LENGTH]) {
+  if (!g_rdm_handler.active_model) {
+    // Only the DEVICE_MODEL PIDs are handled, see GetSetModelId().
+    uint8_t null_uid[UID_LENGTH];
+    memset(null_uid, 0, UID_LENGTH);
+    return RDMUtil_RequiresAction(null_uid, uid);
+  }
+
+  uint8_t dest_uid[UID_LENGTH];
+  memcpy(dest_uid, uid, UID_LENGTH);
+  return g_rdm_handler.active_model->ioctl_fn(IOCTL_REQUIRES_ACTION, dest_uid,
+                                              UID_LENGTH);
+}
+
+void RDMHandler_GetDMXWindow(DMXWindow *window) {
+  if (!(g_rdm_handler.active_model &&
+        g_rdm_handler.active_model->ioctl_fn(
+            IOCTL_GET_DMX_WINDOW, (uint8_t*) window, sizeof(DMXWindow)))) {
+    window->start_slot = 0u;
+    window->footprint = 0u;
+  }
+}
+
+void RDMHandler_BeginDMXFrame() {
+  if (g_rdm_handler.active_model) {
+    g_rdm_handler.active_model->ioctl_fn(IOCTL_DMX_FRAME_START, NULL, 0u);
+  }
+}
+
+void RDMHandler_HandleDMXData(const uint8_t *slots, unsigned int slot_count) {
+  if (g_rdm_handler.active_model) {
+    // The models treat the data as read-only, see IOCTL_DMX_DATA.
+    g_rdm_handler.active_model->ioctl_fn(IOCTL_DMX_DATA, (uint8_t*) slots,
+                                         slot_count);
+  }
+}
+
+bool RDMHandler_GetSettings(ModelSettingsBlock *block) {
+  return g_rdm_handler.active_model &&
+      g_rdm_handler.active_model->ioctl_fn(
+          IOCTL_GET_SETTINGS, (uint8_t*) block, sizeof(ModelSettingsBlock));
+}
+
+bool RDMHandler_SetSettings(const ModelSettingsBlock *block) {
+  // The models treat the block as read-only, see IOCTL_SET_SETTINGS.
+  return g_rdm_handler.active_model &&
+      g_rdm_handler.active_model->ioctl_fn(
+          IOCTL_SET_SETTINGS, (uint8_t*) block, sizeof(ModelSettingsBlock));
+}
+
 void RDMHandler_Tasks() {
   if (g_rdm_handler.active_model) {
     g_rdm_handler.active_model->tasks_fn();
@@ -110,6 +110,10 @@ uint16_t RDMHandler_ActiveModel();
  * @pre The checksum of the command is correct
  * @param header The RDM command header.
  * @param param_data the parameter data
+ *
+ * If PIPELINE_RDMRESPONDER_ACQUIRE_BUFFER is defined, the response is built
+ * in-place in the buffer it returns, otherwise the response is built in the
+ * default g_rdm_buffer and then sent.
  */
 void RDMHandler_HandleRequest(const RDMHeader *header,
                               const uint8_t *param_data);
@@ -122,6 +126,56 @@ void RDMHandler_HandleRequest(const RDMHeader *header,
  */
 void RDMHandler_GetUID(uint8_t *uid);
 
+/**
+ * @brief Check if the active model needs to act on a request sent to a UID.
+ * @param uid The destination UID of the request.
+ * @returns true if the request should be handled, false if it can be ignored.
+ *
+ * This takes into account broadcast & vendorcast UIDs, as well as any
+ * additional UIDs the model represents (e.g. proxied devices).
+ */
+bool RDMHandler_RequiresAction(const uint8_t uid[UID_LENGTH]);
+
+/**
+ * @brief Get the range of slots used by the active model.
+ * @param[out] window The DMXWindow to populate. If there is no active model,
+ *   the footprint is set to 0.
+ */
+void RDMHandler_GetDMXWindow(DMXWindow *window);
+
+/**
+ * @brief Signal the start of a DMX512 frame to the active model.
+ *
+ * This is called from the receive path when a frame with the NULL start code
+ * begins, before any calls to RDMHandler_HandleDMXData() for the frame.
+ */
+void RDMHandler_BeginDMXFrame();
+
+/**
+ * @brief Pass DMX512 data to the active model.
+ * @param slots The slot data, starting at the first slot of the model's
+ *   DMXWindow.
+ * @param slot_count The number of slots of the window received so far.
+ *
+ * This is called from the receive path as the frame arrives.
+ */
+void RDMHandler_HandleDMXData(const uint8_t *slots, unsigned int slot_count);
+
+/**
+ * @brief Get a block of the active model's persistent settings.
+ * @param[in,out] block The block to populate, with the index set.
+ * @returns true if the block was populated, false if there is no active model
+ *   or it doesn't have a block with this index.
+ */
+bool RDMHandler_GetSettings(ModelSettingsBlock *block);
+
+/**
+ * @brief Restore a block of the active model's persistent settings.
+ * @param block The block to restore.
+ * @returns true if the settings were applied, false otherwise.
+ */
+bool RDMHandler_SetSettings(const ModelSettingsBlock *block);
+
 /**
  * @brief Perform the periodic RDM Handler tasks.
  *
@@ -92,6 +92,32 @@ typedef enum {
   PROXY_CHILD_MODEL_ID = 0x0106,
 } ResponderModel;
 
+/**
+ * @brief The range of DMX512 slots a model uses.
+ */
+typedef struct {
+  uint16_t start_slot;  //!< The first slot, 0 is the first slot after the SC.
+  uint16_t footprint;  //!< The number of slots, 0 if the model has none.
+} DMXWindow;
+
+/**
+ * @brief The maximum size of a ModelSettingsBlock.
+ */
+enum { MODEL_SETTINGS_BLOCK_SIZE = 64 };
+
+/**
+ * @brief A block of a model's persistent settings.
+ *
+ * Block 0 holds the settings common to all responders, see
+ * RDMResponder_Ioctl(). Models may use blocks 1 and above for their own
+ * settings.
+ */
+typedef struct {
+  uint8_t index;  //!< The block to get or set.
+  uint8_t length;  //!< The number of bytes of data.
+  uint8_t data[MODEL_SETTINGS_BLOCK_SIZE];  //!< The serialized settings.
+} ModelSettingsBlock;
+
 /**
  * @brief Model ioctl enums.
  *
@@ -106,6 +132,82 @@ typedef enum {
    * @returns Returns 1 on success or 0 if length didn't match UID_LENGTH.
    */
   IOCTL_GET_UID,
+
+  /**
+   * @brief Checks if the model needs to act on requests sent to a UID.
+   * @param data, the destination UID of the request.
+   * @param length should be set to UID_LENGTH.
+   * @returns Returns 1 if the model should process requests sent to the UID,
+   *   or 0 if the request can be ignored.
+   *
+   * This is used to discard RDM frames addressed to other devices as early as
+   * possible. Models that represent more than one UID (e.g. a proxy) must
+   * return 1 if any of the UIDs require action.
+   */
+  IOCTL_REQUIRES_ACTION,
+
+  /**
+   * @brief Signal the start of a DMX512 frame.
+   * @param data, unused.
+   * @param length, unused.
+   * @returns Returns 1 if the model used the signal, 0 otherwise.
+   *
+   * This is called from the receive path once the NULL start code of a frame
+   * arrives, before any IOCTL_DMX_DATA calls for the frame. Models that
+   * accumulate slots across IOCTL_DMX_DATA calls should use this, rather than
+   * the slot count, to detect a new frame.
+   */
+  IOCTL_DMX_FRAME_START,
+
+  /**
+   * @brief Deliver DMX512 slot data to the model.
+   * @param data, the slot data, starting at the first slot of the model's
+   *   DMXWindow. This must not be modified.
+   * @param length the number of slots of the window received so far in this
+   *   frame. This increases with each call within a frame, see
+   *   IOCTL_DMX_FRAME_START.
+   * @returns Returns 1 if the model used the data, 0 otherwise.
+   *
+   * This is called from the receive path each time more slots of the window
+   * arrive, so it may be called several times per frame. Slots outside the
+   * window are never delivered. Models should only do a small, fixed amount
+   * of work per slot in their footprint.
+   */
+  IOCTL_DMX_DATA,
+
+  /**
+   * @brief Get the range of slots the model uses.
+   * @param data, a pointer to a DMXWindow to populate.
+   * @param length should be set to sizeof(DMXWindow).
+   * @returns Returns 1 on success or 0 if length didn't match.
+   *
+   * This is called at the start of each DMX512 frame, so changes to the start
+   * address or personality take effect from the next frame.
+   */
+  IOCTL_GET_DMX_WINDOW,
+
+  /**
+   * @brief Serialize a block of the model's persistent settings.
+   * @param data, a pointer to a ModelSettingsBlock, with the index set. The
+   *   length and data are populated.
+   * @param length should be set to sizeof(ModelSettingsBlock).
+   * @returns Returns 1 if the block was populated, or 0 if the model doesn't
+   *   have a block with this index.
+   */
+  IOCTL_GET_SETTINGS,
+
+  /**
+   * @brief Restore a block of the model's persistent settings.
+   * @param data, a pointer to a ModelSettingsBlock, previously returned by
+   *   IOCTL_GET_SETTINGS.
+   * @param length should be set to sizeof(ModelSettingsBlock).
+   * @returns Returns 1 if the settings were applied, or 0 if the block was
+   *   invalid.
+   *
+   * This is called after the model is activated. An invalid block must leave
+   * the settings unchanged.
+   */
+  IOCTL_SET_SETTINGS,
 } ModelIoctl;
 
 /**
@@ -20,12 +20,12 @@
 
 #include <string.h>
 
-#include "coarse_timer.h"
 #include "constants.h"
 #include "macros.h"
 #include "rdm_buffer.h"
 #include "rdm_util.h"
 #include "receiver_counters.h"
+#include "timer_wheel.h"
 #include "utils.h"
 
 const char MANUFACTURER_LABEL[] = "Open Lighting Project";
@@ -65,12 +65,12 @@ RDMResponder *g_responder = &root_responder;
  */
 typedef struct {
   // Mute params
-  CoarseTimer_Value mute_timer;
+  TimerWheel_Timer mute_timer;
   PORTS_CHANNEL mute_port;
   PORTS_BIT_POS mute_bit;
 
   // Identify params
-  CoarseTimer_Value identify_timer;
+  TimerWheel_Timer identify_timer;
   PORTS_CHANNEL identify_port;
   PORTS_BIT_POS identify_bit;
 } InternalResponderState;
@@ -146,14 +146,98 @@ static inline uint16_t GetControlField() {
          (g_responder->is_proxied_device ? MUTE_PROXY_FLAG : 0);
 }
 
+/*
+ * @brief Serialize the common responder settings into block 0.
+ *
+ * The format is personality (1 byte), start address (2 bytes) and then the
+ * device label.
+ */
+static bool GetSettings(ModelSettingsBlock *block) {
+  if (block->index != 0u) {
+    return false;
+  }
+  uint8_t *ptr = block->data;
+  *ptr++ = g_responder->current_personality;
+  ptr = PushUInt16(ptr, g_responder->dmx_start_address);
+  const unsigned int label_size = RDMUtil_SafeStringLength(
+      g_responder->device_label, RDM_DEFAULT_STRING_SIZE);
+  memcpy(ptr, g_responder->device_label, label_size);
+  ptr += label_size;
+  block->length = ptr - block->data;
+  return true;
+}
+
+/*
+ * @brief Restore the common responder settings from block 0.
+ */
+static bool SetSettings(const ModelSettingsBlock *block) {
+  const unsigned int header_size = sizeof(uint8_t) + sizeof(uint16_t);
+  if (block->index != 0u || block->length < header_size ||
+      block->length > header_size + RDM_DEFAULT_STRING_SIZE) {
+    return false;
+  }
+
+  const uint8_t personality = block->data[0];
+  const uint16_t address = JoinShort(block->data[1], block->data[2]);
+  if (g_responder->def->personality_count) {
+    if (personality == 0u ||
+        personality > g_responder->def->personality_count ||
+        address == 0u || address > MAX_DMX_START_ADDRESS) {
+      return false;
+    }
+  }
+
+  ModelSettingsBlock current = { .index = 0u };
+  GetSettings(&current);
+  if (current.length == block->length &&
+      memcmp(current.data, block->data, block->length) == 0) {
+    return true;
+  }
+
+  if (g_responder->def->personality_count) {
+    g_responder->current_personality = personality;
+    g_responder->dmx_start_address = address;
+  }
+  RDMUtil_StringCopy(g_responder->device_label, RDM_DEFAULT_STRING_SIZE,
+                     (const char*) block->data + header_size,
+                     block->length - header_size);
+  g_responder->using_factory_defaults = false;
+  return true;
+}
+
+/*
+ * @brief Flash the identify LED while the root responder is identifying.
+ */
+static void IdentifyTimer(UNUSED void *data) {
+  if (g_responder->identify_on) {
+    TimerWheel_Schedule(&g_internal_state.identify_timer, FLASH_FAST,
+                        IdentifyTimer, NULL);
+    PLIB_PORTS_PinToggle(PORTS_ID_0, g_internal_state.identify_port,
+                         g_internal_state.identify_bit);
+  }
+}
+
+/*
+ * @brief Flash the mute LED while the root responder is un-muted.
+ */
+static void MuteTimer(UNUSED void *data) {
+  TimerWheel_Schedule(&g_internal_state.mute_timer, FLASH_SLOW, MuteTimer,
+                      NULL);
+  if (!g_responder->is_muted) {
+    PLIB_PORTS_PinToggle(PORTS_ID_0, g_internal_state.mute_port,
+                         g_internal_state.mute_bit);
+  }
+}
+
 // Public Functions
 // ----------------------------------------------------------------------------
 void RDMResponder_Initialize(const RDMResponderSettings *settings) {
-  g_internal_state.mute_timer = CoarseTimer_GetTime();
+  TimerWheel_Schedule(&g_internal_state.mute_timer, FLASH_SLOW, MuteTimer,
+                      NULL);
   g_internal_state.mute_port = settings->mute_port;
   g_internal_state.mute_bit = settings->mute_bit;
 
-  g_internal_state.identify_timer = 0u;
+  TimerWheel_Cancel(&g_internal_state.identify_timer);
   g_internal_state.identify_port = settings->identify_port;
   g_internal_state.identify_bit = settings->identify_bit;
 
@@ -173,24 +257,6 @@ void RDMResponder_Initialize(const RDMResponderSettings *settings) {
   RDMResponder_InitResponder();
 }
 
-void RDMResponder_Tasks() {
-  if (g_responder->identify_on) {
-    if (CoarseTimer_HasElapsed(g_internal_state.identify_timer, FLASH_FAST)) {
-      g_internal_state.identify_timer = CoarseTimer_GetTime();
-      PLIB_PORTS_PinToggle(PORTS_ID_0, g_internal_state.identify_port,
-                           g_internal_state.identify_bit);
-    }
-  }
-
-  if (!g_responder->is_muted) {
-    if (CoarseTimer_HasElapsed(g_internal_state.mute_timer, FLASH_SLOW)) {
-      g_internal_state.mute_timer = CoarseTimer_GetTime();
-      PLIB_PORTS_PinToggle(PORTS_ID_0, g_internal_state.mute_port,
-                           g_internal_state.mute_bit);
-    }
-  }
-}
-
 void RDMResponder_SwitchResponder(RDMResponder *responder) {
   g_responder = responder;
 }
@@ -235,6 +301,22 @@ void RDMResponder_GetUID(uint8_t *uid) {
   memcpy(uid, g_responder->uid, UID_LENGTH);
 }
 
+void RDMResponder_GetDMXWindow(DMXWindow *window) {
+  const PersonalityDefinition *personality = CurrentPersonality();
+  const uint16_t start_address = g_responder->dmx_start_address;
+  window->start_slot = 0u;
+  window->footprint = 0u;
+  if (!personality || start_address == 0u ||
+      start_address > MAX_DMX_START_ADDRESS) {
+    return;
+  }
+  window->start_slot = start_address - 1u;
+  window->footprint = personality->dmx_footprint;
+  if (window->footprint > MAX_DMX_START_ADDRESS - window->start_slot) {
+    window->footprint = MAX_DMX_START_ADDRESS - window->start_slot;
+  }
+}
+
 int RDMResponder_HandleDUBRequest(const uint8_t *param_data,
                                   unsigned int param_data_length) {
   if (g_responder->is_muted || param_data_length != 2 * UID_LENGTH) {
@@ -409,6 +491,17 @@ int RDMResponder_DispatchPID(const RDMHeader *header,
   return RDMResponder_BuildNack(header, NR_UNKNOWN_PID);
 }
 
+PIDCommandHandler RDMResponder_GetSetAllHandler(uint16_t pid) {
+  const ResponderDefinition *definition = g_responder->def;
+  unsigned int i = 0u;
+  for (; i < definition->set_all_descriptor_count; i++) {
+    if (pid == definition->set_all_descriptors[i].pid) {
+      return definition->set_all_descriptors[i].set_handler;
+    }
+  }
+  return NULL;
+}
+
 int RDMResponder_Ioctl(ModelIoctl command, uint8_t *data, unsigned int length) {
   switch (command) {
     case IOCTL_GET_UID:
@@ -417,6 +510,27 @@ int RDMResponder_Ioctl(ModelIoctl command, uint8_t *data, unsigned int length) {
       }
       RDMResponder_GetUID(data);
       return 1;
+    case IOCTL_REQUIRES_ACTION:
+      if (length != UID_LENGTH) {
+        return 0;
+      }
+      return RDMUtil_RequiresAction(g_responder->uid, data);
+    case IOCTL_GET_DMX_WINDOW:
+      if (length != sizeof(DMXWindow)) {
+        return 0;
+      }
+      RDMResponder_GetDMXWindow((DMXWindow*) data);
+      return 1;
+    case IOCTL_GET_SETTINGS:
+      if (length != sizeof(ModelSettingsBlock)) {
+        return 0;
+      }
+      return GetSettings((ModelSettingsBlock*) data);
+    case IOCTL_SET_SETTINGS:
+      if (length != sizeof(ModelSettingsBlock)) {
+        return 0;
+      }
+      return SetSettings((const ModelSettingsBlock*) data);
     default:
       return 0;
   }
@@ -529,7 +643,8 @@ int RDMResponder_SetUnMute(const RDMHeader *header) {
   g_responder->is_muted = false;
   PLIB_PORTS_PinSet(PORTS_ID_0, g_internal_state.mute_port,
                     g_internal_state.mute_bit);
-  g_internal_state.mute_timer = CoarseTimer_GetTime();
+  TimerWheel_Schedule(&g_internal_state.mute_timer, FLASH_SLOW, MuteTimer,
+                      NULL);
 
   ReturnUnlessUnicast(header);
 
@@ -932,7 +1047,8 @@ int RDMResponder_SetIdentifyDevice(const RDMHeader *header,
   }
   g_responder->using_factory_defaults = false;
   if (g_responder->identify_on) {
-    g_internal_state.identify_timer = CoarseTimer_GetTime();
+    TimerWheel_Schedule(&g_internal_state.identify_timer, FLASH_FAST,
+                        IdentifyTimer, NULL);
     PLIB_PORTS_PinSet(PORTS_ID_0, g_internal_state.identify_port,
                       g_internal_state.identify_bit);
   } else {
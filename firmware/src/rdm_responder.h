@@ -235,6 +235,16 @@ typedef struct {
    */
   const PIDDescriptor *descriptors;
 
+  /**
+   * @brief The descriptor table for SET requests sent to SUBDEVICE_ALL.
+   *
+   * Only the set_handler is used. These handlers validate the request once and
+   * apply it to all sub-devices in a single pass, returning a single response.
+   * This may be NULL, in which case the model should dispatch the request to
+   * each sub-device in turn.
+   */
+  const PIDDescriptor *set_all_descriptors;
+
   /**
    * @brief The sensor definitions table.
    *
@@ -264,6 +274,11 @@ typedef struct {
    */
   unsigned int descriptor_count;
 
+  /**
+   * @brief The number of descriptors in the set_all_descriptors table.
+   */
+  unsigned int set_all_descriptor_count;
+
   /**
    * @brief The number of personality definitions in the table.
    */
@@ -337,15 +352,11 @@ typedef struct {
 /**
  * @brief Initialize an RDMResponder struct.
  * @param settings the settings to use for the responder.
- */
-void RDMResponder_Initialize(const RDMResponderSettings *settings);
-
-/**
- * @brief Perform the periodic tasks.
  *
- * This should be called in the main event loop.
+ * This must be called after TimerWheel_Initialize(), the identify and mute
+ * LEDs are flashed from timer wheel callbacks.
  */
-void RDMResponder_Tasks();
+void RDMResponder_Initialize(const RDMResponderSettings *settings);
 
 /**
  * @brief Switch the current responder.
@@ -374,6 +385,15 @@ void RDMResponder_ResetToFactoryDefaults();
  */
 void RDMResponder_GetUID(uint8_t *uid);
 
+/**
+ * @brief Get the range of slots used by the responder.
+ * @param[out] window The DMXWindow to populate.
+ *
+ * This is the DMX start address and the footprint of the current personality.
+ * If the responder doesn't have a start address the footprint is 0.
+ */
+void RDMResponder_GetDMXWindow(DMXWindow *window);
+
 /**
  * @brief Handle a Discovery-unique-branch request.
  * @param param_data The DUB request param_data.
@@ -448,6 +468,14 @@ int RDMResponder_BuildParamDescription(const RDMHeader *incoming_header,
                                        uint16_t param_id,
                                        const ParameterDescription *description);
 
+/**
+ * @brief Find the SUBDEVICE_ALL SET handler for a PID.
+ * @param pid The PID to look up.
+ * @returns The handler from the set_all_descriptors table, or NULL if there
+ *   isn't one.
+ */
+PIDCommandHandler RDMResponder_GetSetAllHandler(uint16_t pid);
+
 /**
  * @brief Invoke a PID handler from the ResponderDefinition.
  * @param incoming_header The header of the incoming frame.
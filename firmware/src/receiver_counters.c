@@ -38,6 +38,7 @@ void ReceiverCounters_ResetCounters() {
   g_responder_counters.rdm_sub_start_code_invalid = 0u;
   g_responder_counters.rdm_msg_len_invalid = 0u;
   g_responder_counters.rdm_param_data_len_invalid = 0u;
+  g_responder_counters.rdm_other_destination = 0u;
   // The initial values are from E1.37-5 (draft).
   g_responder_counters.dmx_last_checksum = UNINITIALIZED_CHECKSUM;
   g_responder_counters.dmx_last_slot_count = UNINITIALIZED_COUNTER;
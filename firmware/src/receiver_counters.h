@@ -44,6 +44,7 @@ typedef struct {
   uint32_t rdm_msg_len_invalid;
   uint32_t rdm_param_data_len_invalid;
   uint32_t rdm_checksum_invalid;
+  uint32_t rdm_other_destination;
   uint8_t dmx_last_checksum;
   uint16_t dmx_last_slot_count;
   uint16_t dmx_min_slot_count;
@@ -137,6 +138,14 @@ static inline uint32_t ReceiverCounters_RDMChecksumInvalidCounter() {
   return g_responder_counters.rdm_checksum_invalid;
 }
 
+/**
+ * @brief The number of RDM frames discarded because they were addressed to
+ * another device.
+ */
+static inline uint32_t ReceiverCounters_RDMOtherDestination() {
+  return g_responder_counters.rdm_other_destination;
+}
+
 /**
  * @brief The additive checksum of the last DMX frame.
  *
@@ -22,12 +22,12 @@
 #include <stdlib.h>
 
 #include "constants.h"
+#include "dmx_input.h"
 #include "dmx_spec.h"
 #include "rdm_frame.h"
 #include "rdm_handler.h"
 #include "receiver_counters.h"
 #include "rdm_util.h"
-#include "spi_rgb.h"
 #include "syslog.h"
 #include "transceiver.h"
 #include "utils.h"
@@ -68,6 +68,70 @@ static ResponderState g_state = STATE_START_CODE;
  */
 static unsigned int g_offset = 0u;
 
+/*
+ * @brief The slots the active model uses, fetched at the start of each frame.
+ */
+static DMXWindow g_dmx_window;
+
+/*
+ * @brief The number of slots of g_dmx_window passed to the model this frame.
+ */
+static uint16_t g_dmx_window_delivered = 0u;
+
+/*
+ * @brief Update the DMX counters & input store with slots [g_offset, length)
+ *   of a frame.
+ * @param data The frame data, starting with the start code.
+ * @param length The number of bytes of the frame received so far.
+ */
+static inline void AccumulateDMXSlots(const uint8_t *data,
+                                      unsigned int length) {
+  if (g_offset >= length) {
+    return;
+  }
+  DMXInput_AppendSlots(data + g_offset, length - g_offset);
+  if (length > DMX_FRAME_SIZE) {
+    // A full frame, there is no need to wait for the next break.
+    DMXInput_EndFrame();
+  }
+  const uint8_t *ptr = data + g_offset;
+  const uint8_t *end = data + length;
+  uint8_t checksum = g_responder_counters.dmx_last_checksum;
+  for (; ptr != end; ptr++) {
+    checksum += *ptr;
+  }
+  g_responder_counters.dmx_last_checksum = checksum;
+  g_responder_counters.dmx_last_slot_count += length - g_offset;
+  if (g_responder_counters.dmx_max_slot_count == UNINITIALIZED_COUNTER ||
+      g_responder_counters.dmx_last_slot_count >
+        g_responder_counters.dmx_max_slot_count) {
+    g_responder_counters.dmx_max_slot_count =
+      g_responder_counters.dmx_last_slot_count;
+  }
+  g_offset = length;
+}
+
+/*
+ * @brief Pass any newly received slots within the model's window to the
+ * model.
+ * @param data The frame data, starting with the start code.
+ * @param length The number of bytes of the frame received so far.
+ */
+static inline void DeliverDMXWindow(const uint8_t *data, unsigned int length) {
+  const unsigned int slot_count = length - 1u;
+  if (slot_count <= g_dmx_window.start_slot) {
+    return;
+  }
+  unsigned int available = slot_count - g_dmx_window.start_slot;
+  if (available > g_dmx_window.footprint) {
+    available = g_dmx_window.footprint;
+  }
+  if (available > g_dmx_window_delivered) {
+    g_dmx_window_delivered = available;
+    RDMHandler_HandleDMXData(data + 1u + g_dmx_window.start_slot, available);
+  }
+}
+
 /*
  * @brief Call the RDM handler when we have a complete and valid frame.
  */
@@ -87,35 +151,11 @@ static inline void DispatchRDMRequest(const uint8_t *frame) {
       header->param_data_length);
 }
 
-/*
- * @brief Increment the bad-checksum counter if the frame was for us.
- */
-static inline void PossiblyIncrementChecksumCounter(const uint8_t *frame) {
-  uint8_t uid[UID_LENGTH];
-  RDMHandler_GetUID(uid);
-  RDMHeader *header = (RDMHeader*) frame;
-  if (RDMUtil_RequiresAction(uid, header->dest_uid)) {
-    SysLog_Message(SYSLOG_ERROR, "Checksum mismatch");
-    g_responder_counters.rdm_checksum_invalid++;
-  }
-}
-
-/*
- * @brief Increment the length-mismatch counter if the frame was for us.
- */
-static inline void PossiblyIncrementLengthMismatchCounter(
-    const uint8_t *frame) {
-  uint8_t uid[UID_LENGTH];
-  RDMHandler_GetUID(uid);
-  RDMHeader *header = (RDMHeader*) frame;
-  if (RDMUtil_RequiresAction(uid, header->dest_uid)) {
-    g_responder_counters.rdm_length_mismatch++;
-  }
-}
-
 // Public Functions
 // ----------------------------------------------------------------------------
-void Responder_Initialize() {}
+void Responder_Initialize() {
+  DMXInput_Initialize();
+}
 
 void Responder_Receive(const TransceiverEvent *event) {
   // While this function is running, UART interrupts are disabled.
@@ -128,6 +168,9 @@ void Responder_Receive(const TransceiverEvent *event) {
     // Right now we can only tell a DMX frame ended when the next one starts.
     // TODO(simon): get some clarity on this. It needs to be discussed and
     // explained in E1.37-5.
+    if (g_state == STATE_DMX_DATA) {
+      DMXInput_EndFrame();
+    }
     if (g_state == STATE_DMX_DATA &&
         (g_responder_counters.dmx_min_slot_count == UNINITIALIZED_COUNTER ||
          g_responder_counters.dmx_last_slot_count <
@@ -150,11 +193,15 @@ void Responder_Receive(const TransceiverEvent *event) {
   }
 
   if (event->result == T_RESULT_RX_FRAME_TIMEOUT) {
-    SPIRGB_CompleteUpdate();
+    if (g_state == STATE_DMX_DATA) {
+      DMXInput_EndFrame();
+    }
     return;
   }
 
-  for (; g_offset < event->length; g_offset++) {
+  // Once the start code shows this is a DMX frame, the remaining slots are
+  // handled in bulk below.
+  for (; g_offset < event->length && g_state != STATE_DMX_DATA; g_offset++) {
     uint8_t b = event->data[g_offset];
     switch (g_state) {
       case STATE_START_CODE:
@@ -163,8 +210,11 @@ void Responder_Receive(const TransceiverEvent *event) {
           g_responder_counters.dmx_last_slot_count = 0u;
           SysLog_Message(SYSLOG_DEBUG, "DMX frame");
           g_responder_counters.dmx_frames++;
+          DMXInput_BeginFrame();
+          RDMHandler_BeginDMXFrame();
+          RDMHandler_GetDMXWindow(&g_dmx_window);
+          g_dmx_window_delivered = 0u;
           g_state = STATE_DMX_DATA;
-          SPIRGB_BeginUpdate();
         } else if (b == RDM_START_CODE) {
           g_responder_counters.rdm_frames++;
           g_state = STATE_RDM_SUB_START_CODE;
@@ -204,6 +254,16 @@ void Responder_Receive(const TransceiverEvent *event) {
             continue;
           }
         }
+        if (g_offset == RDM_DEST_UID_OFFSET + UID_LENGTH - 1u &&
+            !RDMHandler_RequiresAction(event->data + RDM_DEST_UID_OFFSET)) {
+          // Not for us, skip the rest of the frame. Since the COMMS_STATUS
+          // counters only apply to frames we'd act on, there is nothing
+          // further to check.
+          g_responder_counters.rdm_other_destination++;
+          Transceiver_DiscardRXFrame();
+          g_state = STATE_DISCARD;
+          continue;
+        }
         if (g_offset + 1u == event->data[MESSAGE_LENGTH_OFFSET]) {
           g_state = STATE_RDM_CHECKSUM_LO;
         }
@@ -212,36 +272,30 @@ void Responder_Receive(const TransceiverEvent *event) {
         g_state = STATE_RDM_CHECKSUM_HI;
         break;
       case STATE_RDM_CHECKSUM_HI:
+        // Frames for other devices were discarded once the destination UID
+        // arrived, so anything reaching here requires action.
         if (RDMUtil_VerifyChecksum(event->data, event->length)) {
           DispatchRDMRequest(event->data);
         } else {
-          PossiblyIncrementChecksumCounter(event->data);
+          SysLog_Message(SYSLOG_ERROR, "Checksum mismatch");
+          g_responder_counters.rdm_checksum_invalid++;
         }
         g_state = STATE_RDM_POST_CHECKSUM;
         break;
       case STATE_RDM_POST_CHECKSUM:
-        PossiblyIncrementLengthMismatchCounter(event->data);
+        g_responder_counters.rdm_length_mismatch++;
         g_state = STATE_DISCARD;
         break;
       case STATE_DMX_DATA:
-        // TODO(simon): configure this with DMX_START_ADDRESS and footprints.
-        if (g_offset - 1u < 6u) {
-          SPIRGB_SetPixel((g_offset - 1u) / 3u, (g_offset - 1u) % 3u, b);
-        } else if (g_offset - 1u == 6u) {
-          SPIRGB_CompleteUpdate();
-        }
-
-        g_responder_counters.dmx_last_checksum += b;
-        g_responder_counters.dmx_last_slot_count++;
-        if (g_responder_counters.dmx_max_slot_count == UNINITIALIZED_COUNTER ||
-           g_responder_counters.dmx_last_slot_count >
-             g_responder_counters.dmx_max_slot_count) {
-          g_responder_counters.dmx_max_slot_count =
-            g_responder_counters.dmx_last_slot_count;
-        }
+        // Handled by AccumulateDMXSlots().
         break;
       case STATE_DISCARD:
         break;
     }
   }
+
+  if (g_state == STATE_DMX_DATA) {
+    AccumulateDMXSlots(event->data, event->length);
+    DeliverDMXWindow(event->data, event->length);
+  }
 }
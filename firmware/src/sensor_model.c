@@ -20,13 +20,14 @@
 
 #include <stdlib.h>
 
-#include "coarse_timer.h"
 #include "constants.h"
+#include "macros.h"
 #include "random.h"
 #include "rdm_frame.h"
 #include "rdm_responder.h"
 #include "rdm_util.h"
 #include "temperature.h"
+#include "timer_wheel.h"
 #include "utils.h"
 
 #include "app_settings.h"
@@ -50,7 +51,7 @@ static const ResponderDefinition RESPONDER_DEFINITION;
  * @brief The sensor model state.
  */
 typedef struct {
-  CoarseTimer_Value sensor_sample_time;
+  TimerWheel_Timer sample_timer;
   SensorData sensors[NUMBER_OF_SENSORS];
 } SensorModel;
 
@@ -68,8 +69,9 @@ static uint16_t GetSensorValue(unsigned int i) {
       RESPONDER_DEFINITION.sensors[i].range_minimum_value;
 }
 
-void SampleSensors() {
-  g_sensor_model.sensor_sample_time = CoarseTimer_GetTime();
+static void SampleSensors(UNUSED void *data) {
+  TimerWheel_Schedule(&g_sensor_model.sample_timer, SENSOR_SAMPLE_RATE,
+                      SampleSensors, NULL);
 
   unsigned int i = 0;
   for (; i < NUMBER_OF_SENSORS; i++) {
@@ -103,11 +105,13 @@ static void SensorModel_Activate() {
   }
 
   RDMResponder_InitResponder();
-  SampleSensors();
+  SampleSensors(NULL);
   g_responder->sensors = g_sensor_model.sensors;
 }
 
-static void SensorModel_Deactivate() {}
+static void SensorModel_Deactivate() {
+  TimerWheel_Cancel(&g_sensor_model.sample_timer);
+}
 
 static int SensorModel_Ioctl(ModelIoctl command, uint8_t *data,
                              unsigned int length) {
@@ -118,6 +122,11 @@ static int SensorModel_Ioctl(ModelIoctl command, uint8_t *data,
       }
       RDMResponder_GetUID(data);
       return 1;
+    case IOCTL_REQUIRES_ACTION:
+      if (length != UID_LENGTH) {
+        return 0;
+      }
+      return RDMUtil_RequiresAction(g_responder->uid, data);
     default:
       return 0;
   }
@@ -147,12 +156,7 @@ static int SensorModel_HandleRequest(const RDMHeader *header,
   return RDMResponder_DispatchPID(header, param_data);
 }
 
-static void SensorModel_Tasks() {
-  if (CoarseTimer_HasElapsed(g_sensor_model.sensor_sample_time,
-                             SENSOR_SAMPLE_RATE)) {
-    SampleSensors();
-  }
-}
+static void SensorModel_Tasks() {}
 
 const ModelEntry SENSOR_MODEL_ENTRY = {
   .model_id = SENSOR_MODEL_ID,
@@ -0,0 +1,429 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * settings_store.c
+ * Copyright (C) 2015 Simon Newton
+ */
+#include "settings_store.h"
+
+#include <string.h>
+
+#include "flash.h"
+
+enum { PAGE_MAGIC = 0x4a52 };
+enum { WORD_SIZE = sizeof(uint32_t) };
+
+static const uint32_t ERASED_WORD = 0xffffffff;
+static const uint32_t NO_RECORD = 0xffffffff;
+
+typedef enum {
+  RECORD_OK,  //!< The record is valid
+  RECORD_BAD_CHECKSUM,  //!< The record was interrupted, skip over it.
+  RECORD_INVALID,  //!< The header is corrupt.
+  RECORD_END  //!< The end of the records in this page.
+} RecordState;
+
+typedef struct {
+  SettingsStoreConfiguration config;
+  uint32_t index[SETTINGS_STORE_MAX_KEYS];  //!< Address of the current record
+  uint32_t write_offset;  //!< The next free offset in the head page.
+  uint32_t compact_offset;  //!< The offset in the oldest page, 0 if idle.
+  uint16_t sequence;  //!< The sequence number of the head page.
+  uint8_t head;  //!< The newest page.
+  uint8_t oldest;  //!< The oldest page.
+  uint8_t free_pages;  //!< The number of erased pages.
+  bool initialized;
+} SettingsStore;
+
+static SettingsStore g_store;
+
+// Helper functions
+// ----------------------------------------------------------------------------
+static inline uint32_t PageAddress(uint8_t page) {
+  return g_store.config.base_address + page * g_store.config.page_size;
+}
+
+static inline uint8_t NextPage(uint8_t page) {
+  return (page + 1u) % g_store.config.page_count;
+}
+
+static inline bool IsValidPageHeader(uint32_t header) {
+  return (header >> 16) == PAGE_MAGIC;
+}
+
+/*
+ * @brief The size of a record, including the header & padding.
+ */
+static inline unsigned int RecordSize(unsigned int length) {
+  return WORD_SIZE + ((length + WORD_SIZE - 1u) & ~(WORD_SIZE - 1u));
+}
+
+static uint16_t Checksum(uint8_t key, const uint8_t *data,
+                         unsigned int length) {
+  uint16_t sum = key + (length << 8);
+  unsigned int i = 0u;
+  for (; i < length; i++) {
+    sum = ((sum << 1) | (sum >> 15)) + data[i];
+  }
+  return ~sum;
+}
+
+static void ReadData(uint32_t address, uint8_t *data, unsigned int length) {
+  unsigned int i = 0u;
+  while (i < length) {
+    uint32_t word = Flash_ReadWord(address);
+    address += WORD_SIZE;
+    unsigned int j = 0u;
+    for (; j < WORD_SIZE && i < length; j++, i++) {
+      data[i] = word >> (8u * j);
+    }
+  }
+}
+
+static RecordState ReadRecord(uint32_t page_address, uint32_t offset,
+                              uint8_t *key, uint8_t *data,
+                              unsigned int *length) {
+  if (offset + WORD_SIZE > g_store.config.page_size) {
+    return RECORD_END;
+  }
+
+  const uint32_t header = Flash_ReadWord(page_address + offset);
+  if (header == ERASED_WORD) {
+    return RECORD_END;
+  }
+
+  *key = header & 0xff;
+  *length = (header >> 8) & 0xff;
+  if (*key >= SETTINGS_STORE_MAX_KEYS ||
+      *length > SETTINGS_STORE_MAX_VALUE_SIZE ||
+      offset + RecordSize(*length) > g_store.config.page_size) {
+    return RECORD_INVALID;
+  }
+
+  ReadData(page_address + offset + WORD_SIZE, data, *length);
+  if (Checksum(*key, data, *length) != (header >> 16)) {
+    return RECORD_BAD_CHECKSUM;
+  }
+  return RECORD_OK;
+}
+
+/*
+ * @brief Erase a page, if it isn't already erased.
+ */
+static bool ErasePageIfRequired(uint8_t page) {
+  const uint32_t address = PageAddress(page);
+  uint32_t offset = 0u;
+  for (; offset < g_store.config.page_size; offset += WORD_SIZE) {
+    if (Flash_ReadWord(address + offset) != ERASED_WORD) {
+      return Flash_ErasePage(address);
+    }
+  }
+  return true;
+}
+
+static bool StartNewPage() {
+  g_store.head = NextPage(g_store.head);
+  g_store.sequence++;
+  g_store.free_pages--;
+  g_store.write_offset = WORD_SIZE;
+  if (!Flash_WriteWord(PageAddress(g_store.head),
+                       (PAGE_MAGIC << 16) | g_store.sequence)) {
+    // Don't write any records to this page.
+    g_store.write_offset = g_store.config.page_size;
+    return false;
+  }
+  return true;
+}
+
+/*
+ * @brief Append a record to the log.
+ * @param key The key
+ * @param data The value
+ * @param length The length of the value, 0 means delete.
+ * @param reserve The number of free pages that must remain.
+ */
+static bool AppendRecord(uint8_t key, const uint8_t *data,
+                         unsigned int length, unsigned int reserve) {
+  const unsigned int size = RecordSize(length);
+  if (g_store.write_offset + size > g_store.config.page_size) {
+    if (g_store.free_pages <= reserve || !StartNewPage()) {
+      return false;
+    }
+  }
+
+  uint32_t address = PageAddress(g_store.head) + g_store.write_offset;
+  const uint32_t record_address = address;
+  // Advance first, so a failed write isn't written over.
+  g_store.write_offset += size;
+
+  if (!Flash_WriteWord(
+        address,
+        key | (length << 8) | (Checksum(key, data, length) << 16))) {
+    return false;
+  }
+
+  unsigned int i = 0u;
+  while (i < length) {
+    address += WORD_SIZE;
+    uint32_t word = ERASED_WORD;
+    unsigned int j = 0u;
+    for (; j < WORD_SIZE && i < length; j++, i++) {
+      word &= ~(0xffu << (8u * j));
+      word |= (uint32_t) data[i] << (8u * j);
+    }
+    if (!Flash_WriteWord(address, word)) {
+      return false;
+    }
+  }
+
+  g_store.index[key] = length ? record_address : NO_RECORD;
+  return true;
+}
+
+/*
+ * @brief Compact a single record from the oldest page.
+ *
+ * Once all records have been processed, the page is erased.
+ */
+static bool CompactRecord() {
+  const uint32_t page_address = PageAddress(g_store.oldest);
+  if (g_store.compact_offset == 0u) {
+    g_store.compact_offset = WORD_SIZE;
+  }
+
+  uint8_t key;
+  uint8_t data[SETTINGS_STORE_MAX_VALUE_SIZE];
+  unsigned int length;
+  RecordState state = ReadRecord(page_address, g_store.compact_offset, &key,
+                                 data, &length);
+  if (state == RECORD_OK || state == RECORD_BAD_CHECKSUM) {
+    if (state == RECORD_OK &&
+        g_store.index[key] == page_address + g_store.compact_offset) {
+      // The record is current, copy it to the head.
+      if (!AppendRecord(key, data, length, 0u)) {
+        return false;
+      }
+    }
+    g_store.compact_offset += RecordSize(length);
+    return true;
+  }
+
+  if (!Flash_ErasePage(page_address)) {
+    return false;
+  }
+  g_store.oldest = NextPage(g_store.oldest);
+  g_store.free_pages++;
+  g_store.compact_offset = 0u;
+  return true;
+}
+
+static bool CompactOldestPage() {
+  if (g_store.oldest == g_store.head) {
+    return false;
+  }
+  const uint8_t page = g_store.oldest;
+  while (g_store.oldest == page) {
+    if (!CompactRecord()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool WriteRecord(uint8_t key, const uint8_t *data,
+                        unsigned int length) {
+  if (g_store.write_offset + RecordSize(length) > g_store.config.page_size) {
+    // A new page is required, make sure one remains for compaction.
+    // TODO(simon): This erases flash regardless of what the transceiver is
+    // doing. It only happens if SettingsStore_Tasks() hasn't had an idle
+    // period to compact in.
+    while (g_store.free_pages < 2u) {
+      if (!CompactOldestPage()) {
+        return false;
+      }
+    }
+  }
+  return AppendRecord(key, data, length, 1u);
+}
+
+/*
+ * @brief Build the index from the pages between oldest and head.
+ */
+static void BuildIndex(uint8_t used_pages) {
+  uint8_t page = g_store.oldest;
+  uint8_t i = 0u;
+  for (; i < used_pages; i++) {
+    const uint32_t page_address = PageAddress(page);
+    uint32_t offset = WORD_SIZE;
+    uint8_t key;
+    uint8_t data[SETTINGS_STORE_MAX_VALUE_SIZE];
+    unsigned int length;
+    RecordState state;
+    while ((state = ReadRecord(page_address, offset, &key, data, &length)) ==
+           RECORD_OK || state == RECORD_BAD_CHECKSUM) {
+      if (state == RECORD_OK) {
+        g_store.index[key] = length ? page_address + offset : NO_RECORD;
+      }
+      offset += RecordSize(length);
+    }
+
+    if (page == g_store.head) {
+      // If the page is corrupt, don't append to it.
+      g_store.write_offset = state == RECORD_END ? offset :
+                             g_store.config.page_size;
+    }
+    page = NextPage(page);
+  }
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+bool SettingsStore_Initialize(const SettingsStoreConfiguration *config) {
+  g_store.initialized = false;
+  if (config->page_count < 3u ||
+      config->page_size % WORD_SIZE ||
+      config->page_size <
+          WORD_SIZE + 2u * RecordSize(SETTINGS_STORE_MAX_VALUE_SIZE)) {
+    return false;
+  }
+
+  g_store.config = *config;
+  g_store.compact_offset = 0u;
+  unsigned int i = 0u;
+  for (; i < SETTINGS_STORE_MAX_KEYS; i++) {
+    g_store.index[i] = NO_RECORD;
+  }
+
+  // Find the newest page.
+  bool found = false;
+  uint8_t page = 0u;
+  for (; page < config->page_count; page++) {
+    const uint32_t header = Flash_ReadWord(PageAddress(page));
+    const uint16_t sequence = header & 0xffff;
+    if (IsValidPageHeader(header) &&
+        (!found || (int16_t) (sequence - g_store.sequence) > 0)) {
+      g_store.head = page;
+      g_store.sequence = sequence;
+      found = true;
+    }
+  }
+
+  if (!found) {
+    // Start a new log in the first page.
+    for (page = 0u; page < config->page_count; page++) {
+      if (!ErasePageIfRequired(page)) {
+        return false;
+      }
+    }
+    g_store.head = config->page_count - 1u;
+    g_store.oldest = 0u;
+    g_store.sequence = 0xffff;
+    g_store.free_pages = config->page_count;
+    if (!StartNewPage()) {
+      return false;
+    }
+    g_store.initialized = true;
+    return true;
+  }
+
+  // Walk backwards from the head to find the oldest page.
+  g_store.oldest = g_store.head;
+  uint16_t sequence = g_store.sequence;
+  uint8_t used_pages = 1u;
+  while (used_pages < config->page_count) {
+    const uint8_t previous = (g_store.oldest + config->page_count - 1u) %
+                             config->page_count;
+    const uint32_t header = Flash_ReadWord(PageAddress(previous));
+    if (!IsValidPageHeader(header) ||
+        (header & 0xffff) != (uint16_t) (sequence - 1u)) {
+      break;
+    }
+    g_store.oldest = previous;
+    sequence--;
+    used_pages++;
+  }
+
+  // Erase the pages outside the log.
+  g_store.free_pages = config->page_count - used_pages;
+  page = NextPage(g_store.head);
+  for (i = 0u; i < g_store.free_pages; i++) {
+    if (!ErasePageIfRequired(page)) {
+      return false;
+    }
+    page = NextPage(page);
+  }
+
+  BuildIndex(used_pages);
+  g_store.initialized = true;
+  return true;
+}
+
+bool SettingsStore_Get(uint8_t key, uint8_t *data, unsigned int *length) {
+  if (!g_store.initialized || key >= SETTINGS_STORE_MAX_KEYS ||
+      g_store.index[key] == NO_RECORD) {
+    return false;
+  }
+
+  const uint32_t address = g_store.index[key];
+  const unsigned int value_length = (Flash_ReadWord(address) >> 8) & 0xff;
+  if (value_length > *length) {
+    return false;
+  }
+  ReadData(address + WORD_SIZE, data, value_length);
+  *length = value_length;
+  return true;
+}
+
+bool SettingsStore_Set(uint8_t key, const uint8_t *data, unsigned int length) {
+  if (!g_store.initialized || key >= SETTINGS_STORE_MAX_KEYS ||
+      length == 0u || length > SETTINGS_STORE_MAX_VALUE_SIZE) {
+    return false;
+  }
+
+  uint8_t current[SETTINGS_STORE_MAX_VALUE_SIZE];
+  unsigned int current_length = sizeof(current);
+  if (SettingsStore_Get(key, current, &current_length) &&
+      current_length == length && memcmp(current, data, length) == 0) {
+    // No change, save the flash.
+    return true;
+  }
+  return WriteRecord(key, data, length);
+}
+
+bool SettingsStore_Delete(uint8_t key) {
+  if (!g_store.initialized || key >= SETTINGS_STORE_MAX_KEYS) {
+    return false;
+  }
+  if (g_store.index[key] == NO_RECORD) {
+    return true;
+  }
+  return WriteRecord(key, NULL, 0u);
+}
+
+unsigned int SettingsStore_FreePageCount() {
+  return g_store.free_pages;
+}
+
+void SettingsStore_Tasks() {
+  if (!g_store.initialized) {
+    return;
+  }
+
+  if (g_store.compact_offset ||
+      (g_store.free_pages <= SETTINGS_STORE_COMPACT_FREE_PAGES &&
+       g_store.oldest != g_store.head)) {
+    CompactRecord();
+  }
+}
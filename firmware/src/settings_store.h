@@ -0,0 +1,160 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * settings_store.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup settings_store Settings Store
+ * @brief A key / value store for persistent settings.
+ *
+ * The store is a log spread over a ring of flash pages. Each page starts with
+ * a header word containing a magic number and a sequence number, which is
+ * used to find the oldest and newest pages at boot.
+ *
+ * Setting a value appends a record to the newest page, nothing is ever
+ * modified in place. A record is a header word, containing the key, the
+ * length and a checksum of the data, followed by the data padded to a
+ * word boundary. A record with a length of 0 deletes the key.
+ *
+ * At initialization the pages are scanned from oldest to newest to build an
+ * index of the address of the current record for each key, after that lookups
+ * are O(1).
+ *
+ * When the number of free pages drops to SETTINGS_STORE_COMPACT_FREE_PAGES,
+ * SettingsStore_Tasks() starts compacting the oldest page, one record per
+ * call. Records that are still current are copied to the newest page and then
+ * the oldest page is erased. Since pages are used in a ring, each page is
+ * erased in turn, which spreads the wear evenly across the region.
+ *
+ * One free page is always held in reserve for compaction. If a write
+ * requires a new page and only the reserve is free, the oldest page is
+ * compacted synchronously.
+ *
+ * Erasing a page stalls the CPU for around 20ms, and writes stall it for the
+ * duration of each word. SettingsStore_Tasks() should only be called when
+ * the stall won't disrupt anything, e.g. when Transceiver_IsIdle() returns
+ * true. The synchronous compaction in SettingsStore_Set() doesn't have this
+ * protection, so the store should be sized so that background compaction
+ * keeps up.
+ *
+ * A record that was interrupted by a reset will fail the checksum check and
+ * is ignored.
+ *
+ * @addtogroup settings_store
+ * @{
+ * @file settings_store.h
+ * @brief A log structured, wear levelled key / value store in flash.
+ */
+
+#ifndef FIRMWARE_SRC_SETTINGS_STORE_H_
+#define FIRMWARE_SRC_SETTINGS_STORE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The number of keys, keys are from 0 to SETTINGS_STORE_MAX_KEYS - 1.
+ */
+enum { SETTINGS_STORE_MAX_KEYS = 32 };
+
+/**
+ * @brief The maximum size of a value.
+ */
+enum { SETTINGS_STORE_MAX_VALUE_SIZE = 64 };
+
+/**
+ * @brief Background compaction starts when this many pages are free.
+ */
+enum { SETTINGS_STORE_COMPACT_FREE_PAGES = 2 };
+
+/**
+ * @brief The flash region to use for the store.
+ *
+ * The region must not be used by anything else. The current values of all
+ * keys must fit in page_count - 2 pages.
+ */
+typedef struct {
+  uint32_t base_address;  //!< The address of the first page.
+  uint32_t page_size;  //!< The size of a flash page in bytes.
+  uint8_t page_count;  //!< The number of pages, must be at least 3.
+} SettingsStoreConfiguration;
+
+/**
+ * @brief Initialize the settings store.
+ * @param config The flash region to use.
+ * @returns true if the store was initialized, false if the configuration was
+ *   invalid or the flash couldn't be erased.
+ *
+ * Pages that don't have a valid header are erased.
+ */
+bool SettingsStore_Initialize(const SettingsStoreConfiguration *config);
+
+/**
+ * @brief Get the value for a key.
+ * @param key The key to look up.
+ * @param[out] data The buffer to copy the value into.
+ * @param[in,out] length The size of the buffer, updated with the length of the
+ *   value.
+ * @returns true if the key was found and fit in the buffer, false otherwise.
+ */
+bool SettingsStore_Get(uint8_t key, uint8_t *data, unsigned int *length);
+
+/**
+ * @brief Set the value for a key.
+ * @param key The key to set.
+ * @param data The value.
+ * @param length The length of the value, from 1 to
+ *   SETTINGS_STORE_MAX_VALUE_SIZE.
+ * @returns true if the value was stored, false otherwise.
+ *
+ * If the value is the same as the current value, nothing is written.
+ */
+bool SettingsStore_Set(uint8_t key, const uint8_t *data, unsigned int length);
+
+/**
+ * @brief Delete a key.
+ * @param key The key to delete.
+ * @returns true if the key was deleted or didn't exist, false otherwise.
+ */
+bool SettingsStore_Delete(uint8_t key);
+
+/**
+ * @brief Return the number of erased pages available.
+ */
+unsigned int SettingsStore_FreePageCount();
+
+/**
+ * @brief Perform the periodic tasks.
+ *
+ * This should be called from the main event loop, when the CPU can be
+ * stalled for a page erase. It performs background compaction.
+ */
+void SettingsStore_Tasks();
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_SETTINGS_STORE_H_
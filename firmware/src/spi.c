@@ -20,143 +20,258 @@
 #include "spi.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "system/int/sys_int.h"
+#include "peripheral/dma/plib_dma.h"
 #include "peripheral/spi/plib_spi.h"
 #include "sys/attribs.h"
+#include "spi_dma.h"
+#include "stats.h"
 #include "system_config.h"
 
 #define MY_SPI SPI_ID_2
 
 /*
- * @brief The number of slots for transfers.
+ * @brief The DMA channels used for transmit.
+ *
+ * Channel 0 is reserved for the pixel output. The channels must be adjacent so
+ * they can be chained to each other.
  */
-enum { TRANSFER_SLOTS = 2 };
+#define TX_DMA_CHANNEL_A DMA_CHANNEL_1
+#define TX_DMA_CHANNEL_B DMA_CHANNEL_2
+
+/*
+ * @brief The largest block a DMA channel can move.
+ */
+enum { MAX_DMA_BLOCK_SIZE = 0xffffu };
 
 typedef enum {
-  FREE,  // transfer slot is empty
-  QUEUED,  // transfer is queued, but not being sent.
-  IN_TRANSFER,
-  DRAINING,
-  COMPLETE
+  IDLE,  // No transfer is active.
+  IN_TRANSFER,  // The DMA is moving data into the SPI buffer.
+  DRAINING,  // All data is in the SPI buffer, waiting for it to be sent.
+  COMPLETE  // The transfer is complete, waiting for SPI_Tasks().
 } TransferState;
 
 typedef struct {
-  const uint8_t *output;
-  unsigned int output_remaining;
-  unsigned int extra_zeros_to_send;
-  uint8_t *input;
-  unsigned int skip_input_bytes;
-  unsigned int input_remaining;
-  TransferState state;
+  SPISegment segments[SPI_MAX_SEGMENTS];
+  uint8_t segment_count;
   SPI_Callback callback;
 } Transfer;
 
-Transfer g_transfers[TRANSFER_SLOTS];
+/*
+ * @brief The state of the active transfer.
+ */
+typedef struct {
+  TransferState state;
+  uint8_t tx_segment;  // The segment of the next DMA block.
+  unsigned int tx_offset;  // The offset within tx_segment.
+  uint8_t blocks_pending;  // DMA blocks that have been loaded but not sent.
+  uint8_t rx_segment;
+  unsigned int rx_offset;
+  unsigned int rx_remaining;  // Bytes until the end of the last input segment.
+} ActiveTransfer;
+
+// The ring of queued transfers. The transfer at g_queue_head is the active
+// one. Only SPI_Tasks() and the queue functions modify the ring.
+static Transfer g_queue[SPI_TRANSFER_QUEUE_SIZE];
+static uint8_t g_queue_head = 0u;
+static uint8_t g_queue_count = 0u;
+static StatsCounter g_queue_full;
 
-// The index of the active transfer, or -1 if no transfers are active.
-int g_active_transfer = -1;
+static ActiveTransfer g_active;
 
 // Helper methods
 // -----------------------------------------------------------------------------
-static void PickNextTransfer() {
-  unsigned int i = 0;
-  for (; i < TRANSFER_SLOTS; i++) {
-    if (g_transfers[i].state == QUEUED) {
-      g_active_transfer = i;
-      break;
-    }
+
+/*
+ * @brief Load the next block of the active transfer into a DMA channel.
+ * @param channel The DMA channel to load.
+ * @returns true if a block was loaded, false if there are no more blocks.
+ */
+static bool LoadNextBlock(DMA_CHANNEL channel) {
+  const Transfer *transfer = &g_queue[g_queue_head];
+  while (g_active.tx_segment < transfer->segment_count &&
+         g_active.tx_offset ==
+             transfer->segments[g_active.tx_segment].length) {
+    g_active.tx_segment++;
+    g_active.tx_offset = 0u;
+  }
+  if (g_active.tx_segment == transfer->segment_count) {
+    return false;
   }
-}
 
-static void QueueBytes(Transfer *transfer) {
-  while (true) {
-    if (PLIB_SPI_TransmitBufferIsFull(MY_SPI)) {
-      return;
-    }
-    uint8_t data = 0;
-    if (transfer->output_remaining) {
-      data = *transfer->output;
-      transfer->output++;
-      transfer->output_remaining--;
-    } else if (transfer->extra_zeros_to_send) {
-      transfer->extra_zeros_to_send--;
-    } else {
-      // Switch to drain mode
-      PLIB_SPI_FIFOInterruptModeSelect(
-          MY_SPI,
-          SPI_FIFO_INTERRUPT_WHEN_TRANSMISSION_IS_COMPLETE);
-      transfer->state = DRAINING;
-      return;
-    }
-    PLIB_SPI_BufferWrite(MY_SPI, data);
+  const SPISegment *segment = &transfer->segments[g_active.tx_segment];
+  unsigned int length = segment->length - g_active.tx_offset;
+  if (length > MAX_DMA_BLOCK_SIZE) {
+    length = MAX_DMA_BLOCK_SIZE;
   }
+  // Input-only segments send from the zeroed input buffer.
+  const uint8_t *source = segment->output ? segment->output : segment->input;
+
+  SPIDMA_LoadBlock(channel, source + g_active.tx_offset, length);
+  g_active.tx_offset += length;
+  g_active.blocks_pending++;
+  return true;
 }
 
-static void ReadBytes(Transfer *transfer) {
+static void ReadBytes() {
+  const Transfer *transfer = &g_queue[g_queue_head];
   while (!PLIB_SPI_ReceiverFIFOIsEmpty(MY_SPI)) {
     uint8_t data = PLIB_SPI_BufferRead(MY_SPI);
-    if (transfer->skip_input_bytes) {
-      transfer->skip_input_bytes--;
-    } else {
-      if (transfer->input_remaining) {
-        *transfer->input = data;
-        transfer->input++;
-        transfer->input_remaining--;
-      }
-      if (transfer->input_remaining == 0) {
-        SYS_INT_SourceDisable(INT_SOURCE_SPI_2_RECEIVE);
-      }
+    if (g_active.rx_remaining == 0u) {
+      continue;
     }
+
+    while (g_active.rx_offset ==
+           transfer->segments[g_active.rx_segment].length) {
+      g_active.rx_segment++;
+      g_active.rx_offset = 0u;
+    }
+    uint8_t *input = transfer->segments[g_active.rx_segment].input;
+    if (input) {
+      input[g_active.rx_offset] = data;
+    }
+    g_active.rx_offset++;
+    g_active.rx_remaining--;
+    if (g_active.rx_remaining == 0u) {
+      SYS_INT_SourceDisable(INT_SOURCE_SPI_2_RECEIVE);
+    }
+  }
+}
+
+/*
+ * @brief Called when a DMA channel completes a block.
+ * @param channel The channel that completed.
+ *
+ * The other channel has already been enabled by the chain, so this channel is
+ * now idle and can be loaded with the block after that.
+ */
+static void BlockComplete(DMA_CHANNEL channel) {
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0, channel,
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  if (g_active.state != IN_TRANSFER) {
+    return;
+  }
+
+  g_active.blocks_pending--;
+  if (g_active.blocks_pending == 0u) {
+    // All data is in the SPI buffer, wait for it to be sent.
+    g_active.state = DRAINING;
+    PLIB_SPI_FIFOInterruptModeSelect(
+        MY_SPI,
+        SPI_FIFO_INTERRUPT_WHEN_TRANSMISSION_IS_COMPLETE);
+    SYS_INT_SourceStatusClear(INT_SOURCE_SPI_2_TRANSMIT);
+    SYS_INT_SourceEnable(INT_SOURCE_SPI_2_TRANSMIT);
+    return;
+  }
+
+  if (LoadNextBlock(channel)) {
+    PLIB_DMA_ChannelXChainEnable(DMA_ID_0, channel);
+  } else {
+    PLIB_DMA_ChannelXChainDisable(DMA_ID_0, channel);
   }
 }
 
 void __ISR(_SPI_2_VECTOR, ipl3AUTO) SPI_Event() {
-  if (g_active_transfer < 0) {
+  if (g_active.state == IDLE) {
     return;
   }
-  Transfer *transfer = &g_transfers[g_active_transfer];
 
-  if (SYS_INT_SourceStatusGet(INT_SOURCE_SPI_2_TRANSMIT)) {
-    if (transfer->state == DRAINING) {
-      transfer->state = COMPLETE;
-      SYS_INT_SourceDisable(INT_SOURCE_SPI_2_TRANSMIT);
-    } else {
-      QueueBytes(transfer);
-    }
+  // While the DMA is running, the transmit flag is used to trigger the DMA,
+  // so it's only handled here once we're draining.
+  if (g_active.state == DRAINING &&
+      SYS_INT_SourceStatusGet(INT_SOURCE_SPI_2_TRANSMIT)) {
+    g_active.state = COMPLETE;
+    SYS_INT_SourceDisable(INT_SOURCE_SPI_2_TRANSMIT);
     SYS_INT_SourceStatusClear(INT_SOURCE_SPI_2_TRANSMIT);
   }
 
   if (SYS_INT_SourceStatusGet(INT_SOURCE_SPI_2_RECEIVE)) {
-    ReadBytes(transfer);
+    ReadBytes();
     SYS_INT_SourceStatusClear(INT_SOURCE_SPI_2_RECEIVE);
   }
 }
 
-static void StartTransfer(Transfer *transfer) {
-  if (transfer->output_remaining == 0 && transfer->input_remaining == 0) {
-    transfer->state = FREE;
-    transfer->callback(SPI_COMPLETE_TRANSFER);
+void __ISR(_DMA_1_VECTOR, ipl3AUTO) SPI_DMAEventA() {
+  BlockComplete(TX_DMA_CHANNEL_A);
+  SYS_INT_SourceStatusClear(INT_SOURCE_DMA_1);
+}
+
+void __ISR(_DMA_2_VECTOR, ipl3AUTO) SPI_DMAEventB() {
+  BlockComplete(TX_DMA_CHANNEL_B);
+  SYS_INT_SourceStatusClear(INT_SOURCE_DMA_2);
+}
+
+static void PopTransfer(SPIEventType event) {
+  SPI_Callback callback = g_queue[g_queue_head].callback;
+  g_queue_head = (g_queue_head + 1u) % SPI_TRANSFER_QUEUE_SIZE;
+  g_queue_count--;
+  callback(event);
+}
+
+static void StartTransfer() {
+  Transfer *transfer = &g_queue[g_queue_head];
+  unsigned int total_length = 0u;
+  unsigned int input_end = 0u;
+  unsigned int i = 0u;
+  for (; i < transfer->segment_count; i++) {
+    SPISegment *segment = &transfer->segments[i];
+    total_length += segment->length;
+    if (segment->input) {
+      if (!segment->output) {
+        memset(segment->input, 0, segment->length);
+      }
+      input_end = total_length;
+    }
+  }
+
+  if (total_length == 0u) {
+    PopTransfer(SPI_COMPLETE_TRANSFER);
     return;
   }
 
   PLIB_SPI_BufferClear(MY_SPI);
   transfer->callback(SPI_BEGIN_TRANSFER);
 
-  transfer->state = IN_TRANSFER;
+  g_active.state = IN_TRANSFER;
+  g_active.tx_segment = 0u;
+  g_active.tx_offset = 0u;
+  g_active.blocks_pending = 0u;
+  g_active.rx_segment = 0u;
+  g_active.rx_offset = 0u;
+  g_active.rx_remaining = input_end;
+
   PLIB_SPI_FIFOInterruptModeSelect(
       MY_SPI,
-      SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_1HALF_EMPTY_OR_MORE);
-
+      SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_NOT_FULL);
   PLIB_SPI_Enable(MY_SPI);
-  QueueBytes(transfer);
 
-  SYS_INT_SourceStatusClear(INT_SOURCE_SPI_2_TRANSMIT);
-  SYS_INT_SourceEnable(INT_SOURCE_SPI_2_TRANSMIT);
-  if (transfer->input_remaining) {
+  if (g_active.rx_remaining) {
     SYS_INT_SourceStatusClear(INT_SOURCE_SPI_2_RECEIVE);
     SYS_INT_SourceEnable(INT_SOURCE_SPI_2_RECEIVE);
   }
+
+  // Load the first two blocks, the second channel is enabled by the first one
+  // completing.
+  LoadNextBlock(TX_DMA_CHANNEL_A);
+  PLIB_DMA_ChannelXChainDisable(DMA_ID_0, TX_DMA_CHANNEL_A);
+  if (LoadNextBlock(TX_DMA_CHANNEL_B)) {
+    PLIB_DMA_ChannelXChainEnable(DMA_ID_0, TX_DMA_CHANNEL_B);
+  } else {
+    PLIB_DMA_ChannelXChainDisable(DMA_ID_0, TX_DMA_CHANNEL_B);
+  }
+
+  SPIDMA_StartTransmit(TX_DMA_CHANNEL_A);
+}
+
+static void ConfigureDMAChannel(DMA_CHANNEL channel) {
+  SPIDMA_ConfigureTransmit(channel, MY_SPI);
+  PLIB_DMA_ChannelXChainDisable(DMA_ID_0, channel);
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0, channel,
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  PLIB_DMA_ChannelXINTSourceEnable(DMA_ID_0, channel,
+                                   DMA_INT_BLOCK_TRANSFER_COMPLETE);
 }
 
 // Public functions
@@ -166,29 +281,52 @@ bool SPI_QueueTransfer(const uint8_t *output,
                        uint8_t *input,
                        unsigned int input_length,
                        SPI_Callback callback) {
-  Transfer *transfer = NULL;
-  unsigned int i = 0;
-  for (; i < TRANSFER_SLOTS; i++) {
-    if (g_transfers[i].state == FREE) {
-      transfer = &g_transfers[i];
-      break;
+  const SPISegment segments[] = {
+    {
+      .output = output,
+      .input = NULL,
+      .length = output ? output_length : 0u
+    },
+    {
+      .output = NULL,
+      .input = input,
+      .length = input ? input_length : 0u
     }
+  };
+  return SPI_QueueSegments(segments, 2u, callback);
+}
+
+bool SPI_QueueSegments(const SPISegment *segments,
+                       unsigned int segment_count,
+                       SPI_Callback callback) {
+  if (g_queue_count == SPI_TRANSFER_QUEUE_SIZE) {
+    Stats_Increment(&g_queue_full);
+    return false;
   }
-  if (!transfer) {
+  if (segment_count > SPI_MAX_SEGMENTS) {
     return false;
   }
 
-  transfer->state = QUEUED;
-  transfer->output = output;
-  transfer->output_remaining = output_length;
-  transfer->extra_zeros_to_send = input_length;
-  transfer->input = input;
-  transfer->input_remaining = input_length;
-  transfer->skip_input_bytes = output_length;
+  unsigned int i = 0u;
+  for (; i < segment_count; i++) {
+    if (segments[i].length && !segments[i].output && !segments[i].input) {
+      return false;
+    }
+  }
+
+  Transfer *transfer = &g_queue[
+      (g_queue_head + g_queue_count) % SPI_TRANSFER_QUEUE_SIZE];
+  memcpy(transfer->segments, segments, segment_count * sizeof(SPISegment));
+  transfer->segment_count = segment_count;
   transfer->callback = callback;
+  g_queue_count++;
   return true;
 }
 
+unsigned int SPI_QueuedTransfers() {
+  return g_queue_count;
+}
+
 void SPI_Initialize() {
   PLIB_SPI_BaudRateSet(MY_SPI, SYS_CLK_FREQ, 1000000u);
   PLIB_SPI_CommunicationWidthSelect(MY_SPI, SPI_COMMUNICATION_WIDTH_8BITS);
@@ -205,46 +343,40 @@ void SPI_Initialize() {
   SYS_INT_VectorPrioritySet(INT_VECTOR_SPI2, INT_PRIORITY_LEVEL3);
   SYS_INT_VectorSubprioritySet(INT_VECTOR_SPI2, INT_SUBPRIORITY_LEVEL0);
 
-  unsigned int i = 0;
-  for (; i < TRANSFER_SLOTS; i++) {
-    g_transfers[i].state = FREE;
-  }
-  g_active_transfer = -1;
+  // Each SPI transmit interrupt moves one byte into the SPI buffer. Channel A
+  // is enabled when channel B completes and vice versa.
+  PLIB_DMA_Enable(DMA_ID_0);
+  ConfigureDMAChannel(TX_DMA_CHANNEL_A);
+  ConfigureDMAChannel(TX_DMA_CHANNEL_B);
+  PLIB_DMA_ChannelXChainToLower(DMA_ID_0, TX_DMA_CHANNEL_A);
+  PLIB_DMA_ChannelXChainToHigher(DMA_ID_0, TX_DMA_CHANNEL_B);
+
+  SYS_INT_VectorPrioritySet(INT_VECTOR_DMA1, INT_PRIORITY_LEVEL3);
+  SYS_INT_VectorSubprioritySet(INT_VECTOR_DMA1, INT_SUBPRIORITY_LEVEL0);
+  SYS_INT_VectorPrioritySet(INT_VECTOR_DMA2, INT_PRIORITY_LEVEL3);
+  SYS_INT_VectorSubprioritySet(INT_VECTOR_DMA2, INT_SUBPRIORITY_LEVEL0);
+  SYS_INT_SourceStatusClear(INT_SOURCE_DMA_1);
+  SYS_INT_SourceEnable(INT_SOURCE_DMA_1);
+  SYS_INT_SourceStatusClear(INT_SOURCE_DMA_2);
+  SYS_INT_SourceEnable(INT_SOURCE_DMA_2);
+
+  g_queue_head = 0u;
+  g_queue_count = 0u;
+  g_active.state = IDLE;
+  Stats_AddCounter("spi.queue_full", &g_queue_full);
 }
 
 void SPI_Tasks() {
-  if (g_active_transfer < 0) {
-    unsigned int i = 0;
-    for (; i < TRANSFER_SLOTS; i++) {
-      if (g_transfers[i].state == QUEUED) {
-        g_active_transfer = i;
-        break;
-      }
-    }
+  if (g_active.state == COMPLETE) {
+    // Drain the RX buffer
+    ReadBytes();
+    PLIB_SPI_Disable(MY_SPI);
+    g_active.state = IDLE;
+    PopTransfer(SPI_COMPLETE_TRANSFER);
   }
 
-  if (g_active_transfer < 0) {
-    return;
-  }
-  Transfer *transfer = &g_transfers[g_active_transfer];
-
-  switch (transfer->state) {
-    case FREE:
-      return;
-    case QUEUED:
-      StartTransfer(transfer);
-      break;
-    case IN_TRANSFER:
-    case DRAINING:
-      break;
-    case COMPLETE:
-      // Drain the RX buffer
-      ReadBytes(transfer);
-      PLIB_SPI_Disable(MY_SPI);
-      transfer->state = FREE;
-      transfer->callback(SPI_COMPLETE_TRANSFER);
-      // Pick now so we don't starve the higher indices.
-      PickNextTransfer();
-      break;
+  // Start the next transfer straight away, so the bus isn't idle for a loop.
+  if (g_active.state == IDLE && g_queue_count) {
+    StartTransfer();
   }
 }
@@ -25,10 +25,21 @@
  * all clients use the same SPI configuration. If that isn't the case we'll
  * need to introduce client handles or something.
  *
- * Clients can queue an SPI transfer with the SPI_QueueTransfer() method. The
- * callback argument can be used to specify a callback to be run before and
- * after the transfer is performed. This callback can be used to set the
- * relevant chip-enable line.
+ * Clients can queue an SPI transfer with the SPI_QueueTransfer() or
+ * SPI_QueueSegments() methods. The callback argument can be used to specify a
+ * callback to be run before and after the transfer is performed. This
+ * callback can be used to set the relevant chip-enable line. Callbacks are
+ * always run from SPI_Tasks(), never from an ISR.
+ *
+ * Up to SPI_TRANSFER_QUEUE_SIZE transfers can be queued, they are performed in
+ * the order they were queued.
+ *
+ * A transfer is made up of one or more segments, which are sent back-to-back
+ * without releasing the chip-enable line. The transmit side is driven by two
+ * DMA channels that are chained to each other: while one channel sends a
+ * segment, the DMA ISR loads the next segment into the other channel, so there
+ * are no gaps between segments. The receive side is handled by the SPI
+ * receive ISR.
  *
  * @addtogroup spi
  * @{
@@ -42,10 +53,24 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "system_config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifndef SPI_TRANSFER_QUEUE_SIZE
+/**
+ * @brief The number of transfers that can be queued.
+ */
+#define SPI_TRANSFER_QUEUE_SIZE 4u
+#endif
+
+/**
+ * @brief The maximum number of segments in a single transfer.
+ */
+enum { SPI_MAX_SEGMENTS = 4 };
+
 /**
  * @brief SPI Event types.
  */
@@ -60,6 +85,21 @@ typedef enum {
  */
 typedef void (*SPI_Callback)(SPIEventType event);
 
+/**
+ * @brief A segment of an SPI transfer.
+ *
+ * If output is NULL, 0s are sent. If input is NULL the received data is
+ * discarded. At least one of output or input must be non-NULL.
+ *
+ * When output is NULL, the input buffer is zeroed and used as the source of
+ * the transmitted 0s.
+ */
+typedef struct {
+  const uint8_t *output;  //!< The data to send, may be NULL.
+  uint8_t *input;  //!< The location to store received data, may be NULL.
+  unsigned int length;  //!< The number of bytes in the segment.
+} SPISegment;
+
 /**
  * @brief Queue an SPI transfer.
  * @param output The output buffer to send, may be NULL.
@@ -74,13 +114,34 @@ typedef void (*SPI_Callback)(SPIEventType event);
  * stages are optional.
  *
  * The total number of bytes sent will be the sum of (output_length,
- * input_length).
+ * input_length). The length of a NULL buffer is ignored.
  */
 bool SPI_QueueTransfer(const uint8_t *output,
                        unsigned int output_length,
                        uint8_t *input,
                        unsigned int input_length,
                        SPI_Callback callback);
+
+/**
+ * @brief Queue a scatter-gather SPI transfer.
+ * @param segments The segments to transfer, the array is copied.
+ * @param segment_count The number of segments, at most SPI_MAX_SEGMENTS.
+ * @param callback The callback run prior and post this transfer.
+ * @returns True if the transfer was scheduled, false if the queue was full or
+ *   the segments were invalid.
+ *
+ * The buffers referenced by the segments must remain valid until the
+ * SPI_COMPLETE_TRANSFER event.
+ */
+bool SPI_QueueSegments(const SPISegment *segments,
+                       unsigned int segment_count,
+                       SPI_Callback callback);
+
+/**
+ * @brief Return the number of transfers that are queued or in progress.
+ */
+unsigned int SPI_QueuedTransfers();
+
 /**
  * @brief Initialize the SPI driver.
  */
@@ -0,0 +1,57 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * spi_dma.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "spi_dma.h"
+
+#include "sys/kmem.h"
+
+static DMA_TRIGGER_SOURCE TransmitTrigger(SPI_MODULE_ID module_id) {
+  switch (module_id) {
+    case SPI_ID_2:
+      return DMA_TRIGGER_SPI_2_TRANSMIT;
+    case SPI_ID_3:
+      return DMA_TRIGGER_SPI_3_TRANSMIT;
+    case SPI_ID_4:
+      return DMA_TRIGGER_SPI_4_TRANSMIT;
+    case SPI_ID_1:
+    default:
+      return DMA_TRIGGER_SPI_1_TRANSMIT;
+  }
+}
+
+void SPIDMA_ConfigureTransmit(DMA_CHANNEL channel, SPI_MODULE_ID module_id) {
+  PLIB_DMA_ChannelXTriggerEnable(DMA_ID_0, channel,
+                                 DMA_CHANNEL_TRIGGER_TRANSFER_START);
+  PLIB_DMA_ChannelXStartIRQSet(DMA_ID_0, channel, TransmitTrigger(module_id));
+  PLIB_DMA_ChannelXDestinationStartAddressSet(
+      DMA_ID_0, channel, KVA_TO_PA(PLIB_SPI_BufferAddressGet(module_id)));
+  PLIB_DMA_ChannelXDestinationSizeSet(DMA_ID_0, channel, 1u);
+  PLIB_DMA_ChannelXCellSizeSet(DMA_ID_0, channel, 1u);
+}
+
+void SPIDMA_LoadBlock(DMA_CHANNEL channel, const uint8_t *data,
+                      unsigned int length) {
+  PLIB_DMA_ChannelXSourceStartAddressSet(DMA_ID_0, channel, KVA_TO_PA(data));
+  PLIB_DMA_ChannelXSourceSizeSet(DMA_ID_0, channel, length);
+}
+
+void SPIDMA_StartTransmit(DMA_CHANNEL channel) {
+  PLIB_DMA_ChannelXEnable(DMA_ID_0, channel);
+  PLIB_DMA_StartTransferSet(DMA_ID_0, channel);
+}
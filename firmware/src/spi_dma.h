@@ -0,0 +1,79 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * spi_dma.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @addtogroup spi
+ * @{
+ * @file spi_dma.h
+ * @brief Drive an SPI transmit buffer from a DMA channel.
+ *
+ * This is shared by the SPI driver and the SPI RGB output. Each SPI transmit
+ * interrupt moves one byte from the DMA source block into the SPI buffer.
+ */
+
+#ifndef FIRMWARE_SRC_SPI_DMA_H_
+#define FIRMWARE_SRC_SPI_DMA_H_
+
+#include <stdint.h>
+
+#include "system_config.h"
+#include "peripheral/dma/plib_dma.h"
+#include "peripheral/spi/plib_spi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Configure a DMA channel to feed the transmit buffer of an SPI module.
+ * @param channel The DMA channel to configure.
+ * @param module_id The SPI module to transmit on.
+ *
+ * PLIB_DMA_Enable() must have been called.
+ */
+void SPIDMA_ConfigureTransmit(DMA_CHANNEL channel, SPI_MODULE_ID module_id);
+
+/**
+ * @brief Set the block a DMA channel will transmit.
+ * @param channel The DMA channel.
+ * @param data The data to send, this must remain valid until the block
+ *   completes.
+ * @param length The number of bytes to send, at most 0xffff.
+ */
+void SPIDMA_LoadBlock(DMA_CHANNEL channel, const uint8_t *data,
+                      unsigned int length);
+
+/**
+ * @brief Enable a DMA channel and start the transmit.
+ * @param channel The DMA channel, which must have a block loaded.
+ *
+ * The SPI transmit buffer is already empty, so there won't be an interrupt to
+ * start the transfer. This forces the first cell.
+ */
+void SPIDMA_StartTransmit(DMA_CHANNEL channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_SPI_DMA_H_
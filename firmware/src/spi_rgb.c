@@ -21,34 +21,285 @@
 
 #include <string.h>
 
+#include "coarse_timer.h"
+#include "gamma_tables.h"
+#include "peripheral/dma/plib_dma.h"
 #include "peripheral/spi/plib_spi.h"
+#include "spi_dma.h"
 #include "syslog.h"
 
-// TODO(simon): move these into the config (and set with RDM?)
+enum { DEFAULT_PIXEL_COUNT = 2u };
+enum { SLOTS_PER_PIXEL = 3u };
+
+/*
+ * The largest encoding is the APA102: a 4 byte start frame, 4 bytes per pixel
+ * and an end frame of one bit per 2 pixels.
+ */
+enum {
+  TX_BUFFER_SIZE = 4u + 4u * SPIRGB_MAX_PIXEL_COUNT +
+                   (SPIRGB_MAX_PIXEL_COUNT + 15u) / 16u
+};
+
 static const uint8_t LPD8806_PIXEL_BYTE = 0x80u;
+static const uint8_t APA102_PIXEL_BYTE = 0xffu;
 
-enum { LATCH_BYTES = 1u };
-enum { PIXEL_COUNT = 2u };
-enum { SLOTS_PER_PIXEL = 3u };
+// The lookup tables are 16 bits, these drop them to the chip's bit depth.
+enum { SHIFT_7_BIT = 9u };
+enum { SHIFT_8_BIT = 8u };
+
+/*
+ * The WS2801 latches once the clock has been idle for 500uS, in 10ths of a
+ * millisecond.
+ */
+enum { WS2801_LATCH_TIME = 5u };
+
+/*
+ * @brief The color correction state used while encoding.
+ */
+typedef struct {
+  uint16_t lut[SLOTS_PER_PIXEL][GAMMA_TABLE_SIZE];
+  // The truncated bits of each slot from the last frame, or NULL if dithering
+  // is disabled.
+  uint16_t *residuals;
+} ColorCorrection;
+
+/*
+ * @brief Encode the framebuffer into the wire format.
+ * @param pixels The RGB framebuffer.
+ * @param count The number of pixels.
+ * @param correction The color correction to apply.
+ * @param output The buffer to encode into, at least TX_BUFFER_SIZE bytes.
+ * @returns The number of bytes to send.
+ */
+typedef uint16_t (*PixelEncoder)(const uint8_t *pixels, uint16_t count,
+                                 const ColorCorrection *correction,
+                                 uint8_t *output);
 
 typedef struct {
   SPI_MODULE_ID module_id;
+  DMA_CHANNEL dma_channel;
   bool use_enhanced_buffering;
+  bool use_dma;
   bool in_update;
-  uint32_t tx_index;
-  uint8_t pixels[SLOTS_PER_PIXEL * PIXEL_COUNT + LATCH_BYTES];
+  bool dirty;  // The framebuffer has changed since it was last encoded.
+  bool dma_active;
+  bool clock_idle;  // The last frame has been shifted out.
+  SPIRGB_PixelType pixel_type;
+  const uint16_t *gamma_curve;  // NULL for linear.
+  uint8_t white_balance[SLOTS_PER_PIXEL];
+  uint16_t pixel_count;
+  uint16_t tx_index;
+  uint16_t tx_length;
+  uint16_t latch_time;  // The idle time the last frame still needs.
+  CoarseTimer_Value idle_start;
+  uint8_t pixels[SLOTS_PER_PIXEL * SPIRGB_MAX_PIXEL_COUNT];
+  uint16_t residuals[SLOTS_PER_PIXEL * SPIRGB_MAX_PIXEL_COUNT];
+  uint8_t tx_buffer[TX_BUFFER_SIZE];
+  ColorCorrection correction;
 } SPIState;
 
 static SPIState g_spi;
 
+/*
+ * @brief Correct a slot and reduce it to the chip's bit depth.
+ * @param correction The color correction to apply.
+ * @param color The color of the slot.
+ * @param slot The slot index, used to find the dither residual.
+ * @param value The raw slot value.
+ * @param shift The number of bits to drop from the 16 bit corrected value.
+ */
+static inline uint8_t CorrectSlot(const ColorCorrection *correction,
+                                  RGB_Color color, unsigned int slot,
+                                  uint8_t value, unsigned int shift) {
+  uint32_t level = correction->lut[color][value];
+  if (correction->residuals) {
+    level += correction->residuals[slot];
+    if (level > UINT16_MAX) {
+      level = UINT16_MAX;
+    }
+    correction->residuals[slot] = level & ((1u << shift) - 1u);
+  }
+  return level >> shift;
+}
+
+/*
+ * @brief GRB order, 7 bits per color with the high bit set.
+ *
+ * Zero bytes reset the chips' data pointers, one is needed for every 32
+ * pixels.
+ */
+static uint16_t EncodeLPD8806(const uint8_t *pixels, uint16_t count,
+                              const ColorCorrection *correction,
+                              uint8_t *output) {
+  uint8_t *ptr = output;
+  unsigned int slot = 0u;
+  for (; slot != SLOTS_PER_PIXEL * count; slot += SLOTS_PER_PIXEL) {
+    *ptr++ = LPD8806_PIXEL_BYTE |
+             CorrectSlot(correction, GREEN, slot + GREEN,
+                         pixels[slot + GREEN], SHIFT_7_BIT);
+    *ptr++ = LPD8806_PIXEL_BYTE |
+             CorrectSlot(correction, RED, slot + RED, pixels[slot + RED],
+                         SHIFT_7_BIT);
+    *ptr++ = LPD8806_PIXEL_BYTE |
+             CorrectSlot(correction, BLUE, slot + BLUE, pixels[slot + BLUE],
+                         SHIFT_7_BIT);
+  }
+  const uint16_t latch_bytes = (count + 31u) / 32u;
+  memset(ptr, 0, latch_bytes);
+  return ptr - output + latch_bytes;
+}
+
+/*
+ * @brief RGB order, 8 bits per color.
+ *
+ * The WS2801 latches once the clock has been idle for 500uS, so there are no
+ * extra bytes.
+ */
+static uint16_t EncodeWS2801(const uint8_t *pixels, uint16_t count,
+                             const ColorCorrection *correction,
+                             uint8_t *output) {
+  unsigned int slot = 0u;
+  for (; slot != SLOTS_PER_PIXEL * count; slot += SLOTS_PER_PIXEL) {
+    output[slot + RED] = CorrectSlot(correction, RED, slot + RED,
+                                     pixels[slot + RED], SHIFT_8_BIT);
+    output[slot + GREEN] = CorrectSlot(correction, GREEN, slot + GREEN,
+                                       pixels[slot + GREEN], SHIFT_8_BIT);
+    output[slot + BLUE] = CorrectSlot(correction, BLUE, slot + BLUE,
+                                      pixels[slot + BLUE], SHIFT_8_BIT);
+  }
+  return SLOTS_PER_PIXEL * count;
+}
+
+/*
+ * @brief A zero start frame, then a brightness byte and BGR per pixel.
+ *
+ * The data is delayed by half a clock at each pixel, so the end frame needs
+ * at least count / 2 bits to push the data to the end of the strip.
+ */
+static uint16_t EncodeAPA102(const uint8_t *pixels, uint16_t count,
+                             const ColorCorrection *correction,
+                             uint8_t *output) {
+  uint8_t *ptr = output;
+  memset(ptr, 0, 4u);
+  ptr += 4u;
+  unsigned int slot = 0u;
+  for (; slot != SLOTS_PER_PIXEL * count; slot += SLOTS_PER_PIXEL) {
+    *ptr++ = APA102_PIXEL_BYTE;
+    *ptr++ = CorrectSlot(correction, BLUE, slot + BLUE, pixels[slot + BLUE],
+                         SHIFT_8_BIT);
+    *ptr++ = CorrectSlot(correction, GREEN, slot + GREEN,
+                         pixels[slot + GREEN], SHIFT_8_BIT);
+    *ptr++ = CorrectSlot(correction, RED, slot + RED, pixels[slot + RED],
+                         SHIFT_8_BIT);
+  }
+  const uint16_t end_bytes = (count + 15u) / 16u;
+  memset(ptr, 0, end_bytes);
+  return ptr - output + end_bytes;
+}
+
+typedef struct {
+  PixelEncoder encode;
+  // The time the clock must be idle after a frame, in 10ths of a millisecond.
+  uint16_t latch_time;
+} PixelEncoding;
+
+// Indexed by SPIRGB_PixelType.
+static const PixelEncoding ENCODINGS[] = {
+  {EncodeLPD8806, 0u},
+  {EncodeWS2801, WS2801_LATCH_TIME},
+  {EncodeAPA102, 0u}
+};
+
+/*
+ * @brief Rebuild the lookup tables from the gamma curve and white balance.
+ */
+static void BuildLookupTables() {
+  unsigned int color = 0u;
+  for (; color < SLOTS_PER_PIXEL; color++) {
+    const uint32_t scale = g_spi.white_balance[color];
+    uint16_t *lut = g_spi.correction.lut[color];
+    unsigned int i = 0u;
+    for (; i < GAMMA_TABLE_SIZE; i++) {
+      // 257 maps 0 - 255 onto 0 - 65535.
+      const uint32_t level = g_spi.gamma_curve ? g_spi.gamma_curve[i] :
+                             i * 257u;
+      lut[i] = level * scale / UINT8_MAX;
+    }
+  }
+  g_spi.dirty = true;
+}
+
+/*
+ * @brief Write as much of the transmit buffer to the SPI module as we can.
+ * @returns true if the buffer has been sent.
+ */
+static bool WriteBuffer() {
+  while (g_spi.tx_index < g_spi.tx_length) {
+    if (g_spi.use_enhanced_buffering) {
+      if (PLIB_SPI_TransmitBufferIsFull(g_spi.module_id)) {
+        return false;
+      }
+    } else if (PLIB_SPI_IsBusy(g_spi.module_id)) {
+      return false;
+    }
+    PLIB_SPI_BufferWrite(g_spi.module_id, g_spi.tx_buffer[g_spi.tx_index]);
+    g_spi.tx_index++;
+  }
+  return true;
+}
+
+/*
+ * @brief Check if the chips have latched the last frame.
+ * @returns true if the next frame can be sent.
+ *
+ * This must only be called once the transmit buffer has been handed to the SPI
+ * module.
+ */
+static bool HasLatched() {
+  if (g_spi.latch_time == 0u) {
+    return true;
+  }
+  if (!g_spi.clock_idle) {
+    if (PLIB_SPI_IsBusy(g_spi.module_id)) {
+      return false;
+    }
+    g_spi.clock_idle = true;
+    g_spi.idle_start = CoarseTimer_GetTime();
+  }
+  if (!CoarseTimer_HasElapsed(g_spi.idle_start, g_spi.latch_time)) {
+    return false;
+  }
+  g_spi.latch_time = 0u;
+  return true;
+}
+
+static void StartDMATransfer() {
+  SPIDMA_LoadBlock(g_spi.dma_channel, g_spi.tx_buffer, g_spi.tx_length);
+  g_spi.dma_active = true;
+  SPIDMA_StartTransmit(g_spi.dma_channel);
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
 void SPIRGB_Init(const SPIRGBConfiguration *config) {
   g_spi.module_id = config->module_id;
+  g_spi.dma_channel = config->dma_channel;
   g_spi.use_enhanced_buffering = config->use_enhanced_buffering;
+  g_spi.use_dma = config->use_dma;
   g_spi.in_update = false;
+  g_spi.dirty = true;
+  g_spi.dma_active = false;
+  g_spi.pixel_type = SPIRGB_PIXEL_LPD8806;
+  g_spi.pixel_count = DEFAULT_PIXEL_COUNT;
+  g_spi.gamma_curve = NULL;
+  memset(g_spi.white_balance, UINT8_MAX, sizeof(g_spi.white_balance));
+  g_spi.correction.residuals = NULL;
+  BuildLookupTables();
   g_spi.tx_index = 0u;
-
-  memset(g_spi.pixels, LPD8806_PIXEL_BYTE, SLOTS_PER_PIXEL * PIXEL_COUNT);
-  memset(&g_spi.pixels[SLOTS_PER_PIXEL * PIXEL_COUNT], 0, LATCH_BYTES);
+  g_spi.tx_length = 0u;
+  g_spi.latch_time = 0u;
+  g_spi.clock_idle = true;
+  memset(g_spi.pixels, 0, sizeof(g_spi.pixels));
 
   // Init the SPI hardware.
   PLIB_SPI_BaudRateSet(g_spi.module_id, SYS_CLK_FREQ, config->baud_rate);
@@ -57,11 +308,75 @@ void SPIRGB_Init(const SPIRGBConfiguration *config) {
   PLIB_SPI_ClockPolaritySelect(g_spi.module_id, SPI_CLOCK_POLARITY_IDLE_HIGH);
   if (g_spi.use_enhanced_buffering) {
     PLIB_SPI_FIFOEnable(g_spi.module_id);
+    if (g_spi.use_dma) {
+      PLIB_SPI_FIFOInterruptModeSelect(
+          g_spi.module_id, SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_NOT_FULL);
+    }
   }
   PLIB_SPI_SlaveSelectDisable(g_spi.module_id);
   PLIB_SPI_PinDisable(g_spi.module_id, SPI_PIN_SLAVE_SELECT);
   PLIB_SPI_MasterEnable(g_spi.module_id);
   PLIB_SPI_Enable(g_spi.module_id);
+
+  if (g_spi.use_dma) {
+    // Each SPI transmit interrupt moves one byte into the SPI buffer.
+    PLIB_DMA_Enable(DMA_ID_0);
+    SPIDMA_ConfigureTransmit(g_spi.dma_channel, g_spi.module_id);
+  }
+}
+
+void SPIRGB_SetPixelType(SPIRGB_PixelType type) {
+  if (type > SPIRGB_PIXEL_APA102) {
+    return;
+  }
+  g_spi.pixel_type = type;
+  g_spi.dirty = true;
+}
+
+void SPIRGB_SetGamma(SPIRGB_Gamma gamma) {
+  switch (gamma) {
+    case SPIRGB_GAMMA_LINEAR:
+      SPIRGB_SetGammaCurve(NULL);
+      break;
+    case SPIRGB_GAMMA_2_2:
+      SPIRGB_SetGammaCurve(GAMMA_2_2);
+      break;
+    case SPIRGB_GAMMA_2_8:
+      SPIRGB_SetGammaCurve(GAMMA_2_8);
+      break;
+  }
+}
+
+void SPIRGB_SetGammaCurve(const uint16_t *curve) {
+  g_spi.gamma_curve = curve;
+  BuildLookupTables();
+}
+
+void SPIRGB_SetWhiteBalance(uint8_t red, uint8_t green, uint8_t blue) {
+  g_spi.white_balance[RED] = red;
+  g_spi.white_balance[GREEN] = green;
+  g_spi.white_balance[BLUE] = blue;
+  BuildLookupTables();
+}
+
+void SPIRGB_SetDithering(bool enable) {
+  if (enable) {
+    memset(g_spi.residuals, 0, sizeof(g_spi.residuals));
+    g_spi.correction.residuals = g_spi.residuals;
+  } else {
+    g_spi.correction.residuals = NULL;
+  }
+  g_spi.dirty = true;
+}
+
+void SPIRGB_SetPixelCount(uint16_t count) {
+  g_spi.pixel_count = count > SPIRGB_MAX_PIXEL_COUNT ?
+      SPIRGB_MAX_PIXEL_COUNT : count;
+  g_spi.dirty = true;
+}
+
+uint16_t SPIRGB_PixelCount() {
+  return g_spi.pixel_count;
 }
 
 void SPIRGB_BeginUpdate() {
@@ -69,45 +384,67 @@ void SPIRGB_BeginUpdate() {
 }
 
 void SPIRGB_SetPixel(uint16_t index, RGB_Color color, uint8_t value) {
-  if (index >= PIXEL_COUNT || !g_spi.in_update) {
+  if (index >= g_spi.pixel_count || !g_spi.in_update) {
     return;
   }
-  // Map RGB to GRB
-  uint8_t color_offset = 0u;
-  switch (color) {
-    case RED:
-      color_offset = 1u;
-      break;
-    case GREEN:
-      color_offset = 0u;
-      break;
-    case BLUE:
-      color_offset = 2u;
-      break;
-    }
-  g_spi.pixels[index * SLOTS_PER_PIXEL + color_offset] =
-      LPD8806_PIXEL_BYTE | value >> 1;
+  g_spi.pixels[index * SLOTS_PER_PIXEL + color] = value;
+}
+
+void SPIRGB_SetPixels(uint16_t index, const uint8_t *data, uint16_t count) {
+  if (index >= g_spi.pixel_count || !g_spi.in_update) {
+    return;
+  }
+  if (count > g_spi.pixel_count - index) {
+    count = g_spi.pixel_count - index;
+  }
+  memcpy(&g_spi.pixels[index * SLOTS_PER_PIXEL], data,
+         count * SLOTS_PER_PIXEL);
 }
 
 void SPIRGB_CompleteUpdate() {
   g_spi.in_update = false;
-  g_spi.tx_index = 0u;
+  g_spi.dirty = true;
 }
 
 void SPIRGB_Tasks() {
-  if (g_spi.in_update) {
-    return;
-  }
-
-  while (g_spi.tx_index < PIXEL_COUNT * SLOTS_PER_PIXEL + LATCH_BYTES) {
-    if (g_spi.use_enhanced_buffering) {
-      if (PLIB_SPI_TransmitBufferIsFull(g_spi.module_id)) {
+  // Finish sending the current frame before encoding the next one.
+  if (g_spi.use_dma) {
+    if (g_spi.dma_active) {
+      if (!PLIB_DMA_ChannelXINTSourceFlagGet(DMA_ID_0, g_spi.dma_channel,
+                                             DMA_INT_BLOCK_TRANSFER_COMPLETE)) {
         return;
       }
-    } else if (PLIB_SPI_IsBusy(g_spi.module_id)) {
-      return;
+      PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0, g_spi.dma_channel,
+                                          DMA_INT_BLOCK_TRANSFER_COMPLETE);
+      g_spi.dma_active = false;
     }
-    PLIB_SPI_BufferWrite(g_spi.module_id, g_spi.pixels[g_spi.tx_index]);
-    g_spi.tx_index++;
+  } else if (!WriteBuffer()) {
+    return;
+  }
+
+  // Check this even if there is nothing to send, so the idle time starts as
+  // soon as the last frame has been shifted out.
+  const bool latched = HasLatched();
+  if (g_spi.in_update || !g_spi.dirty || !latched) {
+    return;
+  }
+
+  const PixelEncoding *encoding = &ENCODINGS[g_spi.pixel_type];
+  g_spi.tx_length = encoding->encode(g_spi.pixels, g_spi.pixel_count,
+                                     &g_spi.correction, g_spi.tx_buffer);
+  g_spi.tx_index = 0u;
+  // With dithering, each frame carries the residuals to the next one.
+  g_spi.dirty = g_spi.correction.residuals != NULL;
+
+  if (g_spi.tx_length == 0u) {
+    return;
+  }
+  g_spi.latch_time = encoding->latch_time;
+  g_spi.clock_idle = false;
+
+  if (g_spi.use_dma) {
+    StartDMATransfer();
+  } else {
+    WriteBuffer();
   }
 }
@@ -21,8 +21,33 @@
  * @defgroup spi_dmx SPI Pixel Controller
  * @brief Control RGB Pixels using SPI
  *
- * This only supports the LPD8806 chip for now. We're happy to accept pull
- * requests adding support for different pixel types.
+ * The module holds a framebuffer of raw RGB values. When a frame update
+ * completes, the framebuffer is encoded into the wire format for the selected
+ * pixel chip and transmitted. Supported chips are the LPD8806, WS2801 and
+ * APA102. We're happy to accept pull requests adding support for different
+ * pixel types.
+ *
+ * The transmit buffer is either fed to the SPI module byte by byte from
+ * SPIRGB_Tasks(), or handed to a DMA channel which is triggered by the SPI
+ * transmit interrupt. With DMA the CPU only encodes the frame, so long strips
+ * don't starve the rest of the main loop.
+ *
+ * A new frame is not encoded until the previous one has been sent. Updates
+ * that complete while a frame is in flight are coalesced into the next frame.
+ *
+ * Color correction is applied while the frame is encoded. Each color has a
+ * 256 entry, 16 bit lookup table which combines the gamma curve and the white
+ * balance, so correction costs one table load per slot regardless of the
+ * curve. The tables are rebuilt when the gamma or white balance change.
+ *
+ * The lookup tables have more precision than the pixel chips. With temporal
+ * dithering enabled, the bits that are truncated from each slot are carried
+ * over to the next frame, and frames are sent continuously, so that the
+ * average output over several frames matches the corrected value.
+ *
+ * Chips that latch when the clock is idle, like the WS2801, need a gap between
+ * frames. The next frame isn't sent until the clock has been idle for the
+ * chip's latch time, so this also limits the dithering frame rate.
  *
  * @addtogroup spi_dmx
  * @{
@@ -39,8 +64,18 @@ extern "C" {
 #endif
 
 #include "system_config.h"
+#include "peripheral/dma/plib_dma.h"
 #include "peripheral/spi/plib_spi.h"
 
+#ifndef SPIRGB_MAX_PIXEL_COUNT
+/**
+ * @brief The maximum number of pixels.
+ *
+ * 170 RGB pixels fills a DMX universe.
+ */
+#define SPIRGB_MAX_PIXEL_COUNT 170u
+#endif
+
 /**
  * @brief RGB color values.
  */
@@ -50,6 +85,24 @@ typedef enum {
   BLUE = 2
 } RGB_Color;
 
+/**
+ * @brief The pixel chips supported.
+ */
+typedef enum {
+  SPIRGB_PIXEL_LPD8806,  //!< 7 bit GRB with a 0x80 flag, zero latch bytes.
+  SPIRGB_PIXEL_WS2801,  //!< 8 bit RGB, latched by holding the clock low.
+  SPIRGB_PIXEL_APA102  //!< Start frame, 0xff BGR per pixel, end frame.
+} SPIRGB_PixelType;
+
+/**
+ * @brief The built-in gamma curves.
+ */
+typedef enum {
+  SPIRGB_GAMMA_LINEAR,  //!< No gamma correction.
+  SPIRGB_GAMMA_2_2,  //!< A gamma of 2.2.
+  SPIRGB_GAMMA_2_8  //!< A gamma of 2.8.
+} SPIRGB_Gamma;
+
 /**
  * @brief SPI RGB Module configuration
  */
@@ -64,6 +117,12 @@ typedef struct {
    * normal mode there may be delays between bytes.
    */
   bool use_enhanced_buffering;
+
+  /**
+   * @brief Transmit using DMA rather than from SPIRGB_Tasks().
+   */
+  bool use_dma;
+  DMA_CHANNEL dma_channel;  //!< The DMA channel to use, if use_dma is true.
 } SPIRGBConfiguration;
 
 /**
@@ -72,6 +131,60 @@ typedef struct {
  */
 void SPIRGB_Init(const SPIRGBConfiguration *config);
 
+/**
+ * @brief Set the type of pixel chip.
+ * @param type The pixel type.
+ *
+ * The frame will be re-sent in the new format.
+ */
+void SPIRGB_SetPixelType(SPIRGB_PixelType type);
+
+/**
+ * @brief Set the number of pixels.
+ * @param count The number of pixels, this is limited to SPIRGB_MAX_PIXEL_COUNT.
+ *
+ * The frame will be re-sent with the new length.
+ */
+void SPIRGB_SetPixelCount(uint16_t count);
+
+/**
+ * @brief Get the number of pixels.
+ * @returns The number of pixels.
+ */
+uint16_t SPIRGB_PixelCount();
+
+/**
+ * @brief Select one of the built-in gamma curves.
+ * @param gamma The gamma curve to use.
+ *
+ * The default is SPIRGB_GAMMA_LINEAR.
+ */
+void SPIRGB_SetGamma(SPIRGB_Gamma gamma);
+
+/**
+ * @brief Use a custom gamma curve.
+ * @param curve A table of 256 16 bit output values, indexed by the DMX value.
+ *   This must remain valid until the curve is changed.
+ */
+void SPIRGB_SetGammaCurve(const uint16_t *curve);
+
+/**
+ * @brief Set the white balance.
+ * @param red The scale for the red channel, 255 is full output.
+ * @param green The scale for the green channel, 255 is full output.
+ * @param blue The scale for the blue channel, 255 is full output.
+ */
+void SPIRGB_SetWhiteBalance(uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * @brief Enable or disable temporal dithering.
+ * @param enable true to enable dithering.
+ *
+ * While dithering is enabled, frames are sent continuously, with a gap for
+ * chips that latch on clock idle.
+ */
+void SPIRGB_SetDithering(bool enable);
+
 /**
  * @brief Begin a frame update.
  *
@@ -87,6 +200,17 @@ void SPIRGB_BeginUpdate();
  */
 void SPIRGB_SetPixel(uint16_t index, RGB_Color color, uint8_t value);
 
+/**
+ * @brief Set the values for a range of pixels.
+ * @param index The offset of the first pixel.
+ * @param data The RGB values, 3 bytes per pixel.
+ * @param count The number of pixels to set.
+ *
+ * Like SPIRGB_SetPixel(), this only has an effect during an update. Pixels
+ * beyond the pixel count are ignored.
+ */
+void SPIRGB_SetPixels(uint16_t index, const uint8_t *data, uint16_t count);
+
 /**
  * @brief Complete a frame update.
  *
@@ -98,7 +222,8 @@ void SPIRGB_CompleteUpdate();
 /**
  * @brief Perform the periodic SPI RGB tasks.
  *
- * This should be called in the main event loop.
+ * This should be called in the main event loop. It uses the coarse timer to
+ * time the latch gap between frames.
  */
 void SPIRGB_Tasks();
 
@@ -0,0 +1,114 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * stack_monitor.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "stack_monitor.h"
+
+#include <stdint.h>
+
+/*
+ * @brief The value written to the unused stack.
+ */
+#define STACK_PAINT 0xdeadbeefu
+
+enum {
+  /*
+   * @brief The number of words below the stack pointer left alone by the
+   * painting, in case an ISR fires during StackMonitor_Initialize().
+   */
+  GUARD_WORDS = 128,
+
+  /*
+   * @brief The number of words to check on each call to StackMonitor_Tasks().
+   */
+  SCAN_WORDS = 32
+};
+
+typedef struct {
+  uint32_t *limit;
+  uint32_t *top;
+
+  /*
+   * @brief The lowest word known to be used.
+   */
+  uint32_t *watermark;
+
+  /*
+   * @brief The next word to check.
+   */
+  uint32_t *scan;
+} StackMonitorState;
+
+static StackMonitorState g_stack;
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void StackMonitor_Initialize(const StackMonitor_Settings *settings) {
+  g_stack.limit = settings->limit;
+  g_stack.top = settings->top;
+
+  // Don't paint over the frames which are live.
+  uintptr_t sp = (uintptr_t) __builtin_frame_address(0);
+  uintptr_t end = (uintptr_t) g_stack.top;
+  if (sp - GUARD_WORDS * sizeof(uint32_t) < end &&
+      sp > (uintptr_t) g_stack.limit + GUARD_WORDS * sizeof(uint32_t)) {
+    end = sp - GUARD_WORDS * sizeof(uint32_t);
+  }
+
+  uint32_t *ptr = g_stack.limit;
+  for (; (uintptr_t) ptr < end; ptr++) {
+    *((volatile uint32_t*) ptr) = STACK_PAINT;
+  }
+  g_stack.watermark = ptr;
+  g_stack.scan = g_stack.limit;
+}
+
+void StackMonitor_Tasks() {
+  if (g_stack.watermark == g_stack.limit) {
+    // The stack has reached the limit, there's nothing left to find.
+    return;
+  }
+
+  unsigned int i = 0u;
+  for (; i < SCAN_WORDS; i++) {
+    if (g_stack.scan == g_stack.watermark) {
+      // No new usage, start again at the bottom.
+      g_stack.scan = g_stack.limit;
+      return;
+    }
+    if (*((volatile uint32_t*) g_stack.scan) != STACK_PAINT) {
+      // The stack only grows down, so everything above this word is used.
+      g_stack.watermark = g_stack.scan;
+      g_stack.scan = g_stack.limit;
+      return;
+    }
+    g_stack.scan++;
+  }
+}
+
+uint32_t StackMonitor_StackSize() {
+  return (g_stack.top - g_stack.limit) * sizeof(uint32_t);
+}
+
+uint32_t StackMonitor_PeakUsage() {
+  return (g_stack.top - g_stack.watermark) * sizeof(uint32_t);
+}
+
+uint32_t StackMonitor_FreeBytes() {
+  return (g_stack.watermark - g_stack.limit) * sizeof(uint32_t);
+}
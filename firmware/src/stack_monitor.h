@@ -0,0 +1,124 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * stack_monitor.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup stack_monitor Stack Monitor
+ * @brief Track the peak stack usage.
+ *
+ * At startup, the unused part of the stack is painted with a known pattern.
+ * StackMonitor_Tasks() then scans upwards from the stack limit, a few words
+ * per call, looking for the lowest word which has been overwritten. This
+ * gives the deepest the stack has ever grown, and the RAM which has never
+ * been used.
+ *
+ * The heap size is 0, so everything between the end of the static data and
+ * the bottom of the stack is free RAM.
+ *
+ * The Host fetches the values with a COMMAND_GET_MEMORY_INFO message, see
+ * @ref message-commands-getmemoryinfo.
+ *
+ * @addtogroup stack_monitor
+ * @{
+ * @file stack_monitor.h
+ * @brief Track the peak stack usage.
+ */
+
+#ifndef FIRMWARE_SRC_STACK_MONITOR_H_
+#define FIRMWARE_SRC_STACK_MONITOR_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Settings for the StackMonitor module.
+ */
+typedef struct {
+  /**
+   * @brief The lowest address the stack can grow down to.
+   *
+   * With the XC32 linker scripts, this is _splim.
+   */
+  uint32_t *limit;
+
+  /**
+   * @brief The address the stack starts at, with the XC32 linker scripts this
+   *   is _stack.
+   */
+  uint32_t *top;
+} StackMonitor_Settings;
+
+/**
+ * @brief Paint the stack and reset the peak usage.
+ * @param settings The stack monitor settings.
+ *
+ * This should be called as early as possible. Words close to the current
+ * stack pointer are left alone, so they are counted as used.
+ *
+ * @examplepara
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * extern uint32_t _splim;
+ * extern uint32_t _stack;
+ *
+ * StackMonitor_Settings stack_settings = {
+ *   .limit = &_splim,
+ *   .top = &_stack
+ * };
+ * StackMonitor_Initialize(&stack_settings);
+ * ~~~~~~~~~~~~~~~~~~~~~
+ */
+void StackMonitor_Initialize(const StackMonitor_Settings *settings);
+
+/**
+ * @brief Scan the next part of the stack.
+ *
+ * This should be called in the main event loop.
+ */
+void StackMonitor_Tasks();
+
+/**
+ * @brief Get the size of the stack region.
+ * @returns The size in bytes between the limit and the top of the stack.
+ */
+uint32_t StackMonitor_StackSize();
+
+/**
+ * @brief Get the peak stack usage.
+ * @returns The largest number of bytes the stack has used, as of the last
+ *   completed scan.
+ */
+uint32_t StackMonitor_PeakUsage();
+
+/**
+ * @brief Get the RAM which has never been used by the stack.
+ * @returns The number of free bytes, 0 if the stack has reached the limit.
+ */
+uint32_t StackMonitor_FreeBytes();
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_STACK_MONITOR_H_
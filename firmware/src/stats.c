@@ -0,0 +1,122 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * stats.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "stats.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  const char *name;
+  StatsCounter *counter;  //!< The counter, or NULL if value_fn is used.
+  Stats_ValueFn value_fn;
+} StatsEntry;
+
+typedef struct {
+  StatsEntry entries[STATS_MAX_COUNTERS];
+  unsigned int count;
+} StatsData;
+
+static StatsData g_stats;
+
+/*
+ * @brief Find the entry for a name, or a free entry.
+ * @returns The entry, or NULL if the name is too long or there are no free
+ *   entries.
+ */
+static StatsEntry *FindEntry(const char *name) {
+  if (strlen(name) > STATS_MAX_NAME_LENGTH) {
+    return NULL;
+  }
+
+  unsigned int i = 0u;
+  for (; i < g_stats.count; i++) {
+    if (strcmp(g_stats.entries[i].name, name) == 0) {
+      return &g_stats.entries[i];
+    }
+  }
+  if (g_stats.count == STATS_MAX_COUNTERS) {
+    return NULL;
+  }
+  return &g_stats.entries[g_stats.count++];
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void Stats_Initialize() {
+  memset(&g_stats, 0, sizeof(g_stats));
+}
+
+bool Stats_AddCounter(const char *name, StatsCounter *counter) {
+  StatsEntry *entry = FindEntry(name);
+  if (!entry) {
+    return false;
+  }
+  __atomic_store_n(counter, 0u, __ATOMIC_RELAXED);
+  entry->name = name;
+  entry->counter = counter;
+  entry->value_fn = NULL;
+  return true;
+}
+
+bool Stats_AddValue(const char *name, Stats_ValueFn value_fn) {
+  StatsEntry *entry = FindEntry(name);
+  if (!entry) {
+    return false;
+  }
+  entry->name = name;
+  entry->counter = NULL;
+  entry->value_fn = value_fn;
+  return true;
+}
+
+void Stats_Increment(StatsCounter *counter) {
+  // A plain ++ is a load / add / store, so an ISR could lose an increment
+  // made by the main loop.
+  __atomic_fetch_add(counter, 1u, __ATOMIC_RELAXED);
+}
+
+unsigned int Stats_Count() {
+  return g_stats.count;
+}
+
+const char *Stats_Name(unsigned int index) {
+  return g_stats.entries[index].name;
+}
+
+uint32_t Stats_Read(unsigned int index, bool reset) {
+  const StatsEntry *entry = &g_stats.entries[index];
+  if (entry->value_fn) {
+    return entry->value_fn(reset);
+  }
+  if (reset) {
+    return __atomic_exchange_n(entry->counter, 0u, __ATOMIC_RELAXED);
+  }
+  return __atomic_load_n(entry->counter, __ATOMIC_RELAXED);
+}
+
+uint32_t Stats_Get(const char *name) {
+  unsigned int i = 0u;
+  for (; i < g_stats.count; i++) {
+    if (strcmp(g_stats.entries[i].name, name) == 0) {
+      return Stats_Read(i, false);
+    }
+  }
+  return 0u;
+}
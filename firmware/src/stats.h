@@ -0,0 +1,167 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * stats.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup stats Statistics
+ * @brief Runtime counters for the various subsystems.
+ *
+ * Each module owns its counters, and registers them by name when it's
+ * initialized, e.g.:
+ *
+ * @examplepara
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * static StatsCounter g_queue_full;
+ *
+ * void Foo_Initialize() {
+ *   Stats_AddCounter("foo.queue_full", &g_queue_full);
+ * }
+ *
+ * void Foo_Queue() {
+ *   Stats_Increment(&g_queue_full);
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Values the module already tracks, like a high water mark, can be added with
+ * Stats_AddValue().
+ *
+ * The counters can be incremented from any context, including ISRs. The
+ * increments are atomic, so an ISR which preempts the main loop, or a read &
+ * reset, never loses a count. The counters are 32 bits and wrap around; at
+ * 1000 events a second this takes 49 days. Events that are lost because an
+ * ISR couldn't keep up, like a UART receive overrun, are counted by the
+ * module that owns the ISR.
+ *
+ * The Host fetches the counters, along with their names, with a
+ * COMMAND_GET_STATS message, see @ref message-commands-getstats.
+ *
+ * @addtogroup stats
+ * @{
+ * @file stats.h
+ * @brief Runtime counters for the various subsystems.
+ */
+
+#ifndef FIRMWARE_SRC_STATS_H_
+#define FIRMWARE_SRC_STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The maximum number of registered counters.
+ */
+enum { STATS_MAX_COUNTERS = 16 };
+
+/**
+ * @brief The maximum length of a counter name.
+ *
+ * Together with STATS_MAX_COUNTERS, this ensures the COMMAND_GET_STATS
+ * response fits in a single message.
+ */
+enum { STATS_MAX_NAME_LENGTH = 26 };
+
+/**
+ * @brief A counter.
+ *
+ * The storage is provided by the module which owns the counter.
+ */
+typedef uint32_t StatsCounter;
+
+/**
+ * @brief A function which returns a value kept by a module.
+ * @param reset true if the value should be reset once it's been read.
+ * @returns The value.
+ */
+typedef uint32_t (*Stats_ValueFn)(bool reset);
+
+/**
+ * @brief Remove all the registered counters.
+ */
+void Stats_Initialize();
+
+/**
+ * @brief Register a counter.
+ * @param name The name of the counter, in module.counter form. The string
+ *   must remain valid.
+ * @param counter The counter, which is reset to 0.
+ * @returns true if the counter was registered, false if the name was too long
+ *   or there were already STATS_MAX_COUNTERS counters.
+ *
+ * If a counter with the same name is already registered, it's replaced. This
+ * allows modules to be re-initialized.
+ */
+bool Stats_AddCounter(const char *name, StatsCounter *counter);
+
+/**
+ * @brief Register a value kept by a module.
+ * @param name The name of the value, in module.counter form. The string must
+ *   remain valid.
+ * @param value_fn The function to call to read the value.
+ * @returns true if the value was registered, false if the name was too long
+ *   or there were already STATS_MAX_COUNTERS counters.
+ */
+bool Stats_AddValue(const char *name, Stats_ValueFn value_fn);
+
+/**
+ * @brief Increment a counter.
+ * @param counter The counter to increment.
+ */
+void Stats_Increment(StatsCounter *counter);
+
+/**
+ * @brief Get the number of registered counters.
+ * @returns The number of counters.
+ */
+unsigned int Stats_Count();
+
+/**
+ * @brief Get the name of a counter.
+ * @param index The index of the counter, less than Stats_Count().
+ * @returns The name of the counter.
+ */
+const char *Stats_Name(unsigned int index);
+
+/**
+ * @brief Read a counter.
+ * @param index The index of the counter, less than Stats_Count().
+ * @param reset If true, the counter is reset to 0 as it's read. Increments
+ *   which race with the read are never lost.
+ * @returns The value of the counter.
+ */
+uint32_t Stats_Read(unsigned int index, bool reset);
+
+/**
+ * @brief Get the value of a counter by name.
+ * @param name The name of the counter.
+ * @returns The value of the counter, or 0 if it isn't registered.
+ */
+uint32_t Stats_Get(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_STATS_H_
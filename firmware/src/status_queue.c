@@ -0,0 +1,126 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * status_queue.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "status_queue.h"
+
+static const uint8_t STATUS_TYPE_MASK = 0xf;
+
+/*
+ * @brief Return the ring index for a status type.
+ * @returns The index of the ring, or STATUS_QUEUE_TYPE_COUNT if the status
+ *   type isn't valid.
+ */
+static inline unsigned int RingIndex(uint8_t status_type) {
+  const uint8_t severity = status_type & STATUS_TYPE_MASK;
+  if (severity < STATUS_ADVISORY || severity > STATUS_ERROR) {
+    return STATUS_QUEUE_TYPE_COUNT;
+  }
+  return severity - STATUS_ADVISORY;
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void StatusQueue_Initialize(StatusQueue *queue, StatusMessage *storage,
+                            uint8_t ring_size) {
+  unsigned int i = 0u;
+  for (; i < STATUS_QUEUE_TYPE_COUNT; i++) {
+    queue->rings[i].messages = storage + i * ring_size;
+    queue->rings[i].head = 0u;
+    queue->rings[i].count = 0u;
+  }
+  queue->ring_size = ring_size;
+  queue->overflow_count = 0u;
+}
+
+bool StatusQueue_Enqueue(StatusQueue *queue, const StatusMessage *message,
+                         uint8_t report_threshold) {
+  const unsigned int index = RingIndex(message->status_type);
+  if (report_threshold == STATUS_NONE || index == STATUS_QUEUE_TYPE_COUNT ||
+      (message->status_type & STATUS_TYPE_MASK) < report_threshold ||
+      queue->ring_size == 0u) {
+    return false;
+  }
+
+  StatusMessageRing *ring = &queue->rings[index];
+  if (ring->count == queue->ring_size) {
+    // Drop the oldest message.
+    ring->head = (ring->head + 1u) % queue->ring_size;
+    ring->count--;
+    queue->overflow_count++;
+  }
+
+  ring->messages[(ring->head + ring->count) % queue->ring_size] = *message;
+  ring->count++;
+  return true;
+}
+
+bool StatusQueue_Dequeue(StatusQueue *queue, uint8_t status_type,
+                         StatusMessage *message) {
+  const unsigned int lowest = RingIndex(status_type);
+  if (lowest == STATUS_QUEUE_TYPE_COUNT) {
+    return false;
+  }
+
+  unsigned int i = STATUS_QUEUE_TYPE_COUNT;
+  for (; i > lowest; i--) {
+    StatusMessageRing *ring = &queue->rings[i - 1u];
+    if (ring->count) {
+      *message = ring->messages[ring->head];
+      ring->head = (ring->head + 1u) % queue->ring_size;
+      ring->count--;
+      return true;
+    }
+  }
+  return false;
+}
+
+unsigned int StatusQueue_RemoveSubDevices(StatusQueue *queue, uint16_t first,
+                                          uint16_t last) {
+  unsigned int removed = 0u;
+  unsigned int i = 0u;
+  for (; i < STATUS_QUEUE_TYPE_COUNT; i++) {
+    StatusMessageRing *ring = &queue->rings[i];
+    // Compact the ring in place, preserving the order.
+    unsigned int kept = 0u;
+    unsigned int j = 0u;
+    for (; j < ring->count; j++) {
+      const StatusMessage *message =
+          &ring->messages[(ring->head + j) % queue->ring_size];
+      if (message->sub_device >= first && message->sub_device <= last) {
+        continue;
+      }
+      if (kept != j) {
+        ring->messages[(ring->head + kept) % queue->ring_size] = *message;
+      }
+      kept++;
+    }
+    removed += ring->count - kept;
+    ring->count = kept;
+  }
+  return removed;
+}
+
+unsigned int StatusQueue_Count(const StatusQueue *queue) {
+  unsigned int count = 0u;
+  unsigned int i = 0u;
+  for (; i < STATUS_QUEUE_TYPE_COUNT; i++) {
+    count += queue->rings[i].count;
+  }
+  return count;
+}
@@ -0,0 +1,156 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * status_queue.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup status_queue Status Message Queue
+ * @brief A queue of RDM status messages.
+ *
+ * Messages are stored in a ring buffer per status type (advisory, warning and
+ * error), so queuing and dequeuing a message is O(1), regardless of how many
+ * sub-devices a model has. Messages are dequeued in priority order, errors
+ * first, and in the order they were queued within each status type.
+ *
+ * The storage for the rings is provided by the model, which allows each model
+ * to size the queue as required.
+ *
+ * The dimmer model is currently the only model that generates status
+ * messages. The proxy model's children answer GET QUEUED_MESSAGE from their
+ * buffered responses, which aren't status messages, and the other models don't
+ * report any. A model that starts generating status messages should use this
+ * queue rather than keeping its own list.
+ *
+ * @addtogroup status_queue
+ * @{
+ * @file status_queue.h
+ * @brief A queue of RDM status messages.
+ */
+
+#ifndef FIRMWARE_SRC_STATUS_QUEUE_H_
+#define FIRMWARE_SRC_STATUS_QUEUE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rdm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The number of status types, and hence rings, in a StatusQueue.
+ */
+enum { STATUS_QUEUE_TYPE_COUNT = 3 };
+
+/**
+ * @brief An RDM status message.
+ */
+typedef struct {
+  uint16_t sub_device;  //!< The sub-device that generated the message.
+  uint16_t message_id;  //!< The status message id.
+  uint16_t data_value1;  //!< The first data value.
+  uint16_t data_value2;  //!< The second data value.
+  uint8_t status_type;  //!< The RDMStatusType, which may be a cleared type.
+} StatusMessage;
+
+/**
+ * @brief A ring buffer of status messages.
+ */
+typedef struct {
+  StatusMessage *messages;  //!< The storage for the ring.
+  uint8_t head;  //!< The index of the oldest message.
+  uint8_t count;  //!< The number of messages in the ring.
+} StatusMessageRing;
+
+/**
+ * @brief A queue of status messages.
+ */
+typedef struct {
+  /**
+   * @brief The rings, indexed by status type, starting at STATUS_ADVISORY.
+   */
+  StatusMessageRing rings[STATUS_QUEUE_TYPE_COUNT];
+  uint8_t ring_size;  //!< The number of messages each ring can hold.
+  uint16_t overflow_count;  //!< The number of messages that were dropped.
+} StatusQueue;
+
+/**
+ * @brief Initialize a StatusQueue.
+ * @param queue The queue to initialize.
+ * @param storage The memory to store the messages in. This must hold
+ *   STATUS_QUEUE_TYPE_COUNT * ring_size messages.
+ * @param ring_size The number of messages to hold for each status type.
+ */
+void StatusQueue_Initialize(StatusQueue *queue, StatusMessage *storage,
+                            uint8_t ring_size);
+
+/**
+ * @brief Queue a status message.
+ * @param queue The queue to add the message to.
+ * @param message The message to queue.
+ * @param report_threshold The minimum status type to queue, as set by
+ *   SUB_DEVICE_STATUS_REPORT_THRESHOLD. STATUS_NONE suppresses all messages.
+ * @returns true if the message was queued, false if it was filtered.
+ *
+ * If the ring for the status type is full, the oldest message of that type is
+ * dropped.
+ */
+bool StatusQueue_Enqueue(StatusQueue *queue, const StatusMessage *message,
+                         uint8_t report_threshold);
+
+/**
+ * @brief Dequeue the highest priority status message.
+ * @param queue The queue to remove the message from.
+ * @param status_type The requested status type, messages of this type or
+ *   greater severity will be returned.
+ * @param[out] message The dequeued message.
+ * @returns true if a message was dequeued, false if there were no messages of
+ *   the requested type.
+ */
+bool StatusQueue_Dequeue(StatusQueue *queue, uint8_t status_type,
+                         StatusMessage *message);
+
+/**
+ * @brief Remove all messages for a range of sub-devices.
+ * @param queue The queue to remove the messages from.
+ * @param first The first sub-device.
+ * @param last The last sub-device, inclusive.
+ * @returns The number of messages removed.
+ *
+ * This is O(n) in the size of the queue, it's used to handle CLEAR_STATUS_ID.
+ */
+unsigned int StatusQueue_RemoveSubDevices(StatusQueue *queue, uint16_t first,
+                                          uint16_t last);
+
+/**
+ * @brief Return the number of messages in the queue.
+ * @param queue The queue.
+ * @returns The number of queued messages.
+ */
+unsigned int StatusQueue_Count(const StatusQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_STATUS_QUEUE_H_
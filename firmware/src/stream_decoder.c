@@ -24,6 +24,7 @@
 
 #include "app_pipeline.h"
 #include "constants.h"
+#include "stats.h"
 
 // Microchip defines this macro in stdlib.h but it's non standard.
 // We define it here so that the unit tests work.
@@ -53,6 +54,7 @@ typedef struct {
   unsigned int fragment_offset;
   uint8_t fragmented_buffer[PAYLOAD_SIZE];
   uint8_t fragmented_frame : 1;  // true if we've received a fragmented frame
+  StatsCounter fragmented_messages;  // Messages split across USB packets.
 } StreamDecoderData;
 
 StreamDecoderData g_stream_data;
@@ -70,6 +72,8 @@ void StreamDecoder_Initialize(MessageHandler handler) {
   g_stream_data.message.payload = NULL;
   g_stream_data.fragment_offset = 0u;
   g_stream_data.fragmented_frame = false;
+  Stats_AddCounter("usb.fragmented_messages",
+                   &g_stream_data.fragmented_messages);
 }
 
 bool StreamDecoder_GetFragmentedFrameFlag() {
@@ -131,6 +135,9 @@ void StreamDecoder_Process(const uint8_t* data, unsigned int size) {
         payload_size = end - data;
         if (payload_size < g_stream_data.message.length + 1u ||
             g_stream_data.fragment_offset != 0u) {
+          if (g_stream_data.fragment_offset == 0u) {
+            Stats_Increment(&g_stream_data.fragmented_messages);
+          }
           g_stream_data.fragmented_frame = true;
           payload_size = min(
               payload_size,
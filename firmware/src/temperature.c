@@ -23,7 +23,9 @@
 #include "peripheral/adc/plib_adc.h"
 #include "sys/attribs.h"
 
-#include "coarse_timer.h"
+#include "macros.h"
+#include "temperature_conversion.h"
+#include "timer_wheel.h"
 
 #include "app_settings.h"
 
@@ -31,22 +33,7 @@ static const uint16_t SAMPLING_PERIOD = 10000;  // 1s
 // Recalibrate every N SAMPLES - 5 minutes
 static const uint16_t CALIBRATION_CYCLE_LIMIT = 300;
 
-// The conversion function is:
-//   temp [deci-degrees] = m * sampled_value + c
-//
-// The MCP9701AT device has:
-//  - 400mV @ 0 degrees C
-//  - 19.5mV per 1 degree
-//
-// With 10-bit sampling and a 3v3 ref we have:
-//   temp = ((3300 / 1024 * sample - 400) / 19.5 * 10
-//
-// Which reduces to:
-//   temp = 1.6526 * sample - 205.128;
-static const float CONVERSION_MULTIPLIER = 1.6526;
-static const float CONVERSION_OFFSET = -205.128;
-
-static CoarseTimer_Value g_timer;
+static TimerWheel_Timer g_timer;
 
 // The number of samples since the last calibration.
 static uint8_t g_sample_count = 0;
@@ -54,22 +41,48 @@ static uint8_t g_sample_count = 0;
 struct {
   uint16_t offset;  //!< The calibration offset
   bool new_sample;  //!< true if there is a new sample
-  uint16_t sample_value;  //!< The raw sampled value
+  uint16_t sample_value;  //!< The decimated 12-bit sample
   uint16_t temperature;  //!< The temperature in 10ths of a degree.
 } g_adc_data;
 
 void __ISR(_ADC_VECTOR, ipl1AUTO) ADCEvent() {
-  // Read the value from ADC1BUF0
-  g_adc_data.sample_value = PLIB_ADC_ResultGetByIndex(ADC_ID_1, 0);
+  // The ADC converts TEMPERATURE_OVERSAMPLE_COUNT samples back to back and
+  // then interrupts. Read ADC1BUF0 - ADC1BUFF and decimate.
+  uint16_t samples[TEMPERATURE_OVERSAMPLE_COUNT];
+  uint8_t i = 0u;
+  for (; i < TEMPERATURE_OVERSAMPLE_COUNT; i++) {
+    samples[i] = PLIB_ADC_ResultGetByIndex(ADC_ID_1, i);
+  }
+  g_adc_data.sample_value = TemperatureConversion_Decimate(samples);
 
   SYS_INT_SourceDisable(INT_SOURCE_ADC_1);
   SYS_INT_SourceStatusClear(INT_SOURCE_ADC_1);
   g_adc_data.new_sample = true;
 }
 
+#ifdef RDM_RESPONDER_TEMPERATURE_SENSOR
+/*
+ * @brief Start a group of conversions & schedule the next one.
+ */
+static void StartSampling(UNUSED void *data) {
+  if (g_sample_count == 0) {
+    PLIB_ADC_CalibrationEnable(ADC_ID_1);
+  } else {
+    PLIB_ADC_CalibrationDisable(ADC_ID_1);
+  }
+  PLIB_ADC_Enable(ADC_ID_1);
+
+  SYS_INT_SourceStatusClear(INT_SOURCE_ADC_1);
+  SYS_INT_SourceEnable(INT_SOURCE_ADC_1);
+
+  // AD1CON1bits.ASAM = 1;
+  PLIB_ADC_SampleAutoStartEnable(ADC_ID_1);
+  TimerWheel_Schedule(&g_timer, SAMPLING_PERIOD, StartSampling, NULL);
+}
+#endif
+
 void Temperature_Init() {
 #ifdef RDM_RESPONDER_TEMPERATURE_SENSOR
-  g_timer = CoarseTimer_GetTime();
   g_adc_data.new_sample = false;
   g_adc_data.sample_value = 0;
   g_adc_data.temperature = 0;
@@ -97,14 +110,17 @@ void Temperature_Init() {
 
   // AD1CON2 = 0;  // VDD & VSS, no scan, mux A
   PLIB_ADC_MuxAInputScanDisable(ADC_ID_1);
-  PLIB_ADC_SamplesPerInterruptSelect(ADC_ID_1, ADC_1SAMPLE_PER_INTERRUPT);
+  PLIB_ADC_SamplesPerInterruptSelect(ADC_ID_1, ADC_16SAMPLES_PER_INTERRUPT);
 
-  // Stop auto-sample after the interrupt
+  // Stop auto-sample after the interrupt, so each trigger gives one group of
+  // OVERSAMPLE_COUNT conversions.
   PLIB_ADC_ConversionStopSequenceEnable(ADC_ID_1);
 
   SYS_INT_VectorPrioritySet(INT_VECTOR_AD1, INT_PRIORITY_LEVEL1);
   SYS_INT_VectorSubprioritySet(INT_VECTOR_AD1, INT_SUBPRIORITY_LEVEL1);
   SYS_INT_SourceStatusClear(INT_SOURCE_ADC_1);
+
+  TimerWheel_Schedule(&g_timer, SAMPLING_PERIOD, StartSampling, NULL);
 #endif
 }
 
@@ -114,22 +130,6 @@ uint16_t Temperature_GetValue(TemperatureSensor sensor) {
 
 void Temperature_Tasks() {
 #ifdef RDM_RESPONDER_TEMPERATURE_SENSOR
-  if (CoarseTimer_HasElapsed(g_timer, SAMPLING_PERIOD)) {
-    if (g_sample_count == 0) {
-      PLIB_ADC_CalibrationEnable(ADC_ID_1);
-    } else {
-      PLIB_ADC_CalibrationDisable(ADC_ID_1);
-    }
-    PLIB_ADC_Enable(ADC_ID_1);
-
-    SYS_INT_SourceStatusClear(INT_SOURCE_ADC_1);
-    SYS_INT_SourceEnable(INT_SOURCE_ADC_1);
-
-    // AD1CON1bits.ASAM = 1;
-    PLIB_ADC_SampleAutoStartEnable(ADC_ID_1);
-    g_timer = CoarseTimer_GetTime();
-  }
-
   if (g_adc_data.new_sample) {
     PLIB_ADC_Disable(ADC_ID_1);
     g_adc_data.new_sample = false;
@@ -137,9 +137,8 @@ void Temperature_Tasks() {
     if (g_sample_count == 0) {
       g_adc_data.offset = g_adc_data.sample_value;
     } else {
-      g_adc_data.temperature =
-        CONVERSION_MULTIPLIER * (g_adc_data.sample_value  - g_adc_data.offset) +
-          CONVERSION_OFFSET;
+      g_adc_data.temperature = (uint16_t) TemperatureConversion_ToDeciDegrees(
+          (int32_t) g_adc_data.sample_value - g_adc_data.offset);
     }
 
     g_sample_count++;
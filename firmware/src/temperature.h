@@ -51,9 +51,10 @@ void Temperature_Init();
 /**
  * @brief Get the last known value for a sensor.
  * @param sensor The sensor to get the value of
- * @returns The last known value of the sensor, in 10ths of a degree.
+ * @returns The last known value of the sensor, in 10ths of a degree. This is
+ *   a signed value stored in a uint16_t, as used by RDM sensors.
  *
- * If the value is known this will return 0.
+ * If the value is unknown this will return 0.
  */
 uint16_t Temperature_GetValue(TemperatureSensor sensor);
 
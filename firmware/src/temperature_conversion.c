@@ -0,0 +1,59 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * temperature_conversion.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "temperature_conversion.h"
+
+// log4(TEMPERATURE_OVERSAMPLE_COUNT)
+enum { DECIMATION_SHIFT = 2 };
+
+// The conversion function is:
+//   temp [deci-degrees] = (m * sampled_value - c) / d
+//
+// The MCP9701AT device has:
+//  - 400mV @ 0 degrees C
+//  - 19.5mV per 1 degree
+//
+// With a 12-bit value and a 3v3 ref we have:
+//   temp = (3300 * sample / 4096 - 400) / 19.5 * 10
+//
+// Which reduces to the integer form:
+//   temp = (66000 * sample - 32768000) / 159744
+//
+// The numerator fits in 32 bits for all 12-bit samples.
+static const int32_t CONVERSION_MULTIPLIER = 66000;
+static const int32_t CONVERSION_OFFSET = 32768000;
+static const int32_t CONVERSION_DIVISOR = 159744;
+
+uint16_t TemperatureConversion_Decimate(const uint16_t *samples) {
+  uint32_t sum = 0u;
+  unsigned int i = 0u;
+  for (; i < TEMPERATURE_OVERSAMPLE_COUNT; i++) {
+    sum += samples[i];
+  }
+  return sum >> DECIMATION_SHIFT;
+}
+
+int16_t TemperatureConversion_ToDeciDegrees(int32_t sample) {
+  const int32_t numerator = CONVERSION_MULTIPLIER * sample - CONVERSION_OFFSET;
+  // Division truncates towards zero, so round away from it.
+  if (numerator < 0) {
+    return (numerator - CONVERSION_DIVISOR / 2) / CONVERSION_DIVISOR;
+  }
+  return (numerator + CONVERSION_DIVISOR / 2) / CONVERSION_DIVISOR;
+}
@@ -0,0 +1,69 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * temperature_conversion.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef FIRMWARE_SRC_TEMPERATURE_CONVERSION_H_
+#define FIRMWARE_SRC_TEMPERATURE_CONVERSION_H_
+
+/**
+ * @addtogroup temperature
+ * @{
+ * @file temperature_conversion.h
+ * @brief Convert ADC samples to temperatures.
+ *
+ * These are kept separate from the ADC handling so they can be tested on the
+ * host.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The number of 10-bit ADC samples taken for each reading.
+ *
+ * Oversampling by 4^n adds n bits of resolution, so 16 samples are decimated
+ * to a 12-bit value.
+ */
+enum { TEMPERATURE_OVERSAMPLE_COUNT = 16 };
+
+/**
+ * @brief Decimate a group of ADC samples.
+ * @param samples TEMPERATURE_OVERSAMPLE_COUNT 10-bit samples.
+ * @returns The 12-bit value.
+ */
+uint16_t TemperatureConversion_Decimate(const uint16_t *samples);
+
+/**
+ * @brief Convert a 12-bit sample from the MCP9701 to a temperature.
+ * @param sample The sample, less any calibration offset. This may be negative.
+ * @returns The temperature in 10ths of a degree, rounded to the nearest value.
+ */
+int16_t TemperatureConversion_ToDeciDegrees(int32_t sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_TEMPERATURE_CONVERSION_H_
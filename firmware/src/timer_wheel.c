@@ -0,0 +1,266 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * timer_wheel.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "timer_wheel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "coarse_timer.h"
+#include "stats.h"
+
+enum { SLOT_BITS = 6 };
+enum { SLOTS_PER_LEVEL = 1 << SLOT_BITS };
+enum { SLOT_MASK = SLOTS_PER_LEVEL - 1 };
+
+// If TimerWheel_Tasks() falls more than this many ticks behind, it's cheaper
+// to re-sort the timers than to step through each tick.
+enum { CATCH_UP_LIMIT = SLOTS_PER_LEVEL * TIMER_WHEEL_LEVELS };
+
+typedef struct {
+  /*
+   * @brief The next tick to process.
+   */
+  uint32_t tick;
+
+  /*
+   * @brief The number of scheduled timers.
+   */
+  unsigned int timer_count;
+
+  uint32_t max_lateness;
+
+  TimerWheel_Timer *slots[TIMER_WHEEL_LEVELS][SLOTS_PER_LEVEL];
+} TimerWheelData;
+
+static TimerWheelData g_wheel;
+
+static inline unsigned int SlotIndex(uint32_t tick, unsigned int level) {
+  return (tick >> (SLOT_BITS * level)) & SLOT_MASK;
+}
+
+static inline void Link(TimerWheel_Timer **head, TimerWheel_Timer *timer) {
+  timer->next = *head;
+  if (timer->next) {
+    timer->next->pprev = &timer->next;
+  }
+  timer->pprev = head;
+  *head = timer;
+}
+
+static inline void Unlink(TimerWheel_Timer *timer) {
+  *timer->pprev = timer->next;
+  if (timer->next) {
+    timer->next->pprev = timer->pprev;
+  }
+  timer->next = NULL;
+  timer->pprev = NULL;
+}
+
+/*
+ * @brief Detach a slot's list of timers.
+ * @param slot The slot.
+ * @param[out] head The new head of the list.
+ *
+ * Timers in the detached list can still be cancelled.
+ */
+static inline void Detach(TimerWheel_Timer **slot, TimerWheel_Timer **head) {
+  *head = *slot;
+  *slot = NULL;
+  if (*head) {
+    (*head)->pprev = head;
+  }
+}
+
+/*
+ * @brief Place a timer in the slot for its expiry time.
+ */
+static void Insert(TimerWheel_Timer *timer) {
+  uint32_t expiry = timer->expiry;
+  uint32_t delta = expiry - g_wheel.tick;
+  if ((int32_t) delta < 0) {
+    // Already expired, run it on the next tick.
+    expiry = g_wheel.tick;
+    delta = 0u;
+  }
+
+  unsigned int level = 0u;
+  while (level < TIMER_WHEEL_LEVELS - 1u &&
+         delta >= (1u << (SLOT_BITS * (level + 1u)))) {
+    level++;
+  }
+  Link(&g_wheel.slots[level][SlotIndex(expiry, level)], timer);
+}
+
+/*
+ * @brief Move the timers in a slot down to the lower levels.
+ */
+static void Cascade(unsigned int level, unsigned int index) {
+  TimerWheel_Timer *head;
+  Detach(&g_wheel.slots[level][index], &head);
+  while (head) {
+    TimerWheel_Timer *timer = head;
+    Unlink(timer);
+    Insert(timer);
+  }
+}
+
+/*
+ * @brief Run the timers which expire on the current tick.
+ * @param now The current time.
+ */
+static void ProcessTick(uint32_t now) {
+  const uint32_t tick = g_wheel.tick;
+  const unsigned int index = SlotIndex(tick, 0u);
+  if (index == 0u) {
+    unsigned int level = 1u;
+    for (; level < TIMER_WHEEL_LEVELS; level++) {
+      const unsigned int level_index = SlotIndex(tick, level);
+      Cascade(level, level_index);
+      if (level_index != 0u) {
+        break;
+      }
+    }
+  }
+
+  TimerWheel_Timer *head;
+  Detach(&g_wheel.slots[0][index], &head);
+  // Advance before running the callbacks, so any timers they schedule are
+  // placed relative to the next tick.
+  g_wheel.tick++;
+
+  if (head && now - tick > g_wheel.max_lateness) {
+    g_wheel.max_lateness = now - tick;
+  }
+
+  while (head) {
+    TimerWheel_Timer *timer = head;
+    Unlink(timer);
+    g_wheel.timer_count--;
+    timer->callback(timer->data);
+  }
+}
+
+/*
+ * @brief Move the wheel forward to the current time in one step.
+ * @param now The current time.
+ *
+ * Overdue timers are placed in the slot for the current tick.
+ */
+static void Rebase(uint32_t now) {
+  TimerWheel_Timer *head = NULL;
+  unsigned int level = 0u;
+  for (; level < TIMER_WHEEL_LEVELS; level++) {
+    unsigned int index = 0u;
+    for (; index < SLOTS_PER_LEVEL; index++) {
+      TimerWheel_Timer **slot = &g_wheel.slots[level][index];
+      while (*slot) {
+        TimerWheel_Timer *timer = *slot;
+        Unlink(timer);
+        Link(&head, timer);
+      }
+    }
+  }
+
+  g_wheel.tick = now;
+  while (head) {
+    TimerWheel_Timer *timer = head;
+    Unlink(timer);
+    const uint32_t lateness = now - timer->expiry;
+    if ((int32_t) lateness > 0 && lateness > g_wheel.max_lateness) {
+      g_wheel.max_lateness = lateness;
+    }
+    Insert(timer);
+  }
+}
+
+/*
+ * @brief Report the maximum lateness to the stats module.
+ */
+static uint32_t MaxLatenessStat(bool reset) {
+  const uint32_t max_lateness = g_wheel.max_lateness;
+  if (reset) {
+    g_wheel.max_lateness = 0u;
+  }
+  return max_lateness;
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void TimerWheel_Initialize() {
+  // Unlink any scheduled timers, so they can be safely scheduled again.
+  unsigned int level = 0u;
+  for (; level < TIMER_WHEEL_LEVELS; level++) {
+    unsigned int slot = 0u;
+    for (; slot < SLOTS_PER_LEVEL; slot++) {
+      while (g_wheel.slots[level][slot]) {
+        Unlink(g_wheel.slots[level][slot]);
+      }
+    }
+  }
+
+  memset(&g_wheel, 0, sizeof(g_wheel));
+  g_wheel.tick = CoarseTimer_GetTime();
+  Stats_AddValue("timer_wheel.max_lateness", MaxLatenessStat);
+}
+
+void TimerWheel_Schedule(TimerWheel_Timer *timer,
+                         uint32_t delay,
+                         TimerWheel_Callback callback,
+                         void *data) {
+  TimerWheel_Cancel(timer);
+  if (delay > TIMER_WHEEL_MAX_DELAY) {
+    delay = TIMER_WHEEL_MAX_DELAY;
+  }
+
+  // Like CoarseTimer_HasElapsed(), we don't want to fire early, so a timer
+  // scheduled part way through a tick expires delay + 1 ticks later.
+  timer->expiry = CoarseTimer_GetTime() + delay + 1u;
+  timer->callback = callback;
+  timer->data = data;
+  Insert(timer);
+  g_wheel.timer_count++;
+}
+
+void TimerWheel_Cancel(TimerWheel_Timer *timer) {
+  if (timer->pprev) {
+    Unlink(timer);
+    g_wheel.timer_count--;
+  }
+}
+
+bool TimerWheel_IsScheduled(const TimerWheel_Timer *timer) {
+  return timer->pprev != NULL;
+}
+
+void TimerWheel_Tasks() {
+  const uint32_t now = CoarseTimer_GetTime();
+  if (g_wheel.timer_count != 0u &&
+      (int32_t) (now - g_wheel.tick) > (int32_t) CATCH_UP_LIMIT) {
+    Rebase(now);
+  }
+  while ((int32_t) (now - g_wheel.tick) >= 0) {
+    if (g_wheel.timer_count == 0u) {
+      // Nothing to cascade or run, skip ahead.
+      g_wheel.tick = now + 1u;
+      return;
+    }
+    ProcessTick(now);
+  }
+}
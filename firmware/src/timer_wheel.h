@@ -0,0 +1,185 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * timer_wheel.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup timer_wheel Timer Wheel
+ * @brief Run callbacks after a delay.
+ *
+ * Rather than checking CoarseTimer_HasElapsed() on every pass of the main
+ * loop, modules can schedule a callback to run once a delay has passed. The
+ * callbacks are run from TimerWheel_Tasks(), so they run in the main loop,
+ * never from an ISR.
+ *
+ * Timers are stored in a hierarchical timer wheel, with TIMER_WHEEL_LEVELS
+ * levels of 64 slots. The first level holds the timers due within the next
+ * 64 ticks of the coarse timer, each following level has slots 64 times as
+ * wide. As time passes, the timers in the higher levels cascade down to the
+ * lower levels. Scheduling and cancelling a timer are O(1).
+ *
+ * The storage for each timer is provided by the caller, so the wheel never
+ * allocates memory.
+ *
+ * TimerWheel_Tasks() is only called in responder mode, so the callbacks don't
+ * run while in controller or self test mode. The transceiver timeouts are
+ * still polled from Transceiver_Tasks(), since they're needed in every mode
+ * and each check has to be made with the transceiver's interrupts disabled:
+ *  - STATE_C_RX_WAIT_FOR_BREAK & STATE_C_RX_WAIT_FOR_DUB, the RDM response
+ *    timeout.
+ *  - STATE_C_RX_DATA, the controller's RDM inter-slot timeout.
+ *  - STATE_C_BACKOFF, the break-to-break time and the backoff after each
+ *    frame.
+ *  - STATE_R_RX_DATA, the responder's RDM & DMX inter-slot timeouts.
+ *  - STATE_T_RX_WAIT, the self test timeout.
+ *
+ * The inter-slot timeouts, and Transceiver_IsIdle(), use the monotonic clock
+ * since 2.1ms is too close to the coarse timer resolution. The rest use
+ * CoarseTimer_HasElapsed().
+ *
+ * A few other modules check the time only as a condition on work that's
+ * already pending, rather than waiting for a deadline, so they also use
+ * CoarseTimer_HasElapsed():
+ *  - The DMX forwarder's rate limit, only checked once a new frame arrives.
+ *  - The SPI RGB latch time, which starts once the SPI module goes idle, a
+ *    hardware state that's polled anyway.
+ *
+ * @examplepara
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * static TimerWheel_Timer g_timer;
+ *
+ * void Sample(void *data) {
+ *   // Take a sample & schedule the next one.
+ *   TimerWheel_Schedule(&g_timer, SAMPLING_PERIOD, Sample, NULL);
+ * }
+ *
+ * TimerWheel_Schedule(&g_timer, SAMPLING_PERIOD, Sample, NULL);
+ * ~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @addtogroup timer_wheel
+ * @{
+ * @file timer_wheel.h
+ * @brief Run callbacks after a delay.
+ */
+
+#ifndef FIRMWARE_SRC_TIMER_WHEEL_H_
+#define FIRMWARE_SRC_TIMER_WHEEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The number of levels in the wheel.
+ */
+#define TIMER_WHEEL_LEVELS 4u
+
+/**
+ * @brief The maximum delay, in 10ths of a millisecond.
+ *
+ * This is just under 28 minutes, longer delays are reduced to this.
+ */
+#define TIMER_WHEEL_MAX_DELAY ((1u << (6u * TIMER_WHEEL_LEVELS)) - 1u)
+
+/**
+ * @brief The function called when a timer expires.
+ * @param data The data passed to TimerWheel_Schedule().
+ */
+typedef void (*TimerWheel_Callback)(void *data);
+
+/**
+ * @brief A timer.
+ *
+ * The members are private to the timer wheel. A timer must be zero
+ * initialized, which is the case for static storage.
+ */
+typedef struct TimerWheel_Timer {
+  struct TimerWheel_Timer *next;  //!< The next timer in the slot.
+  struct TimerWheel_Timer **pprev;  //!< The pointer which points to this one.
+  uint32_t expiry;  //!< The tick the timer expires on.
+  TimerWheel_Callback callback;  //!< The callback to run.
+  void *data;  //!< The data for the callback.
+} TimerWheel_Timer;
+
+/**
+ * @brief Initialize the timer wheel.
+ *
+ * This must be called after CoarseTimer_Initialize(). Any scheduled timers
+ * are cancelled.
+ *
+ * The maximum time between a timer expiring and its callback being run is
+ * reported as the timer_wheel.max_lateness stat. This measures how long the
+ * main loop takes to get around to TimerWheel_Tasks().
+ */
+void TimerWheel_Initialize();
+
+/**
+ * @brief Schedule a timer.
+ * @param timer The timer to schedule. The timer must remain valid until it
+ *   expires or is cancelled.
+ * @param delay The delay, in 10ths of a millisecond.
+ * @param callback The function to call once the delay has passed.
+ * @param data Data to pass to the callback.
+ *
+ * If the timer is already scheduled, it's rescheduled. The callback never
+ * runs early, like CoarseTimer_HasElapsed(), it may run up to 0.1ms late, in
+ * addition to any delay in calling TimerWheel_Tasks().
+ *
+ * Timers may be scheduled from within a callback, including the timer that
+ * is running.
+ */
+void TimerWheel_Schedule(TimerWheel_Timer *timer,
+                         uint32_t delay,
+                         TimerWheel_Callback callback,
+                         void *data);
+
+/**
+ * @brief Cancel a timer.
+ * @param timer The timer to cancel.
+ *
+ * This does nothing if the timer isn't scheduled.
+ */
+void TimerWheel_Cancel(TimerWheel_Timer *timer);
+
+/**
+ * @brief Check if a timer is scheduled.
+ * @param timer The timer to check.
+ * @returns true if the timer is scheduled, false otherwise.
+ */
+bool TimerWheel_IsScheduled(const TimerWheel_Timer *timer);
+
+/**
+ * @brief Run the callbacks for the expired timers.
+ *
+ * This should be called in the main event loop. If the wheel has fallen well
+ * behind, for example after a period in controller mode, the overdue timers
+ * are run in a single pass.
+ */
+void TimerWheel_Tasks();
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_TIMER_WHEEL_H_
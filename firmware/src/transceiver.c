@@ -30,10 +30,12 @@
 #include "coarse_timer.h"
 #include "constants.h"
 #include "dmx_spec.h"
+#include "monotonic_clock.h"
 #include "peripheral/ic/plib_ic.h"
 #include "peripheral/tmr/plib_tmr.h"
 #include "peripheral/usart/plib_usart.h"
 #include "setting_macros.h"
+#include "stats.h"
 #include "syslog.h"
 #include "system_definitions.h"
 #include "transceiver_timing.h"
@@ -43,6 +45,9 @@
 
 enum { BUFFER_SIZE = DMX_FRAME_SIZE + 1u };
 
+// The time to receive a slot, in microseconds: 11 bits at 250kHz.
+enum { SLOT_TIME = 11u * 1000000u / DMX_BAUD };
+
 // The number of buffers we maintain for overlapping I/O
 enum { NUMBER_OF_BUFFERS = 2};
 
@@ -164,10 +169,9 @@ typedef struct {
   uint16_t last_byte;
 
   /**
-   * @brief The approximate time the last byte arrived, accurate to 10ths of a
-   * millisecond.
+   * @brief The time the last byte was read from the UART.
    */
-  CoarseTimer_Value last_byte_coarse;
+  MonotonicClock_Value last_byte_time;
 
   /**
    * @brief The result of the last operation.
@@ -180,6 +184,12 @@ typedef struct {
   uint8_t expected_length;
   bool found_expected_length;  //!< If expected_length is valid.
 
+  /**
+   * @brief If true, the remainder of the current RX frame is drained from the
+   * UART without being buffered.
+   */
+  bool discard_rx;
+
   /**
    * @brief The token for a mode change event.
    *
@@ -193,6 +203,13 @@ typedef struct {
    */
   TransceiverBuffer* active;
   TransceiverBuffer* next;  //!< The next buffer ready to be transmitted
+  /**
+   * @brief A buffer handed out by Transceiver_AcquireRDMResponseBuffer().
+   *
+   * The response is built in-place and then moved to next by
+   * Transceiver_CommitRDMResponse().
+   */
+  TransceiverBuffer* leased;
 
   TransceiverBuffer* free_list[NUMBER_OF_BUFFERS];
   uint8_t free_size;  //!< The number of buffers in the free list, may be 0.
@@ -211,6 +228,14 @@ typedef struct {
   uint16_t rdm_responder_jitter;
 } TimingSettings;
 
+typedef struct {
+  StatsCounter tx_frames;  //!< Frames sent in controller mode.
+  StatsCounter rx_frames;  //!< Frames received in responder mode.
+  StatsCounter queue_full;  //!< Frames rejected because of no free buffers.
+  StatsCounter rx_overflows;  //!< Frames which overflowed the RX buffer.
+  StatsCounter uart_overruns;  //!< Bytes lost because the UART FIFO was full.
+} TransceiverStats;
+
 // The TX / RX buffers
 static TransceiverBuffer buffers[NUMBER_OF_BUFFERS];
 
@@ -230,6 +255,8 @@ static TransceiverEventCallback g_rx_callback = NULL;
 // The timing settings
 static TimingSettings g_timing_settings;
 
+static TransceiverStats g_stats;
+
 // Timer Functions
 // ----------------------------------------------------------------------------
 /*
@@ -252,6 +279,31 @@ static inline void RebaseTimer(uint16_t last_event) {
       PLIB_TMR_Counter16BitGet(g_hw_settings.timer_module_id) - last_event);
 }
 
+/*
+ * @brief Check if an interval has passed since the last byte was received.
+ * @param interval The interval, in 10ths of a millisecond.
+ *
+ * This uses the monotonic clock rather than the coarse timer, so the 2.1ms
+ * inter-slot timeouts aren't rounded to the 100us coarse timer tick.
+ */
+static inline bool LastByteElapsed(uint32_t interval) {
+  return MonotonicClock_HasElapsed(g_transceiver.last_byte_time,
+                                   interval * 100u);
+}
+
+/*
+ * @brief Check if the inter-slot time has been exceeded.
+ * @param timeout The inter-slot timeout, in 10ths of a millisecond.
+ *
+ * The inter-slot time is measured to the start of the next slot, but we only
+ * see a slot once it's complete. Allow for the slot time, plus another slot
+ * time for the latency of the UART interrupt.
+ */
+static inline bool InterSlotTimeout(uint32_t timeout) {
+  return MonotonicClock_HasElapsed(g_transceiver.last_byte_time,
+                                   timeout * 100u + 2u * SLOT_TIME);
+}
+
 // I/O Functions
 // ----------------------------------------------------------------------------
 
@@ -342,6 +394,7 @@ bool UART_RXBytes() {
     if (g_transceiver.found_expected_length) {
       if (g_transceiver.data_index == g_transceiver.expected_length) {
         // We've got enough data to move on
+        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
         PLIB_USART_ReceiverDisable(g_hw_settings.usart);
         ResetToMark();
         g_transceiver.state = STATE_C_COMPLETE;
@@ -359,7 +412,7 @@ bool UART_RXBytes() {
   }
   g_transceiver.last_byte = PLIB_TMR_Counter16BitGet(
       g_hw_settings.timer_module_id);
-  g_transceiver.last_byte_coarse = CoarseTimer_GetTime();
+  g_transceiver.last_byte_time = MonotonicClock_GetTime();
   return g_transceiver.data_index >= BUFFER_SIZE;
 }
 
@@ -382,6 +435,7 @@ uint8_t Transceiver_FreeBufferCount() {
 static void InitializeBuffers() {
   g_transceiver.active = NULL;
   g_transceiver.next = NULL;
+  g_transceiver.leased = NULL;
 
   unsigned int i = 0u;
   for (; i < NUMBER_OF_BUFFERS; i++) {
@@ -485,6 +539,7 @@ static inline void RXFrameEvent() {
  * @brief Run the RX callback with an end-of-frame event.
  */
 static inline void RXEndFrameEvent() {
+  Stats_Increment(&g_stats.rx_frames);
   TransceiverEvent event = {
     0u,
     T_OP_RX,
@@ -941,6 +996,7 @@ void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6AUTO)
      if (UART_RXBytes()) {
        // Protect against a responder sending us more than 512 bytes of data.
        // The maximum RDM frame size is 257 so this *should* never happen.
+       Stats_Increment(&g_stats.rx_overflows);
        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
@@ -958,9 +1014,18 @@ void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6AUTO)
         RebaseTimer(g_transceiver.last_change);
         g_transceiver.data_index = 0u;
         g_transceiver.event_index = 0u;
+        g_transceiver.discard_rx = false;
         g_transceiver.state = STATE_R_RX_BREAK;
+      } else if (g_transceiver.discard_rx) {
+        // The frame isn't for us, drop the bytes but keep tracking the
+        // inter-slot time so we detect the end of the frame.
+        UART_FlushRX();
+        g_transceiver.last_byte = PLIB_TMR_Counter16BitGet(
+            g_hw_settings.timer_module_id);
+        g_transceiver.last_byte_time = MonotonicClock_GetTime();
       } else if (UART_RXBytes()) {
         // RX buffer is full.
+        Stats_Increment(&g_stats.rx_overflows);
         SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
         SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
         PLIB_USART_ReceiverDisable(g_hw_settings.usart);
@@ -975,6 +1040,11 @@ void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6AUTO)
 
   // Error
   if (SYS_INT_SourceStatusGet(g_hw_settings.usart_error_source)) {
+    if (PLIB_USART_ErrorsGet(g_hw_settings.usart) &
+        USART_ERROR_RECEIVER_OVERRUN) {
+      // This ISR didn't drain the FIFO in time.
+      Stats_Increment(&g_stats.uart_overruns);
+    }
     switch (g_transceiver.state) {
       case STATE_C_RX_IN_DUB:
         SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
@@ -1047,11 +1117,18 @@ void Transceiver_Initialize(const TransceiverHardwareSettings* settings,
   g_transceiver.mode = T_MODE_RESPONDER;
   g_transceiver.desired_mode = T_MODE_RESPONDER;
   g_transceiver.data_index = 0u;
+  g_transceiver.discard_rx = false;
   g_transceiver.mode_change_token = TRANSCEIVER_NO_NOTIFICATION;
 
   InitializeBuffers();
   ResetTimingSettings();
 
+  Stats_AddCounter("transceiver.tx_frames", &g_stats.tx_frames);
+  Stats_AddCounter("transceiver.rx_frames", &g_stats.rx_frames);
+  Stats_AddCounter("transceiver.queue_full", &g_stats.queue_full);
+  Stats_AddCounter("transceiver.rx_overflows", &g_stats.rx_overflows);
+  Stats_AddCounter("transceiver.uart_overruns", &g_stats.uart_overruns);
+
   // Setup the Break, TX Enable & RX Enable I/O Pins
   PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
                                    g_hw_settings.port,
@@ -1142,6 +1219,10 @@ TransceiverMode Transceiver_GetMode() {
   return g_transceiver.mode;
 }
 
+unsigned int Transceiver_GetState() {
+  return g_transceiver.state;
+}
+
 void Transceiver_Tasks() {
   bool ok;
   LogStateChange();
@@ -1273,8 +1354,7 @@ void Transceiver_Tasks() {
       SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
       SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
       if (g_transceiver.data_index > 0 &&
-          CoarseTimer_HasElapsed(g_transceiver.last_byte_coarse,
-                                 CONTROLLER_RECEIVE_RDM_INTERSLOT_TIMEOUT)) {
+          InterSlotTimeout(CONTROLLER_RECEIVE_RDM_INTERSLOT_TIMEOUT)) {
         PLIB_TMR_Stop(g_hw_settings.timer_module_id);
         PLIB_USART_ReceiverDisable(g_hw_settings.usart);
         ResetToMark();
@@ -1341,6 +1421,7 @@ void Transceiver_Tasks() {
                      (uint16_t) (g_timing.get_set_response.mark_end -
                       g_timing.get_set_response.mark_start));
       }
+      Stats_Increment(&g_stats.tx_frames);
       FrameComplete();
       g_transceiver.state = STATE_C_BACKOFF;
       // Fall through
@@ -1432,6 +1513,7 @@ void Transceiver_Tasks() {
       g_timing.request.mark_time = 0u;
       g_transceiver.data_index = 0u;
       g_transceiver.event_index = 0u;
+      g_transceiver.discard_rx = false;
       g_transceiver.active->op = OP_RX;
 
       g_transceiver.state = STATE_R_RX_MBB;
@@ -1475,10 +1557,8 @@ void Transceiver_Tasks() {
         // Got at least one byte, so we have the start code.
         // Check the time since the last byte.
         if ((g_transceiver.active->data[0] == RDM_START_CODE &&
-             CoarseTimer_HasElapsed(g_transceiver.last_byte_coarse,
-                                    RESPONDER_RDM_INTERSLOT_TIMEOUT)) ||
-            CoarseTimer_HasElapsed(g_transceiver.last_byte_coarse,
-                                   RESPONDER_DMX_INTERSLOT_TIMEOUT)) {
+             InterSlotTimeout(RESPONDER_RDM_INTERSLOT_TIMEOUT)) ||
+            InterSlotTimeout(RESPONDER_DMX_INTERSLOT_TIMEOUT)) {
           // RDM inter-slot timeout
           RXEndFrameEvent();
           PLIB_USART_ReceiverDisable(g_hw_settings.usart);
@@ -1606,6 +1686,7 @@ bool Transceiver_QueueFrame(int16_t token, uint8_t start_code,
                             InternalOperation op, const uint8_t* data,
                             unsigned int size) {
   if (g_transceiver.free_size == 0u) {
+    Stats_Increment(&g_stats.queue_full);
     return false;
   }
 
@@ -1661,39 +1742,89 @@ bool Transceiver_QueueRDMRequest(int16_t token, const uint8_t* data,
       data, size);
 }
 
-bool Transceiver_QueueRDMResponse(bool include_break,
-                                  const IOVec* data,
-                                  unsigned int iov_count) {
-  if (g_transceiver.mode != T_MODE_RESPONDER || g_transceiver.free_size == 0u) {
-    return false;
+uint8_t *Transceiver_AcquireRDMResponseBuffer() {
+  if (g_transceiver.mode != T_MODE_RESPONDER || g_transceiver.free_size == 0u ||
+      g_transceiver.leased != NULL) {
+    return NULL;
   }
 
   if (g_transceiver.state != STATE_R_RX_DATA) {
     // Can only queue while we're receiving data
-    return false;
+    return NULL;
   }
 
   g_transceiver.free_size--;
-  g_transceiver.next = g_transceiver.free_list[g_transceiver.free_size];
+  g_transceiver.leased = g_transceiver.free_list[g_transceiver.free_size];
+  return g_transceiver.leased->data;
+}
+
+bool Transceiver_CommitRDMResponse(bool include_break, unsigned int size) {
+  if (g_transceiver.leased == NULL) {
+    return false;
+  }
+
+  if (g_transceiver.state != STATE_R_RX_DATA || size > BUFFER_SIZE) {
+    Transceiver_ReleaseRDMResponseBuffer();
+    return false;
+  }
+
+  g_transceiver.leased->size = size;
+  g_transceiver.leased->op = include_break ? OP_RDM_WITH_RESPONSE :
+                             OP_RDM_DUB_RESPONSE;
+  g_transceiver.next = g_transceiver.leased;
+  g_transceiver.leased = NULL;
+  return true;
+}
+
+void Transceiver_ReleaseRDMResponseBuffer() {
+  if (g_transceiver.leased) {
+    g_transceiver.free_list[g_transceiver.free_size] = g_transceiver.leased;
+    g_transceiver.free_size++;
+    g_transceiver.leased = NULL;
+  }
+}
+
+bool Transceiver_QueueRDMResponse(bool include_break,
+                                  const IOVec* data,
+                                  unsigned int iov_count) {
+  uint8_t *buffer = Transceiver_AcquireRDMResponseBuffer();
+  if (buffer == NULL) {
+    return false;
+  }
 
   unsigned int i = 0u;
   uint16_t offset = 0u;
   for (; i != iov_count; i++) {
     if (offset + data[i].length > BUFFER_SIZE) {
-      memcpy(g_transceiver.next->data + offset, data[i].base,
-             BUFFER_SIZE - offset);
+      memcpy(buffer + offset, data[i].base, BUFFER_SIZE - offset);
       offset = BUFFER_SIZE;
       SysLog_Message(SYSLOG_ERROR, "Truncated RDM response");
       break;
     } else {
-      memcpy(g_transceiver.next->data + offset, data[i].base, data[i].length);
+      memcpy(buffer + offset, data[i].base, data[i].length);
       offset += data[i].length;
     }
   }
-  g_transceiver.next->size = offset;
-  g_transceiver.next->op = include_break ? OP_RDM_WITH_RESPONSE :
-                           OP_RDM_DUB_RESPONSE;
-  return true;
+  return Transceiver_CommitRDMResponse(include_break, offset);
+}
+
+void Transceiver_DiscardRXFrame() {
+  if (g_transceiver.state == STATE_R_RX_DATA) {
+    g_transceiver.discard_rx = true;
+  }
+}
+
+bool Transceiver_IsIdle(uint16_t interval) {
+  switch (g_transceiver.state) {
+    case STATE_C_TX_READY:
+      return g_transceiver.next == NULL &&
+             g_transceiver.desired_mode == T_MODE_CONTROLLER;
+    case STATE_R_RX_MBB:
+      return g_transceiver.desired_mode == T_MODE_RESPONDER &&
+             LastByteElapsed(interval);
+    default:
+      return false;
+  }
 }
 
 bool Transceiver_QueueSelfTest(int16_t token) {
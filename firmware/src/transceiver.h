@@ -57,7 +57,10 @@
  *
  * In responder mode, the TransceiverEventCallback will be run when a frame is
  * received. The handler should call Transceiver_QueueRDMResponse() to send a
- * response frame. See @ref responder-overview "Responder State Machine".
+ * response frame. Alternatively the response can be built directly in the
+ * transmit buffer using Transceiver_AcquireRDMResponseBuffer() and
+ * Transceiver_CommitRDMResponse(), which avoids copying the frame. See
+ * @ref responder-overview "Responder State Machine".
  *
  * @par Self Test Mode
  *
@@ -301,6 +304,13 @@ bool Transceiver_SetMode(TransceiverMode mode, int16_t token);
  */
 TransceiverMode Transceiver_GetMode();
 
+/**
+ * @brief The state of the transceiver's internal state machine.
+ * @returns the current state, the values are defined in transceiver.c.
+ * @note This function should be used for testing only.
+ */
+unsigned int Transceiver_GetState();
+
 /**
  * @brief Perform the periodic transceiver tasks.
  *
@@ -366,6 +376,56 @@ bool Transceiver_QueueRDMResponse(bool include_break,
                                   const IOVec* iov,
                                   unsigned int iov_count);
 
+/**
+ * @brief Lease a transmit buffer so an RDM response can be built in-place.
+ * @returns A pointer to at least RDM_MAX_FRAME_SIZE bytes, or NULL if the
+ *   transceiver isn't receiving a frame in responder mode, or no buffer is
+ *   free.
+ *
+ * The lease must be completed with either Transceiver_CommitRDMResponse() or
+ * Transceiver_ReleaseRDMResponseBuffer() before the next frame is received.
+ * Only a single buffer may be leased at once.
+ */
+uint8_t *Transceiver_AcquireRDMResponseBuffer();
+
+/**
+ * @brief Queue the RDM response built in the leased buffer.
+ * @param include_break true if this response requires a break
+ * @param size The size of the response, including the start code.
+ * @returns true if the response was queued. If false is returned the leased
+ *   buffer is released.
+ */
+bool Transceiver_CommitRDMResponse(bool include_break, unsigned int size);
+
+/**
+ * @brief Return the leased buffer without sending a response.
+ *
+ * This is a no-op if there is no buffer leased.
+ */
+void Transceiver_ReleaseRDMResponseBuffer();
+
+/**
+ * @brief Discard the remainder of the frame currently being received.
+ *
+ * This should only be called from the RX event callback while in responder
+ * mode. The remaining slots of the frame are drained from the UART without
+ * being buffered, and no further T_RESULT_RX_CONTINUE_FRAME events will be
+ * delivered for the frame. It's used to skip RDM frames addressed to other
+ * devices.
+ */
+void Transceiver_DiscardRXFrame();
+
+/**
+ * @brief Check if the line is idle.
+ * @param interval In responder mode, the time since the last byte was
+ *   received, in 10ths of a millisecond.
+ * @returns true if no frame is in progress or pending.
+ *
+ * This is used to defer work that stalls the CPU, like erasing flash, until
+ * it won't disrupt the line timing. A frame may still start after this
+ * returns true, the caller should keep the work as short as possible.
+ */
+bool Transceiver_IsIdle(uint16_t interval);
 
 /**
  * @brief Schedule a loopback self test.
@@ -23,6 +23,7 @@
 #include <stdint.h>
 
 #include "receiver_counters.h"
+#include "stats.h"
 #include "syslog.h"
 #include "system_definitions.h"
 #include "transceiver.h"
@@ -91,6 +92,8 @@ typedef struct {
   CircularBuffer write;
   // The size of the last CDC write.
   unsigned int write_size;
+  // Log lines dropped or truncated because the buffer was full.
+  StatsCounter lines_dropped;
 } USBConsoleData;
 
 USBConsoleData g_usb_console;
@@ -265,6 +268,7 @@ void USBConsole_Initialize() {
 
   USB_DEVICE_CDC_EventHandlerSet(USB_DEVICE_CDC_INDEX_0,
                                  USBConsole_CDCEventHandler, NULL);
+  Stats_AddCounter("console.lines_dropped", &g_usb_console.lines_dropped);
 }
 
 void USBConsole_Log(const char* message) {
@@ -275,6 +279,7 @@ void USBConsole_Log(const char* message) {
   int16_t remaining = SpaceRemaining();
   if (remaining < LOG_TERMINATOR_SIZE) {
     // There isn't enough room for the terminator characters.
+    Stats_Increment(&g_usb_console.lines_dropped);
     return;
   }
 
@@ -289,6 +294,8 @@ void USBConsole_Log(const char* message) {
   // We need to terminate with \r\n
   remaining = SpaceRemaining();
   if (remaining < LOG_TERMINATOR_SIZE) {
+    // The message was truncated.
+    Stats_Increment(&g_usb_console.lines_dropped);
     g_usb_console.write.write -= LOG_TERMINATOR_SIZE;
     if (g_usb_console.write.write < 0) {
       g_usb_console.write.write += USB_CONSOLE_BUFFER_SIZE;
@@ -29,6 +29,7 @@
 #include "flags.h"
 #include "macros.h"
 #include "reset.h"
+#include "stats.h"
 #include "stream_decoder.h"
 #include "system_config.h"
 #include "system_definitions.h"
@@ -63,6 +64,7 @@ typedef struct {
   uint8_t alt_setting;  //!< The alternate setting, always 0
 
   int rx_data_size;
+  StatsCounter tx_busy;  //!< Messages not sent because a TX was in progress.
 } USBTransportData;
 
 static USBTransportData g_usb_transport_data;
@@ -215,6 +217,7 @@ void USBTransport_Initialize(TransportRxFunction rx_cb) {
   g_usb_transport_data.dfu_detach = false;
   g_usb_transport_data.alt_setting = 0;
   g_usb_transport_data.rx_data_size = 0;
+  Stats_AddCounter("usb.tx_busy", &g_usb_transport_data.tx_busy);
 }
 
 void USBTransport_Tasks() {
@@ -336,8 +339,11 @@ void USBTransport_Tasks() {
 
 bool USBTransport_SendResponse(uint8_t token, Command command, uint8_t rc,
                                const IOVec* data, unsigned int iov_count) {
-  if (g_usb_transport_data.tx_in_progress ||
-      g_usb_transport_data.state != USB_STATE_MAIN_TASK) {
+  if (g_usb_transport_data.state != USB_STATE_MAIN_TASK) {
+    return false;
+  }
+  if (g_usb_transport_data.tx_in_progress) {
+    Stats_Increment(&g_usb_transport_data.tx_busy);
     return false;
   }
 
@@ -0,0 +1,102 @@
+#!/usr/bin/python
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Library General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# generate_gamma_tables.py
+# Copyright (C) 2015 Simon Newton
+
+"""Generate firmware/src/gamma_tables.c.
+
+The PIC32MX doesn't have an FPU, so the gamma curves used by the pixel output
+are computed here and compiled into flash. Run this after changing GAMMAS:
+
+  ./scripts/generate_gamma_tables.py firmware/src/gamma_tables.c
+"""
+
+from __future__ import print_function
+
+import argparse
+import sys
+
+# (name, gamma)
+GAMMAS = [
+  ('GAMMA_2_2', 2.2),
+  ('GAMMA_2_8', 2.8),
+]
+
+VALUES_PER_LINE = 8
+MAX_OUTPUT = 0xffff
+
+HEADER = """\
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * gamma_tables.c
+ * Copyright (C) 2015 Simon Newton
+ *
+ * Generated by scripts/generate_gamma_tables.py, do not edit.
+ */
+
+#include "gamma_tables.h"
+"""
+
+
+def Curve(gamma):
+  return [int(round(MAX_OUTPUT * pow(i / 255.0, gamma))) for i in range(256)]
+
+
+def FormatTable(name, gamma):
+  lines = ['', '// gamma = %.1f' % gamma,
+           'const uint16_t %s[GAMMA_TABLE_SIZE] = {' % name]
+  values = Curve(gamma)
+  for i in range(0, len(values), VALUES_PER_LINE):
+    chunk = values[i:i + VALUES_PER_LINE]
+    lines.append('  ' + ', '.join('%5d' % v for v in chunk) + ',')
+  lines[-1] = lines[-1].rstrip(',')
+  lines.append('};')
+  return '\n'.join(lines)
+
+
+def ParseArgs():
+  parser = argparse.ArgumentParser(
+      description='Generate the gamma lookup tables for the firmware.')
+  parser.add_argument('output_file',
+                      help='The file to write, usually '
+                           'firmware/src/gamma_tables.c')
+  return parser.parse_args()
+
+
+def main():
+  args = ParseArgs()
+  output = HEADER + '\n'.join(FormatTable(n, g) for n, g in GAMMAS) + '\n'
+  with open(args.output_file, 'w') as f:
+    f.write(output)
+  print('Wrote %s' % args.output_file)
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
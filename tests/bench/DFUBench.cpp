@@ -0,0 +1,73 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DFUBench.cpp
+ * Benchmarks for the hex2dfu & DFU CRC routines.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "tools/dfu.h"
+#include "tools/utils.h"
+
+/*
+ * CRC a firmware image. The argument is the image size in bytes, the largest
+ * is the size of the application flash region that hex2dfu extracts.
+ */
+static void BM_DFU_CalculateCRC(benchmark::State &state) {
+  std::vector<uint8_t> data(state.range(0));
+  for (unsigned int i = 0; i < data.size(); i++) {
+    data[i] = i * 7;
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        DFU_CalculateCRC(DFU_INITIAL_CRC, data.data(), data.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_DFU_CalculateCRC)->Arg(64)->Arg(4096)->Arg(0x79000);
+
+/*
+ * Decode the data from a hex record, the way hex2dfu does for each line of
+ * the file. The argument is the number of data bytes in the record.
+ */
+static void BM_Hex2DFU_DecodeRecord(benchmark::State &state) {
+  static const char DIGITS[] = "0123456789ABCDEF";
+  const unsigned int byte_count = state.range(0);
+  std::string hex_data;
+  for (unsigned int i = 0; i < byte_count; i++) {
+    hex_data.push_back(DIGITS[(i >> 4) & 0xf]);
+    hex_data.push_back(DIGITS[i & 0xf]);
+  }
+  std::vector<uint8_t> data(byte_count);
+
+  for (auto _ : state) {
+    uint8_t checksum = 0;
+    for (unsigned int i = 0; i < byte_count; i++) {
+      HexToUInt8(hex_data.data() + (i * 2), &data[i]);
+      checksum += data[i];
+    }
+    benchmark::DoNotOptimize(checksum);
+  }
+  state.SetBytesProcessed(state.iterations() * hex_data.size());
+}
+BENCHMARK(BM_Hex2DFU_DecodeRecord)->Arg(16)->Arg(255);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,121 @@
+# Benchmarks
+##################################################
+
+if BUILD_BENCHMARKS
+
+BENCHMARK_CXXFLAGS = $(BUILD_FLAGS) $(WARNING_CXXFLAGS) $(BENCHMARK_CFLAGS)
+
+# The mocks need gmock, even though the benchmarks don't set expectations.
+# These must come after the mocks when linking.
+BENCHMARK_MOCK_LIBS = $(GMOCK_LIBS) $(GTEST_LIBS)
+
+BENCHMARKS = tests/bench/dfu_bench \
+             tests/bench/message_handler_bench \
+             tests/bench/rdm_bench \
+             tests/bench/responder_bench \
+             tests/bench/responder_soak_bench \
+             tests/bench/stream_decoder_bench
+
+noinst_PROGRAMS += $(BENCHMARKS)
+
+tests_bench_dfu_bench_SOURCES = tests/bench/DFUBench.cpp
+tests_bench_dfu_bench_CXXFLAGS = $(BENCHMARK_CXXFLAGS)
+tests_bench_dfu_bench_LDADD = $(BENCHMARK_LIBS) \
+                              tools/libdfu.la
+
+tests_bench_message_handler_bench_SOURCES = \
+    tests/bench/MessageHandlerBench.cpp \
+    tests/bench/TransceiverStub.cpp
+tests_bench_message_handler_bench_CXXFLAGS = $(BENCHMARK_CXXFLAGS)
+tests_bench_message_handler_bench_LDADD = \
+    $(BENCHMARK_LIBS) \
+    firmware/src/libmessagehandler.la \
+    firmware/src/libstackmonitor.la \
+    firmware/src/libtimerwheel.la \
+    firmware/src/libstats.la \
+    firmware/src/libcoarsetimer.la \
+    tests/mocks/libappmock.la \
+    tests/mocks/libdmxforwardermock.la \
+    tests/mocks/libflagsmock.la \
+    tests/mocks/librdmhandlermock.la \
+    tests/mocks/libsyslogmock.la \
+    tests/harmony/mocks/libharmonymock.la \
+    $(BENCHMARK_MOCK_LIBS)
+
+tests_bench_rdm_bench_SOURCES = tests/bench/RDMBench.cpp
+tests_bench_rdm_bench_CXXFLAGS = $(BENCHMARK_CXXFLAGS)
+tests_bench_rdm_bench_LDADD = \
+    $(BENCHMARK_LIBS) \
+    firmware/src/libdimmermodel.la \
+    firmware/src/libledmodel.la \
+    firmware/src/libnetworkmodel.la \
+    firmware/src/libproxymodel.la \
+    firmware/src/libsensormodel.la \
+    firmware/src/libfader.la \
+    firmware/src/libstatusqueue.la \
+    firmware/src/librdmresponder.la \
+    firmware/src/libreceivercounters.la \
+    firmware/src/libtimerwheel.la \
+    firmware/src/libcoarsetimer.la \
+    firmware/src/librdmbuffer.la \
+    firmware/src/librandom.la \
+    firmware/src/librdmutil.la \
+    firmware/src/libstats.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libspirgbmock.la \
+    $(BENCHMARK_MOCK_LIBS)
+
+tests_bench_responder_bench_SOURCES = tests/bench/ResponderBench.cpp
+tests_bench_responder_bench_CXXFLAGS = $(BENCHMARK_CXXFLAGS)
+tests_bench_responder_bench_LDADD = $(BENCHMARK_LIBS) \
+                                    firmware/src/libresponder.la \
+                                    firmware/src/libdmxinput.la \
+                                    firmware/src/libreceivercounters.la \
+                                    firmware/src/librdmutil.la \
+                                    tests/mocks/librdmhandlermock.la \
+                                    tests/mocks/libsyslogmock.la \
+                                    tests/mocks/libtransceivermock.la \
+                                    $(BENCHMARK_MOCK_LIBS)
+
+tests_bench_responder_soak_bench_SOURCES = tests/bench/ResponderSoakBench.cpp
+tests_bench_responder_soak_bench_CXXFLAGS = \
+    $(BENCHMARK_CXXFLAGS) $(OLA_CFLAGS) \
+    $(GMOCK_INCLUDES) $(GTEST_INCLUDES) \
+    -I tests/mocks -I tests/harmony/mocks
+tests_bench_responder_soak_bench_LDADD = \
+    $(BENCHMARK_LIBS) $(OLA_LIBS) \
+    tests/sim/libsim.la \
+    firmware/src/libtransceiver.la \
+    firmware/src/libresponder.la \
+    firmware/src/libdmxinput.la \
+    firmware/src/libreceivercounters.la \
+    firmware/src/librdmutil.la \
+    firmware/src/libcoarsetimer.la \
+    firmware/src/libmonotonicclock.la \
+    firmware/src/libstats.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/librdmhandlermock.la \
+    tests/mocks/libsyslogmock.la \
+    $(BENCHMARK_MOCK_LIBS)
+
+tests_bench_stream_decoder_bench_SOURCES = tests/bench/StreamDecoderBench.cpp
+tests_bench_stream_decoder_bench_CXXFLAGS = $(BENCHMARK_CXXFLAGS)
+tests_bench_stream_decoder_bench_LDADD = $(BENCHMARK_LIBS) \
+                                         firmware/src/libstreamdecoder.la \
+                                         firmware/src/libstats.la
+
+# Run each benchmark, the results are written to <benchmark>.json.
+# Extra arguments can be passed with BENCHMARK_FLAGS, e.g.
+#   make bench BENCHMARK_FLAGS=--benchmark_filter=CRC
+bench: $(BENCHMARKS)
+	@for bench in $(BENCHMARKS); do \
+	  echo "Running $$bench"; \
+	  ./$$bench --benchmark_out=$$bench.json \
+	    --benchmark_out_format=json $(BENCHMARK_FLAGS) || exit 1; \
+	done
+
+CLEANFILES = $(BENCHMARKS:=.json)
+
+.PHONY: bench
+
+endif
@@ -0,0 +1,71 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MessageHandlerBench.cpp
+ * Benchmarks for the message handler.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "constants.h"
+#include "dmx_spec.h"
+#include "message_handler.h"
+#include "stream_decoder.h"
+
+namespace {
+
+unsigned int g_sent_messages = 0u;
+
+bool CountSend(uint8_t, Command, uint8_t, const IOVec*, unsigned int) {
+  g_sent_messages++;
+  return true;
+}
+
+}  // namespace
+
+/*
+ * Handle a TX_DMX message. The argument is the number of slots in the frame.
+ *
+ * Queueing succeeds, so no reply is sent from the handler.
+ */
+static void BM_MessageHandler_TXDMX(benchmark::State &state) {
+  uint8_t slots[DMX_FRAME_SIZE];
+  for (unsigned int i = 0; i < DMX_FRAME_SIZE; i++) {
+    slots[i] = i;
+  }
+
+  Message message;
+  message.token = 1;
+  message.command = TX_DMX;
+  message.length = state.range(0);
+  message.payload = slots;
+
+  MessageHandler_Initialize(CountSend);
+  g_sent_messages = 0u;
+
+  for (auto _ : state) {
+    MessageHandler_HandleMessage(&message);
+  }
+
+  if (g_sent_messages) {
+    state.SkipWithError("Unexpected reply");
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * message.length);
+}
+BENCHMARK(BM_MessageHandler_TXDMX)->Arg(0)->Arg(24)->Arg(DMX_FRAME_SIZE);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,169 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMBench.cpp
+ * Benchmarks for the RDM checksum & PID dispatch.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <string>
+
+#include "constants.h"
+#include "dimmer_model.h"
+#include "led_model.h"
+#include "network_model.h"
+#include "proxy_model.h"
+#include "rdm.h"
+#include "rdm_frame.h"
+#include "rdm_responder.h"
+#include "rdm_util.h"
+#include "sensor_model.h"
+#include "utils.h"
+
+namespace {
+
+const uint8_t TEST_UID[UID_LENGTH] = {0x7a, 0x70, 0x12, 0x34, 0x56, 0x78};
+const uint8_t CONTROLLER_UID[UID_LENGTH] = {0x7a, 0x70, 0, 0, 0, 0};
+
+// A PID that none of the models support, so the whole table is searched.
+const uint16_t UNKNOWN_PID = 0x7fe0;
+
+const unsigned int MAX_RDM_FRAME_SIZE =
+    sizeof(RDMHeader) + MAX_PARAM_DATA_SIZE + RDM_CHECKSUM_LENGTH;
+
+/*
+ * @brief Build a GET request for our UID.
+ * @returns The size of the frame, including the checksum.
+ */
+unsigned int BuildGetRequest(uint16_t pid, uint8_t param_data_length,
+                             uint8_t *frame) {
+  memset(frame, 0, MAX_RDM_FRAME_SIZE);
+  RDMHeader *header = reinterpret_cast<RDMHeader*>(frame);
+  header->start_code = RDM_START_CODE;
+  header->sub_start_code = RDM_SUB_START_CODE;
+  header->message_length = sizeof(RDMHeader) + param_data_length;
+  memcpy(header->dest_uid, TEST_UID, UID_LENGTH);
+  memcpy(header->src_uid, CONTROLLER_UID, UID_LENGTH);
+  header->command_class = GET_COMMAND;
+  PushUInt16(reinterpret_cast<uint8_t*>(&header->param_id), pid);
+  header->param_data_length = param_data_length;
+  return RDMUtil_AppendChecksum(frame);
+}
+
+typedef struct {
+  const char *name;
+  const ModelEntry *entry;
+  void (*initialize)();
+} ModelInfo;
+
+const ModelInfo MODELS[] = {
+  {"dimmer", &DIMMER_MODEL_ENTRY, DimmerModel_Initialize},
+  {"led", &LED_MODEL_ENTRY, LEDModel_Initialize},
+  {"network", &NETWORK_MODEL_ENTRY, NetworkModel_Initialize},
+  {"proxy", &PROXY_MODEL_ENTRY, ProxyModel_Initialize},
+  {"sensor", &SENSOR_MODEL_ENTRY, SensorModel_Initialize},
+};
+
+typedef enum {
+  FIRST_PID,
+  LAST_PID,
+  NO_SUCH_PID,
+} PIDPosition;
+
+/*
+ * @brief Find a PID in the active responder's table that can be fetched
+ * without param data.
+ */
+uint16_t FindPID(PIDPosition position) {
+  const ResponderDefinition *def = g_responder->def;
+  for (unsigned int i = 0; i < def->descriptor_count; i++) {
+    const PIDDescriptor &descriptor = def->descriptors[
+        position == FIRST_PID ? i : def->descriptor_count - 1 - i];
+    if (descriptor.get_handler && descriptor.get_param_size == 0u) {
+      return descriptor.pid;
+    }
+  }
+  return UNKNOWN_PID;
+}
+
+void BM_RDMResponder_DispatchPID(benchmark::State &state,
+                                 const ModelInfo *model,
+                                 PIDPosition position) {
+  RDMResponderSettings settings;
+  memset(&settings, 0, sizeof(settings));
+  memcpy(settings.uid, TEST_UID, UID_LENGTH);
+  RDMResponder_Initialize(&settings);
+  model->initialize();
+  model->entry->activate_fn();
+
+  const uint16_t pid = position == NO_SUCH_PID ? UNKNOWN_PID :
+      FindPID(position);
+  uint8_t frame[MAX_RDM_FRAME_SIZE];
+  BuildGetRequest(pid, 0u, frame);
+  const RDMHeader *header = reinterpret_cast<const RDMHeader*>(frame);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        RDMResponder_DispatchPID(header, frame + sizeof(RDMHeader)));
+  }
+  state.counters["descriptors"] = g_responder->def->descriptor_count;
+  model->entry->deactivate_fn();
+}
+
+void BM_RDMUtil_VerifyChecksum(benchmark::State &state) {
+  uint8_t frame[MAX_RDM_FRAME_SIZE];
+  const unsigned int size = BuildGetRequest(PID_DEVICE_INFO, state.range(0),
+                                            frame);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(RDMUtil_VerifyChecksum(frame, size));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+}  // namespace
+
+BENCHMARK(BM_RDMUtil_VerifyChecksum)
+    ->Arg(0)->Arg(64)->Arg(MAX_PARAM_DATA_SIZE);
+
+int main(int argc, char *argv[]) {
+  const struct {
+    const char *name;
+    PIDPosition position;
+  } positions[] = {
+    {"first", FIRST_PID},
+    {"last", LAST_PID},
+    {"unknown", NO_SUCH_PID},
+  };
+
+  for (const ModelInfo &model : MODELS) {
+    for (const auto &position : positions) {
+      const std::string name = std::string("BM_RDMResponder_DispatchPID/") +
+          model.name + "/" + position.name;
+      benchmark::RegisterBenchmark(name.c_str(), BM_RDMResponder_DispatchPID,
+                                   &model, position.position);
+    }
+  }
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderBench.cpp
+ * Benchmarks for the responder's receive path.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+
+#include "dmx_input.h"
+#include "dmx_spec.h"
+#include "receiver_counters.h"
+#include "responder.h"
+#include "transceiver.h"
+
+/*
+ * Receive a full DMX frame per iteration. The argument is the number of bytes
+ * added to the frame between calls to Responder_Receive(), which is how the
+ * transceiver delivers the frame as the UART fills the buffer.
+ *
+ * The RDMHandler & Transceiver mocks are linked without expectations, so the
+ * model's DMX window is empty.
+ */
+static void BM_Responder_ReceiveDMXFrame(benchmark::State &state) {
+  const unsigned int chunk_size = state.range(0);
+  const unsigned int size = DMX_FRAME_SIZE + 1u;
+  uint8_t frame[size];
+  frame[0] = NULL_START_CODE;
+  for (unsigned int i = 1; i < size; i++) {
+    frame[i] = i;
+  }
+
+  Responder_Initialize();
+  ReceiverCounters_ResetCounters();
+
+  TransceiverEvent event;
+  event.token = 0;
+  event.op = T_OP_RX;
+  event.data = frame;
+  event.timing = NULL;
+
+  for (auto _ : state) {
+    for (unsigned int i = 0; i < size; i += chunk_size) {
+      event.result = i ? T_RESULT_RX_CONTINUE_FRAME : T_RESULT_RX_START_FRAME;
+      event.length = std::min(i + chunk_size, size);
+      Responder_Receive(&event);
+    }
+  }
+
+  if (DMXInput_LatestSequence() != state.iterations()) {
+    state.SkipWithError("Frames were lost");
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_Responder_ReceiveDMXFrame)
+    ->Arg(1)->Arg(16)->Arg(DMX_FRAME_SIZE + 1);
+
+BENCHMARK_MAIN();
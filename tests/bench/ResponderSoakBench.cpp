@@ -0,0 +1,345 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderSoakBench.cpp
+ * A soak test of the responder's receive path, under sustained load.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "RDMHandlerMock.h"
+#include "coarse_timer.h"
+#include "constants.h"
+#include "monotonic_clock.h"
+#include "rdm.h"
+#include "rdm_frame.h"
+#include "rdm_util.h"
+#include "receiver_counters.h"
+#include "responder.h"
+#include "setting_macros.h"
+#include "transceiver.h"
+
+#include "tests/sim/InterruptController.h"
+#include "tests/sim/LoadGenerator.h"
+#include "tests/sim/PeripheralCoreTimer.h"
+#include "tests/sim/PeripheralInputCapture.h"
+#include "tests/sim/PeripheralPorts.h"
+#include "tests/sim/PeripheralTimer.h"
+#include "tests/sim/PeripheralUART.h"
+#include "tests/sim/SignalGenerator.h"
+#include "tests/sim/Simulator.h"
+
+using ola::NewCallback;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::_;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Declare the ISR symbols.
+void InputCaptureEvent(void);
+void Transceiver_TimerEvent();
+void Transceiver_UARTEvent();
+
+#ifdef __cplusplus
+}
+#endif
+
+namespace {
+
+const uint32_t kClockSpeed = 80000000;
+const uint32_t kBaudRate = 250000;
+const uint64_t kResponderUID = 0x7a7000000001;
+
+// E1.20 allows 2ms from the end of the request to the start of the response.
+// The latency is measured to the first slot, so add the response break & mark.
+const double kMaxLatency = 2000.0 + 176.0 + 12.0;
+
+// Long enough for the last queued frames to be sent, in microseconds. This
+// covers two full DMX512 frames & an RDM response.
+const uint64_t kDrainTime = 100000;
+
+// The simulated time to run for, in seconds. Set with --soak_duration.
+unsigned int g_soak_duration = 1;
+
+// The coarse timer ISR, as in app.c.
+void TimerEvent() {
+  CoarseTimer_TimerEvent();
+  MonotonicClock_Update();
+}
+
+/*
+ * @brief A responder, with the transceiver running on simulated peripherals.
+ *
+ * The RDM handler is mocked, it ACKs every request with an empty GET
+ * response. This keeps the model code out of the measurement.
+ */
+class SoakHarness {
+ public:
+  SoakHarness()
+      : m_tx_callback(NewCallback(this, &SoakHarness::GotByte)),
+        m_callback(NewCallback(this, &SoakHarness::Tasks)),
+        m_simulator(kClockSpeed),
+        m_core_timer(&m_simulator),
+        m_timer(&m_simulator, &m_interrupt_controller),
+        m_ic(&m_simulator, &m_interrupt_controller),
+        m_uart(&m_simulator, &m_interrupt_controller, m_tx_callback.get()),
+        m_generator(&m_simulator, &m_ic, &m_uart, AS_IC_ID(2),
+                    AS_USART_ID(1), kClockSpeed, kBaudRate),
+        m_request_time(0),
+        m_responses(0),
+        m_min_latency(UINT64_MAX),
+        m_max_latency(0) {
+    PLIB_TMR_SetMock(&m_timer);
+    PLIB_IC_SetMock(&m_ic);
+    PLIB_USART_SetMock(&m_uart);
+    PLIB_PORTS_SetMock(&m_ports);
+    SYS_INT_SetMock(&m_interrupt_controller);
+    CORE_TIMER_SetMock(&m_core_timer);
+    RDMHandler_SetMock(&m_rdm_handler);
+
+    ON_CALL(m_rdm_handler, RequiresAction(_)).WillByDefault(Return(true));
+    ON_CALL(m_rdm_handler, HandleRequest(_, _))
+        .WillByDefault(Invoke(this, &SoakHarness::HandleRequest));
+
+    m_interrupt_controller.RegisterISR(INT_SOURCE_TIMER_1,
+        NewCallback(&TimerEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_TIMER_3,
+        NewCallback(&Transceiver_TimerEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_INPUT_CAPTURE_2,
+        NewCallback(&InputCaptureEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_ERROR,
+        NewCallback(&Transceiver_UARTEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_TRANSMIT,
+        NewCallback(&Transceiver_UARTEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_RECEIVE,
+        NewCallback(&Transceiver_UARTEvent));
+
+    m_simulator.AddTask(m_callback.get());
+
+    TransceiverHardwareSettings settings = {
+      .usart = AS_USART_ID(1),
+      .usart_vector = AS_USART_INTERRUPT_VECTOR(1),
+      .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(1),
+      .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(1),
+      .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(1),
+      .port = PORT_CHANNEL_F,
+      .break_bit = PORTS_BIT_POS_8,
+      .tx_enable_bit = PORTS_BIT_POS_1,
+      .rx_enable_bit = PORTS_BIT_POS_0,
+      .input_capture_module = AS_IC_ID(2),
+      .input_capture_vector = AS_IC_INTERRUPT_VECTOR(2),
+      .input_capture_source = AS_IC_INTERRUPT_SOURCE(2),
+      .timer_module_id = AS_TIMER_ID(3),
+      .timer_vector = AS_TIMER_INTERRUPT_VECTOR(3),
+      .timer_source = AS_TIMER_INTERRUPT_SOURCE(3),
+      .input_capture_timer = AS_IC_TMR_ID(3),
+    };
+    Transceiver_Initialize(&settings, nullptr, &RXHandler);
+
+    CoarseTimer_Settings timer_settings = {
+      .timer_id = AS_TIMER_ID(1),
+      .interrupt_source = AS_TIMER_INTERRUPT_SOURCE(1)
+    };
+    MonotonicClock_Initialize();
+    CoarseTimer_Initialize(&timer_settings);
+    Responder_Initialize();
+    ReceiverCounters_ResetCounters();
+    Transceiver_SetMode(T_MODE_RESPONDER, 0);
+  }
+
+  ~SoakHarness() {
+    m_simulator.RemoveTask(m_callback.get());
+    RDMHandler_SetMock(nullptr);
+    PLIB_TMR_SetMock(nullptr);
+    PLIB_IC_SetMock(nullptr);
+    PLIB_USART_SetMock(nullptr);
+    PLIB_PORTS_SetMock(nullptr);
+    SYS_INT_SetMock(nullptr);
+    CORE_TIMER_SetMock(nullptr);
+  }
+
+  Simulator *GetSimulator() { return &m_simulator; }
+  SignalGenerator *GetSignalGenerator() { return &m_generator; }
+
+  // Run for a duration, in microseconds.
+  void Run(uint64_t duration) {
+    m_simulator.SetClockLimit(duration, false);
+    m_simulator.Run();
+  }
+
+  uint64_t Responses() const { return m_responses; }
+
+  // The time from the RDM handler being called to the first slot of the
+  // response, in microseconds.
+  double MinLatency() const {
+    return m_responses ? ToMicroSeconds(m_min_latency) : 0.0;
+  }
+  double MaxLatency() const { return ToMicroSeconds(m_max_latency); }
+
+ private:
+  std::unique_ptr<PeripheralUART::TXCallback> m_tx_callback;
+  std::unique_ptr<ola::Callback0<void>> m_callback;
+
+  Simulator m_simulator;
+  InterruptController m_interrupt_controller;
+  PeripheralCoreTimer m_core_timer;
+  PeripheralTimer m_timer;
+  PeripheralInputCapture m_ic;
+  PeripheralPorts m_ports;
+  PeripheralUART m_uart;
+  SignalGenerator m_generator;
+  NiceMock<MockRDMHandler> m_rdm_handler;
+
+  uint8_t m_response[RDM_MAX_FRAME_SIZE];
+  uint64_t m_request_time;  // 0 if no response is pending.
+  uint64_t m_responses;
+  uint64_t m_min_latency;
+  uint64_t m_max_latency;
+
+  static bool RXHandler(const TransceiverEvent *event) {
+    Responder_Receive(event);
+    return true;
+  }
+
+  void Tasks() {
+    Transceiver_Tasks();
+  }
+
+  void GotByte(USART_MODULE_ID uart_id, uint8_t byte) {
+    if (uart_id != AS_USART_ID(1) || m_request_time == 0) {
+      return;
+    }
+    const uint64_t latency = m_simulator.Clock() - m_request_time;
+    m_min_latency = std::min(m_min_latency, latency);
+    m_max_latency = std::max(m_max_latency, latency);
+    m_request_time = 0;
+    m_responses++;
+    (void) byte;
+  }
+
+  void HandleRequest(const RDMHeader *header, const uint8_t *param_data) {
+    RDMHeader *response = reinterpret_cast<RDMHeader*>(m_response);
+    memcpy(response, header, sizeof(RDMHeader));
+    memcpy(response->dest_uid, header->src_uid, UID_LENGTH);
+    memcpy(response->src_uid, header->dest_uid, UID_LENGTH);
+    response->message_length = sizeof(RDMHeader);
+    response->port_id = ACK;
+    response->command_class = header->command_class + 1;
+    response->param_data_length = 0;
+
+    IOVec iov;
+    iov.base = m_response;
+    iov.length = RDMUtil_AppendChecksum(m_response);
+    if (Transceiver_QueueRDMResponse(true, &iov, 1)) {
+      m_request_time = m_simulator.Clock();
+    }
+    (void) param_data;
+  }
+
+  double ToMicroSeconds(uint64_t cycles) const {
+    return cycles * 1000000.0 / kClockSpeed;
+  }
+};
+
+}  // namespace
+
+/*
+ * Run the responder for g_soak_duration seconds of simulated traffic, from a
+ * LoadGenerator. Each frame the responder should have seen is checked against
+ * the receiver counters, and every RDM request must be answered.
+ *
+ * The argument is the seed for the LoadGenerator.
+ */
+static void BM_Responder_Soak(benchmark::State &state) {
+  for (auto _ : state) {
+    SoakHarness harness;
+    LoadGenerator load(harness.GetSimulator(), harness.GetSignalGenerator(),
+                       kResponderUID);
+    load.SetSeed(state.range(0));
+
+    const auto start = std::chrono::steady_clock::now();
+    // Run on after the load stops, so the frames already queued play out.
+    const uint64_t duration = g_soak_duration * 1000000ull;
+    load.StopAt(duration * (kClockSpeed / 1000000));
+    harness.Run(duration + kDrainTime);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    const LoadGenerator::Counters &sent = load.GetCounters();
+    const uint64_t dmx_frames = sent.dmx_frames + sent.framing_errors;
+    const uint64_t frames = dmx_frames + sent.asc_frames + sent.rdm_requests;
+    const uint64_t received = ReceiverCounters_DMXFrames() +
+        ReceiverCounters_ASCFrames() + ReceiverCounters_RDMFrames();
+    const uint64_t drops = frames - std::min(frames, received);
+
+    state.counters["frames"] = frames;
+    state.counters["drops"] = drops;
+    state.counters["dmx_frames"] = ReceiverCounters_DMXFrames();
+    state.counters["asc_frames"] = ReceiverCounters_ASCFrames();
+    state.counters["rdm_frames"] = ReceiverCounters_RDMFrames();
+    state.counters["rdm_responses"] = harness.Responses();
+    state.counters["short_breaks"] = sent.short_breaks;
+    state.counters["min_latency_us"] = harness.MinLatency();
+    state.counters["max_latency_us"] = harness.MaxLatency();
+    state.counters["sim_speed"] = g_soak_duration / elapsed.count();
+
+    if (drops || received > frames) {
+      state.SkipWithError("The receiver counters don't match the load");
+    } else if (harness.Responses() != sent.rdm_requests) {
+      state.SkipWithError("RDM requests were not answered");
+    } else if (harness.MaxLatency() > kMaxLatency) {
+      state.SkipWithError("An RDM response was late");
+    }
+  }
+}
+BENCHMARK(BM_Responder_Soak)
+    ->Arg(1)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+int main(int argc, char **argv) {
+  // Strip --soak_duration=<seconds> before the benchmark flags are parsed.
+  const std::string flag = "--soak_duration=";
+  int out = 1;
+  for (int i = 1; i < argc; i++) {
+    if (flag.compare(0, flag.size(), argv[i], flag.size()) == 0) {
+      g_soak_duration = atoi(argv[i] + flag.size());
+    } else {
+      argv[out++] = argv[i];
+    }
+  }
+  argc = out;
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * StreamDecoderBench.cpp
+ * Benchmarks for the stream decoder.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "constants.h"
+#include "stream_decoder.h"
+
+namespace {
+
+// The max packet size for a full speed USB bulk endpoint.
+const unsigned int USB_PACKET_SIZE = 64u;
+
+// The number of messages in each stream.
+const unsigned int MESSAGE_COUNT = 16u;
+
+unsigned int g_message_count = 0u;
+
+void CountMessage(const Message *message) {
+  benchmark::DoNotOptimize(message->payload);
+  g_message_count++;
+}
+
+/*
+ * Build a stream of TX_DMX messages, each with the given payload size.
+ */
+std::vector<uint8_t> BuildStream(unsigned int payload_size) {
+  std::vector<uint8_t> stream;
+  for (unsigned int i = 0; i < MESSAGE_COUNT; i++) {
+    stream.push_back(START_OF_MESSAGE_ID);
+    stream.push_back(i);
+    stream.push_back(TX_DMX & 0xff);
+    stream.push_back(TX_DMX >> 8);
+    stream.push_back(payload_size & 0xff);
+    stream.push_back(payload_size >> 8);
+    for (unsigned int j = 0; j < payload_size; j++) {
+      stream.push_back(j);
+    }
+    stream.push_back(END_OF_MESSAGE_ID);
+  }
+  return stream;
+}
+
+void RunStream(benchmark::State &state, unsigned int chunk_size) {
+  const std::vector<uint8_t> stream = BuildStream(state.range(0));
+  StreamDecoder_Initialize(CountMessage);
+  g_message_count = 0u;
+
+  for (auto _ : state) {
+    for (unsigned int offset = 0; offset < stream.size();
+         offset += chunk_size) {
+      StreamDecoder_Process(
+          stream.data() + offset,
+          std::min<unsigned int>(chunk_size, stream.size() - offset));
+    }
+  }
+
+  if (g_message_count != MESSAGE_COUNT * state.iterations()) {
+    state.SkipWithError("Messages were lost");
+  }
+  state.SetItemsProcessed(g_message_count);
+  state.SetBytesProcessed(state.iterations() * stream.size());
+}
+
+}  // namespace
+
+/*
+ * The whole stream is passed in a single call, so the payloads are handed to
+ * the MessageHandler without copying.
+ */
+static void BM_StreamDecoder_Contiguous(benchmark::State &state) {
+  RunStream(state, ~0u);
+}
+BENCHMARK(BM_StreamDecoder_Contiguous)->Arg(0)->Arg(64)->Arg(PAYLOAD_SIZE);
+
+/*
+ * The stream arrives in USB sized packets, so messages larger than a packet
+ * are reassembled in the decoder's buffer.
+ */
+static void BM_StreamDecoder_Fragmented(benchmark::State &state) {
+  RunStream(state, USB_PACKET_SIZE);
+}
+BENCHMARK(BM_StreamDecoder_Fragmented)->Arg(0)->Arg(64)->Arg(PAYLOAD_SIZE);
+
+BENCHMARK_MAIN();
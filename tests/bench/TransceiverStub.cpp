@@ -0,0 +1,130 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TransceiverStub.cpp
+ * A minimal transceiver for the message handler benchmarks.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <string.h>
+
+#include "dmx_spec.h"
+#include "transceiver.h"
+
+/*
+ * The gmock based transceiver adds more overhead than the message handler
+ * itself, so the benchmarks use this instead. The transceiver is always in
+ * controller mode and frames are copied into a single buffer, which is
+ * roughly what Transceiver_QueueDMX() does.
+ */
+
+namespace {
+
+uint8_t g_frame[DMX_FRAME_SIZE];
+TransceiverMode g_mode = T_MODE_CONTROLLER;
+
+bool CopyFrame(const uint8_t *data, unsigned int size) {
+  if (size > DMX_FRAME_SIZE) {
+    return false;
+  }
+  memcpy(g_frame, data, size);
+  return true;
+}
+
+}  // namespace
+
+bool Transceiver_SetMode(TransceiverMode mode, int16_t) {
+  g_mode = mode;
+  return true;
+}
+
+TransceiverMode Transceiver_GetMode() {
+  return g_mode;
+}
+
+bool Transceiver_QueueDMX(int16_t, const uint8_t* data,
+                          unsigned int size) {
+  return CopyFrame(data, size);
+}
+
+bool Transceiver_QueueRDMDUB(int16_t, const uint8_t* data,
+                             unsigned int size) {
+  return CopyFrame(data, size);
+}
+
+bool Transceiver_QueueRDMRequest(int16_t, const uint8_t* data,
+                                 unsigned int size, bool) {
+  return CopyFrame(data, size);
+}
+
+bool Transceiver_QueueSelfTest(int16_t) {
+  return true;
+}
+
+bool Transceiver_SetBreakTime(uint16_t) {
+  return true;
+}
+
+uint16_t Transceiver_GetBreakTime() {
+  return 0u;
+}
+
+bool Transceiver_SetMarkTime(uint16_t) {
+  return true;
+}
+
+uint16_t Transceiver_GetMarkTime() {
+  return 0u;
+}
+
+bool Transceiver_SetRDMBroadcastTimeout(uint16_t) {
+  return true;
+}
+
+uint16_t Transceiver_GetRDMBroadcastTimeout() {
+  return 0u;
+}
+
+bool Transceiver_SetRDMResponseTimeout(uint16_t) {
+  return true;
+}
+
+uint16_t Transceiver_GetRDMResponseTimeout() {
+  return 0u;
+}
+
+bool Transceiver_SetRDMDUBResponseLimit(uint16_t) {
+  return true;
+}
+
+uint16_t Transceiver_GetRDMDUBResponseLimit() {
+  return 0u;
+}
+
+bool Transceiver_SetRDMResponderDelay(uint16_t) {
+  return true;
+}
+
+uint16_t Transceiver_GetRDMResponderDelay() {
+  return 0u;
+}
+
+bool Transceiver_SetRDMResponderJitter(uint16_t) {
+  return true;
+}
+
+uint16_t Transceiver_GetRDMResponderJitter() {
+  return 0u;
+}
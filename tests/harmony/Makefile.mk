@@ -1,6 +1,13 @@
 noinst_LTLIBRARIES += tests/harmony/mocks/libharmonymock.la
 
 tests_harmony_mocks_libharmonymock_la_SOURCES = \
+    tests/harmony/mocks/core_timer_mock.cpp \
+    tests/harmony/mocks/core_timer_mock.h \
+    tests/harmony/mocks/harmony_call_observer.cpp \
+    tests/harmony/mocks/harmony_call_observer.h \
+    tests/harmony/mocks/kmem.cpp \
+    tests/harmony/mocks/plib_dma_mock.cpp \
+    tests/harmony/mocks/plib_dma_mock.h \
     tests/harmony/mocks/plib_eth_mock.cpp \
     tests/harmony/mocks/plib_eth_mock.h \
     tests/harmony/mocks/plib_ic_mock.cpp \
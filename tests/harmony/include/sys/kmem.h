@@ -0,0 +1,32 @@
+/*
+ * This is the stub for kmem.h used for the tests. It contains the bare
+ * minimum required to convert addresses for the DMA controller.
+ */
+
+#ifndef TESTS_HARMONY_INCLUDE_SYS_KMEM_H_
+#define TESTS_HARMONY_INCLUDE_SYS_KMEM_H_
+
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Host pointers don't fit in 32 bits, so each address is recorded and a
+ * 32 bit handle is returned in its place. Adding an offset of less than 1MB
+ * to a handle gives the same offset from the original pointer. This allows
+ * the simulated DMA controller to get back to the memory.
+ */
+uint32_t KMEM_KVAToPA(const volatile void *address);
+
+void *KMEM_PAToKVA(uint32_t address);
+
+#define KVA_TO_PA(v) KMEM_KVAToPA(v)
+#define PA_TO_KVA1(pa) KMEM_PAToKVA(pa)
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  // TESTS_HARMONY_INCLUDE_SYS_KMEM_H_
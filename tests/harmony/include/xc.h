@@ -0,0 +1,25 @@
+/*
+ * This is the stub for xc.h used for the tests. It contains the bare
+ * minimum required to read the core timer.
+ */
+
+#ifndef TESTS_HARMONY_INCLUDE_XC_H_
+#define TESTS_HARMONY_INCLUDE_XC_H_
+
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * On the target this is a macro which reads the CP0 Count register. The
+ * core timer increments at half the system clock rate.
+ */
+uint32_t _CP0_GET_COUNT();
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  // TESTS_HARMONY_INCLUDE_XC_H_
@@ -0,0 +1,19 @@
+#include <gmock/gmock.h>
+#include "core_timer_mock.h"
+#include "harmony_call_observer.h"
+
+namespace {
+  CoreTimerInterface *g_core_timer_mock = NULL;
+}
+
+void CORE_TIMER_SetMock(CoreTimerInterface* mock) {
+  g_core_timer_mock = mock;
+}
+
+uint32_t _CP0_GET_COUNT() {
+  HARMONY_RECORD_CALL();
+  if (g_core_timer_mock) {
+    return g_core_timer_mock->CounterGet();
+  }
+  return 0;
+}
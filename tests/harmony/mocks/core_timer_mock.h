@@ -0,0 +1,22 @@
+#ifndef TESTS_HARMONY_MOCKS_CORE_TIMER_MOCK_H_
+#define TESTS_HARMONY_MOCKS_CORE_TIMER_MOCK_H_
+
+#include <gmock/gmock.h>
+#include <stdint.h>
+#include "xc.h"
+
+class CoreTimerInterface {
+ public:
+  virtual ~CoreTimerInterface() {}
+
+  virtual uint32_t CounterGet() = 0;
+};
+
+class MockCoreTimer : public CoreTimerInterface {
+ public:
+  MOCK_METHOD0(CounterGet, uint32_t());
+};
+
+void CORE_TIMER_SetMock(CoreTimerInterface* mock);
+
+#endif  // TESTS_HARMONY_MOCKS_CORE_TIMER_MOCK_H_
@@ -0,0 +1,17 @@
+#include "harmony_call_observer.h"
+
+#include <stddef.h>
+
+namespace {
+  HarmonyCallObserver *g_call_observer = NULL;
+}
+
+void Harmony_SetCallObserver(HarmonyCallObserver *observer) {
+  g_call_observer = observer;
+}
+
+void Harmony_RecordCall(const char *function) {
+  if (g_call_observer) {
+    g_call_observer->Called(function);
+  }
+}
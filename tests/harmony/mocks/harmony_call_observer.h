@@ -0,0 +1,26 @@
+#ifndef TESTS_HARMONY_MOCKS_HARMONY_CALL_OBSERVER_H_
+#define TESTS_HARMONY_MOCKS_HARMONY_CALL_OBSERVER_H_
+
+/*
+ * Observes every call into the mocked Harmony peripheral library.
+ *
+ * Each PLIB_*, SYS_INT_*, SYS_CLK_* and core timer wrapper reports its name
+ * before dispatching to the mock, so the simulator can count the peripheral
+ * accesses the firmware makes.
+ */
+class HarmonyCallObserver {
+ public:
+  virtual ~HarmonyCallObserver() {}
+
+  // function is the name of the Harmony function, it's a string literal.
+  virtual void Called(const char *function) = 0;
+};
+
+// Set the observer, or nullptr to remove it. Ownership is not transferred.
+void Harmony_SetCallObserver(HarmonyCallObserver *observer);
+
+void Harmony_RecordCall(const char *function);
+
+#define HARMONY_RECORD_CALL() Harmony_RecordCall(__func__)
+
+#endif  // TESTS_HARMONY_MOCKS_HARMONY_CALL_OBSERVER_H_
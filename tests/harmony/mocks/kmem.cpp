@@ -0,0 +1,33 @@
+#include <stdint.h>
+#include <vector>
+#include "sys/kmem.h"
+
+namespace {
+const unsigned int ADDRESS_BITS = 20;
+const uint32_t OFFSET_MASK = (1u << ADDRESS_BITS) - 1;
+
+std::vector<const volatile void*> g_addresses;
+}
+
+uint32_t KMEM_KVAToPA(const volatile void *address) {
+  unsigned int i = 0;
+  for (; i < g_addresses.size(); i++) {
+    if (g_addresses[i] == address) {
+      break;
+    }
+  }
+  if (i == g_addresses.size()) {
+    g_addresses.push_back(address);
+  }
+  return (i + 1) << ADDRESS_BITS;
+}
+
+void *KMEM_PAToKVA(uint32_t address) {
+  uint32_t index = address >> ADDRESS_BITS;
+  if (index == 0 || index > g_addresses.size()) {
+    return nullptr;
+  }
+  const volatile uint8_t *base = reinterpret_cast<const volatile uint8_t*>(
+      g_addresses[index - 1]);
+  return const_cast<uint8_t*>(base + (address & OFFSET_MASK));
+}
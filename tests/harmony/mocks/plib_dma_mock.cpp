@@ -0,0 +1,166 @@
+#include <gmock/gmock.h>
+#include "plib_dma_mock.h"
+#include "harmony_call_observer.h"
+
+namespace {
+  PeripheralDMAInterface *g_plib_dma_mock = NULL;
+}
+
+void PLIB_DMA_SetMock(PeripheralDMAInterface* mock) {
+  g_plib_dma_mock = mock;
+}
+
+void PLIB_DMA_Enable(DMA_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->Enable(index);
+  }
+}
+
+void PLIB_DMA_ChannelXEnable(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXEnable(index, channel);
+  }
+}
+
+void PLIB_DMA_ChannelXDisable(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXDisable(index, channel);
+  }
+}
+
+void PLIB_DMA_ChannelXChainEnable(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXChainEnable(index, channel);
+  }
+}
+
+void PLIB_DMA_ChannelXChainDisable(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXChainDisable(index, channel);
+  }
+}
+
+void PLIB_DMA_ChannelXChainToHigher(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXChainToHigher(index, channel);
+  }
+}
+
+void PLIB_DMA_ChannelXChainToLower(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXChainToLower(index, channel);
+  }
+}
+
+void PLIB_DMA_ChannelXTriggerEnable(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                    DMA_CHANNEL_TRIGGER_TYPE trigger) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXTriggerEnable(index, channel, trigger);
+  }
+}
+
+void PLIB_DMA_ChannelXStartIRQSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  DMA_TRIGGER_SOURCE IRQ) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXStartIRQSet(index, channel, IRQ);
+  }
+}
+
+void PLIB_DMA_ChannelXSourceStartAddressSet(DMA_MODULE_ID index,
+                                            DMA_CHANNEL channel,
+                                            uint32_t sourceStartAddress) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXSourceStartAddressSet(index, channel,
+                                                   sourceStartAddress);
+  }
+}
+
+void PLIB_DMA_ChannelXDestinationStartAddressSet(
+    DMA_MODULE_ID index, DMA_CHANNEL channel,
+    uint32_t destinationStartAddress) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXDestinationStartAddressSet(
+        index, channel, destinationStartAddress);
+  }
+}
+
+void PLIB_DMA_ChannelXSourceSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                    uint16_t sourceSize) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXSourceSizeSet(index, channel, sourceSize);
+  }
+}
+
+void PLIB_DMA_ChannelXDestinationSizeSet(DMA_MODULE_ID index,
+                                         DMA_CHANNEL channel,
+                                         uint16_t destinationSize) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXDestinationSizeSet(index, channel,
+                                                destinationSize);
+  }
+}
+
+void PLIB_DMA_ChannelXCellSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  uint16_t CellSize) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXCellSizeSet(index, channel, CellSize);
+  }
+}
+
+bool PLIB_DMA_ChannelXINTSourceFlagGet(DMA_MODULE_ID index,
+                                       DMA_CHANNEL channel,
+                                       DMA_INT_TYPE dmaINTSource) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    return g_plib_dma_mock->ChannelXINTSourceFlagGet(index, channel,
+                                                     dmaINTSource);
+  }
+  return false;
+}
+
+void PLIB_DMA_ChannelXINTSourceFlagClear(DMA_MODULE_ID index,
+                                         DMA_CHANNEL channel,
+                                         DMA_INT_TYPE dmaINTSource) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXINTSourceFlagClear(index, channel, dmaINTSource);
+  }
+}
+
+void PLIB_DMA_ChannelXINTSourceEnable(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                      DMA_INT_TYPE dmaINTSource) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXINTSourceEnable(index, channel, dmaINTSource);
+  }
+}
+
+void PLIB_DMA_ChannelXINTSourceDisable(DMA_MODULE_ID index,
+                                       DMA_CHANNEL channel,
+                                       DMA_INT_TYPE dmaINTSource) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXINTSourceDisable(index, channel, dmaINTSource);
+  }
+}
+
+void PLIB_DMA_StartTransferSet(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->StartTransferSet(index, channel);
+  }
+}
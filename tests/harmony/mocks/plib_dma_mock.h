@@ -0,0 +1,107 @@
+#ifndef TESTS_HARMONY_MOCKS_PLIB_DMA_MOCK_H_
+#define TESTS_HARMONY_MOCKS_PLIB_DMA_MOCK_H_
+
+#include <gmock/gmock.h>
+#include "peripheral/dma/plib_dma.h"
+
+class PeripheralDMAInterface {
+ public:
+  virtual ~PeripheralDMAInterface() {}
+
+  virtual void Enable(DMA_MODULE_ID index) = 0;
+  virtual void ChannelXEnable(DMA_MODULE_ID index, DMA_CHANNEL channel) = 0;
+  virtual void ChannelXDisable(DMA_MODULE_ID index, DMA_CHANNEL channel) = 0;
+  virtual void ChannelXChainEnable(DMA_MODULE_ID index,
+                                   DMA_CHANNEL channel) = 0;
+  virtual void ChannelXChainDisable(DMA_MODULE_ID index,
+                                    DMA_CHANNEL channel) = 0;
+  virtual void ChannelXChainToHigher(DMA_MODULE_ID index,
+                                     DMA_CHANNEL channel) = 0;
+  virtual void ChannelXChainToLower(DMA_MODULE_ID index,
+                                    DMA_CHANNEL channel) = 0;
+  virtual void ChannelXTriggerEnable(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                     DMA_CHANNEL_TRIGGER_TYPE trigger) = 0;
+  virtual void ChannelXStartIRQSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                   DMA_TRIGGER_SOURCE IRQ) = 0;
+  virtual void ChannelXSourceStartAddressSet(DMA_MODULE_ID index,
+                                             DMA_CHANNEL channel,
+                                             uint32_t sourceStartAddress) = 0;
+  virtual void ChannelXDestinationStartAddressSet(
+      DMA_MODULE_ID index, DMA_CHANNEL channel,
+      uint32_t destinationStartAddress) = 0;
+  virtual void ChannelXSourceSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                     uint16_t sourceSize) = 0;
+  virtual void ChannelXDestinationSizeSet(DMA_MODULE_ID index,
+                                          DMA_CHANNEL channel,
+                                          uint16_t destinationSize) = 0;
+  virtual void ChannelXCellSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                   uint16_t CellSize) = 0;
+  virtual bool ChannelXINTSourceFlagGet(DMA_MODULE_ID index,
+                                        DMA_CHANNEL channel,
+                                        DMA_INT_TYPE dmaINTSource) = 0;
+  virtual void ChannelXINTSourceFlagClear(DMA_MODULE_ID index,
+                                          DMA_CHANNEL channel,
+                                          DMA_INT_TYPE dmaINTSource) = 0;
+  virtual void ChannelXINTSourceEnable(DMA_MODULE_ID index,
+                                       DMA_CHANNEL channel,
+                                       DMA_INT_TYPE dmaINTSource) = 0;
+  virtual void ChannelXINTSourceDisable(DMA_MODULE_ID index,
+                                        DMA_CHANNEL channel,
+                                        DMA_INT_TYPE dmaINTSource) = 0;
+  virtual void StartTransferSet(DMA_MODULE_ID index, DMA_CHANNEL channel) = 0;
+};
+
+class MockPeripheralDMA : public PeripheralDMAInterface {
+ public:
+  MOCK_METHOD1(Enable, void(DMA_MODULE_ID index));
+  MOCK_METHOD2(ChannelXEnable, void(DMA_MODULE_ID index, DMA_CHANNEL channel));
+  MOCK_METHOD2(ChannelXDisable,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel));
+  MOCK_METHOD2(ChannelXChainEnable,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel));
+  MOCK_METHOD2(ChannelXChainDisable,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel));
+  MOCK_METHOD2(ChannelXChainToHigher,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel));
+  MOCK_METHOD2(ChannelXChainToLower,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel));
+  MOCK_METHOD3(ChannelXTriggerEnable,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_CHANNEL_TRIGGER_TYPE trigger));
+  MOCK_METHOD3(ChannelXStartIRQSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_TRIGGER_SOURCE IRQ));
+  MOCK_METHOD3(ChannelXSourceStartAddressSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint32_t sourceStartAddress));
+  MOCK_METHOD3(ChannelXDestinationStartAddressSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint32_t destinationStartAddress));
+  MOCK_METHOD3(ChannelXSourceSizeSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint16_t sourceSize));
+  MOCK_METHOD3(ChannelXDestinationSizeSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint16_t destinationSize));
+  MOCK_METHOD3(ChannelXCellSizeSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint16_t CellSize));
+  MOCK_METHOD3(ChannelXINTSourceFlagGet,
+               bool(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_INT_TYPE dmaINTSource));
+  MOCK_METHOD3(ChannelXINTSourceFlagClear,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_INT_TYPE dmaINTSource));
+  MOCK_METHOD3(ChannelXINTSourceEnable,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_INT_TYPE dmaINTSource));
+  MOCK_METHOD3(ChannelXINTSourceDisable,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_INT_TYPE dmaINTSource));
+  MOCK_METHOD2(StartTransferSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel));
+};
+
+void PLIB_DMA_SetMock(PeripheralDMAInterface* mock);
+
+#endif  // TESTS_HARMONY_MOCKS_PLIB_DMA_MOCK_H_
@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 #include "plib_eth_mock.h"
+#include "harmony_call_observer.h"
 
 namespace {
   MockPeripheralEth *g_plib_eth_mock = NULL;
@@ -10,6 +11,7 @@ void PLIB_Eth_SetMock(MockPeripheralEth* mock) {
 }
 
 uint8_t PLIB_ETH_StationAddressGet(ETH_MODULE_ID index, uint8_t which) {
+  HARMONY_RECORD_CALL();
   if (g_plib_eth_mock) {
     return g_plib_eth_mock->StationAddressGet(index, which);
   }
@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 #include "plib_ic_mock.h"
+#include "harmony_call_observer.h"
 
 namespace {
   PeripheralInputCaptureInterface *g_plib_ic_mock = NULL;
@@ -10,12 +11,14 @@ void PLIB_IC_SetMock(PeripheralInputCaptureInterface* mock) {
 }
 
 void PLIB_IC_Enable(IC_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ic_mock) {
     g_plib_ic_mock->Enable(index);
   }
 }
 
 void PLIB_IC_Disable(IC_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ic_mock) {
     g_plib_ic_mock->Disable(index);
   }
@@ -23,12 +26,14 @@ void PLIB_IC_Disable(IC_MODULE_ID index) {
 
 void PLIB_IC_FirstCaptureEdgeSelect(IC_MODULE_ID index,
                                     IC_EDGE_TYPES edgeType) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ic_mock) {
     g_plib_ic_mock->FirstCaptureEdgeSelect(index, edgeType);
   }
 }
 
 uint16_t PLIB_IC_Buffer16BitGet(IC_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ic_mock) {
     return g_plib_ic_mock->Buffer16BitGet(index);
   }
@@ -36,18 +41,21 @@ uint16_t PLIB_IC_Buffer16BitGet(IC_MODULE_ID index) {
 }
 
 void PLIB_IC_BufferSizeSelect(IC_MODULE_ID index, IC_BUFFER_SIZE bufSize) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ic_mock) {
     g_plib_ic_mock->BufferSizeSelect(index, bufSize);
   }
 }
 
 void PLIB_IC_TimerSelect(IC_MODULE_ID index, IC_TIMERS tmr) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ic_mock) {
     g_plib_ic_mock->TimerSelect(index, tmr);
   }
 }
 
 void PLIB_IC_ModeSelect(IC_MODULE_ID index, IC_INPUT_CAPTURE_MODES modeSel) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ic_mock) {
     g_plib_ic_mock->ModeSelect(index, modeSel);
   }
@@ -55,12 +63,14 @@ void PLIB_IC_ModeSelect(IC_MODULE_ID index, IC_INPUT_CAPTURE_MODES modeSel) {
 
 void PLIB_IC_EventsPerInterruptSelect(IC_MODULE_ID index,
                                       IC_EVENTS_PER_INTERRUPT event) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ic_mock) {
     g_plib_ic_mock->EventsPerInterruptSelect(index, event);
   }
 }
 
 bool PLIB_IC_BufferIsEmpty(IC_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ic_mock) {
     return g_plib_ic_mock->BufferIsEmpty(index);
   }
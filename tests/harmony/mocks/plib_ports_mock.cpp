@@ -1,17 +1,19 @@
 #include <gmock/gmock.h>
 #include "plib_ports_mock.h"
+#include "harmony_call_observer.h"
 
 namespace {
-  MockPeripheralPorts *g_plib_ports_mock = NULL;
+  PeripheralPortsInterface *g_plib_ports_mock = NULL;
 }
 
-void PLIB_PORTS_SetMock(MockPeripheralPorts* mock) {
+void PLIB_PORTS_SetMock(PeripheralPortsInterface* mock) {
   g_plib_ports_mock = mock;
 }
 
 void PLIB_PORTS_PinDirectionInputSet(PORTS_MODULE_ID index,
                                       PORTS_CHANNEL channel,
                                       PORTS_BIT_POS bitPos) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ports_mock) {
     g_plib_ports_mock->PinDirectionInputSet(index, channel, bitPos);
   }
@@ -20,6 +22,7 @@ void PLIB_PORTS_PinDirectionInputSet(PORTS_MODULE_ID index,
 void PLIB_PORTS_PinDirectionOutputSet(PORTS_MODULE_ID index,
                                       PORTS_CHANNEL channel,
                                       PORTS_BIT_POS bitPos) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ports_mock) {
     g_plib_ports_mock->PinDirectionOutputSet(index, channel, bitPos);
   }
@@ -28,6 +31,7 @@ void PLIB_PORTS_PinDirectionOutputSet(PORTS_MODULE_ID index,
 bool PLIB_PORTS_PinGet(PORTS_MODULE_ID index,
                        PORTS_CHANNEL channel,
                        PORTS_BIT_POS bitPos) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ports_mock) {
     return g_plib_ports_mock->PinGet(index, channel, bitPos);
   }
@@ -37,6 +41,7 @@ bool PLIB_PORTS_PinGet(PORTS_MODULE_ID index,
 void PLIB_PORTS_PinSet(PORTS_MODULE_ID index,
                        PORTS_CHANNEL channel,
                        PORTS_BIT_POS bitPos) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ports_mock) {
     g_plib_ports_mock->PinSet(index, channel, bitPos);
   }
@@ -45,6 +50,7 @@ void PLIB_PORTS_PinSet(PORTS_MODULE_ID index,
 void PLIB_PORTS_PinClear(PORTS_MODULE_ID index,
                          PORTS_CHANNEL channel,
                          PORTS_BIT_POS bitPos) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ports_mock) {
     g_plib_ports_mock->PinClear(index, channel, bitPos);
   }
@@ -53,6 +59,7 @@ void PLIB_PORTS_PinClear(PORTS_MODULE_ID index,
 void PLIB_PORTS_PinToggle(PORTS_MODULE_ID index,
                           PORTS_CHANNEL channel,
                           PORTS_BIT_POS bitPos) {
+  HARMONY_RECORD_CALL();
   if (g_plib_ports_mock) {
     g_plib_ports_mock->PinToggle(index, channel, bitPos);
   }
@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 #include "plib_spi_mock.h"
+#include "harmony_call_observer.h"
 
 namespace {
   PeripheralSPIInterface *g_plib_spi_mock = NULL;
@@ -10,18 +11,21 @@ void PLIB_SPI_SetMock(PeripheralSPIInterface* spi) {
 }
 
 void PLIB_SPI_Enable(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->Enable(index);
   }
 }
 
 void PLIB_SPI_Disable(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->Disable(index);
   }
 }
 
 bool PLIB_SPI_TransmitBufferIsFull(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     return g_plib_spi_mock->TransmitBufferIsFull(index);
   }
@@ -30,6 +34,7 @@ bool PLIB_SPI_TransmitBufferIsFull(SPI_MODULE_ID index) {
 
 void PLIB_SPI_CommunicationWidthSelect(SPI_MODULE_ID index,
                                        SPI_COMMUNICATION_WIDTH width) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->CommunicationWidthSelect(index, width);
   }
@@ -37,12 +42,14 @@ void PLIB_SPI_CommunicationWidthSelect(SPI_MODULE_ID index,
 
 void PLIB_SPI_ClockPolaritySelect(SPI_MODULE_ID index,
                                   SPI_CLOCK_POLARITY polarity) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->ClockPolaritySelect(index, polarity);
   }
 }
 
 void PLIB_SPI_MasterEnable(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->MasterEnable(index);
   }
@@ -50,6 +57,7 @@ void PLIB_SPI_MasterEnable(SPI_MODULE_ID index) {
 
 void PLIB_SPI_FIFOInterruptModeSelect(SPI_MODULE_ID index,
                                       SPI_FIFO_INTERRUPT mode) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->FIFOInterruptModeSelect(index, mode);
   }
@@ -57,12 +65,14 @@ void PLIB_SPI_FIFOInterruptModeSelect(SPI_MODULE_ID index,
 
 void PLIB_SPI_BaudRateSet(SPI_MODULE_ID index, uint32_t clockFrequency,
                           uint32_t baudRate) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->BaudRateSet(index, clockFrequency, baudRate);
   }
 }
 
 bool PLIB_SPI_IsBusy(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     return g_plib_spi_mock->IsBusy(index);
   }
@@ -70,12 +80,14 @@ bool PLIB_SPI_IsBusy(SPI_MODULE_ID index) {
 }
 
 void PLIB_SPI_FIFOEnable(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->FIFOEnable(index);
   }
 }
 
 bool PLIB_SPI_ReceiverFIFOIsEmpty(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     return g_plib_spi_mock->ReceiverFIFOIsEmpty(index);
   }
@@ -83,31 +95,44 @@ bool PLIB_SPI_ReceiverFIFOIsEmpty(SPI_MODULE_ID index) {
 }
 
 void PLIB_SPI_BufferWrite(SPI_MODULE_ID index, uint8_t data) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->BufferWrite(index, data);
   }
 }
 
 uint8_t PLIB_SPI_BufferRead(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     return g_plib_spi_mock->BufferRead(index);
   }
   return 0;
 }
 
+void* PLIB_SPI_BufferAddressGet(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
+  if (g_plib_spi_mock) {
+    return g_plib_spi_mock->BufferAddressGet(index);
+  }
+  return NULL;
+}
+
 void PLIB_SPI_SlaveSelectDisable(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->SlaveSelectDisable(index);
   }
 }
 
 void PLIB_SPI_BufferClear(SPI_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     return g_plib_spi_mock->BufferClear(index);
   }
 }
 
 void PLIB_SPI_PinDisable(SPI_MODULE_ID index, SPI_PIN pin) {
+  HARMONY_RECORD_CALL();
   if (g_plib_spi_mock) {
     g_plib_spi_mock->PinDisable(index, pin);
   }
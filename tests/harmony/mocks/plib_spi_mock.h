@@ -26,6 +26,7 @@ class PeripheralSPIInterface {
   virtual void BufferWrite(SPI_MODULE_ID index, uint8_t data) = 0;
   virtual void BufferClear(SPI_MODULE_ID index) = 0;
   virtual uint8_t BufferRead(SPI_MODULE_ID index) = 0;
+  virtual void* BufferAddressGet(SPI_MODULE_ID index) = 0;
   virtual void SlaveSelectDisable(SPI_MODULE_ID index) = 0;
   virtual void PinDisable(SPI_MODULE_ID index, SPI_PIN pin) = 0;
 };
@@ -50,6 +51,7 @@ class MockPeripheralSPI : public PeripheralSPIInterface {
   MOCK_METHOD2(BufferWrite, void(SPI_MODULE_ID index, uint8_t data));
   MOCK_METHOD1(BufferClear, void(SPI_MODULE_ID index));
   MOCK_METHOD1(BufferRead, uint8_t(SPI_MODULE_ID index));
+  MOCK_METHOD1(BufferAddressGet, void*(SPI_MODULE_ID index));
   MOCK_METHOD1(SlaveSelectDisable, void(SPI_MODULE_ID index));
   MOCK_METHOD2(PinDisable, void(SPI_MODULE_ID index, SPI_PIN pin));
 };
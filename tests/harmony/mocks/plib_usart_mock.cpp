@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 #include "plib_usart_mock.h"
+#include "harmony_call_observer.h"
 
 namespace {
   PeripheralUSARTInterface *g_plib_usart_mock = NULL;
@@ -10,24 +11,28 @@ void PLIB_USART_SetMock(PeripheralUSARTInterface* mock) {
 }
 
 void PLIB_USART_Enable(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->Enable(index);
   }
 }
 
 void PLIB_USART_Disable(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->Disable(index);
   }
 }
 
 void PLIB_USART_TransmitterEnable(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->TransmitterEnable(index);
   }
 }
 
 void PLIB_USART_TransmitterDisable(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->TransmitterDisable(index);
   }
@@ -35,18 +40,21 @@ void PLIB_USART_TransmitterDisable(USART_MODULE_ID index) {
 
 void PLIB_USART_BaudRateSet(USART_MODULE_ID index, uint32_t clockFrequency,
                             uint32_t baudRate) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->BaudRateSet(index, clockFrequency, baudRate);
   }
 }
 
 void PLIB_USART_TransmitterByteSend(USART_MODULE_ID index, int8_t data) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->TransmitterByteSend(index, data);
   }
 }
 
 int8_t PLIB_USART_ReceiverByteReceive(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     return g_plib_usart_mock->ReceiverByteReceive(index);
   }
@@ -54,6 +62,7 @@ int8_t PLIB_USART_ReceiverByteReceive(USART_MODULE_ID index) {
 }
 
 bool PLIB_USART_ReceiverDataIsAvailable(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     return g_plib_usart_mock->ReceiverDataIsAvailable(index);
   }
@@ -61,6 +70,7 @@ bool PLIB_USART_ReceiverDataIsAvailable(USART_MODULE_ID index) {
 }
 
 bool PLIB_USART_TransmitterBufferIsFull(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     return g_plib_usart_mock->TransmitterBufferIsFull(index);
   }
@@ -68,12 +78,14 @@ bool PLIB_USART_TransmitterBufferIsFull(USART_MODULE_ID index) {
 }
 
 void PLIB_USART_ReceiverEnable(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->ReceiverEnable(index);
   }
 }
 
 void PLIB_USART_ReceiverDisable(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->ReceiverDisable(index);
   }
@@ -82,6 +94,7 @@ void PLIB_USART_ReceiverDisable(USART_MODULE_ID index) {
 void PLIB_USART_TransmitterInterruptModeSelect(
     USART_MODULE_ID index,
     USART_TRANSMIT_INTR_MODE fifolevel) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->TransmitterInterruptModeSelect(index, fifolevel);
   }
@@ -89,6 +102,7 @@ void PLIB_USART_TransmitterInterruptModeSelect(
 
 void PLIB_USART_HandshakeModeSelect(USART_MODULE_ID index,
                                     USART_HANDSHAKE_MODE handshakeConfig) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->HandshakeModeSelect(index, handshakeConfig);
   }
@@ -96,6 +110,7 @@ void PLIB_USART_HandshakeModeSelect(USART_MODULE_ID index,
 
 void PLIB_USART_OperationModeSelect(USART_MODULE_ID index,
                                     USART_OPERATION_MODE operationmode) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->OperationModeSelect(index, operationmode);
   }
@@ -103,12 +118,14 @@ void PLIB_USART_OperationModeSelect(USART_MODULE_ID index,
 
 void PLIB_USART_LineControlModeSelect(USART_MODULE_ID index,
                                       USART_LINECONTROL_MODE dataFlowConfig) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     g_plib_usart_mock->LineControlModeSelect(index, dataFlowConfig);
   }
 }
 
 USART_ERROR PLIB_USART_ErrorsGet(USART_MODULE_ID index) {
+  HARMONY_RECORD_CALL();
   if (g_plib_usart_mock) {
     return g_plib_usart_mock->ErrorsGet(index);
   }
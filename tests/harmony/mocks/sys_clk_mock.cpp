@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 #include "sys_clk_mock.h"
+#include "harmony_call_observer.h"
 
 namespace {
   MockSysClk *g_sys_clk_mock = NULL;
@@ -10,6 +11,7 @@ void SYS_CLK_SetMock(MockSysClk* mock) {
 }
 
 uint32_t SYS_CLK_PeripheralFrequencyGet(CLK_BUSES_PERIPHERAL peripheralBus) {
+  HARMONY_RECORD_CALL();
   if (g_sys_clk_mock) {
     return g_sys_clk_mock->PeripheralFrequencyGet(peripheralBus);
   }
@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 #include "sys_int_mock.h"
+#include "harmony_call_observer.h"
 
 namespace {
   SysIntInterface *g_sys_int_mock = NULL;
@@ -10,6 +11,7 @@ void SYS_INT_SetMock(SysIntInterface* mock) {
 }
 
 bool SYS_INT_SourceStatusGet(INT_SOURCE source) {
+  HARMONY_RECORD_CALL();
   if (g_sys_int_mock) {
     return g_sys_int_mock->SourceStatusGet(source);
   }
@@ -17,18 +19,21 @@ bool SYS_INT_SourceStatusGet(INT_SOURCE source) {
 }
 
 void SYS_INT_SourceStatusClear(INT_SOURCE source) {
+  HARMONY_RECORD_CALL();
   if (g_sys_int_mock) {
     g_sys_int_mock->SourceStatusClear(source);
   }
 }
 
 void SYS_INT_SourceEnable(INT_SOURCE source) {
+  HARMONY_RECORD_CALL();
   if (g_sys_int_mock) {
     g_sys_int_mock->SourceEnable(source);
   }
 }
 
 bool SYS_INT_SourceDisable(INT_SOURCE source) {
+  HARMONY_RECORD_CALL();
   if (g_sys_int_mock) {
     return g_sys_int_mock->SourceDisable(source);
   }
@@ -36,6 +41,7 @@ bool SYS_INT_SourceDisable(INT_SOURCE source) {
 }
 
 void SYS_INT_VectorPrioritySet(INT_VECTOR vector, INT_PRIORITY_LEVEL priority) {
+  HARMONY_RECORD_CALL();
   if (g_sys_int_mock) {
     g_sys_int_mock->VectorPrioritySet(vector, priority);
   }
@@ -43,6 +49,7 @@ void SYS_INT_VectorPrioritySet(INT_VECTOR vector, INT_PRIORITY_LEVEL priority) {
 
 void SYS_INT_VectorSubprioritySet(INT_VECTOR vector,
                                   INT_SUBPRIORITY_LEVEL subpriority) {
+  HARMONY_RECORD_CALL();
   if (g_sys_int_mock) {
     g_sys_int_mock->VectorSubprioritySet(vector, subpriority);
   }
@@ -0,0 +1,48 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMXForwarderMock.cpp
+ * A mock DMX forwarder module.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "DMXForwarderMock.h"
+
+namespace {
+MockDMXForwarder *g_dmx_forwarder_mock = NULL;
+}
+
+void DMXForwarder_SetMock(MockDMXForwarder* mock) {
+  g_dmx_forwarder_mock = mock;
+}
+
+void DMXForwarder_Initialize(TransportTXFunction tx_cb) {
+  if (g_dmx_forwarder_mock) {
+    g_dmx_forwarder_mock->Initialize(tx_cb);
+  }
+}
+
+bool DMXForwarder_Configure(uint8_t token, uint8_t mode, uint16_t interval) {
+  if (g_dmx_forwarder_mock) {
+    return g_dmx_forwarder_mock->Configure(token, mode, interval);
+  }
+  return false;
+}
+
+void DMXForwarder_Tasks() {
+  if (g_dmx_forwarder_mock) {
+    g_dmx_forwarder_mock->Tasks();
+  }
+}
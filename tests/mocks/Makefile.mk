@@ -4,6 +4,7 @@
 noinst_LTLIBRARIES += tests/mocks/libappmock.la \
                       tests/mocks/libbootloaderoptionsmock.la \
                       tests/mocks/libcoarsetimermock.la \
+                      tests/mocks/libdmxforwardermock.la \
                       tests/mocks/libflagsmock.la \
                       tests/mocks/libflashmock.la \
                       tests/mocks/liblaunchermock.la \
@@ -36,6 +37,12 @@ tests_mocks_libcoarsetimermock_la_SOURCES = tests/mocks/CoarseTimerMock,h \
 tests_mocks_libcoarsetimermock_la_CXXFLAGS = $(MOCK_CXXFLAGS)
 tests_mocks_libcoarsetimermock_la_LIBADD = $(MOCK_LIBS)
 
+tests_mocks_libdmxforwardermock_la_SOURCES = \
+    tests/mocks/DMXForwarderMock.h \
+    tests/mocks/DMXForwarderMock.cpp
+tests_mocks_libdmxforwardermock_la_CXXFLAGS = $(MOCK_CXXFLAGS)
+tests_mocks_libdmxforwardermock_la_LIBADD = $(MOCK_LIBS)
+
 tests_mocks_libflagsmock_la_SOURCES = tests/mocks/FlagsMock.h \
                                       tests/mocks/FlagsMock.cpp
 tests_mocks_libflagsmock_la_CXXFLAGS = $(MOCK_CXXFLAGS)
@@ -54,6 +54,13 @@ bool RDMHandler_SetActiveModel(uint16_t model_id) {
   return false;
 }
 
+uint16_t RDMHandler_ActiveModel() {
+  if (g_rdmhandler_mock) {
+    return g_rdmhandler_mock->ActiveModel();
+  }
+  return NULL_MODEL_ID;
+}
+
 void RDMHandler_HandleRequest(const RDMHeader *header,
                               const uint8_t *param_data) {
   if (g_rdmhandler_mock) {
@@ -61,6 +68,45 @@ void RDMHandler_HandleRequest(const RDMHeader *header,
   }
 }
 
+bool RDMHandler_RequiresAction(const uint8_t uid[UID_LENGTH]) {
+  if (g_rdmhandler_mock) {
+    return g_rdmhandler_mock->RequiresAction(uid);
+  }
+  return false;
+}
+
+void RDMHandler_GetDMXWindow(DMXWindow *window) {
+  if (g_rdmhandler_mock) {
+    g_rdmhandler_mock->GetDMXWindow(window);
+  }
+}
+
+void RDMHandler_BeginDMXFrame() {
+  if (g_rdmhandler_mock) {
+    g_rdmhandler_mock->BeginDMXFrame();
+  }
+}
+
+void RDMHandler_HandleDMXData(const uint8_t *slots, unsigned int slot_count) {
+  if (g_rdmhandler_mock) {
+    g_rdmhandler_mock->HandleDMXData(slots, slot_count);
+  }
+}
+
+bool RDMHandler_GetSettings(ModelSettingsBlock *block) {
+  if (g_rdmhandler_mock) {
+    return g_rdmhandler_mock->GetSettings(block);
+  }
+  return false;
+}
+
+bool RDMHandler_SetSettings(const ModelSettingsBlock *block) {
+  if (g_rdmhandler_mock) {
+    return g_rdmhandler_mock->SetSettings(block);
+  }
+  return false;
+}
+
 void RDMHandler_Tasks() {
   if (g_rdmhandler_mock) {
     g_rdmhandler_mock->Tasks();
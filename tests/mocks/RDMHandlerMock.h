@@ -30,9 +30,17 @@ class MockRDMHandler {
   MOCK_METHOD1(Initialize, void(const RDMHandlerSettings *settings));
   MOCK_METHOD1(AddModel, bool(const ModelEntry *entry));
   MOCK_METHOD1(SetActiveModel, bool(uint16_t model_id));
+  MOCK_METHOD0(ActiveModel, uint16_t());
   MOCK_METHOD1(GetUID, void(uint8_t *uid));
   MOCK_METHOD2(HandleRequest, void(const RDMHeader *header,
                                    const uint8_t *param_data));
+  MOCK_METHOD1(RequiresAction, bool(const uint8_t *uid));
+  MOCK_METHOD1(GetDMXWindow, void(DMXWindow *window));
+  MOCK_METHOD0(BeginDMXFrame, void());
+  MOCK_METHOD2(HandleDMXData, void(const uint8_t *slots,
+                                   unsigned int slot_count));
+  MOCK_METHOD1(GetSettings, bool(ModelSettingsBlock *block));
+  MOCK_METHOD1(SetSettings, bool(const ModelSettingsBlock *block));
   MOCK_METHOD0(Tasks, void());
 };
 
@@ -34,6 +34,25 @@ void SPIRGB_Init(const SPIRGBConfiguration *config) {
   }
 }
 
+void SPIRGB_SetPixelType(SPIRGB_PixelType type) {
+  if (g_spirgb_mock) {
+    g_spirgb_mock->SetPixelType(type);
+  }
+}
+
+void SPIRGB_SetPixelCount(uint16_t count) {
+  if (g_spirgb_mock) {
+    g_spirgb_mock->SetPixelCount(count);
+  }
+}
+
+uint16_t SPIRGB_PixelCount() {
+  if (g_spirgb_mock) {
+    return g_spirgb_mock->PixelCount();
+  }
+  return 0u;
+}
+
 void SPIRGB_BeginUpdate() {
   if (g_spirgb_mock) {
     g_spirgb_mock->BeginUpdate();
@@ -46,6 +65,12 @@ void SPIRGB_SetPixel(uint16_t index, RGB_Color color, uint8_t value) {
   }
 }
 
+void SPIRGB_SetPixels(uint16_t index, const uint8_t *data, uint16_t count) {
+  if (g_spirgb_mock) {
+    g_spirgb_mock->SetPixels(index, data, count);
+  }
+}
+
 void SPIRGB_CompleteUpdate() {
   if (g_spirgb_mock) {
     g_spirgb_mock->CompleteUpdate();
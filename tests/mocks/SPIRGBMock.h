@@ -27,8 +27,13 @@
 class MockSPIRGB {
  public:
   MOCK_METHOD1(Init, void(const SPIRGBConfiguration *config));
+  MOCK_METHOD1(SetPixelType, void(SPIRGB_PixelType type));
+  MOCK_METHOD1(SetPixelCount, void(uint16_t count));
+  MOCK_METHOD0(PixelCount, uint16_t());
   MOCK_METHOD0(BeginUpdate, void());
   MOCK_METHOD3(SetPixel, void(uint16_t index, RGB_Color color, uint8_t value));
+  MOCK_METHOD3(SetPixels,
+               void(uint16_t index, const uint8_t *data, uint16_t count));
   MOCK_METHOD0(CompleteUpdate, void());
   MOCK_METHOD0(Tasks, void());
 };
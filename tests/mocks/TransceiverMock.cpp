@@ -89,6 +89,32 @@ bool Transceiver_QueueRDMRequest(int16_t token, const uint8_t* data,
   return true;
 }
 
+void Transceiver_DiscardRXFrame() {
+  if (g_transceiver_mock) {
+    g_transceiver_mock->DiscardRXFrame();
+  }
+}
+
+uint8_t *Transceiver_AcquireRDMResponseBuffer() {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->AcquireRDMResponseBuffer();
+  }
+  return NULL;
+}
+
+bool Transceiver_CommitRDMResponse(bool include_break, unsigned int size) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->CommitRDMResponse(include_break, size);
+  }
+  return false;
+}
+
+void Transceiver_ReleaseRDMResponseBuffer() {
+  if (g_transceiver_mock) {
+    g_transceiver_mock->ReleaseRDMResponseBuffer();
+  }
+}
+
 bool Transceiver_QueueSelfTest(int16_t token) {
   if (g_transceiver_mock) {
     return g_transceiver_mock->QueueSelfTest(token);
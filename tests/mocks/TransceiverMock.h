@@ -42,6 +42,10 @@ class MockTransceiver {
                                  unsigned int size));
   MOCK_METHOD4(QueueRDMRequest, bool(int16_t token, const uint8_t* data,
                                      unsigned int size, bool is_broadcast));
+  MOCK_METHOD0(DiscardRXFrame, void());
+  MOCK_METHOD0(AcquireRDMResponseBuffer, uint8_t*());
+  MOCK_METHOD2(CommitRDMResponse, bool(bool include_break, unsigned int size));
+  MOCK_METHOD0(ReleaseRDMResponseBuffer, void());
   MOCK_METHOD1(QueueSelfTest, bool(int16_t token));
   MOCK_METHOD0(Transceiver_Reset, void());
   MOCK_METHOD1(SetBreakTime, bool(uint16_t break_time_us));
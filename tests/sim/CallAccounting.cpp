@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * CallAccounting.cpp
+ * Count the Harmony calls made by ISRs & the Tasks function.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+
+#include "CallAccounting.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+void CallAccounting::Totals::Add(const Totals &other) {
+  invocations += other.invocations;
+  calls += other.calls;
+  cycles += other.cycles;
+  max_cycles = std::max(max_cycles, other.max_cycles);
+}
+
+CallAccounting::Totals CallAccounting::FrameCost::ISRTotals() const {
+  Totals totals;
+  for (const auto &iter : isrs) {
+    totals.Add(iter.second);
+  }
+  return totals;
+}
+
+CallAccounting::CallAccounting()
+    : m_default_cost(1),
+      m_unattributed_calls(0),
+      m_tracer(nullptr) {
+}
+
+void CallAccounting::SetCost(const std::string &function,
+                             unsigned int cycles) {
+  m_costs[function] = cycles;
+}
+
+void CallAccounting::BeginISR(INT_SOURCE source) {
+  m_scopes.push_back(Scope(true, source));
+}
+
+void CallAccounting::EndISR() {
+  EndScope(true);
+}
+
+void CallAccounting::BeginTask() {
+  // The source isn't used for task scopes.
+  m_scopes.push_back(Scope(false, INT_SOURCE_TIMER_CORE));
+}
+
+void CallAccounting::EndTask() {
+  EndScope(false);
+}
+
+void CallAccounting::EndFrame() {
+  m_frames.push_back(m_current);
+  m_current = FrameCost();
+}
+
+void CallAccounting::Reset() {
+  m_scopes.clear();
+  m_current = FrameCost();
+  m_frames.clear();
+  m_unattributed_calls = 0;
+}
+
+void CallAccounting::Called(const char *function) {
+  if (m_scopes.empty()) {
+    m_unattributed_calls++;
+    return;
+  }
+
+  const auto iter = m_costs.find(function);
+  Scope &scope = m_scopes.back();
+  scope.calls++;
+  scope.cycles += iter == m_costs.end() ? m_default_cost : iter->second;
+  m_current.function_calls[function]++;
+}
+
+void CallAccounting::EndScope(bool is_isr) {
+  if (m_scopes.empty() || m_scopes.back().is_isr != is_isr) {
+    FAIL() << "Mismatched " << (is_isr ? "EndISR()" : "EndTask()");
+    return;
+  }
+
+  const Scope scope = m_scopes.back();
+  m_scopes.pop_back();
+  Totals *totals = is_isr ? &m_current.isrs[scope.source] : &m_current.tasks;
+  totals->invocations++;
+  totals->calls += scope.calls;
+  totals->cycles += scope.cycles;
+  totals->max_cycles = std::max(totals->max_cycles, scope.cycles);
+
+  if (m_tracer && scope.calls) {
+    if (is_isr) {
+      std::ostringstream track;
+      track << "ISR " << scope.source;
+      m_tracer->AddSpan(track.str(), "ISR", scope.cycles);
+    } else {
+      m_tracer->AddSpan("Tasks", "Tasks", scope.cycles);
+    }
+  }
+}
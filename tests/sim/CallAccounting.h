@@ -0,0 +1,165 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * CallAccounting.h
+ * Count the Harmony calls made by ISRs & the Tasks function.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+
+#ifndef TESTS_SIM_CALLACCOUNTING_H_
+#define TESTS_SIM_CALLACCOUNTING_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Tracer.h"
+#include "harmony_call_observer.h"
+#include "system/int/sys_int.h"
+
+/*
+ * @brief Attribute the Harmony calls the firmware makes to ISRs and Tasks()
+ * passes.
+ *
+ * Each call into the mocked peripheral library is charged to the innermost
+ * open scope. ISR scopes are opened by the InterruptController, task scopes
+ * with BeginTask() / EndTask() around the call to the Tasks() function. Calls
+ * made outside of any scope, e.g. during initialization, are only counted in
+ * UnattributedCalls().
+ *
+ * Each call costs 1 cycle unless a different cost is set with SetCost(). The
+ * costs don't need to be accurate, they exist so different designs, say DMA
+ * vs FIFO refill, can be compared without hardware.
+ *
+ * Totals accumulate until EndFrame() is called, which saves them as a
+ * FrameCost and starts a new frame.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  CallAccounting accounting;
+ *  accounting.SetCost("PLIB_USART_TransmitterByteSend", 4);
+ *  interrupt_controller.SetCallAccounting(&accounting);
+ *  Harmony_SetCallObserver(&accounting);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class CallAccounting : public HarmonyCallObserver {
+ public:
+  /*
+   * @brief The cost of a set of ISR invocations or Tasks() passes.
+   */
+  struct Totals {
+   public:
+    Totals() : invocations(0), calls(0), cycles(0), max_cycles(0) {}
+
+    unsigned int invocations;  // The number of ISR runs or Tasks() passes.
+    unsigned int calls;  // The total number of Harmony calls.
+    uint64_t cycles;  // The total weighted cost of the calls.
+    uint64_t max_cycles;  // The most expensive single invocation.
+
+    void Add(const Totals &other);
+  };
+
+  /*
+   * @brief The cost of one simulated frame.
+   */
+  struct FrameCost {
+   public:
+    std::map<INT_SOURCE, Totals> isrs;  // Keyed by interrupt source.
+    Totals tasks;
+    std::map<std::string, unsigned int> function_calls;
+
+    // The totals over all ISRs.
+    Totals ISRTotals() const;
+  };
+
+  CallAccounting();
+
+  /*
+   * @brief Set the cost of a Harmony function.
+   * @param function The name of the function, e.g. "PLIB_USART_Enable".
+   * @param cycles The cost of each call.
+   */
+  void SetCost(const std::string &function, unsigned int cycles);
+
+  /*
+   * @brief Set the cost of the functions without an entry in the cost table.
+   */
+  void SetDefaultCost(unsigned int cycles) { m_default_cost = cycles; }
+
+  /*
+   * @brief Record each ISR run & Tasks() pass as a span.
+   * @param tracer The tracer to use, or nullptr to stop. Ownership is not
+   *   transferred.
+   *
+   * The length of each span is its weighted cost in cycles. Tasks() passes
+   * which don't make any Harmony calls are skipped, since the simulator runs
+   * Tasks() on every clock cycle.
+   */
+  void SetTracer(Tracer *tracer) { m_tracer = tracer; }
+
+  void BeginISR(INT_SOURCE source);
+  void EndISR();
+
+  void BeginTask();
+  void EndTask();
+
+  /*
+   * @brief Save the current totals as a frame and start a new one.
+   */
+  void EndFrame();
+
+  /*
+   * @brief Discard the saved frames & the current totals.
+   */
+  void Reset();
+
+  // The totals since the last call to EndFrame().
+  const FrameCost &CurrentFrame() const { return m_current; }
+
+  const std::vector<FrameCost> &Frames() const { return m_frames; }
+
+  unsigned int UnattributedCalls() const { return m_unattributed_calls; }
+
+  // From HarmonyCallObserver
+  void Called(const char *function);
+
+ private:
+  struct Scope {
+   public:
+    Scope(bool isr, INT_SOURCE interrupt_source)
+      : is_isr(isr),
+        source(interrupt_source),
+        calls(0),
+        cycles(0) {}
+
+    bool is_isr;
+    INT_SOURCE source;
+    unsigned int calls;
+    uint64_t cycles;
+  };
+
+  std::map<std::string, unsigned int> m_costs;
+  unsigned int m_default_cost;
+  std::vector<Scope> m_scopes;
+  FrameCost m_current;
+  std::vector<FrameCost> m_frames;
+  unsigned int m_unattributed_calls;
+  Tracer *m_tracer;
+
+  void EndScope(bool is_isr);
+};
+
+#endif  // TESTS_SIM_CALLACCOUNTING_H_
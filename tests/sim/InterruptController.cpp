@@ -38,6 +38,10 @@ InterruptController::Interrupt::~Interrupt() {
   }
 }
 
+InterruptController::InterruptController()
+    : m_accounting(nullptr) {
+}
+
 InterruptController::~InterruptController() {
   ola::STLDeleteValues(&m_interrupts);
 }
@@ -61,7 +65,13 @@ void InterruptController::RaiseInterrupt(INT_SOURCE source) {
   while (interrupt->active) {
     if (interrupt->callback) {
       // The ISR is responsible for clearing the active flag
+      if (m_accounting) {
+        m_accounting->BeginISR(source);
+      }
       interrupt->callback->Run();
+      if (m_accounting) {
+        m_accounting->EndISR();
+      }
     } else {
       FAIL() << "Interrupt " << source << " is active but no callback set!";
     }
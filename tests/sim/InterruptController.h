@@ -22,6 +22,7 @@
 #define TESTS_SIM_INTERRUPTCONTROLLER_H_
 
 #include <map>
+#include "CallAccounting.h"
 #include "ola/Callback.h"
 #include "sys_int_mock.h"
 
@@ -29,6 +30,7 @@ class InterruptController : public SysIntInterface {
  public:
   typedef ola::Callback0<void> ISRCallback;
 
+  InterruptController();
   ~InterruptController();
 
   // Ownership of the callback is transferred.
@@ -36,6 +38,12 @@ class InterruptController : public SysIntInterface {
 
   void RaiseInterrupt(INT_SOURCE source);
 
+  // Charge the Harmony calls made by each ISR run to the CallAccounting, or
+  // nullptr to stop. Ownership is not transferred.
+  void SetCallAccounting(CallAccounting *accounting) {
+    m_accounting = accounting;
+  }
+
   bool SourceStatusGet(INT_SOURCE source);
   void SourceStatusClear(INT_SOURCE source);
   void SourceEnable(INT_SOURCE source);
@@ -57,6 +65,7 @@ class InterruptController : public SysIntInterface {
   };
 
   std::map<INT_SOURCE, Interrupt*> m_interrupts;
+  CallAccounting *m_accounting;
 
   Interrupt *GetInterrupt(INT_SOURCE source);
 };
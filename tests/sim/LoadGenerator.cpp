@@ -0,0 +1,203 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * LoadGenerator.cpp
+ * Generate sustained, randomised DMX & RDM traffic.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+
+#include "LoadGenerator.h"
+
+#include <stdint.h>
+#include <random>
+#include <vector>
+
+#include "constants.h"
+#include "dmx_spec.h"
+#include "rdm.h"
+
+using std::vector;
+
+namespace {
+
+void AppendUID(uint64_t uid, vector<uint8_t> *output) {
+  for (int i = UID_LENGTH - 1; i >= 0; i--) {
+    output->push_back((uid >> (8 * i)) & 0xff);
+  }
+}
+
+// The PIDs used for the RDM requests.
+const uint16_t REQUEST_PIDS[] = {
+  PID_DEVICE_INFO,
+  PID_SUPPORTED_PARAMETERS,
+  PID_SOFTWARE_VERSION_LABEL,
+  PID_DMX_START_ADDRESS,
+  PID_IDENTIFY_DEVICE,
+};
+
+}  // namespace
+
+LoadGenerator::LoadGenerator(Simulator *simulator,
+                             SignalGenerator *generator,
+                             uint64_t responder_uid,
+                             const Settings &settings)
+    : m_simulator(simulator),
+      m_generator(generator),
+      m_callback(ola::NewCallback(this, &LoadGenerator::Tick)),
+      m_responder_uid(responder_uid),
+      m_settings(settings),
+      m_transaction_number(0),
+      m_stop_at(0) {
+  m_simulator->AddTask(m_callback.get());
+}
+
+LoadGenerator::~LoadGenerator() {
+  m_simulator->RemoveTask(m_callback.get());
+}
+
+void LoadGenerator::Tick() {
+  if (m_stop_at && m_simulator->Clock() >= m_stop_at) {
+    return;
+  }
+  // Keep the next frame queued behind the current one, so there are no gaps.
+  if (m_generator->PendingEvents() < 2) {
+    QueueFrame();
+  }
+}
+
+void LoadGenerator::SetSeed(uint32_t seed) {
+  m_random.seed(seed);
+}
+
+LoadGenerator::FrameType LoadGenerator::PickFrameType() {
+  unsigned int value = Random(0, 99);
+  if (value < m_settings.rdm_percent) {
+    return FRAME_RDM;
+  }
+  value -= m_settings.rdm_percent;
+  if (value < m_settings.asc_percent) {
+    return FRAME_ASC;
+  }
+  value -= m_settings.asc_percent;
+  if (value < m_settings.framing_error_percent) {
+    return FRAME_FRAMING_ERROR;
+  }
+  value -= m_settings.framing_error_percent;
+  if (value < m_settings.short_break_percent) {
+    return FRAME_SHORT_BREAK;
+  }
+  return FRAME_DMX;
+}
+
+void LoadGenerator::QueueFrame() {
+  switch (PickFrameType()) {
+    case FRAME_DMX:
+      QueueSlots(NULL_START_CODE, Random(1, MAX_SLOTS));
+      m_counters.dmx_frames++;
+      break;
+    case FRAME_RDM:
+      QueueRDMRequest();
+      m_counters.rdm_requests++;
+      break;
+    case FRAME_ASC:
+      {
+        // Any start code other than DMX or RDM.
+        uint8_t start_code = Random(1, 0xfe);
+        if (start_code == RDM_START_CODE) {
+          start_code++;
+        }
+        QueueSlots(start_code, Random(1, MAX_SLOTS));
+        m_counters.asc_frames++;
+      }
+      break;
+    case FRAME_FRAMING_ERROR:
+      QueueFramingError();
+      m_counters.framing_errors++;
+      break;
+    case FRAME_SHORT_BREAK:
+      {
+        // The break is ignored, and so is the frame which follows it.
+        m_generator->AddBreak(m_settings.short_break_time);
+        m_generator->AddMark(m_settings.mark_time);
+        const unsigned int slot_count = Random(1, MAX_SLOTS);
+        m_generator->AddByte(NULL_START_CODE);
+        for (unsigned int i = 0; i < slot_count; i++) {
+          m_generator->AddByte(Random(0, 255));
+        }
+        m_counters.slots += slot_count + 1;
+        m_counters.short_breaks++;
+      }
+      break;
+  }
+}
+
+void LoadGenerator::QueueSlots(uint8_t start_code, unsigned int slot_count) {
+  m_generator->AddBreak(m_settings.break_time);
+  m_generator->AddMark(m_settings.mark_time);
+  m_generator->AddByte(start_code);
+  for (unsigned int i = 0; i < slot_count; i++) {
+    m_generator->AddByte(Random(0, 255));
+  }
+  m_counters.slots += slot_count + 1;
+}
+
+void LoadGenerator::QueueFramingError() {
+  // The start code is always received, so the frame is still counted.
+  const unsigned int slot_count = Random(1, MAX_SLOTS);
+  const unsigned int error_slot = Random(1, slot_count);
+  m_generator->AddBreak(m_settings.break_time);
+  m_generator->AddMark(m_settings.mark_time);
+  m_generator->AddByte(NULL_START_CODE);
+  for (unsigned int i = 1; i < error_slot; i++) {
+    m_generator->AddByte(Random(0, 255));
+  }
+  m_generator->AddFramingError(Random(0, 255));
+  m_counters.slots += error_slot + 1;
+}
+
+void LoadGenerator::QueueRDMRequest() {
+  vector<uint8_t> frame = {RDM_START_CODE, RDM_SUB_START_CODE, 24};
+  AppendUID(m_responder_uid, &frame);
+  AppendUID(CONTROLLER_UID, &frame);
+  const uint16_t pid = REQUEST_PIDS[
+      Random(0, sizeof(REQUEST_PIDS) / sizeof(REQUEST_PIDS[0]) - 1)];
+  frame.push_back(m_transaction_number++);
+  frame.push_back(1);  // port ID
+  frame.push_back(0);  // message count
+  frame.push_back(0);  // sub device
+  frame.push_back(0);
+  frame.push_back(GET_COMMAND);
+  frame.push_back(pid >> 8);
+  frame.push_back(pid & 0xff);
+  frame.push_back(0);  // param data length
+  uint16_t checksum = 0;
+  for (const auto &byte : frame) {
+    checksum += byte;
+  }
+  frame.push_back(checksum >> 8);
+  frame.push_back(checksum & 0xff);
+
+  m_generator->AddBreak(m_settings.break_time);
+  m_generator->AddMark(m_settings.mark_time);
+  m_generator->AddFrame(frame.data(), frame.size());
+  m_generator->AddDelay(m_settings.rdm_gap);
+  m_counters.slots += frame.size();
+}
+
+unsigned int LoadGenerator::Random(unsigned int min, unsigned int max) {
+  std::uniform_int_distribution<unsigned int> distribution(min, max);
+  return distribution(m_random);
+}
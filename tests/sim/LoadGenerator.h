@@ -0,0 +1,162 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * LoadGenerator.h
+ * Generate sustained, randomised DMX & RDM traffic.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+
+#ifndef TESTS_SIM_LOADGENERATOR_H_
+#define TESTS_SIM_LOADGENERATOR_H_
+
+#include <stdint.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "SignalGenerator.h"
+#include "Simulator.h"
+#include "ola/Callback.h"
+
+/*
+ * @brief Keep a SignalGenerator supplied with an endless stream of traffic.
+ *
+ * Each frame is picked at random. Most are DMX512 frames with a random slot
+ * count, sent at the maximum refresh rate: the shortest legal break & mark,
+ * no inter-slot delay and no mark-before-break. The rest are:
+ *  - RDM GET requests to the responder under test, followed by a gap so the
+ *    responder has time to reply.
+ *  - ASC frames with a random start code.
+ *  - DMX frames with a framing error in one of the slots.
+ *  - DMX frames which follow a break that is too short. These should be
+ *    ignored by the receiver.
+ *
+ * The generator is seeded, so a run can be reproduced. GetCounters() records
+ * what was queued, so it can be compared with what the receiver saw.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  LoadGenerator load(&simulator, &generator, 0x7a7000000001);
+ *  load.SetSeed(1);
+ *  simulator.SetClockLimit(1000000, false);  // 1s
+ *  simulator.Run();
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class LoadGenerator {
+ public:
+  /*
+   * @brief The traffic mix & timing.
+   *
+   * The percentages are the chance of each frame being of that type, the
+   * remaining frames are DMX512. Times are in microseconds.
+   */
+  struct Settings {
+   public:
+    Settings()
+      : break_time(92),
+        mark_time(12),
+        short_break_time(40),
+        rdm_gap(3000),
+        rdm_percent(10),
+        asc_percent(5),
+        framing_error_percent(2),
+        short_break_percent(2) {}
+
+    uint32_t break_time;
+    uint32_t mark_time;
+    uint32_t short_break_time;
+    uint32_t rdm_gap;  // The delay after each RDM request.
+    unsigned int rdm_percent;
+    unsigned int asc_percent;
+    unsigned int framing_error_percent;
+    unsigned int short_break_percent;
+  };
+
+  /*
+   * @brief The frames queued so far.
+   */
+  struct Counters {
+   public:
+    Counters()
+      : dmx_frames(0),
+        asc_frames(0),
+        rdm_requests(0),
+        framing_errors(0),
+        short_breaks(0),
+        slots(0) {}
+
+    uint64_t dmx_frames;  // Complete DMX frames.
+    uint64_t asc_frames;
+    uint64_t rdm_requests;
+    uint64_t framing_errors;  // DMX frames with a framing error.
+    uint64_t short_breaks;  // DMX frames after a short break.
+    uint64_t slots;  // All slots, including start codes.
+  };
+
+  // Ownership of the arguments is not transferred.
+  LoadGenerator(Simulator *simulator, SignalGenerator *generator,
+                uint64_t responder_uid,
+                const Settings &settings = Settings());
+  ~LoadGenerator();
+
+  void Tick();
+
+  /*
+   * @brief Seed the generator, so runs can be reproduced.
+   */
+  void SetSeed(uint32_t seed);
+
+  /*
+   * @brief Stop queuing frames once the simulator clock reaches a value.
+   * @param clock The clock value, in cycles. 0 means run forever.
+   *
+   * The frames already queued are still sent, so the counters are complete
+   * once the SignalGenerator has run dry.
+   */
+  void StopAt(uint64_t clock) { m_stop_at = clock; }
+
+  const Counters &GetCounters() const { return m_counters; }
+
+ private:
+  enum FrameType {
+    FRAME_DMX,
+    FRAME_RDM,
+    FRAME_ASC,
+    FRAME_FRAMING_ERROR,
+    FRAME_SHORT_BREAK,
+  };
+
+  Simulator *m_simulator;
+  SignalGenerator *m_generator;
+  std::unique_ptr<ola::Callback0<void>> m_callback;
+  const uint64_t m_responder_uid;
+  const Settings m_settings;
+  std::mt19937 m_random;
+  Counters m_counters;
+  uint8_t m_transaction_number;
+  uint64_t m_stop_at;
+
+  FrameType PickFrameType();
+  void QueueFrame();
+  void QueueSlots(uint8_t start_code, unsigned int slot_count);
+  void QueueFramingError();
+  void QueueRDMRequest();
+  unsigned int Random(unsigned int min, unsigned int max);
+
+  static const unsigned int MAX_SLOTS = 512;
+  static const uint64_t CONTROLLER_UID = 0x7a70fffffffe;
+};
+
+#endif  // TESTS_SIM_LOADGENERATOR_H_
@@ -3,20 +3,34 @@
 
 noinst_LTLIBRARIES += tests/sim/libsim.la
 
-tests_sim_libsim_la_SOURCES = tests/sim/InterruptController.cpp \
+tests_sim_libsim_la_SOURCES = tests/sim/CallAccounting.cpp \
+                              tests/sim/CallAccounting.h \
+                              tests/sim/InterruptController.cpp \
                               tests/sim/InterruptController.h \
+                              tests/sim/LoadGenerator.cpp \
+                              tests/sim/LoadGenerator.h \
+                              tests/sim/PeripheralCoreTimer.cpp \
+                              tests/sim/PeripheralCoreTimer.h \
+                              tests/sim/PeripheralDMA.cpp \
+                              tests/sim/PeripheralDMA.h \
                               tests/sim/PeripheralInputCapture.cpp \
                               tests/sim/PeripheralInputCapture.h \
+                              tests/sim/PeripheralPorts.cpp \
+                              tests/sim/PeripheralPorts.h \
                               tests/sim/PeripheralSPI.cpp \
                               tests/sim/PeripheralSPI.h \
                               tests/sim/PeripheralTimer.cpp \
                               tests/sim/PeripheralTimer.h \
                               tests/sim/PeripheralUART.cpp \
                               tests/sim/PeripheralUART.h \
+                              tests/sim/RS485Bus.cpp \
+                              tests/sim/RS485Bus.h \
                               tests/sim/SignalGenerator.cpp \
                               tests/sim/SignalGenerator.h \
                               tests/sim/Simulator.cpp \
-                              tests/sim/Simulator.h
+                              tests/sim/Simulator.h \
+                              tests/sim/Tracer.cpp \
+                              tests/sim/Tracer.h
 tests_sim_libsim_la_CXXFLAGS = $(BUILD_FLAGS) $(GMOCK_INCLUDES) \
                                $(GTEST_INCLUDES)  -I tests/harmony/mocks
 tests_sim_libsim_la_LIBADD = $(GMOCK_LIBS) $(GTEST_LIBS)
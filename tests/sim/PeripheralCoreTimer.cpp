@@ -0,0 +1,43 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PeripheralCoreTimer.cpp
+ * The core timer used with the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "PeripheralCoreTimer.h"
+
+#include "Simulator.h"
+#include "ola/Callback.h"
+
+PeripheralCoreTimer::PeripheralCoreTimer(Simulator *simulator)
+    : m_simulator(simulator),
+      m_callback(ola::NewCallback(this, &PeripheralCoreTimer::Tick)),
+      m_cycles(0) {
+  m_simulator->AddTask(m_callback.get());
+}
+
+PeripheralCoreTimer::~PeripheralCoreTimer() {
+  m_simulator->RemoveTask(m_callback.get());
+}
+
+void PeripheralCoreTimer::Tick() {
+  m_cycles++;
+}
+
+uint32_t PeripheralCoreTimer::CounterGet() {
+  return static_cast<uint32_t>(m_cycles / 2);
+}
@@ -0,0 +1,52 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PeripheralCoreTimer.h
+ * The core timer used with the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef TESTS_SIM_PERIPHERALCORETIMER_H_
+#define TESTS_SIM_PERIPHERALCORETIMER_H_
+
+#include <stdint.h>
+#include <memory>
+
+#include "core_timer_mock.h"
+
+#include "Simulator.h"
+#include "ola/Callback.h"
+
+/*
+ * The core timer increments once every two system clock cycles. Unlike the
+ * simulator clock, it isn't reset by Simulator::Run().
+ */
+class PeripheralCoreTimer : public CoreTimerInterface {
+ public:
+  // Ownership is not transferred.
+  explicit PeripheralCoreTimer(Simulator *simulator);
+  ~PeripheralCoreTimer();
+
+  void Tick();
+
+  uint32_t CounterGet();
+
+ private:
+  Simulator *m_simulator;
+  std::unique_ptr<ola::Callback0<void>> m_callback;
+  uint64_t m_cycles;
+};
+
+#endif  // TESTS_SIM_PERIPHERALCORETIMER_H_
@@ -0,0 +1,398 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PeripheralDMA.cpp
+ * The DMA controller used with the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "PeripheralDMA.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "macros.h"
+#include "sys/kmem.h"
+#include "Simulator.h"
+#include "ola/Callback.h"
+
+PeripheralDMA::Channel::Channel()
+    : enabled(false),
+      force_start(false),
+      start_trigger_enabled(false),
+      chain_enabled(false),
+      chain_from_higher(true),
+      start_irq(DMA_TRIGGER_SPI_1_TRANSMIT),
+      source_address(0),
+      destination_address(0),
+      source_size(0),
+      destination_size(0),
+      cell_size(1),
+      source_offset(0),
+      destination_offset(0),
+      transferred(0),
+      flags(0),
+      interrupt_enables(0),
+      block_count(0) {
+}
+
+PeripheralDMA::PeripheralDMA(
+    Simulator *simulator,
+    InterruptController *interrupt_controller,
+    PeripheralSPI *spi)
+    : m_simulator(simulator),
+      m_interrupt_controller(interrupt_controller),
+      m_spi(spi),
+      m_callback(ola::NewCallback(this, &PeripheralDMA::Tick)),
+      m_enabled(false),
+      m_channels(DMA_NUMBER_OF_CHANNELS) {
+  m_simulator->AddTask(m_callback.get());
+}
+
+PeripheralDMA::~PeripheralDMA() {
+  m_simulator->RemoveTask(m_callback.get());
+}
+
+unsigned int PeripheralDMA::BlockCount(DMA_CHANNEL channel) const {
+  if (channel >= m_channels.size()) {
+    ADD_FAILURE() << "Invalid DMA channel " << channel;
+    return 0;
+  }
+  return m_channels[channel].block_count;
+}
+
+void PeripheralDMA::Tick() {
+  if (!m_enabled) {
+    return;
+  }
+
+  for (unsigned int i = 0; i < m_channels.size(); i++) {
+    Channel *channel = &m_channels[i];
+    if (!channel->enabled) {
+      continue;
+    }
+
+    if (channel->force_start) {
+      channel->force_start = false;
+    } else if (channel->start_trigger_enabled &&
+               m_interrupt_controller->SourceStatusGet(
+                   static_cast<INT_SOURCE>(channel->start_irq))) {
+      // The flag is cleared so that each event only moves one cell.
+      m_interrupt_controller->SourceStatusClear(
+          static_cast<INT_SOURCE>(channel->start_irq));
+    } else {
+      continue;
+    }
+    TransferCell(i);
+  }
+}
+
+void PeripheralDMA::Enable(DMA_MODULE_ID index) {
+  if (index != DMA_ID_0) {
+    ADD_FAILURE() << "Invalid DMA module " << index;
+    return;
+  }
+  m_enabled = true;
+}
+
+void PeripheralDMA::ChannelXEnable(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->enabled = true;
+  }
+}
+
+void PeripheralDMA::ChannelXDisable(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->enabled = false;
+  }
+}
+
+void PeripheralDMA::ChannelXChainEnable(DMA_MODULE_ID index,
+                                        DMA_CHANNEL channel) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->chain_enabled = true;
+  }
+}
+
+void PeripheralDMA::ChannelXChainDisable(DMA_MODULE_ID index,
+                                         DMA_CHANNEL channel) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->chain_enabled = false;
+  }
+}
+
+void PeripheralDMA::ChannelXChainToHigher(DMA_MODULE_ID index,
+                                          DMA_CHANNEL channel) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->chain_from_higher = true;
+  }
+}
+
+void PeripheralDMA::ChannelXChainToLower(DMA_MODULE_ID index,
+                                         DMA_CHANNEL channel) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->chain_from_higher = false;
+  }
+}
+
+void PeripheralDMA::ChannelXTriggerEnable(DMA_MODULE_ID index,
+                                          DMA_CHANNEL channel,
+                                          DMA_CHANNEL_TRIGGER_TYPE trigger) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (!dma_channel) {
+    return;
+  }
+  if (trigger == DMA_CHANNEL_TRIGGER_TRANSFER_START) {
+    dma_channel->start_trigger_enabled = true;
+  } else {
+    ADD_FAILURE() << "Unsupported DMA trigger " << trigger;
+  }
+}
+
+void PeripheralDMA::ChannelXStartIRQSet(DMA_MODULE_ID index,
+                                        DMA_CHANNEL channel,
+                                        DMA_TRIGGER_SOURCE IRQ) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->start_irq = IRQ;
+  }
+}
+
+void PeripheralDMA::ChannelXSourceStartAddressSet(DMA_MODULE_ID index,
+                                                  DMA_CHANNEL channel,
+                                                  uint32_t sourceStartAddress) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->source_address = sourceStartAddress;
+    dma_channel->source_offset = 0;
+    dma_channel->transferred = 0;
+  }
+}
+
+void PeripheralDMA::ChannelXDestinationStartAddressSet(
+    DMA_MODULE_ID index,
+    DMA_CHANNEL channel,
+    uint32_t destinationStartAddress) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->destination_address = destinationStartAddress;
+    dma_channel->destination_offset = 0;
+    dma_channel->transferred = 0;
+  }
+}
+
+void PeripheralDMA::ChannelXSourceSizeSet(DMA_MODULE_ID index,
+                                          DMA_CHANNEL channel,
+                                          uint16_t sourceSize) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->source_size = sourceSize;
+  }
+}
+
+void PeripheralDMA::ChannelXDestinationSizeSet(DMA_MODULE_ID index,
+                                               DMA_CHANNEL channel,
+                                               uint16_t destinationSize) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->destination_size = destinationSize;
+  }
+}
+
+void PeripheralDMA::ChannelXCellSizeSet(DMA_MODULE_ID index,
+                                        DMA_CHANNEL channel,
+                                        uint16_t CellSize) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->cell_size = CellSize;
+  }
+}
+
+bool PeripheralDMA::ChannelXINTSourceFlagGet(DMA_MODULE_ID index,
+                                             DMA_CHANNEL channel,
+                                             DMA_INT_TYPE dmaINTSource) {
+  Channel *dma_channel = GetChannel(index, channel);
+  return dma_channel && (dma_channel->flags & dmaINTSource);
+}
+
+void PeripheralDMA::ChannelXINTSourceFlagClear(DMA_MODULE_ID index,
+                                               DMA_CHANNEL channel,
+                                               DMA_INT_TYPE dmaINTSource) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->flags &= ~dmaINTSource;
+  }
+}
+
+void PeripheralDMA::ChannelXINTSourceEnable(DMA_MODULE_ID index,
+                                            DMA_CHANNEL channel,
+                                            DMA_INT_TYPE dmaINTSource) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->interrupt_enables |= dmaINTSource;
+  }
+}
+
+void PeripheralDMA::ChannelXINTSourceDisable(DMA_MODULE_ID index,
+                                             DMA_CHANNEL channel,
+                                             DMA_INT_TYPE dmaINTSource) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->interrupt_enables &= ~dmaINTSource;
+  }
+}
+
+void PeripheralDMA::StartTransferSet(DMA_MODULE_ID index,
+                                     DMA_CHANNEL channel) {
+  Channel *dma_channel = GetChannel(index, channel);
+  if (dma_channel) {
+    dma_channel->force_start = true;
+  }
+}
+
+PeripheralDMA::Channel *PeripheralDMA::GetChannel(DMA_MODULE_ID index,
+                                                  DMA_CHANNEL channel) {
+  if (index != DMA_ID_0) {
+    ADD_FAILURE() << "Invalid DMA module " << index;
+    return nullptr;
+  }
+  if (channel >= m_channels.size()) {
+    ADD_FAILURE() << "Invalid DMA channel " << channel;
+    return nullptr;
+  }
+  return &m_channels[channel];
+}
+
+void PeripheralDMA::TransferCell(unsigned int channel_index) {
+  Channel *channel = &m_channels[channel_index];
+  const unsigned int block_size = std::max(channel->source_size,
+                                           channel->destination_size);
+  if (channel->source_size == 0 || channel->destination_size == 0) {
+    ADD_FAILURE() << "DMA channel " << channel_index << " has a zero size";
+    channel->enabled = false;
+    return;
+  }
+
+  for (unsigned int i = 0; i < channel->cell_size; i++) {
+    uint8_t data = 0;
+    if (!ReadByte(channel->source_address + channel->source_offset, &data) ||
+        !WriteByte(channel->destination_address + channel->destination_offset,
+                   data)) {
+      ADD_FAILURE() << "DMA address error on channel " << channel_index;
+      channel->enabled = false;
+      SetFlags(channel_index, DMA_INT_ADDRESS_ERROR);
+      return;
+    }
+
+    channel->transferred++;
+    channel->source_offset++;
+    if (channel->source_offset == channel->source_size) {
+      channel->source_offset = 0;
+      SetFlags(channel_index, DMA_INT_SOURCE_DONE);
+    }
+    channel->destination_offset++;
+    if (channel->destination_offset == channel->destination_size) {
+      channel->destination_offset = 0;
+      SetFlags(channel_index, DMA_INT_DESTINATION_DONE);
+    }
+
+    if (channel->transferred == block_size) {
+      CompleteBlock(channel_index);
+      return;
+    }
+  }
+  SetFlags(channel_index, DMA_INT_CELL_TRANSFER_COMPLETE);
+}
+
+void PeripheralDMA::CompleteBlock(unsigned int channel_index) {
+  Channel *channel = &m_channels[channel_index];
+  channel->enabled = false;
+  channel->transferred = 0;
+  channel->source_offset = 0;
+  channel->destination_offset = 0;
+  channel->block_count++;
+
+  // Enable any channels chained to this one before the interrupt is
+  // serviced, as the hardware does.
+  if (channel_index + 1 < m_channels.size()) {
+    Channel *next = &m_channels[channel_index + 1];
+    if (next->chain_enabled && next->chain_from_higher) {
+      next->enabled = true;
+    }
+  }
+  if (channel_index > 0) {
+    Channel *previous = &m_channels[channel_index - 1];
+    if (previous->chain_enabled && !previous->chain_from_higher) {
+      previous->enabled = true;
+    }
+  }
+
+  SetFlags(channel_index, DMA_INT_BLOCK_TRANSFER_COMPLETE);
+}
+
+void PeripheralDMA::SetFlags(unsigned int channel_index, uint8_t flags) {
+  Channel *channel = &m_channels[channel_index];
+  channel->flags |= flags;
+  if (channel->interrupt_enables & flags) {
+    m_interrupt_controller->RaiseInterrupt(
+        static_cast<INT_SOURCE>(INT_SOURCE_DMA_0 + channel_index));
+  }
+}
+
+bool PeripheralDMA::ReadByte(uint32_t address, uint8_t *data) {
+  SPI_MODULE_ID module;
+  if (SPIModule(address, &module)) {
+    *data = m_spi->BufferRead(module);
+    return true;
+  }
+  const uint8_t *ptr = reinterpret_cast<uint8_t*>(PA_TO_KVA1(address));
+  if (!ptr) {
+    return false;
+  }
+  *data = *ptr;
+  return true;
+}
+
+bool PeripheralDMA::WriteByte(uint32_t address, uint8_t data) {
+  SPI_MODULE_ID module;
+  if (SPIModule(address, &module)) {
+    m_spi->BufferWrite(module, data);
+    return true;
+  }
+  uint8_t *ptr = reinterpret_cast<uint8_t*>(PA_TO_KVA1(address));
+  if (!ptr) {
+    return false;
+  }
+  *ptr = data;
+  return true;
+}
+
+bool PeripheralDMA::SPIModule(uint32_t address, SPI_MODULE_ID *module) {
+  for (unsigned int i = 0; i < SPI_NUMBER_OF_MODULES; i++) {
+    SPI_MODULE_ID index = static_cast<SPI_MODULE_ID>(i);
+    if (KVA_TO_PA(m_spi->BufferAddressGet(index)) == address) {
+      *module = index;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PeripheralDMA.h
+ * The DMA controller used with the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef TESTS_SIM_PERIPHERALDMA_H_
+#define TESTS_SIM_PERIPHERALDMA_H_
+
+#include <memory>
+#include <vector>
+
+#include "plib_dma_mock.h"
+
+#include "InterruptController.h"
+#include "PeripheralSPI.h"
+#include "Simulator.h"
+#include "ola/Callback.h"
+
+/*
+ * A basic model of the PIC32 DMA controller.
+ *
+ * Each event on a channel's start IRQ moves one cell. A block is complete once
+ * max(source size, destination size) bytes have been moved, at which point
+ * the channel is disabled and any channel chained to it is enabled.
+ *
+ * Addresses that match an SPI buffer address are routed to the SPI module,
+ * everything else is treated as memory.
+ */
+class PeripheralDMA : public PeripheralDMAInterface {
+ public:
+  // Ownership is not transferred.
+  PeripheralDMA(Simulator *simulator,
+                InterruptController *interrupt_controller,
+                PeripheralSPI *spi);
+  ~PeripheralDMA();
+
+  // The number of blocks completed on a channel.
+  unsigned int BlockCount(DMA_CHANNEL channel) const;
+
+  void Tick();
+
+  void Enable(DMA_MODULE_ID index);
+  void ChannelXEnable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void ChannelXDisable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void ChannelXChainEnable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void ChannelXChainDisable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void ChannelXChainToHigher(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void ChannelXChainToLower(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void ChannelXTriggerEnable(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                             DMA_CHANNEL_TRIGGER_TYPE trigger);
+  void ChannelXStartIRQSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                           DMA_TRIGGER_SOURCE IRQ);
+  void ChannelXSourceStartAddressSet(DMA_MODULE_ID index,
+                                     DMA_CHANNEL channel,
+                                     uint32_t sourceStartAddress);
+  void ChannelXDestinationStartAddressSet(DMA_MODULE_ID index,
+                                          DMA_CHANNEL channel,
+                                          uint32_t destinationStartAddress);
+  void ChannelXSourceSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                             uint16_t sourceSize);
+  void ChannelXDestinationSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  uint16_t destinationSize);
+  void ChannelXCellSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                           uint16_t CellSize);
+  bool ChannelXINTSourceFlagGet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                DMA_INT_TYPE dmaINTSource);
+  void ChannelXINTSourceFlagClear(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  DMA_INT_TYPE dmaINTSource);
+  void ChannelXINTSourceEnable(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                               DMA_INT_TYPE dmaINTSource);
+  void ChannelXINTSourceDisable(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                DMA_INT_TYPE dmaINTSource);
+  void StartTransferSet(DMA_MODULE_ID index, DMA_CHANNEL channel);
+
+ private:
+  struct Channel {
+   public:
+    Channel();
+
+    bool enabled;
+    bool force_start;
+    bool start_trigger_enabled;
+    bool chain_enabled;
+    // True if this channel is enabled by the channel below it (N - 1), false
+    // if it's enabled by the channel above it (N + 1).
+    bool chain_from_higher;
+    DMA_TRIGGER_SOURCE start_irq;
+    uint32_t source_address;
+    uint32_t destination_address;
+    uint16_t source_size;
+    uint16_t destination_size;
+    uint16_t cell_size;
+    uint16_t source_offset;
+    uint16_t destination_offset;
+    unsigned int transferred;
+    uint8_t flags;
+    uint8_t interrupt_enables;
+    unsigned int block_count;
+  };
+
+  Simulator *m_simulator;
+  InterruptController *m_interrupt_controller;
+  PeripheralSPI *m_spi;
+  std::unique_ptr<ola::Callback0<void>> m_callback;
+  bool m_enabled;
+  std::vector<Channel> m_channels;
+
+  Channel *GetChannel(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void TransferCell(unsigned int channel_index);
+  void CompleteBlock(unsigned int channel_index);
+  void SetFlags(unsigned int channel_index, uint8_t flags);
+  bool ReadByte(uint32_t address, uint8_t *data);
+  bool WriteByte(uint32_t address, uint8_t data);
+  bool SPIModule(uint32_t address, SPI_MODULE_ID *module);
+};
+
+#endif  // TESTS_SIM_PERIPHERALDMA_H_
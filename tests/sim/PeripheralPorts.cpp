@@ -0,0 +1,77 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PeripheralPorts.cpp
+ * The I/O ports for the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+
+#include "PeripheralPorts.h"
+
+#include <map>
+#include <string>
+
+#include "macros.h"
+
+void PeripheralPorts::TracePin(PORTS_CHANNEL channel, PORTS_BIT_POS bit,
+                               Tracer *tracer, const std::string &name) {
+  Pin &pin = m_pins[PinId(channel, bit)];
+  pin.tracer = tracer;
+  pin.signal = tracer->AddSignal(name, 1, pin.value);
+}
+
+void PeripheralPorts::PinDirectionInputSet(UNUSED PORTS_MODULE_ID index,
+                                           UNUSED PORTS_CHANNEL channel,
+                                           UNUSED PORTS_BIT_POS bitPos) {
+}
+
+void PeripheralPorts::PinDirectionOutputSet(UNUSED PORTS_MODULE_ID index,
+                                            UNUSED PORTS_CHANNEL channel,
+                                            UNUSED PORTS_BIT_POS bitPos) {
+}
+
+bool PeripheralPorts::PinGet(UNUSED PORTS_MODULE_ID index,
+                             PORTS_CHANNEL channel,
+                             PORTS_BIT_POS bitPos) {
+  return m_pins[PinId(channel, bitPos)].value;
+}
+
+void PeripheralPorts::PinSet(UNUSED PORTS_MODULE_ID index,
+                             PORTS_CHANNEL channel,
+                             PORTS_BIT_POS bitPos) {
+  SetPin(channel, bitPos, true);
+}
+
+void PeripheralPorts::PinClear(UNUSED PORTS_MODULE_ID index,
+                               PORTS_CHANNEL channel,
+                               PORTS_BIT_POS bitPos) {
+  SetPin(channel, bitPos, false);
+}
+
+void PeripheralPorts::PinToggle(UNUSED PORTS_MODULE_ID index,
+                                PORTS_CHANNEL channel,
+                                PORTS_BIT_POS bitPos) {
+  SetPin(channel, bitPos, !m_pins[PinId(channel, bitPos)].value);
+}
+
+void PeripheralPorts::SetPin(PORTS_CHANNEL channel, PORTS_BIT_POS bit,
+                             bool value) {
+  Pin &pin = m_pins[PinId(channel, bit)];
+  pin.value = value;
+  if (pin.tracer) {
+    pin.tracer->SetSignal(pin.signal, value);
+  }
+}
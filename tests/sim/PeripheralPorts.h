@@ -0,0 +1,84 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PeripheralPorts.h
+ * The I/O ports for the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+
+#ifndef TESTS_SIM_PERIPHERALPORTS_H_
+#define TESTS_SIM_PERIPHERALPORTS_H_
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "plib_ports_mock.h"
+
+#include "Tracer.h"
+
+/*
+ * @brief The I/O ports.
+ *
+ * This holds the output latch of each pin. Input levels aren't simulated, so
+ * PinGet() returns the last value written. Pins can be added to a Tracer to
+ * record when they change.
+ */
+class PeripheralPorts : public PeripheralPortsInterface {
+ public:
+  PeripheralPorts() {}
+
+  /*
+   * @brief Record changes to a pin.
+   * @param channel The port the pin is on.
+   * @param bit The pin.
+   * @param tracer The tracer to add the pin to, ownership is not transferred.
+   * @param name The name of the signal.
+   */
+  void TracePin(PORTS_CHANNEL channel, PORTS_BIT_POS bit, Tracer *tracer,
+                const std::string &name);
+
+  void PinDirectionInputSet(PORTS_MODULE_ID index, PORTS_CHANNEL channel,
+                            PORTS_BIT_POS bitPos);
+  void PinDirectionOutputSet(PORTS_MODULE_ID index, PORTS_CHANNEL channel,
+                             PORTS_BIT_POS bitPos);
+  bool PinGet(PORTS_MODULE_ID index, PORTS_CHANNEL channel,
+              PORTS_BIT_POS bitPos);
+  void PinSet(PORTS_MODULE_ID index, PORTS_CHANNEL channel,
+              PORTS_BIT_POS bitPos);
+  void PinClear(PORTS_MODULE_ID index, PORTS_CHANNEL channel,
+                PORTS_BIT_POS bitPos);
+  void PinToggle(PORTS_MODULE_ID index, PORTS_CHANNEL channel,
+                 PORTS_BIT_POS bitPos);
+
+ private:
+  typedef std::pair<PORTS_CHANNEL, PORTS_BIT_POS> PinId;
+
+  struct Pin {
+   public:
+    Pin() : value(false), tracer(nullptr), signal(0) {}
+
+    bool value;
+    Tracer *tracer;
+    Tracer::SignalId signal;
+  };
+
+  std::map<PinId, Pin> m_pins;
+
+  void SetPin(PORTS_CHANNEL channel, PORTS_BIT_POS bit, bool value);
+};
+
+#endif  // TESTS_SIM_PERIPHERALPORTS_H_
@@ -40,7 +40,8 @@ PeripheralSPI::SPI::SPI(INT_SOURCE source)
       has_overflowed(false),
       rx_interrupt_mode(SPI_FIFO_INTERRUPT_WHEN_RECEIVE_BUFFER_IS_FULL),
       tx_interrupt_mode(SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_NOT_FULL),
-      rx_iter(incoming_bytes.begin()) {
+      buffer_register(0),
+      rx_index(0) {
 }
 
 
@@ -72,13 +73,7 @@ void PeripheralSPI::QueueResponseByte(SPI_MODULE_ID index, uint8_t data) {
     return;
   }
 
-  SPI *spi = &m_spi[index];
-  bool reset_iter = spi->rx_iter == spi->incoming_bytes.end();
-  spi->incoming_bytes.push_back(data);
-  if (reset_iter) {
-    spi->rx_iter = spi->incoming_bytes.end();
-    spi->rx_iter--;
-  }
+  m_spi[index].incoming_bytes.push_back(data);
 }
 
 vector<uint8_t> PeripheralSPI::SentBytes(SPI_MODULE_ID index) {
@@ -107,9 +102,9 @@ void PeripheralSPI::Tick() {
         spi.sent_bytes.push_back(tx_data);
 
         uint8_t rx_data = 0;
-        if (spi.rx_iter != spi.incoming_bytes.end()) {
-          rx_data = *spi.rx_iter;
-          spi.rx_iter++;
+        if (spi.rx_index < spi.incoming_bytes.size()) {
+          rx_data = spi.incoming_bytes[spi.rx_index];
+          spi.rx_index++;
         }
         if (spi.rx_queue.size() < spi.fifo_size) {
           spi.rx_queue.push_back(rx_data);
@@ -304,6 +299,14 @@ uint8_t PeripheralSPI::BufferRead(SPI_MODULE_ID index) {
   return data;
 }
 
+void* PeripheralSPI::BufferAddressGet(SPI_MODULE_ID index) {
+  if (index >= m_spi.size()) {
+    ADD_FAILURE() << "Invalid SPI " << index;
+    return nullptr;
+  }
+  return &m_spi[index].buffer_register;
+}
+
 void PeripheralSPI::SlaveSelectDisable(SPI_MODULE_ID index) {
   if (index >= m_spi.size()) {
     ADD_FAILURE() << "Invalid SPI " << index;
@@ -63,6 +63,7 @@ class PeripheralSPI : public PeripheralSPIInterface {
   void BufferWrite(SPI_MODULE_ID index, uint8_t data);
   void BufferClear(SPI_MODULE_ID index);
   uint8_t BufferRead(SPI_MODULE_ID index);
+  void* BufferAddressGet(SPI_MODULE_ID index);
   void SlaveSelectDisable(SPI_MODULE_ID index);
   void PinDisable(SPI_MODULE_ID index, SPI_PIN pin);
 
@@ -87,6 +88,9 @@ class PeripheralSPI : public PeripheralSPIInterface {
     SPI_FIFO_INTERRUPT rx_interrupt_mode;
     SPI_FIFO_INTERRUPT tx_interrupt_mode;
 
+    // Stands in for the SPIxBUF register, so the module has an address.
+    uint32_t buffer_register;
+
     // The queue for outgoing bytes.
     std::deque<uint32_t> tx_queue;
     // The queue for incoming bytes.
@@ -96,7 +100,8 @@ class PeripheralSPI : public PeripheralSPIInterface {
     ByteVector sent_bytes;
     // Incoming bytes to return.
     ByteVector incoming_bytes;
-    ByteVector::iterator rx_iter;
+    // The index of the next byte in incoming_bytes.
+    unsigned int rx_index;
 
     static const uint8_t ENHANCED_BUFFER_SIZE = 8;
   };
@@ -21,6 +21,7 @@
 #include "PeripheralUART.h"
 
 #include <gtest/gtest.h>
+#include <string>
 #include <vector>
 
 #include "macros.h"
@@ -39,7 +40,9 @@ PeripheralUART::UART::UART(INT_SOURCE source)
       errors(USART_ERROR_NONE),
       ticks_per_bit(16),
       tx_counter(0),
-      tx_state(IDLE) {
+      tx_state(IDLE),
+      tracer(nullptr),
+      tx_signal(0) {
 }
 
 PeripheralUART::PeripheralUART(Simulator *simulator,
@@ -95,6 +98,7 @@ void PeripheralUART::Tick() {
             uart.tx_state = static_cast<UARTState>(uart.tx_state + 1);
           }
         }
+        TraceTXLine(uart);
 
         bool trigger_tx_isr = false;
         switch (uart.int_mode) {
@@ -154,6 +158,17 @@ void PeripheralUART::SignalFramingError(USART_MODULE_ID index, uint8_t byte) {
   }
 }
 
+void PeripheralUART::TraceTX(USART_MODULE_ID index, Tracer *tracer,
+                             const std::string &name) {
+  if (index >= m_uarts.size()) {
+    FAIL() << "Invalid UART " << index;
+  }
+  UART &uart = m_uarts[index];
+  uart.tracer = tracer;
+  uart.tx_signal = tracer->AddSignal(name, 1, 1);
+  TraceTXLine(uart);
+}
+
 void PeripheralUART::Enable(USART_MODULE_ID index) {
   if (index >= m_uarts.size()) {
     FAIL() << "Invalid UART " << index;
@@ -177,6 +192,7 @@ void PeripheralUART::Disable(USART_MODULE_ID index) {
   }
   uart.tx_counter = 0;
   uart.tx_state = IDLE;
+  TraceTXLine(uart);
   // TODO(simon): reset flags here
   uart.errors = USART_ERROR_NONE;
 }
@@ -316,3 +332,18 @@ USART_ERROR PeripheralUART::ErrorsGet(USART_MODULE_ID index) {
   // Yuck
   return static_cast<USART_ERROR>(m_uarts[index].errors);
 }
+
+void PeripheralUART::TraceTXLine(const UART &uart) {
+  if (!uart.tracer) {
+    return;
+  }
+
+  // The line idles high, the bits are sent LSB first.
+  bool level = true;
+  if (uart.tx_state == START_BIT) {
+    level = false;
+  } else if (uart.tx_state >= BIT_0 && uart.tx_state <= BIT_7) {
+    level = (uart.tx_byte >> (uart.tx_state - BIT_0)) & 1;
+  }
+  uart.tracer->SetSignal(uart.tx_signal, level);
+}
@@ -23,12 +23,14 @@
 
 #include <memory>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "plib_usart_mock.h"
 
 #include "InterruptController.h"
 #include "Simulator.h"
+#include "Tracer.h"
 #include "ola/Callback.h"
 
 class PeripheralUART : public PeripheralUSARTInterface {
@@ -50,6 +52,10 @@ class PeripheralUART : public PeripheralUSARTInterface {
   // Signal a framing error has occured.
   void SignalFramingError(USART_MODULE_ID index, uint8_t byte);
 
+  // Record the level of the TX line. Ownership of the tracer is not
+  // transferred.
+  void TraceTX(USART_MODULE_ID index, Tracer *tracer, const std::string &name);
+
   void Enable(USART_MODULE_ID index);
   void Disable(USART_MODULE_ID index);
   void TransmitterEnable(USART_MODULE_ID index);
@@ -113,10 +119,15 @@ class PeripheralUART : public PeripheralUSARTInterface {
     uint32_t tx_counter;
     UARTState tx_state;
 
+    Tracer *tracer;
+    Tracer::SignalId tx_signal;
+
     static const uint16_t FRAMING_ERROR_FLAG = 0x8000;
   };
 
   std::vector<UART> m_uarts;
+
+  void TraceTXLine(const UART &uart);
   static const uint8_t TX_FIFO_SIZE = 8;
   static const uint8_t RX_FIFO_SIZE = 8;
 };
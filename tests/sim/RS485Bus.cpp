@@ -0,0 +1,352 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RS485Bus.cpp
+ * A multi-drop RS485 bus with behavioural RDM responders.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "RS485Bus.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "constants.h"
+#include "rdm.h"
+#include "rdm_frame.h"
+
+using std::vector;
+
+namespace {
+
+enum {
+  DUB_PREAMBLE_SIZE = 7,
+  DUB_PREAMBLE_BYTE = 0xfe,
+  DUB_SEPARATOR_BYTE = 0xaa,
+  MUTE_CONTROL_FIELD_SIZE = 2,
+};
+
+const uint64_t BROADCAST_DEVICE_ID = 0xffffffff;
+const uint64_t ALL_MANUFACTURERS = 0xffff;
+
+uint64_t UIDFromBytes(const uint8_t *data) {
+  uint64_t uid = 0;
+  for (unsigned int i = 0; i < UID_LENGTH; i++) {
+    uid = (uid << 8) + data[i];
+  }
+  return uid;
+}
+
+void AppendUID(uint64_t uid, vector<uint8_t> *output) {
+  for (int i = UID_LENGTH - 1; i >= 0; i--) {
+    output->push_back((uid >> (8 * i)) & 0xff);
+  }
+}
+
+uint16_t Checksum(const uint8_t *data, unsigned int length) {
+  uint16_t checksum = 0;
+  for (unsigned int i = 0; i < length; i++) {
+    checksum += data[i];
+  }
+  return checksum;
+}
+
+vector<uint8_t> EncodeDUBResponse(uint64_t uid) {
+  vector<uint8_t> uid_bytes;
+  AppendUID(uid, &uid_bytes);
+
+  vector<uint8_t> response(DUB_PREAMBLE_SIZE, DUB_PREAMBLE_BYTE);
+  response.push_back(DUB_SEPARATOR_BYTE);
+  for (const auto &byte : uid_bytes) {
+    response.push_back(byte | 0xaa);
+    response.push_back(byte | 0x55);
+  }
+  uint16_t checksum = Checksum(response.data() + DUB_PREAMBLE_SIZE + 1,
+                               2 * UID_LENGTH);
+  response.push_back((checksum >> 8) | 0xaa);
+  response.push_back((checksum >> 8) | 0x55);
+  response.push_back((checksum & 0xff) | 0xaa);
+  response.push_back((checksum & 0xff) | 0x55);
+  return response;
+}
+}  // namespace
+
+RS485Bus::RS485Bus(Simulator *simulator,
+                   SignalGenerator *generator,
+                   uint32_t clock_speed,
+                   uint32_t baud_rate)
+    : m_simulator(simulator),
+      m_generator(generator),
+      m_callback(ola::NewCallback(this, &RS485Bus::Tick)),
+      m_cycles_per_usecond(clock_speed / 1000000),
+      m_cycles_per_bit(clock_speed / baud_rate),
+      m_cycles(0),
+      m_request_start(0),
+      m_last_byte(0) {
+  m_simulator->AddTask(m_callback.get());
+}
+
+RS485Bus::~RS485Bus() {
+  m_simulator->RemoveTask(m_callback.get());
+}
+
+void RS485Bus::Tick() {
+  m_cycles++;
+}
+
+void RS485Bus::AddResponder(uint64_t uid, uint32_t delay, uint32_t jitter) {
+  m_responders.push_back(Responder(uid, delay, jitter));
+}
+
+void RS485Bus::SetSeed(uint32_t seed) {
+  m_random.seed(seed);
+}
+
+void RS485Bus::ControllerByte(uint8_t byte) {
+  const uint64_t slot_time = BITS_PER_SLOT * m_cycles_per_bit;
+  if (!m_request.empty() && m_cycles - m_last_byte > 2 * slot_time) {
+    // A gap this long means a new frame, drop what we had. Non-RDM frames end
+    // up here.
+    m_request.clear();
+  }
+
+  if (m_request.empty()) {
+    m_request_start = m_cycles > slot_time ? m_cycles - slot_time : 0;
+  }
+  m_request.push_back(byte);
+  m_last_byte = m_cycles;
+
+  if (m_request[0] != RDM_START_CODE || m_request.size() < 3) {
+    return;
+  }
+  // The message length doesn't include the checksum.
+  if (m_request.size() == m_request[2] + 2u) {
+    HandleRequest();
+    m_request.clear();
+  }
+}
+
+bool RS485Bus::IsMuted(uint64_t uid) const {
+  for (const auto &responder : m_responders) {
+    if (responder.uid == uid) {
+      return responder.muted;
+    }
+  }
+  return false;
+}
+
+void RS485Bus::HandleRequest() {
+  const uint8_t *frame = m_request.data();
+  const unsigned int length = frame[2];
+  if (length < sizeof(RDMHeader) || frame[1] != RDM_SUB_START_CODE ||
+      Checksum(frame, length) != ((frame[length] << 8) + frame[length + 1])) {
+    return;
+  }
+
+  const RDMHeader *header = reinterpret_cast<const RDMHeader*>(frame);
+  const uint8_t *param_data = frame + sizeof(RDMHeader);
+  if (sizeof(RDMHeader) + header->param_data_length != length) {
+    return;
+  }
+
+  Transaction transaction;
+  transaction.request_start = m_request_start;
+  transaction.request_end = m_last_byte;
+  transaction.command_class = header->command_class;
+  transaction.param_id = (frame[21] << 8) + frame[22];
+
+  const uint64_t dest = UIDFromBytes(header->dest_uid);
+  const bool broadcast = (dest & BROADCAST_DEVICE_ID) == BROADCAST_DEVICE_ID;
+  const uint64_t manufacturer = dest >> 32;
+
+  if (header->command_class == DISCOVERY_COMMAND) {
+    if (transaction.param_id == PID_DISC_UNIQUE_BRANCH) {
+      if (broadcast && header->param_data_length == 2 * UID_LENGTH) {
+        HandleDUB(param_data, &transaction);
+      }
+    } else if (transaction.param_id == PID_DISC_MUTE ||
+               transaction.param_id == PID_DISC_UN_MUTE) {
+      for (auto &responder : m_responders) {
+        if (responder.uid == dest ||
+            (broadcast && (manufacturer == ALL_MANUFACTURERS ||
+                           manufacturer == responder.uid >> 32))) {
+          responder.muted = transaction.param_id == PID_DISC_MUTE;
+          if (!broadcast) {
+            vector<uint8_t> control_field(MUTE_CONTROL_FIELD_SIZE, 0);
+            SendResponse(responder, DISCOVERY_COMMAND_RESPONSE, control_field,
+                         &transaction);
+          }
+        }
+      }
+    }
+  } else if ((header->command_class == GET_COMMAND ||
+              header->command_class == SET_COMMAND) && !broadcast) {
+    for (const auto &responder : m_responders) {
+      if (responder.uid == dest) {
+        SendResponse(responder, header->command_class + 1, vector<uint8_t>(),
+                     &transaction);
+      }
+    }
+  }
+  m_transactions.push_back(transaction);
+}
+
+void RS485Bus::HandleDUB(const uint8_t *param_data, Transaction *transaction) {
+  const uint64_t lower = UIDFromBytes(param_data);
+  const uint64_t upper = UIDFromBytes(param_data + UID_LENGTH);
+
+  vector<Driver> drivers;
+  for (const auto &responder : m_responders) {
+    if (!responder.muted && responder.uid >= lower &&
+        responder.uid <= upper) {
+      drivers.push_back(Driver(ResponseDelay(responder) * m_cycles_per_usecond,
+                               EncodeDUBResponse(responder.uid)));
+    }
+  }
+  if (!drivers.empty()) {
+    transaction->responders = drivers.size();
+    PlayDUBResponses(drivers, transaction);
+  }
+}
+
+void RS485Bus::SendResponse(const Responder &responder, uint8_t command_class,
+                            const vector<uint8_t> &param_data,
+                            Transaction *transaction) {
+  const RDMHeader *request = reinterpret_cast<const RDMHeader*>(
+      m_request.data());
+
+  vector<uint8_t> frame;
+  frame.push_back(RDM_START_CODE);
+  frame.push_back(RDM_SUB_START_CODE);
+  frame.push_back(sizeof(RDMHeader) + param_data.size());
+  frame.insert(frame.end(), request->src_uid, request->src_uid + UID_LENGTH);
+  AppendUID(responder.uid, &frame);
+  frame.push_back(request->transaction_number);
+  frame.push_back(ACK);
+  frame.push_back(0);  // message count
+  frame.push_back(m_request[18]);
+  frame.push_back(m_request[19]);
+  frame.push_back(command_class);
+  frame.push_back(m_request[21]);
+  frame.push_back(m_request[22]);
+  frame.push_back(param_data.size());
+  frame.insert(frame.end(), param_data.begin(), param_data.end());
+  uint16_t checksum = Checksum(frame.data(), frame.size());
+  frame.push_back(checksum >> 8);
+  frame.push_back(checksum & 0xff);
+
+  const uint32_t delay = ResponseDelay(responder);
+  m_generator->Reset();
+  m_generator->AddDelay(delay);
+  m_generator->AddBreak(BREAK_TIME);
+  m_generator->AddMark(MARK_TIME);
+  m_generator->AddFrame(frame.data(), frame.size());
+
+  transaction->responders++;
+  transaction->response_start = transaction->request_end +
+      delay * m_cycles_per_usecond;
+  transaction->response_end = transaction->response_start +
+      (BREAK_TIME + MARK_TIME) * m_cycles_per_usecond +
+      frame.size() * BITS_PER_SLOT * m_cycles_per_bit;
+}
+
+void RS485Bus::PlayDUBResponses(const vector<Driver> &drivers,
+                                Transaction *transaction) {
+  const uint64_t slot_time = BITS_PER_SLOT * m_cycles_per_bit;
+  uint64_t start = drivers[0].start;
+  uint64_t end = 0;
+  for (const auto &driver : drivers) {
+    start = std::min(start, driver.start);
+    end = std::max(end, driver.start + driver.data.size() * slot_time);
+  }
+  transaction->response_start = transaction->request_end + start;
+  transaction->response_end = transaction->request_end + end;
+
+  // Decode the combined line like a UART with 16x oversampling: find a
+  // falling edge, check the start bit is still low half a bit later, then
+  // sample the middle of each data bit & the first stop bit.
+  m_generator->Reset();
+  const uint32_t step = std::max(m_cycles_per_bit / 16u, 1u);
+  const uint32_t half_bit = m_cycles_per_bit / 2;
+  uint64_t played = 0;
+  uint64_t t = start;
+  while (t < end) {
+    if (LineState(drivers, t) || LineState(drivers, t + half_bit)) {
+      t += step;
+      continue;
+    }
+
+    uint8_t value = 0;
+    for (unsigned int i = 0; i < 8; i++) {
+      if (LineState(drivers, t + half_bit + (i + 1) * m_cycles_per_bit)) {
+        value |= (1 << i);
+      }
+    }
+    const bool stop_bit = LineState(drivers,
+                                    t + half_bit + 9 * m_cycles_per_bit);
+
+    // The generator sends whole slots, so a slot which starts before the
+    // last one finished is delayed.
+    if (t > played) {
+      const uint32_t gap = (t - played) / m_cycles_per_usecond;
+      if (gap) {
+        m_generator->AddDelay(gap);
+        played += gap * m_cycles_per_usecond;
+      }
+    }
+    if (stop_bit) {
+      m_generator->AddByte(value);
+    } else {
+      m_generator->AddFramingError(value);
+    }
+    played += slot_time;
+    t += half_bit + 9 * m_cycles_per_bit;
+  }
+}
+
+uint32_t RS485Bus::ResponseDelay(const Responder &responder) {
+  if (!responder.jitter) {
+    return responder.delay;
+  }
+  std::uniform_int_distribution<uint32_t> jitter(0, responder.jitter);
+  return responder.delay + jitter(m_random);
+}
+
+bool RS485Bus::LineState(const vector<Driver> &drivers, uint64_t t) const {
+  // With no drivers, the line is biased to a mark.
+  bool driven = false;
+  bool line = false;
+  for (const auto &driver : drivers) {
+    if (t < driver.start) {
+      continue;
+    }
+    const uint64_t bit = (t - driver.start) / m_cycles_per_bit;
+    if (bit >= driver.data.size() * BITS_PER_SLOT) {
+      continue;
+    }
+    driven = true;
+    const unsigned int bit_in_slot = bit % BITS_PER_SLOT;
+    if (bit_in_slot == 0) {
+      continue;  // start bit
+    } else if (bit_in_slot <= 8) {
+      line |= (driver.data[bit / BITS_PER_SLOT] >> (bit_in_slot - 1)) & 1;
+    } else {
+      line = true;  // stop bits
+    }
+  }
+  return driven ? line : true;
+}
@@ -0,0 +1,185 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RS485Bus.h
+ * A multi-drop RS485 bus with behavioural RDM responders.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef TESTS_SIM_RS485BUS_H_
+#define TESTS_SIM_RS485BUS_H_
+
+#include <stdint.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "SignalGenerator.h"
+#include "Simulator.h"
+#include "ola/Callback.h"
+
+/*
+ * @brief A multi-drop RS485 line, shared by the controller under test and any
+ * number of behavioural RDM responders.
+ *
+ * The controller's transmitted bytes are passed to ControllerByte(), usually
+ * from the PeripheralUART TX callback. Once a complete RDM request has been
+ * seen, each responder it's addressed to replies after its response delay,
+ * plus a random amount of jitter. The reply is played back to the controller
+ * with the SignalGenerator.
+ *
+ * The responders understand DISC_UNIQUE_BRANCH, DISC_MUTE & DISC_UN_MUTE. Any
+ * other GET / SET is ACKed with no parameter data.
+ *
+ * DUB responses are combined at the bit level. Each responder drives its own
+ * 8N2 bit stream and the line is the wired-OR of the active drivers. The
+ * combined line is then decoded the way a UART would, sampling each bit in
+ * the middle, so overlapping responses produce corrupt bytes and framing
+ * errors rather than a clean frame.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  RS485Bus bus(&simulator, &generator, kClockSpeed, kBaudRate);
+ *  bus.AddResponder(0x7a7000000001, 176, 20);
+ *  bus.AddResponder(0x7a7000000002, 300, 0);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class RS485Bus {
+ public:
+  /*
+   * @brief The line timings for a request and the responses to it.
+   *
+   * Times are in simulator clock cycles since the bus was created. The
+   * response times are 0 if no responder replied.
+   */
+  struct Transaction {
+   public:
+    Transaction()
+      : request_start(0),
+        request_end(0),
+        response_start(0),
+        response_end(0),
+        command_class(0),
+        param_id(0),
+        responders(0) {}
+
+    uint64_t request_start;  // The start of the first slot.
+    uint64_t request_end;  // The end of the last slot.
+    uint64_t response_start;  // The first falling edge of the response.
+    uint64_t response_end;  // The end of the last stop bit.
+    uint8_t command_class;
+    uint16_t param_id;
+    unsigned int responders;  // The number of responders which replied.
+
+    bool Collision() const { return responders > 1; }
+  };
+
+  // Ownership of the arguments is not transferred.
+  RS485Bus(Simulator *simulator,
+           SignalGenerator *generator,
+           uint32_t clock_speed,
+           uint32_t baud_rate);
+  ~RS485Bus();
+
+  void Tick();
+
+  /*
+   * @brief Attach a responder to the bus.
+   * @param uid The responder's UID.
+   * @param delay The minimum time in microseconds between the end of the
+   *   request and the start of the response.
+   * @param jitter The maximum random time in microseconds added to the delay.
+   */
+  void AddResponder(uint64_t uid, uint32_t delay, uint32_t jitter);
+
+  /*
+   * @brief Seed the jitter generator, so runs can be reproduced.
+   */
+  void SetSeed(uint32_t seed);
+
+  /*
+   * @brief Called for each byte the controller transmits.
+   */
+  void ControllerByte(uint8_t byte);
+
+  /*
+   * @brief Check if a responder is muted.
+   */
+  bool IsMuted(uint64_t uid) const;
+
+  /*
+   * @brief The current bus time, in clock cycles.
+   */
+  uint64_t Now() const { return m_cycles; }
+
+  const std::vector<Transaction>& Transactions() const {
+    return m_transactions;
+  }
+
+  void ClearTransactions() { m_transactions.clear(); }
+
+ private:
+  struct Responder {
+   public:
+    Responder(uint64_t uid, uint32_t delay, uint32_t jitter)
+      : uid(uid), delay(delay), jitter(jitter), muted(false) {}
+
+    uint64_t uid;
+    uint32_t delay;
+    uint32_t jitter;
+    bool muted;
+  };
+
+  // A responder's contribution to the line.
+  struct Driver {
+   public:
+    Driver(uint64_t start, const std::vector<uint8_t> &data)
+      : start(start), data(data) {}
+
+    uint64_t start;  // Relative to the end of the request.
+    std::vector<uint8_t> data;
+  };
+
+  Simulator *m_simulator;
+  SignalGenerator *m_generator;
+  std::unique_ptr<ola::Callback0<void>> m_callback;
+  const uint32_t m_cycles_per_usecond;
+  const uint32_t m_cycles_per_bit;
+  uint64_t m_cycles;
+
+  std::vector<Responder> m_responders;
+  std::mt19937 m_random;
+
+  std::vector<uint8_t> m_request;
+  uint64_t m_request_start;
+  uint64_t m_last_byte;
+
+  std::vector<Transaction> m_transactions;
+
+  void HandleRequest();
+  void HandleDUB(const uint8_t *param_data, Transaction *transaction);
+  void SendResponse(const Responder &responder, uint8_t command_class,
+                    const std::vector<uint8_t> &param_data,
+                    Transaction *transaction);
+  void PlayDUBResponses(const std::vector<Driver> &drivers,
+                        Transaction *transaction);
+  uint32_t ResponseDelay(const Responder &responder);
+  bool LineState(const std::vector<Driver> &drivers, uint64_t t) const;
+
+  static const unsigned int BITS_PER_SLOT = 11;
+  static const uint32_t BREAK_TIME = 176;
+  static const uint32_t MARK_TIME = 12;
+};
+
+#endif  // TESTS_SIM_RS485BUS_H_
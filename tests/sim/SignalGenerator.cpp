@@ -22,6 +22,7 @@
 
 #include <stdint.h>
 #include <queue>
+#include <string>
 
 #include "PeripheralInputCapture.h"
 #include "PeripheralUART.h"
@@ -46,8 +47,11 @@ SignalGenerator::SignalGenerator(Simulator *simulator,
       m_framing_error_at(0),
       m_line_state(HIGH),
       m_tx_byte(0),
+      m_tx_stop_bits(true),
       m_state(IDLE),
-      m_callback(ola::NewCallback(this, &SignalGenerator::Tick)) {
+      m_callback(ola::NewCallback(this, &SignalGenerator::Tick)),
+      m_tracer(nullptr),
+      m_line_signal(0) {
   m_simulator->AddTask(m_callback.get());
 }
 
@@ -55,6 +59,11 @@ SignalGenerator::~SignalGenerator() {
   m_simulator->RemoveTask(m_callback.get());
 }
 
+void SignalGenerator::TraceLine(Tracer *tracer, const std::string &name) {
+  m_tracer = tracer;
+  m_line_signal = tracer->AddSignal(name, 1, m_line_state == HIGH);
+}
+
 void SignalGenerator::Tick() {
   uint64_t clock = m_simulator->Clock();
   if (m_framing_error_at && clock == m_framing_error_at) {
@@ -105,7 +114,11 @@ void SignalGenerator::Reset() {
   m_next_event_at = 0;
   m_framing_error_at = 0;
   m_line_state = HIGH;
+  if (m_tracer) {
+    m_tracer->SetSignal(m_line_signal, true);
+  }
   m_tx_byte = 0;
+  m_tx_stop_bits = true;
   m_state = IDLE;
 }
 
@@ -172,6 +185,7 @@ void SignalGenerator::ProcessNextEvent() {
     case EVENT_BYTE:
     case EVENT_FRAMING_ERROR:
       m_tx_byte = event.byte;
+      m_tx_stop_bits = event.type == EVENT_BYTE;
       SetLineState(LOW);
       m_state = START_BIT;
       if (event.type == EVENT_FRAMING_ERROR) {
@@ -192,6 +206,9 @@ void SignalGenerator::SetLineState(LineState new_state) {
     return;
   }
   m_line_state = new_state;
+  if (m_tracer) {
+    m_tracer->SetSignal(m_line_signal, new_state == HIGH);
+  }
   m_input_capture->TriggerEvent(
       m_ic_index,
       new_state == LOW ? IC_EDGE_FALLING : IC_EDGE_RISING);
@@ -219,7 +236,8 @@ bool SignalGenerator::GetNextBit() const {
       return m_tx_byte & 0x80;
     case BIT_7:
     case STOP_BIT_1:
-      return true;  // stop bit
+      // stop bit, the line is held low for a framing error.
+      return m_tx_stop_bits;
     default:
       ADD_FAILURE() << "Invalid bit";
       return false;
@@ -23,10 +23,12 @@
 
 #include <stdint.h>
 #include <queue>
+#include <string>
 
 #include "PeripheralInputCapture.h"
 #include "PeripheralUART.h"
 #include "Simulator.h"
+#include "Tracer.h"
 
 /*
  * @brief The signal generator generates the IC & UART events to simulate an
@@ -63,6 +65,13 @@ class SignalGenerator {
 
   void Tick();
 
+  /*
+   * @brief Record the level of the generated line.
+   * @param tracer The tracer to add the line to, ownership is not transferred.
+   * @param name The name of the signal.
+   */
+  void TraceLine(Tracer *tracer, const std::string &name);
+
   /*
    * @brief Reset the generator.
    */
@@ -75,6 +84,11 @@ class SignalGenerator {
    */
   void SetStopOnComplete(bool stop_on_complete);
 
+  /*
+   * @brief The number of events which haven't started yet.
+   */
+  unsigned int PendingEvents() const { return m_events.size(); }
+
   /*
    * @brief Queue a delay (noop)
    */
@@ -103,8 +117,9 @@ class SignalGenerator {
   /*
    * @brief Queue a framing error.
    *
-   * For a framing error we send the data bits of the byte and then skip the
-   * stop bits.
+   * For a framing error we send the data bits of the byte and then hold the
+   * line low where the stop bits would be. The line stays low until the next
+   * event.
    */
   void AddFramingError(uint8_t byte);
 
@@ -165,9 +180,12 @@ class SignalGenerator {
   uint64_t m_framing_error_at;
   LineState m_line_state;
   uint8_t m_tx_byte;
+  bool m_tx_stop_bits;
   State m_state;
   std::unique_ptr<ola::Callback0<void>> m_callback;
   std::queue<Event> m_events;
+  Tracer *m_tracer;
+  Tracer::SignalId m_line_signal;
 
   void ProcessNextEvent();
   void AddDurationToClock(uint32_t duration);
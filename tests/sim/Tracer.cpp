@@ -0,0 +1,220 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Tracer.cpp
+ * Record waveforms & spans from the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+
+#include "Tracer.h"
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// VCD times are written in picoseconds, so any clock which is a whole number
+// of MHz can be represented exactly.
+const uint64_t PICOSECONDS_PER_USECOND = 1000000;
+
+// The first & last printable characters for VCD identifiers.
+const char FIRST_IDENTIFIER_CHAR = '!';
+const char LAST_IDENTIFIER_CHAR = '~';
+
+}  // namespace
+
+Tracer::Tracer(Simulator *simulator, uint32_t clock_speed)
+    : m_simulator(simulator),
+      m_callback(ola::NewCallback(this, &Tracer::Tick)),
+      m_cycles_per_usecond(clock_speed / 1000000),
+      m_cycles(0) {
+  m_simulator->AddTask(m_callback.get());
+}
+
+Tracer::~Tracer() {
+  m_simulator->RemoveTask(m_callback.get());
+}
+
+void Tracer::Tick() {
+  m_cycles++;
+}
+
+Tracer::SignalId Tracer::AddSignal(const std::string &name,
+                                   unsigned int width,
+                                   uint32_t initial_value) {
+  if (width == 0 || width > 32) {
+    ADD_FAILURE() << "Invalid width " << width << " for " << name;
+    width = 1;
+  }
+  m_signals.push_back(Signal(name, width, initial_value));
+  return m_signals.size() - 1;
+}
+
+void Tracer::SetSignal(SignalId signal_id, uint32_t value) {
+  if (signal_id >= m_signals.size()) {
+    FAIL() << "Invalid signal " << signal_id;
+  }
+
+  Signal &signal = m_signals[signal_id];
+  if (signal.value == value) {
+    return;
+  }
+  signal.value = value;
+  m_changes.push_back(Change(m_cycles, signal_id, value));
+}
+
+void Tracer::AddSpan(const std::string &track, const std::string &name,
+                     uint64_t duration) {
+  const auto iter = m_tracks.insert(
+      std::make_pair(track, m_tracks.size() + 1)).first;
+  const unsigned int track_id = iter->second;
+
+  // Time doesn't advance while the firmware runs, so a busy loop produces a
+  // span every cycle. Merge these rather than writing millions of events.
+  for (auto span = m_spans.rbegin(); span != m_spans.rend(); ++span) {
+    if (span->track != track_id) {
+      continue;
+    }
+    const uint64_t span_end = span->start + span->duration;
+    if (span->name == name && m_cycles <= span_end + 1) {
+      span->duration = std::max(span_end, m_cycles + duration) - span->start;
+      return;
+    }
+    break;
+  }
+  m_spans.push_back(Span(track_id, name, m_cycles, duration));
+}
+
+void Tracer::WriteVCD(std::ostream *output) const {
+  *output << "$version ja-rule simulator $end\n"
+          << "$timescale 1ps $end\n"
+          << "$scope module sim $end\n";
+  for (SignalId id = 0; id < m_signals.size(); id++) {
+    const Signal &signal = m_signals[id];
+    *output << "$var wire " << signal.width << " " << VCDIdentifier(id) << " "
+            << signal.name << " $end\n";
+  }
+  *output << "$upscope $end\n"
+          << "$enddefinitions $end\n"
+          << "#0\n"
+          << "$dumpvars\n";
+  for (SignalId id = 0; id < m_signals.size(); id++) {
+    WriteVCDValue(m_signals[id], m_signals[id].initial_value,
+                  VCDIdentifier(id), output);
+  }
+  *output << "$end\n";
+
+  bool first = true;
+  uint64_t last_time = 0;
+  for (const auto &change : m_changes) {
+    if (first || change.time != last_time) {
+      *output << "#"
+              << change.time * PICOSECONDS_PER_USECOND / m_cycles_per_usecond
+              << "\n";
+      last_time = change.time;
+      first = false;
+    }
+    WriteVCDValue(m_signals[change.signal], change.value,
+                  VCDIdentifier(change.signal), output);
+  }
+}
+
+void Tracer::WriteChromeTrace(std::ostream *output) const {
+  *output << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n"
+          << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+          << "\"args\": {\"name\": \"ja-rule simulator\"}}";
+
+  for (const auto &iter : m_tracks) {
+    *output << ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+            << "\"tid\": " << iter.second << ", \"args\": {\"name\": "
+            << JSONString(iter.first) << "}}";
+  }
+
+  for (const auto &span : m_spans) {
+    *output << ",\n  {\"name\": " << JSONString(span.name)
+            << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << span.track
+            << ", \"ts\": " << Microseconds(span.start)
+            << ", \"dur\": " << Microseconds(span.duration) << "}";
+  }
+
+  // Signals are written as counters, starting with the initial values.
+  for (const auto &signal : m_signals) {
+    *output << ",\n  {\"name\": " << JSONString(signal.name)
+            << ", \"ph\": \"C\", \"pid\": 1, \"ts\": 0, \"args\": {"
+            << "\"value\": " << signal.initial_value << "}}";
+  }
+  for (const auto &change : m_changes) {
+    *output << ",\n  {\"name\": "
+            << JSONString(m_signals[change.signal].name)
+            << ", \"ph\": \"C\", \"pid\": 1, \"ts\": "
+            << Microseconds(change.time) << ", \"args\": {"
+            << "\"value\": " << change.value << "}}";
+  }
+  *output << "\n]}\n";
+}
+
+std::string Tracer::Microseconds(uint64_t cycles) const {
+  // Chrome trace times are in microseconds, keep nanosecond precision.
+  const uint64_t nanoseconds = cycles * 1000 / m_cycles_per_usecond;
+  std::ostringstream str;
+  str << nanoseconds / 1000 << "." << std::setfill('0') << std::setw(3)
+      << nanoseconds % 1000;
+  return str.str();
+}
+
+void Tracer::WriteVCDValue(const Signal &signal, uint32_t value,
+                           const std::string &identifier,
+                           std::ostream *output) const {
+  if (signal.width == 1) {
+    *output << (value ? "1" : "0") << identifier << "\n";
+    return;
+  }
+
+  *output << "b";
+  for (int bit = signal.width - 1; bit >= 0; bit--) {
+    *output << ((value >> bit) & 1);
+  }
+  *output << " " << identifier << "\n";
+}
+
+std::string Tracer::VCDIdentifier(SignalId signal) {
+  const unsigned int base = LAST_IDENTIFIER_CHAR - FIRST_IDENTIFIER_CHAR + 1;
+  std::string identifier;
+  do {
+    identifier.push_back(FIRST_IDENTIFIER_CHAR + signal % base);
+    signal /= base;
+  } while (signal);
+  return identifier;
+}
+
+std::string Tracer::JSONString(const std::string &input) {
+  std::string output = "\"";
+  for (const auto &c : input) {
+    if (c == '"' || c == '\\') {
+      output.push_back('\\');
+    }
+    output.push_back(c);
+  }
+  output.push_back('"');
+  return output;
+}
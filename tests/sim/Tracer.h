@@ -0,0 +1,166 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Tracer.h
+ * Record waveforms & spans from the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+
+#ifndef TESTS_SIM_TRACER_H_
+#define TESTS_SIM_TRACER_H_
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Simulator.h"
+#include "ola/Callback.h"
+
+/*
+ * @brief Record signals and spans from a simulation, so they can be viewed
+ * with external tools.
+ *
+ * Signals are values which change over time, e.g. the level of the TX line or
+ * the transceiver state. They are written as a Value Change Dump (VCD), which
+ * can be opened with GTKWave or similar.
+ *
+ * Spans are periods of activity on a named track, e.g. the run of an ISR.
+ * They are written in the Chrome trace event JSON format, which can be opened
+ * with Perfetto (ui.perfetto.dev) or chrome://tracing. The signals are
+ * included in the JSON as counters.
+ *
+ * Times are recorded in clock cycles since the tracer was created, so
+ * multiple calls to Simulator::Run() produce a single timeline. The simulator
+ * doesn't order its tasks, so times may be a cycle out.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  Tracer tracer(&simulator, kClockSpeed);
+ *  uart.TraceTX(AS_USART_ID(1), &tracer, "tx");
+ *  ...
+ *  std::ofstream vcd("trace.vcd");
+ *  tracer.WriteVCD(&vcd);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class Tracer {
+ public:
+  typedef unsigned int SignalId;
+
+  // Ownership of the simulator is not transferred.
+  Tracer(Simulator *simulator, uint32_t clock_speed);
+  ~Tracer();
+
+  void Tick();
+
+  /*
+   * @brief Add a signal.
+   * @param name The name of the signal.
+   * @param width The width in bits, signals wider than 1 bit are shown as a
+   *   bus.
+   * @param initial_value The value of the signal at time 0.
+   * @returns The id to pass to SetSignal().
+   */
+  SignalId AddSignal(const std::string &name, unsigned int width,
+                     uint32_t initial_value);
+
+  /*
+   * @brief Set the value of a signal, unchanged values are ignored.
+   */
+  void SetSignal(SignalId signal, uint32_t value);
+
+  /*
+   * @brief Record a span which starts now.
+   * @param track The track to display the span on.
+   * @param name The name of the span.
+   * @param duration The length of the span, in clock cycles.
+   *
+   * If the span overlaps, or immediately follows, the last span on the track
+   * and has the same name, the last span is extended instead.
+   */
+  void AddSpan(const std::string &track, const std::string &name,
+               uint64_t duration);
+
+  /*
+   * @brief The current trace time, in clock cycles.
+   */
+  uint64_t Now() const { return m_cycles; }
+
+  /*
+   * @brief Write the signals as a Value Change Dump.
+   */
+  void WriteVCD(std::ostream *output) const;
+
+  /*
+   * @brief Write the spans & signals in the Chrome trace event format.
+   */
+  void WriteChromeTrace(std::ostream *output) const;
+
+ private:
+  struct Signal {
+   public:
+    Signal(const std::string &name, unsigned int width, uint32_t value)
+      : name(name), width(width), initial_value(value), value(value) {}
+
+    std::string name;
+    unsigned int width;
+    uint32_t initial_value;
+    uint32_t value;
+  };
+
+  struct Change {
+   public:
+    Change(uint64_t time, SignalId signal, uint32_t value)
+      : time(time), signal(signal), value(value) {}
+
+    uint64_t time;
+    SignalId signal;
+    uint32_t value;
+  };
+
+  struct Span {
+   public:
+    Span(unsigned int track, const std::string &name, uint64_t start,
+         uint64_t duration)
+      : track(track), name(name), start(start), duration(duration) {}
+
+    unsigned int track;
+    std::string name;
+    uint64_t start;
+    uint64_t duration;
+  };
+
+  Simulator *m_simulator;
+  std::unique_ptr<ola::Callback0<void>> m_callback;
+  const uint32_t m_cycles_per_usecond;
+  uint64_t m_cycles;
+
+  std::vector<Signal> m_signals;
+  std::vector<Change> m_changes;
+  std::map<std::string, unsigned int> m_tracks;
+  std::vector<Span> m_spans;
+
+  std::string Microseconds(uint64_t cycles) const;
+  void WriteVCDValue(const Signal &signal, uint32_t value,
+                     const std::string &identifier,
+                     std::ostream *output) const;
+
+  static std::string VCDIdentifier(SignalId signal);
+  static std::string JSONString(const std::string &input);
+};
+
+#endif  // TESTS_SIM_TRACER_H_
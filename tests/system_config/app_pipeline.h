@@ -1,10 +1,25 @@
 /*
- * This is the system_pipeline.h used for the tests. All macros are undefined,
+ * This is the system_pipeline.h used for the tests. Most macros are undefined,
  * which means we use the function pointers passed to the initialization
  * functions as callbacks.
+ *
+ * The RDM response buffer macros are defined, since there is no callback
+ * equivalent. They use the transceiver mock, which doesn't lease a buffer
+ * unless a test asks it to.
  */
 
 #ifndef TESTS_SYSTEM_CONFIG_APP_PIPELINE_H_
 #define TESTS_SYSTEM_CONFIG_APP_PIPELINE_H_
 
+#include "transceiver.h"
+
+#define PIPELINE_RDMRESPONDER_ACQUIRE_BUFFER() \
+  Transceiver_AcquireRDMResponseBuffer()
+
+#define PIPELINE_RDMRESPONDER_COMMIT(include_break, size) \
+  Transceiver_CommitRDMResponse(include_break, size);
+
+#define PIPELINE_RDMRESPONDER_RELEASE_BUFFER() \
+  Transceiver_ReleaseRDMResponseBuffer();
+
 #endif  // TESTS_SYSTEM_CONFIG_APP_PIPELINE_H_
@@ -137,6 +137,16 @@
  */
 #define SPI_USE_ENHANCED_BUFFERING true
 
+/**
+ * @brief Transmit pixel data using DMA.
+ */
+#define SPI_USE_DMA true
+
+/**
+ * @brief The DMA channel to use if SPI_USE_DMA is true.
+ */
+#define SPI_DMA_CHANNEL DMA_CHANNEL_0
+
 /**
  * @}
  */
@@ -0,0 +1,259 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMXForwarderTest.cpp
+ * Tests for the DMX forwarder.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "Array.h"
+#include "Matchers.h"
+#include "TransportMock.h"
+#include "coarse_timer.h"
+#include "dmx_forwarder.h"
+#include "dmx_input.h"
+#include "sys_int_mock.h"
+
+using ::testing::Args;
+using ::testing::InSequence;
+using ::testing::Return;
+using ::testing::StrictMock;
+using ::testing::_;
+
+class DMXForwarderTest : public testing::Test {
+ public:
+  void SetUp() {
+    SYS_INT_SetMock(&m_sys_int_mock);
+    CoarseTimer_Settings timer_settings = {
+      .timer_id = TMR_ID_2,
+      .interrupt_source = INT_SOURCE_TIMER_2
+    };
+    CoarseTimer_Initialize(&timer_settings);
+    CoarseTimer_SetCounter(1000);
+
+    Transport_SetMock(&m_transport_mock);
+    DMXInput_Initialize();
+    DMXForwarder_Initialize(Transport_Send);
+  }
+
+  void TearDown() {
+    Transport_SetMock(nullptr);
+    SYS_INT_SetMock(nullptr);
+  }
+
+  void ReceiveFrame(const uint8_t *data, unsigned int length) {
+    DMXInput_BeginFrame();
+    DMXInput_AppendSlots(data, length);
+    DMXInput_EndFrame();
+  }
+
+ protected:
+  testing::NiceMock<MockSysInt> m_sys_int_mock;
+  StrictMock<MockTransport> m_transport_mock;
+
+  static const uint8_t kToken = 12;
+};
+
+TEST_F(DMXForwarderTest, off) {
+  const uint8_t frame[] = {1, 2, 3};
+  ReceiveFrame(frame, arraysize(frame));
+  DMXForwarder_Tasks();
+
+  EXPECT_FALSE(DMXForwarder_Configure(kToken, 3, 0));
+  DMXForwarder_Tasks();
+}
+
+TEST_F(DMXForwarderTest, fullFrames) {
+  EXPECT_TRUE(DMXForwarder_Configure(kToken, DMX_FORWARD_FULL_FRAMES, 0));
+
+  // Nothing received yet.
+  DMXForwarder_Tasks();
+
+  const uint8_t frame[] = {1, 2, 3};
+  const uint8_t payload1[] = {1, 1, 2, 3};
+  const uint8_t payload2[] = {2, 1, 2, 3};
+  {
+    InSequence seq;
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_FRAME, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload1, arraysize(payload1))))
+        .WillOnce(Return(true));
+    // The transport is busy, so the frame is retried.
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_FRAME, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload2, arraysize(payload2))))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+  }
+
+  ReceiveFrame(frame, arraysize(frame));
+  DMXForwarder_Tasks();
+  // No new frame.
+  DMXForwarder_Tasks();
+
+  // Unchanged frames are still sent in full frame mode.
+  ReceiveFrame(frame, arraysize(frame));
+  DMXForwarder_Tasks();
+  DMXForwarder_Tasks();
+  DMXForwarder_Tasks();
+}
+
+TEST_F(DMXForwarderTest, rateLimit) {
+  // At most one frame every 2ms.
+  EXPECT_TRUE(DMXForwarder_Configure(kToken, DMX_FORWARD_FULL_FRAMES, 20));
+
+  uint8_t frame[] = {0};
+  const uint8_t payload1[] = {1, 1};
+  const uint8_t payload3[] = {3, 3};
+  {
+    InSequence seq;
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_FRAME, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload1, arraysize(payload1))))
+        .WillOnce(Return(true));
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_FRAME, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload3, arraysize(payload3))))
+        .WillOnce(Return(true));
+  }
+
+  // The first frame is sent immediately.
+  frame[0] = 1;
+  ReceiveFrame(frame, arraysize(frame));
+  DMXForwarder_Tasks();
+
+  frame[0] = 2;
+  ReceiveFrame(frame, arraysize(frame));
+  CoarseTimer_SetCounter(1010);
+  DMXForwarder_Tasks();
+
+  // Frame 2 is dropped, frame 3 is sent once the interval has passed.
+  frame[0] = 3;
+  ReceiveFrame(frame, arraysize(frame));
+  CoarseTimer_SetCounter(1019);
+  DMXForwarder_Tasks();
+  CoarseTimer_SetCounter(1021);
+  DMXForwarder_Tasks();
+  DMXForwarder_Tasks();
+}
+
+TEST_F(DMXForwarderTest, changes) {
+  EXPECT_TRUE(DMXForwarder_Configure(kToken, DMX_FORWARD_CHANGES, 0));
+
+  uint8_t frame[] = {1, 2, 3, 0, 0, 0, 0, 0, 9};
+  // Slots 0 - 2 and slot 8, the 0s match the initial state.
+  const uint8_t payload1[] = {
+    1, 9, 0,
+    0, 0, 3, 0, 1, 2, 3,
+    8, 0, 1, 0, 9
+  };
+  const uint8_t payload3[] = {
+    3, 9, 0,
+    2, 0, 4, 0, 4, 0, 0, 5
+  };
+  // The frame shrinks, so there are no ranges.
+  const uint8_t payload4[] = {4, 4, 0};
+  // And grows again, the non-0 slots that were dropped are sent.
+  const uint8_t payload5[] = {
+    5, 9, 0,
+    5, 0, 4, 0, 5, 0, 0, 9
+  };
+  {
+    InSequence seq;
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_CHANGES, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload1, arraysize(payload1))))
+        .WillOnce(Return(true));
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_CHANGES, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload3, arraysize(payload3))))
+        .WillOnce(Return(true));
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_CHANGES, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload4, arraysize(payload4))))
+        .WillOnce(Return(true));
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_CHANGES, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload5, arraysize(payload5))))
+        .WillOnce(Return(true));
+  }
+
+  ReceiveFrame(frame, arraysize(frame));
+  DMXForwarder_Tasks();
+
+  // An identical frame isn't sent.
+  ReceiveFrame(frame, arraysize(frame));
+  DMXForwarder_Tasks();
+
+  // Changes spanning a word boundary are sent as a single range.
+  frame[2] = 4;
+  frame[5] = 5;
+  ReceiveFrame(frame, arraysize(frame));
+  DMXForwarder_Tasks();
+
+  frame[4] = 0;
+  ReceiveFrame(frame, 4);
+  DMXForwarder_Tasks();
+
+  ReceiveFrame(frame, arraysize(frame));
+  DMXForwarder_Tasks();
+  DMXForwarder_Tasks();
+}
+
+TEST_F(DMXForwarderTest, changesSplitAcrossMessages) {
+  // The remaining changes are sent without waiting for the interval.
+  EXPECT_TRUE(DMXForwarder_Configure(kToken, DMX_FORWARD_CHANGES, 100));
+
+  // The first message fits 506 slots.
+  uint8_t payload1[PAYLOAD_SIZE];
+  payload1[0] = 1;
+  payload1[1] = 0;
+  payload1[2] = 2;
+  payload1[3] = 0;
+  payload1[4] = 0;
+  payload1[5] = 506 & 0xff;
+  payload1[6] = 506 >> 8;
+  memset(payload1 + 7, 0xff, PAYLOAD_SIZE - 7);
+
+  const uint8_t payload2[] = {
+    1, 0, 2,
+    506 & 0xff, 506 >> 8, 6, 0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+  };
+  {
+    InSequence seq;
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_CHANGES, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload1, arraysize(payload1))))
+        .WillOnce(Return(true));
+    EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RX_DMX_CHANGES, RC_OK,
+                                       _, _))
+        .With(Args<3, 4>(PayloadIs(payload2, arraysize(payload2))))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+  }
+
+  uint8_t frame[DMX_FRAME_SIZE];
+  memset(frame, 0xff, sizeof(frame));
+  ReceiveFrame(frame, arraysize(frame));
+  DMXForwarder_Tasks();
+  DMXForwarder_Tasks();
+  DMXForwarder_Tasks();
+
+  // Everything has been sent.
+  DMXForwarder_Tasks();
+}
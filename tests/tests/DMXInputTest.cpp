@@ -0,0 +1,151 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMXInputTest.cpp
+ * Tests for the DMX input store.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "dmx_input.h"
+
+class DMXInputTest : public testing::Test {
+ public:
+  void SetUp() {
+    DMXInput_Initialize();
+  }
+
+  void SendFrame(const uint8_t *data, unsigned int length) {
+    DMXInput_BeginFrame();
+    DMXInput_AppendSlots(data, length);
+    DMXInput_EndFrame();
+  }
+};
+
+TEST_F(DMXInputTest, noFrame) {
+  const DMXInputFrame *frame = DMXInput_GetFrame();
+  ASSERT_NE(nullptr, frame);
+  EXPECT_EQ(0u, frame->sequence);
+  EXPECT_EQ(0u, frame->slot_count);
+  EXPECT_EQ(0u, DMXInput_LatestSequence());
+
+  // Slots outside a frame are ignored.
+  const uint8_t data[] = {1, 2, 3};
+  DMXInput_AppendSlots(data, sizeof(data));
+  DMXInput_EndFrame();
+  EXPECT_EQ(0u, DMXInput_GetFrame()->sequence);
+}
+
+TEST_F(DMXInputTest, publish) {
+  const uint8_t data[] = {10, 20, 30, 40};
+  DMXInput_BeginFrame();
+  DMXInput_AppendSlots(data, 2);
+  DMXInput_AppendSlots(data + 2, 2);
+
+  // Nothing is visible until the frame ends.
+  EXPECT_EQ(0u, DMXInput_GetFrame()->sequence);
+  DMXInput_EndFrame();
+  EXPECT_EQ(1u, DMXInput_LatestSequence());
+
+  const DMXInputFrame *frame = DMXInput_GetFrame();
+  EXPECT_EQ(1u, frame->sequence);
+  EXPECT_EQ(sizeof(data), frame->slot_count);
+  EXPECT_EQ(0, memcmp(data, frame->slots, sizeof(data)));
+
+  // Ending the frame again doesn't publish another frame.
+  DMXInput_EndFrame();
+  EXPECT_EQ(1u, DMXInput_LatestSequence());
+
+  // With no new frame, the same frame is returned.
+  EXPECT_EQ(frame, DMXInput_GetFrame());
+  EXPECT_EQ(1u, frame->sequence);
+}
+
+TEST_F(DMXInputTest, readerIsStable) {
+  const uint8_t first[] = {1, 1, 1};
+  SendFrame(first, sizeof(first));
+  const DMXInputFrame *frame = DMXInput_GetFrame();
+
+  // The producer can publish any number of frames while the reader holds the
+  // first one.
+  uint8_t data[] = {0, 0, 0};
+  for (unsigned int i = 2; i < 10; i++) {
+    memset(data, i, sizeof(data));
+    SendFrame(data, sizeof(data));
+    EXPECT_EQ(1u, frame->sequence);
+    EXPECT_EQ(0, memcmp(first, frame->slots, sizeof(first)));
+  }
+
+  // A partial frame doesn't disturb the reader either.
+  DMXInput_BeginFrame();
+  DMXInput_AppendSlots(first, 1);
+  EXPECT_EQ(1u, frame->sequence);
+
+  // The reader skips straight to the newest complete frame.
+  frame = DMXInput_GetFrame();
+  EXPECT_EQ(9u, frame->sequence);
+  EXPECT_EQ(9u, DMXInput_LatestSequence());
+  EXPECT_EQ(sizeof(data), frame->slot_count);
+  EXPECT_EQ(0, memcmp(data, frame->slots, sizeof(data)));
+}
+
+TEST_F(DMXInputTest, interleaved) {
+  uint8_t data[] = {0, 0};
+  for (unsigned int i = 1; i < 20; i++) {
+    memset(data, i, sizeof(data));
+    SendFrame(data, sizeof(data));
+    const DMXInputFrame *frame = DMXInput_GetFrame();
+    EXPECT_EQ(i, frame->sequence);
+    EXPECT_EQ(i, frame->slots[1]);
+  }
+}
+
+TEST_F(DMXInputTest, oversizedFrame) {
+  uint8_t data[DMX_FRAME_SIZE + 10];
+  memset(data, 0x55, sizeof(data));
+
+  DMXInput_BeginFrame();
+  DMXInput_AppendSlots(data, 500);
+  DMXInput_AppendSlots(data, 20);
+  DMXInput_AppendSlots(data, 1);
+  DMXInput_EndFrame();
+  EXPECT_EQ(DMX_FRAME_SIZE, DMXInput_GetFrame()->slot_count);
+
+  SendFrame(data, sizeof(data));
+  EXPECT_EQ(DMX_FRAME_SIZE, DMXInput_GetFrame()->slot_count);
+
+  // An empty frame.
+  SendFrame(data, 0);
+  EXPECT_EQ(3u, DMXInput_GetFrame()->sequence);
+  EXPECT_EQ(0u, DMXInput_GetFrame()->slot_count);
+}
+
+TEST_F(DMXInputTest, restartFrame) {
+  const uint8_t data[] = {1, 2, 3, 4};
+  DMXInput_BeginFrame();
+  DMXInput_AppendSlots(data, sizeof(data));
+  // A new frame starts before the first one ends.
+  DMXInput_BeginFrame();
+  DMXInput_AppendSlots(data + 2, 2);
+  DMXInput_EndFrame();
+
+  const DMXInputFrame *frame = DMXInput_GetFrame();
+  EXPECT_EQ(1u, frame->sequence);
+  EXPECT_EQ(2u, frame->slot_count);
+  EXPECT_EQ(3u, frame->slots[0]);
+  EXPECT_EQ(4u, frame->slots[1]);
+}
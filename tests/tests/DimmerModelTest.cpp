@@ -32,6 +32,7 @@
 #include "rdm.h"
 #include "rdm_buffer.h"
 #include "rdm_responder.h"
+#include "timer_wheel.h"
 #include "Array.h"
 #include "CoarseTimerMock.h"
 #include "Matchers.h"
@@ -47,14 +48,17 @@ using ola::rdm::RDMResponse;
 using ola::rdm::RDMSetRequest;
 using std::unique_ptr;
 using testing::Return;
+using testing::ReturnPointee;
 using testing::_;
 
 class DimmerModelTest : public ModelTest {
  public:
-  DimmerModelTest() : ModelTest(&DIMMER_MODEL_ENTRY) {}
+  DimmerModelTest() : ModelTest(&DIMMER_MODEL_ENTRY), m_now(0) {}
 
   void SetUp() {
     CoarseTimer_SetMock(&m_timer);
+    ON_CALL(m_timer, GetTime()).WillByDefault(ReturnPointee(&m_now));
+    TimerWheel_Initialize();
 
     RDMResponderSettings settings;
     memcpy(settings.uid, TEST_UID, UID_LENGTH);
@@ -64,11 +68,18 @@ class DimmerModelTest : public ModelTest {
   }
 
   void TearDown() {
+    DIMMER_MODEL_ENTRY.deactivate_fn();
     CoarseTimer_SetMock(nullptr);
   }
 
+  void AdvanceTime(uint32_t ticks) {
+    m_now += ticks;
+    TimerWheel_Tasks();
+  }
+
  protected:
   ::testing::NiceMock<MockCoarseTimer> m_timer;
+  CoarseTimer_Value m_now;
 };
 
 TEST_F(DimmerModelTest, testLifecycle) {
@@ -207,11 +218,11 @@ TEST_F(DimmerModelTest, selfTest) {
   size = InvokeRDMHandler(get_request.get());
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 
-  // Run Tasks
-  testing::InSequence seq;
-  EXPECT_CALL(m_timer, HasElapsed(_, 50000)).WillOnce(Return(true));
-  EXPECT_CALL(m_timer, HasElapsed(_, _)).WillRepeatedly(Return(false));
-  DIMMER_MODEL_ENTRY.tasks_fn();
+  // The first self test takes 5s.
+  AdvanceTime(50000);
+  size = InvokeRDMHandler(get_request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  AdvanceTime(1);
 
   // Confirm self test is complete
   selftest = 0;
@@ -292,6 +303,126 @@ TEST_F(DimmerModelTest, presetPlayback) {
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 }
 
+TEST_F(DimmerModelTest, presetFade) {
+  // Capture the DMX levels in scene 2, with a 1s up fade & a 0.5s down fade.
+  uint8_t dmx[] = {255, 128, 0, 10};
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  const uint8_t capture_data[] = {0, 2, 0, 10, 0, 5, 0, 20};
+  unique_ptr<RDMRequest> request = BuildSetRequest(
+      PID_CAPTURE_PRESET, capture_data, arraysize(capture_data));
+  unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  memset(dmx, 0, arraysize(dmx));
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(1));
+
+  // Play scene 2
+  const uint8_t playback_data[] = {0, 2, 0xff};
+  request = BuildSetRequest(PID_PRESET_PLAYBACK, playback_data,
+                            arraysize(playback_data));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  // Half way
+  ON_CALL(m_timer, ElapsedTime(_)).WillByDefault(Return(5000));
+  AdvanceTime(5000);
+  EXPECT_EQ(32895, DimmerModel_GetOutputLevel(1));
+  EXPECT_EQ(16448, DimmerModel_GetOutputLevel(3));
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(4));
+  EXPECT_EQ(1285, DimmerModel_GetOutputLevel(5));
+
+  // Complete
+  ON_CALL(m_timer, ElapsedTime(_)).WillByDefault(Return(10000));
+  AdvanceTime(5000);
+  EXPECT_EQ(0xfffe, DimmerModel_GetOutputLevel(1));
+  EXPECT_EQ(32895, DimmerModel_GetOutputLevel(3));
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(4));
+  EXPECT_EQ(2570, DimmerModel_GetOutputLevel(5));
+
+  // With the default merge mode, the preset overrides DMX.
+  dmx[1] = 200;
+  dmx[2] = 100;
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(32895, DimmerModel_GetOutputLevel(3));
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(4));
+
+  // HTP
+  uint8_t merge_mode = MERGE_MODE_HTP;
+  request = BuildSetRequest(PID_PRESET_MERGEMODE, &merge_mode,
+                            sizeof(merge_mode));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(0xfffe, DimmerModel_GetOutputLevel(1));
+  EXPECT_EQ(51399, DimmerModel_GetOutputLevel(3));
+  EXPECT_EQ(25700, DimmerModel_GetOutputLevel(4));
+  EXPECT_EQ(2570, DimmerModel_GetOutputLevel(5));
+
+  // LTP, only the sub-devices with DMX changes use the DMX level.
+  merge_mode = MERGE_MODE_LTP;
+  request = BuildSetRequest(PID_PRESET_MERGEMODE, &merge_mode,
+                            sizeof(merge_mode));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  dmx[0] = 10;
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(2570, DimmerModel_GetOutputLevel(1));
+  EXPECT_EQ(51399, DimmerModel_GetOutputLevel(3));
+  EXPECT_EQ(25700, DimmerModel_GetOutputLevel(4));
+  EXPECT_EQ(2570, DimmerModel_GetOutputLevel(5));
+
+  // Turning playback off returns to DMX.
+  const uint8_t off_data[] = {0, 0, 0};
+  request = BuildSetRequest(PID_PRESET_PLAYBACK, off_data,
+                            arraysize(off_data));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(2570, DimmerModel_GetOutputLevel(1));
+  EXPECT_EQ(51399, DimmerModel_GetOutputLevel(3));
+  EXPECT_EQ(25700, DimmerModel_GetOutputLevel(4));
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(5));
+}
+
+TEST_F(DimmerModelTest, presetPlaybackAllWithoutScenes) {
+  // Restore a set of presets where none are programmed, not even the
+  // factory scene.
+  ModelSettingsBlock block;
+  block.index = 2u;
+  block.length = 3u * 11u;
+  memset(block.data, 0, block.length);
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_SET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+
+  uint8_t dmx[] = {255, 128};
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(0xfffe, DimmerModel_GetOutputLevel(1));
+
+  // There is nothing to play.
+  const uint8_t set_data[] = {0xff, 0xff, 0xff};
+  unique_ptr<RDMRequest> request = BuildSetRequest(
+      PID_PRESET_PLAYBACK, set_data, arraysize(set_data));
+  unique_ptr<RDMResponse> response(NackWithReason(
+      request.get(), ola::rdm::NR_DATA_OUT_OF_RANGE));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  // Playback stays off & the output still follows DMX.
+  AdvanceTime(10000);
+  EXPECT_EQ(0xfffe, DimmerModel_GetOutputLevel(1));
+
+  request = BuildGetRequest(PID_PRESET_PLAYBACK);
+  const uint8_t expected_response[] = {0, 0, 0};
+  response.reset(GetResponseFromData(
+      request.get(), expected_response, arraysize(expected_response)));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+}
+
 TEST_F(DimmerModelTest, failMode) {
   unique_ptr<RDMRequest> request = BuildGetRequest(PID_DMX_FAIL_MODE);
 
@@ -499,6 +630,20 @@ TEST_F(DimmerModelTest, powerOnSelfTest) {
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 }
 
+TEST_F(DimmerModelTest, subDeviceOutOfRange) {
+  // Sub-device 2 is skipped and 6 is past the last sub-device.
+  const uint16_t sub_devices[] = {2, 6, 0xfffe};
+  for (unsigned int i = 0; i < arraysize(sub_devices); i++) {
+    unique_ptr<RDMRequest> request = BuildSubDeviceGetRequest(
+        PID_DIMMER_INFO, sub_devices[i]);
+    unique_ptr<RDMResponse> response(
+        NackWithReason(request.get(), ola::rdm::NR_SUB_DEVICE_OUT_OF_RANGE));
+
+    int size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  }
+}
+
 TEST_F(DimmerModelTest, clearStatusId) {
   unique_ptr<RDMRequest> request = BuildSubDeviceSetRequest(
       PID_CLEAR_STATUS_ID, 1);
@@ -571,6 +716,38 @@ TEST_F(DimmerModelTest, burnIn) {
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 }
 
+TEST_F(DimmerModelTest, setAllSubDevices) {
+  // Set the max level for all sub devices
+  const uint16_t max_level = HostToNetwork(static_cast<uint16_t>(0x1234));
+  unique_ptr<RDMRequest> request = BuildSubDeviceSetRequest(
+      PID_MAXIMUM_LEVEL, SUBDEVICE_ALL,
+      reinterpret_cast<const uint8_t*>(&max_level), sizeof(max_level));
+
+  unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  // Confirm each sub-device was updated.
+  const uint16_t sub_devices[] = {1, 3, 4, 5};
+  for (unsigned int i = 0; i < arraysize(sub_devices); i++) {
+    request = BuildSubDeviceGetRequest(PID_MAXIMUM_LEVEL, sub_devices[i]);
+    response.reset(GetResponseFromData(
+          request.get(), reinterpret_cast<const uint8_t*>(&max_level),
+          sizeof(max_level)));
+    size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  }
+
+  // Invalid data is rejected once, rather than per sub-device.
+  const uint8_t identify_mode = 0x7f;
+  request = BuildSubDeviceSetRequest(PID_IDENTIFY_MODE, SUBDEVICE_ALL,
+                                     &identify_mode, sizeof(identify_mode));
+  response.reset(NackWithReason(request.get(),
+                                ola::rdm::NR_DATA_OUT_OF_RANGE));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+}
+
 TEST_F(DimmerModelTest, dimmerInfo) {
   unique_ptr<RDMRequest> request = BuildSubDeviceGetRequest(PID_DIMMER_INFO, 1);
 
@@ -615,7 +792,7 @@ TEST_F(DimmerModelTest, maximumLevel) {
   unique_ptr<RDMRequest> request = BuildSubDeviceGetRequest(
       PID_MAXIMUM_LEVEL, 1);
 
-  const uint8_t expected_response[] = { 0, 0 };
+  const uint8_t expected_response[] = { 0xff, 0xfe };
   unique_ptr<RDMResponse> response(GetResponseFromData(
         request.get(),
         reinterpret_cast<const uint8_t*>(&expected_response),
@@ -661,6 +838,197 @@ TEST_F(DimmerModelTest, curve) {
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 }
 
+TEST_F(DimmerModelTest, outputLevels) {
+  uint8_t dmx[] = {255, 128, 0, 1};
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx,
+                                           arraysize(dmx)));
+  EXPECT_EQ(0xfffe, DimmerModel_GetOutputLevel(1));
+  EXPECT_EQ(32895, DimmerModel_GetOutputLevel(3));
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(4));
+  EXPECT_EQ(257, DimmerModel_GetOutputLevel(5));
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(2));
+
+  // Partial frames only update the sub-devices within the slots received.
+  dmx[0] = 0;
+  dmx[1] = 0;
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, 1);
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(1));
+  EXPECT_EQ(32895, DimmerModel_GetOutputLevel(3));
+
+  // Change the curve, the output is updated immediately.
+  const uint8_t curve = 3;
+  unique_ptr<RDMRequest> request = BuildSubDeviceSetRequest(
+      PID_CURVE, 1, &curve, sizeof(curve));
+  unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  dmx[0] = 128;
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, 1);
+  EXPECT_EQ(16513, DimmerModel_GetOutputLevel(1));
+
+  // Split minimum levels and a maximum level.
+  const uint8_t max_level[] = {0x80, 0x00};
+  request = BuildSubDeviceSetRequest(
+      PID_MAXIMUM_LEVEL, 5, max_level, sizeof(max_level));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  const uint8_t min_level[] = {0x10, 0x00, 0x08, 0x00, 1};
+  request = BuildSubDeviceSetRequest(
+      PID_MINIMUM_LEVEL, 5, min_level, sizeof(min_level));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  // The last change for sub-device 5 was increasing.
+  EXPECT_EQ(4208, DimmerModel_GetOutputLevel(5));
+
+  dmx[3] = 255;
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(0x8000, DimmerModel_GetOutputLevel(5));
+
+  dmx[3] = 1;
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(2168, DimmerModel_GetOutputLevel(5));
+
+  // On below min.
+  dmx[3] = 0;
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(0x0800, DimmerModel_GetOutputLevel(5));
+}
+
+TEST_F(DimmerModelTest, settings) {
+  ModelSettingsBlock block;
+  block.index = 1u;
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_GET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+  const uint8_t sub_devices[] = {
+    0, 1, 1,
+    0, 2, 1,
+    0, 3, 1,
+    0, 4, 1
+  };
+  EXPECT_THAT(ArrayTuple(block.data, block.length),
+              DataIs(sub_devices, arraysize(sub_devices)));
+
+  // Move sub-device 1 and change its curve.
+  block.data[1] = 10;
+  block.data[2] = 3;
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_SET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+
+  uint8_t dmx[10] = {};
+  dmx[9] = 128;
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(16513, DimmerModel_GetOutputLevel(1));
+
+  // An odd curve isn't valid for sub-device 4.
+  block.data[8] = 3;
+  EXPECT_EQ(0, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_SET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+  block.data[8] = 1;
+  block.data[5] = 5;
+  EXPECT_EQ(0, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_SET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+  block.data[5] = 1;
+  block.length--;
+  EXPECT_EQ(0, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_SET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+
+  // Presets
+  block.index = 2u;
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_GET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+  const uint8_t presets[] = {
+    0, 0, 0, 0, 0, 0, PRESET_PROGRAMMED_READ_ONLY, 255, 255, 255, 255,
+    0, 0, 0, 0, 0, 0, PRESET_NOT_PROGRAMMED, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, PRESET_NOT_PROGRAMMED, 0, 0, 0, 0
+  };
+  EXPECT_THAT(ArrayTuple(block.data, block.length),
+              DataIs(presets, arraysize(presets)));
+
+  const uint8_t new_scene[] = {
+    0, 10, 0, 20, 0, 30, PRESET_PROGRAMMED, 1, 2, 3, 4
+  };
+  memcpy(block.data + arraysize(new_scene), new_scene, arraysize(new_scene));
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_SET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+
+  ModelSettingsBlock result;
+  result.index = 2u;
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_GET_SETTINGS, reinterpret_cast<uint8_t*>(&result),
+      sizeof(result)));
+  EXPECT_THAT(ArrayTuple(result.data, result.length),
+              DataIs(block.data, block.length));
+
+  // Invalid programmed state.
+  block.data[arraysize(new_scene) + 6] = PRESET_PROGRAMMED_READ_ONLY + 1;
+  EXPECT_EQ(0, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_SET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+
+  // Block 0 is handled by the responder, there is no block 3.
+  block.index = 0u;
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_GET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+  block.index = 3u;
+  EXPECT_EQ(0, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_GET_SETTINGS, reinterpret_cast<uint8_t*>(&block), sizeof(block)));
+}
+
+TEST_F(DimmerModelTest, dmxWindow) {
+  DMXWindow window;
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_GET_DMX_WINDOW, reinterpret_cast<uint8_t*>(&window),
+      sizeof(window)));
+  EXPECT_EQ(0u, window.start_slot);
+  EXPECT_EQ(4u, window.footprint);
+
+  // Move the block, the window follows it.
+  uint16_t start_address = HostToNetwork(static_cast<uint16_t>(90));
+  unique_ptr<RDMRequest> request = BuildSetRequest(
+      PID_DMX_BLOCK_ADDRESS,
+      reinterpret_cast<const uint8_t*>(&start_address),
+      sizeof(start_address));
+  unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_GET_DMX_WINDOW, reinterpret_cast<uint8_t*>(&window),
+      sizeof(window)));
+  EXPECT_EQ(89u, window.start_slot);
+  EXPECT_EQ(4u, window.footprint);
+
+  // The data now starts at slot 90.
+  uint8_t dmx[] = {255, 128, 0, 1};
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(0xfffe, DimmerModel_GetOutputLevel(1));
+  EXPECT_EQ(32895, DimmerModel_GetOutputLevel(3));
+
+  // A gap between sub-devices is included in the window.
+  start_address = HostToNetwork(static_cast<uint16_t>(200));
+  request.reset(new RDMSetRequest(
+      m_controller_uid, m_our_uid, 0, 0, 3, PID_DMX_START_ADDRESS,
+      reinterpret_cast<const uint8_t*>(&start_address),
+      sizeof(start_address)));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  EXPECT_EQ(1, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_GET_DMX_WINDOW, reinterpret_cast<uint8_t*>(&window),
+      sizeof(window)));
+  EXPECT_EQ(89u, window.start_slot);
+  EXPECT_EQ(111u, window.footprint);
+
+  // Invalid length.
+  EXPECT_EQ(0, DIMMER_MODEL_ENTRY.ioctl_fn(
+      IOCTL_GET_DMX_WINDOW, reinterpret_cast<uint8_t*>(&window), 1));
+}
+
 TEST_F(DimmerModelTest, curveDescription) {
   uint8_t curve = 1;
   unique_ptr<RDMRequest> request = BuildSubDeviceGetRequest(
@@ -700,6 +1068,44 @@ TEST_F(DimmerModelTest, outputResponseTime) {
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 }
 
+TEST_F(DimmerModelTest, slowOutputResponse) {
+  const uint8_t slow = 2;
+  unique_ptr<RDMRequest> request = BuildSubDeviceSetRequest(
+      PID_OUTPUT_RESPONSE_TIME, 1, &slow, sizeof(slow));
+  unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  // Sub-device 1 moves to the new level over 1s, sub-device 3 is fast.
+  uint8_t dmx[] = {255, 255};
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(1));
+  EXPECT_EQ(0xfffe, DimmerModel_GetOutputLevel(3));
+
+  AdvanceTime(201);
+  EXPECT_EQ(1311, DimmerModel_GetOutputLevel(1));
+  for (unsigned int i = 0; i < 48; i++) {
+    AdvanceTime(201);
+  }
+  EXPECT_EQ(64239, DimmerModel_GetOutputLevel(1));
+  AdvanceTime(201);
+  EXPECT_EQ(0xfffe, DimmerModel_GetOutputLevel(1));
+
+  // Returning to fast jumps straight to the target.
+  dmx[0] = 0;
+  DIMMER_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+  AdvanceTime(201);
+  EXPECT_EQ(0xfffe - 1311, DimmerModel_GetOutputLevel(1));
+
+  const uint8_t fast = 1;
+  request = BuildSubDeviceSetRequest(
+      PID_OUTPUT_RESPONSE_TIME, 1, &fast, sizeof(fast));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(0, DimmerModel_GetOutputLevel(1));
+}
+
 TEST_F(DimmerModelTest, outputResponseTimeDescription) {
   uint8_t setting = 1;
   unique_ptr<RDMRequest> request = BuildSubDeviceGetRequest(
@@ -754,8 +1160,8 @@ TEST_F(DimmerModelTest, modulationFrequencyDescription) {
 }
 
 TEST_F(DimmerModelTest, queuedMessages) {
-  EXPECT_CALL(m_timer, HasElapsed(_, _)).WillOnce(Return(true));
-  DIMMER_MODEL_ENTRY.tasks_fn();
+  // Status messages are generated every 30s.
+  AdvanceTime(300001);
 
   uint8_t status_type = 0x02;
   unique_ptr<RDMRequest> request = BuildGetRequest(
@@ -0,0 +1,126 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * FaderTest.cpp
+ * Tests for the Fader code.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "fader.h"
+
+namespace {
+
+const unsigned int CHANNEL_COUNT = 4;
+}  // namespace
+
+class FaderTest : public testing::Test {
+ public:
+  void SetUp() {
+    for (unsigned int i = 0; i < CHANNEL_COUNT; i++) {
+      m_levels[i] = 0;
+    }
+    Fader_Initialize(&m_fader, m_channels, m_levels, CHANNEL_COUNT);
+  }
+
+ protected:
+  FaderChannel m_channels[CHANNEL_COUNT];
+  uint8_t m_levels[CHANNEL_COUNT];
+  Fader m_fader;
+};
+
+TEST_F(FaderTest, inactive) {
+  EXPECT_FALSE(m_fader.active);
+  EXPECT_FALSE(Fader_Update(&m_fader, 100));
+  EXPECT_EQ(0, m_levels[0]);
+}
+
+TEST_F(FaderTest, fadeUpAndDown) {
+  m_levels[2] = 200;
+  m_levels[3] = 255;
+  const uint8_t targets[] = {255, 100, 0, 255};
+  Fader_Start(&m_fader, targets, 100, 50);
+  EXPECT_TRUE(m_fader.active);
+
+  EXPECT_TRUE(Fader_Update(&m_fader, 0));
+  EXPECT_EQ(0, m_levels[0]);
+  EXPECT_EQ(0, m_levels[1]);
+  EXPECT_EQ(200, m_levels[2]);
+  EXPECT_EQ(255, m_levels[3]);
+
+  EXPECT_TRUE(Fader_Update(&m_fader, 25));
+  EXPECT_EQ(64, m_levels[0]);
+  EXPECT_EQ(25, m_levels[1]);
+  EXPECT_EQ(100, m_levels[2]);
+  EXPECT_EQ(255, m_levels[3]);
+
+  // The down fade is complete.
+  EXPECT_TRUE(Fader_Update(&m_fader, 60));
+  EXPECT_EQ(153, m_levels[0]);
+  EXPECT_EQ(60, m_levels[1]);
+  EXPECT_EQ(0, m_levels[2]);
+
+  EXPECT_FALSE(Fader_Update(&m_fader, 100));
+  EXPECT_EQ(255, m_levels[0]);
+  EXPECT_EQ(100, m_levels[1]);
+  EXPECT_EQ(0, m_levels[2]);
+  EXPECT_EQ(255, m_levels[3]);
+  EXPECT_FALSE(m_fader.active);
+}
+
+TEST_F(FaderTest, zeroTime) {
+  const uint8_t targets[] = {10, 20, 30, 40};
+  Fader_Start(&m_fader, targets, 0, 0);
+  EXPECT_FALSE(Fader_Update(&m_fader, 0));
+  for (unsigned int i = 0; i < CHANNEL_COUNT; i++) {
+    EXPECT_EQ(targets[i], m_levels[i]);
+  }
+}
+
+TEST_F(FaderTest, restartMidFade) {
+  const uint8_t targets[] = {200, 200, 200, 200};
+  Fader_Start(&m_fader, targets, 100, 100);
+  EXPECT_TRUE(Fader_Update(&m_fader, 50));
+  EXPECT_EQ(100, m_levels[0]);
+
+  // The new fade starts from where the last one got to.
+  const uint8_t targets2[] = {0, 0, 0, 0};
+  Fader_Start(&m_fader, targets2, 100, 10);
+  EXPECT_TRUE(Fader_Update(&m_fader, 0));
+  EXPECT_EQ(100, m_levels[0]);
+  EXPECT_FALSE(Fader_Update(&m_fader, 5000));
+  EXPECT_EQ(0, m_levels[0]);
+
+  Fader_Start(&m_fader, targets, 100, 100);
+  Fader_Update(&m_fader, 10);
+  Fader_Stop(&m_fader);
+  EXPECT_FALSE(Fader_Update(&m_fader, 100));
+  EXPECT_EQ(20, m_levels[0]);
+}
+
+TEST_F(FaderTest, longFade) {
+  // 65535 10ths of a second, in 10ths of a millisecond.
+  const uint32_t fade_time = 65535u * 1000u;
+  const uint8_t targets[] = {255, 255, 255, 255};
+  Fader_Start(&m_fader, targets, fade_time, fade_time);
+  EXPECT_TRUE(Fader_Update(&m_fader, fade_time / 2));
+  EXPECT_EQ(128, m_levels[0]);
+  EXPECT_TRUE(Fader_Update(&m_fader, fade_time - 1));
+  EXPECT_EQ(255, m_levels[0]);
+  EXPECT_FALSE(Fader_Update(&m_fader, fade_time));
+  EXPECT_EQ(255, m_levels[0]);
+}
@@ -35,6 +35,7 @@
 #include "Array.h"
 #include "Matchers.h"
 #include "ModelTest.h"
+#include "SPIRGBMock.h"
 #include "TestHelpers.h"
 
 using ola::network::HostToNetwork;
@@ -45,6 +46,9 @@ using ola::rdm::RDMRequest;
 using ola::rdm::RDMResponse;
 using ola::rdm::RDMSetRequest;
 using std::unique_ptr;
+using ::testing::InSequence;
+using ::testing::StrictMock;
+using ::testing::_;
 
 class LEDModelTest : public ModelTest {
  public:
@@ -56,5 +60,102 @@ class LEDModelTest : public ModelTest {
     RDMResponder_Initialize(&settings);
     LEDModel_Initialize();
     LED_MODEL_ENTRY.activate_fn();
+    SPIRGB_SetMock(&spi_mock);
   }
+
+  void TearDown() {
+    SPIRGB_SetMock(nullptr);
+  }
+
+ protected:
+  StrictMock<MockSPIRGB> spi_mock;
 };
+
+TEST_F(LEDModelTest, dmxData) {
+  uint8_t dmx[] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+  // Pixels are copied as they arrive and the frame is sent once the footprint
+  // is complete.
+  {
+    InSequence seq;
+    EXPECT_CALL(spi_mock, BeginUpdate()).Times(1);
+    EXPECT_CALL(spi_mock, SetPixels(0, dmx, 1)).Times(1);
+    EXPECT_CALL(spi_mock, SetPixels(1, dmx + 3, 1)).Times(1);
+    EXPECT_CALL(spi_mock, CompleteUpdate()).Times(1);
+  }
+  EXPECT_EQ(1, LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_FRAME_START, nullptr, 0));
+  for (unsigned int i = 1; i <= arraysize(dmx); i++) {
+    EXPECT_EQ(1, LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, i));
+  }
+
+  // A short frame is sent when the next frame starts.
+  {
+    InSequence seq;
+    EXPECT_CALL(spi_mock, BeginUpdate()).Times(1);
+    EXPECT_CALL(spi_mock, SetPixels(0, dmx, 1)).Times(1);
+    EXPECT_CALL(spi_mock, CompleteUpdate()).Times(1);
+  }
+  LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_FRAME_START, nullptr, 0);
+  LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, 4);
+  LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_FRAME_START, nullptr, 0);
+}
+
+TEST_F(LEDModelTest, shortThenLongFrame) {
+  uint8_t dmx[] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+  // A one pixel frame, followed by a full frame delivered in a single call.
+  // Both frames are sent, even though the slot count increased.
+  {
+    InSequence seq;
+    EXPECT_CALL(spi_mock, BeginUpdate()).Times(1);
+    EXPECT_CALL(spi_mock, SetPixels(0, dmx, 1)).Times(1);
+    EXPECT_CALL(spi_mock, CompleteUpdate()).Times(1);
+    EXPECT_CALL(spi_mock, BeginUpdate()).Times(1);
+    EXPECT_CALL(spi_mock, SetPixels(0, dmx, 2)).Times(1);
+    EXPECT_CALL(spi_mock, CompleteUpdate()).Times(1);
+  }
+  LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_FRAME_START, nullptr, 0);
+  LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, 3);
+  LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_FRAME_START, nullptr, 0);
+  LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+
+  // Repeated data within a frame isn't sent again.
+  LED_MODEL_ENTRY.ioctl_fn(IOCTL_DMX_DATA, dmx, arraysize(dmx));
+}
+
+TEST_F(LEDModelTest, pixelTypeAndCount) {
+  EXPECT_CALL(spi_mock, SetPixelType(SPIRGB_PIXEL_APA102)).Times(1);
+  uint16_t pixel_type = HostToNetwork(static_cast<uint16_t>(4));
+  unique_ptr<RDMRequest> request = BuildSetRequest(
+      PID_PIXEL_TYPE, reinterpret_cast<const uint8_t*>(&pixel_type),
+      sizeof(pixel_type));
+  unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  // P9813 isn't supported.
+  pixel_type = HostToNetwork(static_cast<uint16_t>(3));
+  request = BuildSetRequest(
+      PID_PIXEL_TYPE, reinterpret_cast<const uint8_t*>(&pixel_type),
+      sizeof(pixel_type));
+  response.reset(NackWithReason(request.get(), ola::rdm::NR_DATA_OUT_OF_RANGE));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  EXPECT_CALL(spi_mock, SetPixelCount(170)).Times(1);
+  uint16_t pixel_count = HostToNetwork(static_cast<uint16_t>(170));
+  request = BuildSetRequest(
+      PID_PIXEL_COUNT, reinterpret_cast<const uint8_t*>(&pixel_count),
+      sizeof(pixel_count));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  pixel_count = HostToNetwork(static_cast<uint16_t>(171));
+  request = BuildSetRequest(
+      PID_PIXEL_COUNT, reinterpret_cast<const uint8_t*>(&pixel_count),
+      sizeof(pixel_count));
+  response.reset(NackWithReason(request.get(), ola::rdm::NR_DATA_OUT_OF_RANGE));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+}
@@ -1,7 +1,8 @@
 # LIBS
 
 noinst_LTLIBRARIES += tests/tests/libmodeltest.la \
-                      tests/tests/libbootloaderhelper.la
+                      tests/tests/libbootloaderhelper.la \
+                      tests/tests/libproxymodelsmallpool.la
 
 tests_tests_libmodeltest_la_SOURCES = tests/tests/ModelTest.h \
                                       tests/tests/ModelTest.cpp
@@ -16,6 +17,13 @@ tests_tests_libbootloaderhelper_la_CXXFLAGS= \
     $(GMOCK_INCLUDES) $(GTEST_INCLUDES) \
     -I tests/mocks -I tests/harmony/mocks
 
+# The proxy model with a pool small enough to be exhausted.
+tests_tests_libproxymodelsmallpool_la_SOURCES = firmware/src/proxy_model.c
+tests_tests_libproxymodelsmallpool_la_CFLAGS = \
+    $(BUILD_FLAGS) \
+    -DPROXY_MODEL_CHILD_COUNT=3 \
+    -DPROXY_MODEL_BUFFER_POOL_SIZE=3
+
 # TESTS
 ################################################
 TESTING_CFLAGS = $(BUILD_FLAGS) -I tests/include
@@ -31,19 +39,32 @@ TESTS += tests/tests/bootloader_test \
          tests/tests/bootloader_transfer_test \
          tests/tests/coarse_timer_test \
          tests/tests/dimmer_model_test \
+         tests/tests/dmx_forwarder_test \
+         tests/tests/dmx_input_test \
+         tests/tests/fader_test \
          tests/tests/flags_test \
          tests/tests/led_model_test \
          tests/tests/message_handler_test \
+         tests/tests/model_settings_test \
+         tests/tests/monotonic_clock_test \
          tests/tests/network_model_test \
+         tests/tests/proxy_model_pool_test \
          tests/tests/proxy_model_test \
          tests/tests/rdm_handler_test \
          tests/tests/rdm_responder_test \
          tests/tests/rdm_util_test \
          tests/tests/responder_test \
+         tests/tests/settings_store_test \
+         tests/tests/stack_monitor_test \
+         tests/tests/stats_test \
          tests/tests/spirgb_test \
+         tests/tests/status_queue_test \
          tests/tests/stream_decoder_test \
+         tests/tests/simulated_bus_test \
          tests/tests/simulated_transceiver_test \
          tests/tests/spi_test \
+         tests/tests/temperature_conversion_test \
+         tests/tests/timer_wheel_test \
          tests/tests/transceiver_test \
          tests/tests/usb_transport_test \
          tests/tests/utils_test
@@ -84,15 +105,39 @@ tests_tests_dimmer_model_test_SOURCES = tests/tests/DimmerModelTest.cpp
 tests_tests_dimmer_model_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
 tests_tests_dimmer_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                       firmware/src/libdimmermodel.la \
+                                      firmware/src/libfader.la \
                                       firmware/src/librdmresponder.la \
                                       firmware/src/libreceivercounters.la \
                                       firmware/src/librdmbuffer.la \
                                       firmware/src/librdmutil.la \
+                                      firmware/src/libstatusqueue.la \
+                                      firmware/src/libtimerwheel.la \
+                                      firmware/src/libstats.la \
                                       tests/harmony/mocks/libharmonymock.la \
                                       tests/mocks/libcoarsetimermock.la \
                                       tests/tests/libmodeltest.la \
                                       tests/mocks/libmatchers.la
 
+tests_tests_dmx_forwarder_test_SOURCES = tests/tests/DMXForwarderTest.cpp
+tests_tests_dmx_forwarder_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_dmx_forwarder_test_LDADD = $(TESTING_LIBS) \
+                                       firmware/src/libdmxforwarder.la \
+                                       firmware/src/libdmxinput.la \
+                                       firmware/src/libcoarsetimer.la \
+                                       tests/mocks/libmatchers.la \
+                                       tests/mocks/libtransportmock.la \
+                                       tests/harmony/mocks/libharmonymock.la
+
+tests_tests_dmx_input_test_SOURCES = tests/tests/DMXInputTest.cpp
+tests_tests_dmx_input_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_dmx_input_test_LDADD = $(TESTING_LIBS) \
+                                   firmware/src/libdmxinput.la
+
+tests_tests_fader_test_SOURCES = tests/tests/FaderTest.cpp
+tests_tests_fader_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_fader_test_LDADD = $(TESTING_LIBS) \
+                               firmware/src/libfader.la
+
 tests_tests_flags_test_SOURCES = tests/tests/FlagsTest.cpp
 tests_tests_flags_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_flags_test_LDADD = $(TESTING_LIBS) \
@@ -106,19 +151,27 @@ tests_tests_led_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                    firmware/src/libledmodel.la \
                                    firmware/src/librdmresponder.la \
                                    firmware/src/libreceivercounters.la \
+                                   firmware/src/libtimerwheel.la \
+                                   firmware/src/libstats.la \
                                    firmware/src/libcoarsetimer.la \
                                    firmware/src/librdmbuffer.la \
                                    firmware/src/librandom.la \
                                    firmware/src/librdmutil.la \
                                    tests/tests/libmodeltest.la \
                                    tests/harmony/mocks/libharmonymock.la \
-                                   tests/mocks/libmatchers.la
+                                   tests/mocks/libmatchers.la \
+                                   tests/mocks/libspirgbmock.la
 
 tests_tests_message_handler_test_SOURCES = tests/tests/MessageHandlerTest.cpp
 tests_tests_message_handler_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_message_handler_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
                                          firmware/src/libmessagehandler.la \
+                                         firmware/src/libstackmonitor.la \
+                                         firmware/src/libtimerwheel.la \
+                                         firmware/src/libstats.la \
                                          tests/mocks/libappmock.la \
+                                         tests/mocks/libcoarsetimermock.la \
+                                         tests/mocks/libdmxforwardermock.la \
                                          tests/mocks/libflagsmock.la \
                                          tests/mocks/libmatchers.la \
                                          tests/mocks/librdmhandlermock.la \
@@ -127,12 +180,31 @@ tests_tests_message_handler_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
                                          tests/mocks/libtransportmock.la \
                                          tests/harmony/mocks/libharmonymock.la
 
+tests_tests_model_settings_test_SOURCES = tests/tests/ModelSettingsTest.cpp
+tests_tests_model_settings_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_model_settings_test_LDADD = $(TESTING_LIBS) \
+                                        firmware/src/libmodelsettings.la \
+                                        firmware/src/libsettingsstore.la \
+                                        firmware/src/libtimerwheel.la \
+                                        firmware/src/libstats.la \
+                                        tests/mocks/libcoarsetimermock.la \
+                                        tests/mocks/libflashmock.la \
+                                        tests/mocks/librdmhandlermock.la
+
+tests_tests_monotonic_clock_test_SOURCES = tests/tests/MonotonicClockTest.cpp
+tests_tests_monotonic_clock_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_monotonic_clock_test_LDADD = $(TESTING_LIBS) \
+                                         firmware/src/libmonotonicclock.la \
+                                         tests/harmony/mocks/libharmonymock.la
+
 tests_tests_network_model_test_SOURCES = tests/tests/NetworkModelTest.cpp
 tests_tests_network_model_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
 tests_tests_network_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                        firmware/src/libnetworkmodel.la \
                                        firmware/src/librdmresponder.la \
                                        firmware/src/libreceivercounters.la \
+                                       firmware/src/libtimerwheel.la \
+                                       firmware/src/libstats.la \
                                        firmware/src/libcoarsetimer.la \
                                        firmware/src/librdmbuffer.la \
                                        firmware/src/librandom.la \
@@ -141,16 +213,35 @@ tests_tests_network_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                        tests/harmony/mocks/libharmonymock.la \
                                        tests/mocks/libmatchers.la
 
+tests_tests_proxy_model_pool_test_SOURCES = tests/tests/ProxyModelPoolTest.cpp
+tests_tests_proxy_model_pool_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
+tests_tests_proxy_model_pool_test_LDADD = \
+    $(TESTING_LIBS) $(OLA_LIBS) \
+    tests/tests/libproxymodelsmallpool.la \
+    firmware/src/librdmresponder.la \
+    firmware/src/libreceivercounters.la \
+    firmware/src/libtimerwheel.la \
+    firmware/src/libcoarsetimer.la \
+    firmware/src/librdmbuffer.la \
+    firmware/src/librandom.la \
+    firmware/src/librdmutil.la \
+    firmware/src/libstats.la \
+    tests/tests/libmodeltest.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libmatchers.la
+
 tests_tests_proxy_model_test_SOURCES = tests/tests/ProxyModelTest.cpp
 tests_tests_proxy_model_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
 tests_tests_proxy_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                      firmware/src/libproxymodel.la \
                                      firmware/src/librdmresponder.la \
                                      firmware/src/libreceivercounters.la \
+                                     firmware/src/libtimerwheel.la \
                                      firmware/src/libcoarsetimer.la \
                                      firmware/src/librdmbuffer.la \
                                      firmware/src/librandom.la \
                                      firmware/src/librdmutil.la \
+                                     firmware/src/libstats.la \
                                      tests/tests/libmodeltest.la \
                                      tests/harmony/mocks/libharmonymock.la \
                                      tests/mocks/libmatchers.la
@@ -159,9 +250,12 @@ tests_tests_rdm_handler_test_SOURCES = tests/tests/RDMHandlerTest.cpp
 tests_tests_rdm_handler_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
 tests_tests_rdm_handler_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                      tests/mocks/libmatchers.la \
+                                     tests/mocks/libtransceivermock.la \
                                      firmware/src/librdmhandler.la \
                                      firmware/src/librdmresponder.la \
                                      firmware/src/libreceivercounters.la \
+                                     firmware/src/libtimerwheel.la \
+                                     firmware/src/libstats.la \
                                      firmware/src/libcoarsetimer.la \
                                      firmware/src/librdmbuffer.la \
                                      firmware/src/librdmutil.la \
@@ -173,6 +267,8 @@ tests_tests_rdm_responder_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                        firmware/src/librdmresponder.la \
                                        firmware/src/libreceivercounters.la \
                                        firmware/src/librdmbuffer.la \
+                                       firmware/src/libtimerwheel.la \
+                                       firmware/src/libstats.la \
                                        firmware/src/libcoarsetimer.la \
                                        firmware/src/librdmutil.la \
                                        tests/harmony/mocks/libharmonymock.la \
@@ -188,32 +284,65 @@ tests_tests_rdm_util_test_LDADD = $(TESTING_LIBS) \
 tests_tests_responder_test_SOURCES = tests/tests/ResponderTest.cpp
 tests_tests_responder_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_responder_test_LDADD = $(TESTING_LIBS) \
+                                   firmware/src/libdmxinput.la \
                                    firmware/src/librdmutil.la \
                                    firmware/src/libreceivercounters.la \
                                    firmware/src/libresponder.la \
                                    firmware/src/librdmutil.la \
                                    tests/mocks/libmatchers.la \
                                    tests/mocks/librdmhandlermock.la \
-                                   tests/mocks/libspirgbmock.la \
-                                   tests/mocks/libsyslogmock.la
+                                   tests/mocks/libsyslogmock.la \
+                                   tests/mocks/libtransceivermock.la
+
+tests_tests_settings_store_test_SOURCES = tests/tests/SettingsStoreTest.cpp
+tests_tests_settings_store_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_settings_store_test_LDADD = $(TESTING_LIBS) \
+                                        firmware/src/libsettingsstore.la \
+                                        tests/mocks/libflashmock.la
 
 tests_tests_spirgb_test_SOURCES = tests/tests/SPIRGBTest.cpp
 tests_tests_spirgb_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_spirgb_test_LDADD = $(TESTING_LIBS) \
+                                firmware/src/libcoarsetimer.la \
                                 firmware/src/libspirgb.la \
+                                firmware/src/libspidma.la \
                                 tests/harmony/mocks/libharmonymock.la \
                                 tests/mocks/libmatchers.la
 
+tests_tests_stack_monitor_test_SOURCES = tests/tests/StackMonitorTest.cpp
+tests_tests_stack_monitor_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_stack_monitor_test_LDADD = $(TESTING_LIBS) \
+                                       firmware/src/libstackmonitor.la
+
+tests_tests_stats_test_SOURCES = tests/tests/StatsTest.cpp
+tests_tests_stats_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_stats_test_LDADD = $(TESTING_LIBS) \
+                               firmware/src/libstats.la
+
+tests_tests_status_queue_test_SOURCES = tests/tests/StatusQueueTest.cpp
+tests_tests_status_queue_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_status_queue_test_LDADD = $(TESTING_LIBS) \
+                                      firmware/src/libstatusqueue.la
+
 tests_tests_stream_decoder_test_SOURCES = tests/tests/StreamDecoderTest.cpp
 tests_tests_stream_decoder_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_stream_decoder_test_LDADD = $(TESTING_LIBS) \
                                         firmware/src/libstreamdecoder.la \
+                                        firmware/src/libstats.la \
                                         tests/mocks/libmessagehandlermock.la
 
+tests_tests_temperature_conversion_test_SOURCES = \
+    tests/tests/TemperatureConversionTest.cpp
+tests_tests_temperature_conversion_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_temperature_conversion_test_LDADD = \
+    $(TESTING_LIBS) \
+    firmware/src/libtemperatureconversion.la
+
 tests_tests_usb_transport_test_SOURCES = tests/tests/USBTransportTest.cpp
 tests_tests_usb_transport_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_usb_transport_test_LDADD = $(TESTING_LIBS) \
                                        firmware/src/libusbtransport.la \
+                                       firmware/src/libstats.la \
                                        tests/harmony/mocks/libharmonymock.la \
                                        tests/mocks/libbootloaderoptionsmock.la \
                                        tests/mocks/libmatchers.la \
@@ -227,17 +356,41 @@ tests_tests_spi_test_LDADD = \
     $(GMOCK_LIBS) $(GTEST_LIBS) $(OLA_LIBS) \
     tests/sim/libsim.la \
     firmware/src/libspi.la \
+    firmware/src/libspidma.la \
+    firmware/src/libstats.la \
     tests/mocks/libmatchers.la \
     tests/harmony/mocks/libharmonymock.la
 
+tests_tests_timer_wheel_test_SOURCES = tests/tests/TimerWheelTest.cpp
+tests_tests_timer_wheel_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_timer_wheel_test_LDADD = $(TESTING_LIBS) \
+                                     firmware/src/libtimerwheel.la \
+                                     firmware/src/libcoarsetimer.la \
+                                     firmware/src/libstats.la \
+                                     tests/harmony/mocks/libharmonymock.la
+
 tests_tests_transceiver_test_SOURCES = tests/tests/TransceiverTest.cpp
 tests_tests_transceiver_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_transceiver_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
                                      firmware/src/libtransceiver.la \
+                                     firmware/src/libmonotonicclock.la \
+                                     firmware/src/libstats.la \
                                      tests/harmony/mocks/libharmonymock.la \
                                      tests/mocks/libcoarsetimermock.la \
                                      tests/mocks/libsyslogmock.la
 
+tests_tests_simulated_bus_test_SOURCES = tests/tests/SimulatedBusTest.cpp
+tests_tests_simulated_bus_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
+tests_tests_simulated_bus_test_LDADD = \
+    $(GMOCK_LIBS) $(GTEST_LIBS) $(OLA_LIBS) \
+    tests/sim/libsim.la \
+    firmware/src/libtransceiver.la \
+    firmware/src/libcoarsetimer.la \
+    firmware/src/libmonotonicclock.la \
+    firmware/src/libstats.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libsyslogmock.la
+
 tests_tests_simulated_transceiver_test_SOURCES = \
     tests/tests/SimulatedTransceiverTest.cpp
 tests_tests_simulated_transceiver_test_CXXFLAGS = \
@@ -247,6 +400,8 @@ tests_tests_simulated_transceiver_test_LDADD = \
     tests/sim/libsim.la \
     firmware/src/libtransceiver.la \
     firmware/src/libcoarsetimer.la \
+    firmware/src/libmonotonicclock.la \
+    firmware/src/libstats.la \
     tests/harmony/mocks/libharmonymock.la \
     tests/mocks/libsyslogmock.la
 
@@ -22,6 +22,8 @@
 
 #include "AppMock.h"
 #include "Array.h"
+#include "CoarseTimerMock.h"
+#include "DMXForwarderMock.h"
 #include "FlagsMock.h"
 #include "Matchers.h"
 #include "RDMHandlerMock.h"
@@ -29,6 +31,9 @@
 #include "TransportMock.h"
 #include "constants.h"
 #include "message_handler.h"
+#include "stack_monitor.h"
+#include "stats.h"
+#include "timer_wheel.h"
 
 using ::testing::Args;
 using ::testing::Return;
@@ -319,6 +324,40 @@ TEST_F(MessageHandlerTest, testDMX) {
   MessageHandler_HandleMessage(&message);
 }
 
+TEST_F(MessageHandlerTest, testDMXForwarding) {
+  MockDMXForwarder forwarder_mock;
+  DMXForwarder_SetMock(&forwarder_mock);
+
+  testing::InSequence seq;
+  EXPECT_CALL(forwarder_mock, Configure(kToken, DMX_FORWARD_CHANGES, 250))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_SET_DMX_FORWARDING,
+                                     RC_OK, NULL, 0))
+      .WillOnce(Return(true));
+  EXPECT_CALL(forwarder_mock, Configure(kToken, 7, 0))
+      .WillOnce(Return(false));
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_SET_DMX_FORWARDING,
+                                     RC_BAD_PARAM, NULL, 0))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+
+  const uint8_t payload[] = {DMX_FORWARD_CHANGES, 250, 0};
+  Message message = {
+    kToken, COMMAND_SET_DMX_FORWARDING, arraysize(payload), &payload[0]
+  };
+  MessageHandler_HandleMessage(&message);
+
+  const uint8_t bad_mode[] = {7, 0, 0};
+  message.payload = bad_mode;
+  MessageHandler_HandleMessage(&message);
+
+  // Short payload
+  message.length = 1;
+  MessageHandler_HandleMessage(&message);
+
+  DMXForwarder_SetMock(nullptr);
+}
+
 TEST_F(MessageHandlerTest, testFlags) {
   MockFlags flags_mock;
   Flags_SetMock(&flags_mock);
@@ -329,6 +368,100 @@ TEST_F(MessageHandlerTest, testFlags) {
   MessageHandler_HandleMessage(&message);
 }
 
+TEST_F(MessageHandlerTest, testGetStats) {
+  Stats_Initialize();
+  StatsCounter queue_full;
+  Stats_AddCounter("spi.queue_full", &queue_full);
+  Stats_Increment(&queue_full);
+  Stats_Increment(&queue_full);
+
+  // Run a timer callback 0.5ms late.
+  testing::NiceMock<MockCoarseTimer> timer_mock;
+  CoarseTimer_SetMock(&timer_mock);
+  TimerWheel_Initialize();
+  TimerWheel_Timer timer = {};
+  TimerWheel_Schedule(&timer, 10, [](void*) {}, NULL);
+  EXPECT_CALL(timer_mock, GetTime()).WillOnce(Return(16));
+  TimerWheel_Tasks();
+  CoarseTimer_SetMock(nullptr);
+
+  const uint8_t response[] = {
+    2,
+    2, 0, 0, 0, 14, 's', 'p', 'i', '.', 'q', 'u', 'e', 'u', 'e', '_', 'f',
+    'u', 'l', 'l',
+    5, 0, 0, 0, 24, 't', 'i', 'm', 'e', 'r', '_', 'w', 'h', 'e', 'e', 'l',
+    '.', 'm', 'a', 'x', '_', 'l', 'a', 't', 'e', 'n', 'e', 's', 's',
+  };
+
+  uint8_t reset_response[sizeof(response)];
+  memcpy(reset_response, response, sizeof(reset_response));
+  reset_response[1] = 0;
+  reset_response[20] = 0;
+
+  testing::InSequence seq;
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_GET_STATS, RC_OK, _, _))
+      .With(Args<3, 4>(PayloadIs(response, arraysize(response))))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_GET_STATS, RC_OK, _, _))
+      .With(Args<3, 4>(PayloadIs(reset_response, arraysize(reset_response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_GET_STATS, RC_BAD_PARAM,
+                                     NULL, 0))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+
+  Message message = { kToken, COMMAND_GET_STATS, 0, NULL };
+  MessageHandler_HandleMessage(&message);
+
+  // Read & reset.
+  const uint8_t payload[] = {STATS_FLAG_RESET, 0};
+  message.length = 1;
+  message.payload = payload;
+  MessageHandler_HandleMessage(&message);
+  MessageHandler_HandleMessage(&message);
+
+  // Unknown flags & long payloads are rejected.
+  const uint8_t bad_flags = 0x80;
+  message.payload = &bad_flags;
+  MessageHandler_HandleMessage(&message);
+
+  message.length = arraysize(payload);
+  message.payload = payload;
+  MessageHandler_HandleMessage(&message);
+}
+
+TEST_F(MessageHandlerTest, testGetMemoryInfo) {
+  static uint32_t stack[16];
+  StackMonitor_Settings settings = {
+    .limit = stack,
+    .top = stack + arraysize(stack)
+  };
+  StackMonitor_Initialize(&settings);
+
+  const uint8_t response[] = {
+    64, 0, 0, 0,
+    0, 0, 0, 0,
+    64, 0, 0, 0
+  };
+
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_GET_MEMORY_INFO, RC_OK,
+                                     _, 1))
+      .With(Args<3, 4>(PayloadIs(response, arraysize(response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_GET_MEMORY_INFO,
+                                     RC_BAD_PARAM, NULL, 0))
+      .WillOnce(Return(true));
+
+  Message message = { kToken, COMMAND_GET_MEMORY_INFO, 0, NULL };
+  MessageHandler_HandleMessage(&message);
+
+  const uint8_t payload = 0;
+  message.length = sizeof(payload);
+  message.payload = &payload;
+  MessageHandler_HandleMessage(&message);
+}
+
 TEST_F(MessageHandlerTest, testReset) {
   MockApp app_mock;
   APP_SetMock(&app_mock);
@@ -0,0 +1,221 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ModelSettingsTest.cpp
+ * Tests for the ModelSettings code.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "model_settings.h"
+#include "settings_store.h"
+#include "timer_wheel.h"
+#include "CoarseTimerMock.h"
+#include "FlashMock.h"
+#include "RDMHandlerMock.h"
+
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::ReturnPointee;
+using ::testing::StrictMock;
+using ::testing::_;
+using std::string;
+
+namespace {
+
+const uint32_t BASE_ADDRESS = 0x9d07c000;
+const uint32_t PAGE_SIZE = 256;
+const uint8_t PAGE_COUNT = 4;
+
+/*
+ * A flash region in RAM.
+ */
+class RAMFlash : public FlashInterface {
+ public:
+  RAMFlash() : m_data(PAGE_SIZE * PAGE_COUNT, 0xff) {}
+
+  bool ErasePage(uint32_t address) {
+    memset(&m_data[address - BASE_ADDRESS], 0xff, PAGE_SIZE);
+    return true;
+  }
+
+  bool WriteWord(uint32_t address, uint32_t data) {
+    uint32_t value;
+    memcpy(&value, &m_data[address - BASE_ADDRESS], sizeof(value));
+    value &= data;
+    memcpy(&m_data[address - BASE_ADDRESS], &value, sizeof(value));
+    return true;
+  }
+
+  uint32_t ReadWord(uint32_t address) {
+    uint32_t value;
+    memcpy(&value, &m_data[address - BASE_ADDRESS], sizeof(value));
+    return value;
+  }
+
+ private:
+  std::vector<uint8_t> m_data;
+};
+
+uint8_t BlockKey(uint16_t model_id, uint8_t index) {
+  return 1 + (model_id - LED_MODEL_ID) * MODEL_SETTINGS_MAX_BLOCKS + index;
+}
+
+string BlockData(const ModelSettingsBlock *block) {
+  return string(reinterpret_cast<const char*>(block->data), block->length);
+}
+
+MATCHER_P2(BlockIs, index, data, "") {
+  return arg->index == index && BlockData(arg) == data;
+}
+
+/*
+ * Populate a block, if it's block 0.
+ */
+bool GetFirstBlock(const string &data, ModelSettingsBlock *block) {
+  if (block->index != 0u) {
+    return false;
+  }
+  memcpy(block->data, data.data(), data.size());
+  block->length = data.size();
+  return true;
+}
+}  // namespace
+
+class ModelSettingsTest : public testing::Test {
+ public:
+  ModelSettingsTest() : m_now(0) {}
+
+  void SetUp() {
+    Flash_SetMock(&m_flash);
+    RDMHandler_SetMock(&m_handler);
+    CoarseTimer_SetMock(&m_timer);
+    ON_CALL(m_timer, GetTime()).WillByDefault(ReturnPointee(&m_now));
+    TimerWheel_Initialize();
+
+    SettingsStoreConfiguration config = {
+      .base_address = BASE_ADDRESS,
+      .page_size = PAGE_SIZE,
+      .page_count = PAGE_COUNT
+    };
+    ASSERT_TRUE(SettingsStore_Initialize(&config));
+  }
+
+  void TearDown() {
+    Flash_SetMock(nullptr);
+    RDMHandler_SetMock(nullptr);
+    CoarseTimer_SetMock(nullptr);
+  }
+
+  bool Set(uint8_t key, const string &value) {
+    return SettingsStore_Set(
+        key, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+  }
+
+  void AdvanceTime(uint32_t ticks) {
+    m_now += ticks;
+    TimerWheel_Tasks();
+  }
+
+  string Get(uint8_t key) {
+    uint8_t data[SETTINGS_STORE_MAX_VALUE_SIZE];
+    unsigned int length = sizeof(data);
+    if (!SettingsStore_Get(key, data, &length)) {
+      return "";
+    }
+    return string(reinterpret_cast<char*>(data), length);
+  }
+
+ protected:
+  RAMFlash m_flash;
+  StrictMock<MockRDMHandler> m_handler;
+  NiceMock<MockCoarseTimer> m_timer;
+  CoarseTimer_Value m_now;
+};
+
+TEST_F(ModelSettingsTest, emptyStore) {
+  EXPECT_CALL(m_handler, SetActiveModel(_)).Times(0);
+  EXPECT_CALL(m_handler, ActiveModel()).WillOnce(Return(LED_MODEL_ID));
+  ModelSettings_Initialize();
+}
+
+TEST_F(ModelSettingsTest, restore) {
+  const string responder_settings("\x01\x00\x05label", 8);
+  ASSERT_TRUE(Set(0, string("\x01\x05", 2)));
+  ASSERT_TRUE(Set(BlockKey(DIMMER_MODEL_ID, 0), responder_settings));
+  ASSERT_TRUE(Set(BlockKey(DIMMER_MODEL_ID, 2), "presets"));
+  // Another model's settings are ignored.
+  ASSERT_TRUE(Set(BlockKey(LED_MODEL_ID, 0), "led"));
+
+  EXPECT_CALL(m_handler, SetActiveModel(DIMMER_MODEL_ID))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_handler, ActiveModel()).WillOnce(Return(DIMMER_MODEL_ID));
+  EXPECT_CALL(m_handler, SetSettings(BlockIs(0, responder_settings)))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_handler, SetSettings(BlockIs(2, "presets")))
+      .WillOnce(Return(true));
+  ModelSettings_Initialize();
+}
+
+TEST_F(ModelSettingsTest, save) {
+  EXPECT_CALL(m_handler, ActiveModel()).WillRepeatedly(Return(LED_MODEL_ID));
+  ModelSettings_Initialize();
+
+  // Nothing happens until the interval has passed.
+  ModelSettings_Tasks();
+  AdvanceTime(MODEL_SETTINGS_SAVE_INTERVAL);
+
+  EXPECT_CALL(m_handler, GetSettings(_))
+      .Times(MODEL_SETTINGS_MAX_BLOCKS)
+      .WillRepeatedly(Invoke([](ModelSettingsBlock *block) {
+        return GetFirstBlock("new label", block);
+      }));
+  AdvanceTime(1);
+
+  EXPECT_EQ("new label", Get(BlockKey(LED_MODEL_ID, 0)));
+  EXPECT_EQ("", Get(BlockKey(LED_MODEL_ID, 1)));
+  EXPECT_EQ("", Get(0));
+}
+
+TEST_F(ModelSettingsTest, modelChange) {
+  ASSERT_TRUE(Set(BlockKey(SENSOR_MODEL_ID, 0), "sensor"));
+
+  EXPECT_CALL(m_handler, ActiveModel())
+      .WillOnce(Return(LED_MODEL_ID))
+      .WillRepeatedly(Return(SENSOR_MODEL_ID));
+  ModelSettings_Initialize();
+
+  // The new model's settings are loaded, and it becomes the startup model.
+  EXPECT_CALL(m_handler, SetSettings(BlockIs(0, "sensor")))
+      .WillOnce(Return(true));
+  ModelSettings_Tasks();
+  EXPECT_EQ(string("\x01\x03", 2), Get(0));
+
+  // Once loaded, the settings are saved as normal.
+  EXPECT_CALL(m_handler, GetSettings(_))
+      .Times(MODEL_SETTINGS_MAX_BLOCKS)
+      .WillRepeatedly(Invoke([](ModelSettingsBlock *block) {
+        return GetFirstBlock("sensor 2", block);
+      }));
+  AdvanceTime(MODEL_SETTINGS_SAVE_INTERVAL + 1);
+  ModelSettings_Tasks();
+  EXPECT_EQ("sensor 2", Get(BlockKey(SENSOR_MODEL_ID, 0)));
+}
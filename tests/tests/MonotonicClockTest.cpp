@@ -0,0 +1,117 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MonotonicClockTest.cpp
+ * Tests for the monotonic clock.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include "monotonic_clock.h"
+#include "core_timer_mock.h"
+
+class FakeCoreTimer : public CoreTimerInterface {
+ public:
+  FakeCoreTimer() : m_counter(0) {}
+
+  uint32_t CounterGet() { return m_counter; }
+
+  void Set(uint32_t counter) { m_counter = counter; }
+  void Advance(uint32_t ticks) { m_counter += ticks; }
+
+ private:
+  uint32_t m_counter;
+};
+
+class MonotonicClockTest : public testing::TestWithParam<uint32_t> {
+ public:
+  void SetUp() {
+    CORE_TIMER_SetMock(&m_core_timer);
+    m_core_timer.Set(GetParam());
+    MonotonicClock_Initialize();
+  }
+
+  void TearDown() {
+    CORE_TIMER_SetMock(nullptr);
+  }
+
+ protected:
+  FakeCoreTimer m_core_timer;
+};
+
+TEST_P(MonotonicClockTest, startsAtZero) {
+  EXPECT_EQ(0u, MonotonicClock_GetTime());
+  m_core_timer.Advance(5);
+  EXPECT_EQ(5u, MonotonicClock_GetTime());
+  MonotonicClock_Update();
+  EXPECT_EQ(5u, MonotonicClock_GetTime());
+}
+
+TEST_P(MonotonicClockTest, wrap) {
+  // Cross the 32-bit boundary of the core timer several times, updating the
+  // clock every 2^31 ticks.
+  uint64_t expected = 0u;
+  for (unsigned int i = 0; i < 8; i++) {
+    m_core_timer.Advance(0x80000000u);
+    expected += 0x80000000u;
+    EXPECT_EQ(expected, MonotonicClock_GetTime());
+    MonotonicClock_Update();
+    EXPECT_EQ(expected, MonotonicClock_GetTime());
+  }
+  EXPECT_EQ(0x400000000ull, MonotonicClock_GetTime());
+
+  // The update may be late, as long as it's within one wrap period.
+  m_core_timer.Advance(0xffffffffu);
+  MonotonicClock_Update();
+  EXPECT_EQ(0x4ffffffffull, MonotonicClock_GetTime());
+}
+
+TEST_P(MonotonicClockTest, setTime) {
+  MonotonicClock_SetTime(0xfffffffff0ull);
+  m_core_timer.Advance(0x20u);
+  EXPECT_EQ(0x10000000010ull, MonotonicClock_GetTime());
+  MonotonicClock_Update();
+  EXPECT_EQ(0x10000000010ull, MonotonicClock_GetTime());
+}
+
+TEST_P(MonotonicClockTest, elapsed) {
+  MonotonicClock_Value start = MonotonicClock_GetTime();
+  EXPECT_TRUE(MonotonicClock_HasElapsed(start, 0u));
+  EXPECT_FALSE(MonotonicClock_HasElapsed(start, 1u));
+
+  m_core_timer.Advance(MONOTONIC_CLOCK_TICKS_PER_US * 100u - 1u);
+  EXPECT_EQ(MONOTONIC_CLOCK_TICKS_PER_US * 100u - 1u,
+            MonotonicClock_ElapsedTicks(start));
+  EXPECT_FALSE(MonotonicClock_HasElapsed(start, 100u));
+  m_core_timer.Advance(1u);
+  EXPECT_TRUE(MonotonicClock_HasElapsed(start, 100u));
+  EXPECT_FALSE(MonotonicClock_HasElapsed(start, 101u));
+}
+
+INSTANTIATE_TEST_CASE_P(InstantiationName,
+                        MonotonicClockTest,
+                        ::testing::Values(0, 1, 0x80000000, 0xffffffff));
+
+TEST(MonotonicClockConversionTest, conversions) {
+  // The core timer runs at half the 80MHz system clock.
+  EXPECT_EQ(40u, MONOTONIC_CLOCK_TICKS_PER_US);
+  EXPECT_EQ(0u, MonotonicClock_TicksToMicroSeconds(39u));
+  EXPECT_EQ(1u, MonotonicClock_TicksToMicroSeconds(40u));
+  EXPECT_EQ(107374182u, MonotonicClock_TicksToMicroSeconds(0xffffffffu));
+  EXPECT_EQ(40000000u, MonotonicClock_MicroSecondsToTicks(1000000u));
+  EXPECT_EQ(0x2800000000ull,
+            MonotonicClock_MicroSecondsToTicks(0x100000000ull));
+}
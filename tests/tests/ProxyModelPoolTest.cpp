@@ -0,0 +1,210 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ProxyModelPoolTest.cpp
+ * Tests for the Proxy Model buffer pool, built with 3 children sharing a pool
+ * of 3 buffers so the pool can be exhausted.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include <ola/rdm/UID.h>
+#include <ola/rdm/RDMCommand.h>
+#include <ola/rdm/RDMEnums.h>
+#include <ola/rdm/RDMResponseCodes.h>
+#include <ola/network/NetworkUtils.h>
+#include <string.h>
+#include <memory>
+
+#include "proxy_model.h"
+#include "rdm.h"
+#include "rdm_buffer.h"
+#include "rdm_responder.h"
+#include "stats.h"
+#include "Array.h"
+#include "Matchers.h"
+#include "ModelTest.h"
+#include "TestHelpers.h"
+
+using ola::network::HostToNetwork;
+using ola::rdm::UID;
+using ola::rdm::GetResponseFromData;
+using ola::rdm::NackWithReason;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using std::unique_ptr;
+
+class ProxyModelPoolTest : public ModelTest {
+ public:
+  ProxyModelPoolTest()
+      : ModelTest(&PROXY_MODEL_ENTRY),
+        m_child_uid1(0x7a70, 0x123456ff),
+        m_child_uid2(0x7a70, 0x12345700),
+        m_child_uid3(0x7a70, 0x12345701) {
+    m_our_uid = UID(PARENT_UID);
+  }
+
+  void SetUp() {
+    RDMResponderSettings settings;
+    memcpy(settings.uid, PARENT_UID, UID_LENGTH);
+    RDMResponder_Initialize(&settings);
+    Stats_Initialize();
+    ProxyModel_Initialize();
+    PROXY_MODEL_ENTRY.activate_fn();
+  }
+
+ protected:
+  UID m_child_uid1;
+  UID m_child_uid2;
+  UID m_child_uid3;
+
+  unique_ptr<RDMRequest> BuildChildGetRequest(
+      const UID &uid,
+      uint16_t pid,
+      const uint8_t *param_data = NULL,
+      unsigned int param_data_size = 0) {
+    return unique_ptr<RDMGetRequest>(new RDMGetRequest(
+        m_controller_uid, uid, 0, 0, 0, pid, param_data,
+        param_data_size));
+  }
+
+  /*
+   * @brief Send a request to a child and check for the ACK_TIMER.
+   */
+  void ExpectAckTimer(const RDMRequest *request) {
+    uint16_t delay = HostToNetwork(ACK_TIMER_TIME);
+    unique_ptr<RDMResponse> response(GetResponseFromData(
+        request, reinterpret_cast<uint8_t*>(&delay), sizeof(delay),
+        ola::rdm::RDM_ACK_TIMER));
+    int size = InvokeRDMHandler(request);
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  }
+
+  /*
+   * @brief Queue a GET IDENTIFY_DEVICE for a child.
+   */
+  void QueueIdentify(const UID &uid) {
+    unique_ptr<RDMRequest> request = BuildChildGetRequest(
+        uid, PID_IDENTIFY_DEVICE);
+    ExpectAckTimer(request.get());
+  }
+
+  /*
+   * @brief Send a GET QUEUED_MESSAGE and check the IDENTIFY_DEVICE response.
+   */
+  void ExpectIdentifyMessage(const UID &uid, uint8_t status_type,
+                             uint8_t queued_message_count = 0) {
+    unique_ptr<RDMRequest> request = BuildChildGetRequest(
+        uid, PID_QUEUED_MESSAGE, &status_type, sizeof(status_type));
+    uint8_t identify_device = 0;
+    unique_ptr<RDMResponse> response(GetResponseWithPid(
+        request.get(), PID_IDENTIFY_DEVICE, &identify_device,
+        sizeof(identify_device), ola::rdm::RDM_ACK, queued_message_count));
+    int size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  }
+
+  /*
+   * @brief Send a GET QUEUED_MESSAGE and check for an empty STATUS_MESSAGES.
+   */
+  void ExpectEmptyStatusMessages(const UID &uid, uint8_t status_type) {
+    unique_ptr<RDMRequest> request = BuildChildGetRequest(
+        uid, PID_QUEUED_MESSAGE, &status_type, sizeof(status_type));
+    unique_ptr<RDMResponse> response(GetResponseWithPid(
+        request.get(), PID_STATUS_MESSAGES, NULL, 0));
+    int size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  }
+
+  static const uint8_t PARENT_UID[UID_LENGTH];
+  static const uint16_t ACK_TIMER_TIME = 1u;
+};
+
+// The children's device ids carry into the upper bytes.
+const uint8_t ProxyModelPoolTest::PARENT_UID[] = {
+  0x7a, 0x70, 0x12, 0x34, 0x56, 0xfe
+};
+
+TEST_F(ProxyModelPoolTest, proxiedDevices) {
+  unique_ptr<RDMRequest> request = BuildGetRequest(PID_PROXIED_DEVICES);
+
+  const uint8_t expected_response[] = {
+    0x7a, 0x70, 0x12, 0x34, 0x56, 0xff,
+    0x7a, 0x70, 0x12, 0x34, 0x57, 0x00,
+    0x7a, 0x70, 0x12, 0x34, 0x57, 0x01,
+  };
+
+  unique_ptr<RDMResponse> response(GetResponseFromData(
+        request.get(), expected_response, arraysize(expected_response)));
+
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+}
+
+TEST_F(ProxyModelPoolTest, exhaustion) {
+  const uint8_t GET_NEXT = ola::rdm::STATUS_ERROR;
+  const uint8_t GET_LAST = ola::rdm::STATUS_GET_LAST_MESSAGE;
+  EXPECT_EQ(3u, ProxyModel_FreeBufferCount());
+
+  // Each child queues & fetches a message, in order 1, 2, 3. Each buffer is
+  // now held as a last message.
+  QueueIdentify(m_child_uid1);
+  ExpectIdentifyMessage(m_child_uid1, GET_NEXT);
+  QueueIdentify(m_child_uid2);
+  ExpectIdentifyMessage(m_child_uid2, GET_NEXT);
+  QueueIdentify(m_child_uid3);
+  ExpectIdentifyMessage(m_child_uid3, GET_NEXT);
+  EXPECT_EQ(0u, ProxyModel_FreeBufferCount());
+  EXPECT_EQ(0u, ProxyModel_BufferPoolExhaustedCount());
+
+  // Child 3 queues another message. The pool is empty so the last message of
+  // child 1, which was serviced least recently, is reclaimed.
+  QueueIdentify(m_child_uid3);
+  EXPECT_EQ(1u, ProxyModel_BufferPoolExhaustedCount());
+  EXPECT_EQ(0u, ProxyModel_FreeBufferCount());
+
+  ExpectIdentifyMessage(m_child_uid2, GET_LAST);
+  ExpectIdentifyMessage(m_child_uid3, GET_LAST, 1);
+
+  // Child 3 already has a message queued, so it's NACKed.
+  unique_ptr<RDMRequest> request = BuildChildGetRequest(
+      m_child_uid3, PID_IDENTIFY_DEVICE);
+  unique_ptr<RDMResponse> response(NackWithReason(
+      request.get(), ola::rdm::NR_PROXY_BUFFER_FULL, 1));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(1u, ProxyModel_BufferPoolNackCount());
+  EXPECT_EQ(1u, ProxyModel_BufferPoolExhaustedCount());
+
+  // Child 1 no longer holds a last message, so the request is passed to the
+  // child and the empty STATUS_MESSAGES is queued. This reclaims the oldest
+  // remaining last message, child 2's. Child 3's queued message is never
+  // reclaimed.
+  uint8_t status_type = GET_LAST;
+  request = BuildChildGetRequest(m_child_uid1, PID_QUEUED_MESSAGE,
+                                 &status_type, sizeof(status_type));
+  ExpectAckTimer(request.get());
+  EXPECT_EQ(2u, ProxyModel_BufferPoolExhaustedCount());
+  ExpectIdentifyMessage(m_child_uid3, GET_LAST, 1);
+
+  ExpectEmptyStatusMessages(m_child_uid1, GET_NEXT);
+  ExpectIdentifyMessage(m_child_uid3, GET_NEXT);
+  EXPECT_EQ(1u, ProxyModel_FreeBufferCount());
+
+  EXPECT_EQ(2u, Stats_Get("proxy.pool_exhausted"));
+  EXPECT_EQ(1u, Stats_Get("proxy.pool_nacks"));
+}
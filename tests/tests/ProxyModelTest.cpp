@@ -32,6 +32,7 @@
 #include "rdm.h"
 #include "rdm_buffer.h"
 #include "rdm_responder.h"
+#include "stats.h"
 #include "Array.h"
 #include "Matchers.h"
 #include "ModelTest.h"
@@ -60,6 +61,7 @@ class ProxyModelTest : public ModelTest {
     RDMResponderSettings settings;
     memcpy(settings.uid, TEST_UID, UID_LENGTH);
     RDMResponder_Initialize(&settings);
+    Stats_Initialize();
     ProxyModel_Initialize();
     PROXY_MODEL_ENTRY.activate_fn();
   }
@@ -267,3 +269,67 @@ TEST_F(ProxyModelTest, testdoubleQueuedMessage) {
   size = InvokeRDMHandler(request.get());
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 }
+
+TEST_F(ProxyModelTest, sharedBufferPool) {
+  const unsigned int pool_size = ProxyModel_FreeBufferCount();
+  EXPECT_LE(2u * 2u, pool_size);
+
+  unique_ptr<RDMRequest> request1 = BuildChildGetRequest(
+      m_child_uid1, PID_IDENTIFY_DEVICE);
+  unique_ptr<RDMRequest> request2 = BuildChildGetRequest(
+      m_child_uid2, PID_IDENTIFY_DEVICE);
+
+  unique_ptr<RDMResponse> response(BuildAckTimerResponse(
+      request1.get(), ACK_TIMER_TIME));
+  int size = InvokeRDMHandler(request1.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(pool_size - 1u, ProxyModel_FreeBufferCount());
+
+  response.reset(BuildAckTimerResponse(request2.get(), ACK_TIMER_TIME));
+  size = InvokeRDMHandler(request2.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(pool_size - 2u, ProxyModel_FreeBufferCount());
+
+  // A NACK doesn't consume a buffer.
+  response.reset(NackWithReason(
+      request1.get(), ola::rdm::NR_PROXY_BUFFER_FULL, 1));
+  size = InvokeRDMHandler(request1.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(pool_size - 2u, ProxyModel_FreeBufferCount());
+
+  // Fetch child 1's message, the buffer becomes the last message.
+  uint8_t status_type = ola::rdm::STATUS_ERROR;
+  unique_ptr<RDMRequest> get_queued_request = BuildChildGetRequest(
+      m_child_uid1, PID_QUEUED_MESSAGE, &status_type, sizeof(status_type));
+  uint8_t identify_device = 0;
+  response.reset(GetResponseWithPid(get_queued_request.get(),
+                                    PID_IDENTIFY_DEVICE,
+                                    &identify_device,
+                                    sizeof(identify_device)));
+  size = InvokeRDMHandler(get_queued_request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(pool_size - 2u, ProxyModel_FreeBufferCount());
+
+  // Queue another message for child 1, then fetch it. The previous last
+  // message is returned to the pool.
+  response.reset(BuildAckTimerResponse(request1.get(), ACK_TIMER_TIME));
+  size = InvokeRDMHandler(request1.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(pool_size - 3u, ProxyModel_FreeBufferCount());
+
+  response.reset(GetResponseWithPid(get_queued_request.get(),
+                                    PID_IDENTIFY_DEVICE,
+                                    &identify_device,
+                                    sizeof(identify_device)));
+  size = InvokeRDMHandler(get_queued_request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  EXPECT_EQ(pool_size - 2u, ProxyModel_FreeBufferCount());
+
+  EXPECT_EQ(0u, ProxyModel_BufferPoolExhaustedCount());
+  EXPECT_EQ(1u, ProxyModel_BufferPoolNackCount());
+
+  // The pool is reported in COMMAND_GET_STATS.
+  EXPECT_EQ(pool_size - 2u, Stats_Get("proxy.free_buffers"));
+  EXPECT_EQ(0u, Stats_Get("proxy.pool_exhausted"));
+  EXPECT_EQ(1u, Stats_Get("proxy.pool_nacks"));
+}
@@ -28,11 +28,14 @@
 
 #include "rdm_buffer.h"
 #include "rdm_handler.h"
+#include "rdm_responder.h"
 #include "utils.h"
 #include "Array.h"
 #include "Matchers.h"
 #include "TestHelpers.h"
+#include "TransceiverMock.h"
 
+using ::testing::InvokeWithoutArgs;
 using ::testing::Return;
 using ::testing::StrictMock;
 using ::testing::WithArgs;
@@ -256,6 +259,8 @@ TEST_F(RDMHandlerTest, testDispatching) {
   EXPECT_THAT(uid, MatchesUID(NULL_UID));
   RDMHandler_HandleRequest(reinterpret_cast<const RDMHeader*>(SAMPLE_MESSAGE),
                            nullptr);
+  RDMHandler_BeginDMXFrame();
+  RDMHandler_HandleDMXData(SAMPLE_MESSAGE, arraysize(SAMPLE_MESSAGE));
   RDMHandler_Tasks();
 
   EXPECT_TRUE(RDMHandler_AddModel(&FIRST_MODEL));
@@ -295,10 +300,17 @@ TEST_F(RDMHandlerTest, testDispatching) {
   EXPECT_TRUE(RDMHandler_SetActiveModel(MODEL_TWO));
   EXPECT_TRUE(RDMHandler_SetActiveModel(MODEL_TWO));
   EXPECT_CALL(m_second_model, Request(_, nullptr)).Times(1);
+  EXPECT_CALL(m_second_model, Ioctl(IOCTL_DMX_FRAME_START, nullptr, 0))
+    .WillOnce(Return(1));
+  EXPECT_CALL(m_second_model, Ioctl(IOCTL_DMX_DATA, _,
+                                    arraysize(SAMPLE_MESSAGE)))
+    .WillOnce(Return(1));
   EXPECT_CALL(m_second_model, Tasks()).Times(1);
 
   RDMHandler_HandleRequest(reinterpret_cast<const RDMHeader*>(SAMPLE_MESSAGE),
                            nullptr);
+  RDMHandler_BeginDMXFrame();
+  RDMHandler_HandleDMXData(SAMPLE_MESSAGE, arraysize(SAMPLE_MESSAGE));
   RDMHandler_Tasks();
 
   // Try an invalid model
@@ -331,6 +343,87 @@ TEST_F(RDMHandlerTest, testSendResponse) {
                            nullptr);
 }
 
+TEST_F(RDMHandlerTest, testAcquireBuffer) {
+  RDMHandlerSettings settings = {
+    .default_model = MODEL_ONE,
+    .send_callback = SendResponse
+  };
+  RDMHandler_Initialize(&settings);
+
+  StrictMock<MockTransceiver> transceiver_mock;
+  Transceiver_SetMock(&transceiver_mock);
+
+  uint8_t tx_buffer[RDM_MAX_FRAME_SIZE];
+  uint8_t *rdm_buffer = g_rdm_buffer;
+
+  // The response is built in the leased buffer, and committed rather than
+  // sent.
+  testing::InSequence seq;
+  EXPECT_CALL(m_first_model, Activate()).Times(1);
+  EXPECT_CALL(transceiver_mock, AcquireRDMResponseBuffer())
+    .WillOnce(Return(tx_buffer));
+  EXPECT_CALL(m_first_model, Request(_, nullptr))
+    .WillOnce(InvokeWithoutArgs([&]() {
+      EXPECT_EQ(tx_buffer, g_rdm_buffer);
+      return 26;
+    }));
+  EXPECT_CALL(transceiver_mock, CommitRDMResponse(true, 26))
+    .WillOnce(Return(true));
+
+  // No break.
+  EXPECT_CALL(transceiver_mock, AcquireRDMResponseBuffer())
+    .WillOnce(Return(tx_buffer));
+  EXPECT_CALL(m_first_model, Request(_, nullptr)).WillOnce(Return(-24));
+  EXPECT_CALL(transceiver_mock, CommitRDMResponse(false, 24))
+    .WillOnce(Return(true));
+
+  // No response releases the buffer.
+  EXPECT_CALL(transceiver_mock, AcquireRDMResponseBuffer())
+    .WillOnce(Return(tx_buffer));
+  EXPECT_CALL(m_first_model, Request(_, nullptr))
+    .WillOnce(Return(RDM_RESPONDER_NO_RESPONSE));
+  EXPECT_CALL(transceiver_mock, ReleaseRDMResponseBuffer()).Times(1);
+
+  EXPECT_TRUE(RDMHandler_AddModel(&FIRST_MODEL));
+  for (unsigned int i = 0; i < 3; i++) {
+    RDMHandler_HandleRequest(
+        reinterpret_cast<const RDMHeader*>(SAMPLE_MESSAGE), nullptr);
+    EXPECT_EQ(rdm_buffer, g_rdm_buffer);
+  }
+  Transceiver_SetMock(nullptr);
+}
+
+TEST_F(RDMHandlerTest, testAcquireBufferFailure) {
+  RDMHandlerSettings settings = {
+    .default_model = MODEL_ONE,
+    .send_callback = SendResponse
+  };
+  RDMHandler_Initialize(&settings);
+
+  StrictMock<MockTransceiver> transceiver_mock;
+  Transceiver_SetMock(&transceiver_mock);
+
+  uint8_t *rdm_buffer = g_rdm_buffer;
+
+  // Without a leased buffer, the response is built in g_rdm_buffer and sent
+  // with the callback.
+  testing::InSequence seq;
+  EXPECT_CALL(m_first_model, Activate()).Times(1);
+  EXPECT_CALL(transceiver_mock, AcquireRDMResponseBuffer())
+    .WillOnce(Return(nullptr));
+  EXPECT_CALL(m_first_model, Request(_, nullptr))
+    .WillOnce(InvokeWithoutArgs([&]() {
+      EXPECT_EQ(rdm_buffer, g_rdm_buffer);
+      return 26;
+    }));
+  EXPECT_CALL(m_sender_mock, SendResponse(true, _, 1)).Times(1);
+
+  EXPECT_TRUE(RDMHandler_AddModel(&FIRST_MODEL));
+  RDMHandler_HandleRequest(reinterpret_cast<const RDMHeader*>(SAMPLE_MESSAGE),
+                           nullptr);
+  Transceiver_SetMock(nullptr);
+}
+
 TEST_F(RDMHandlerTest, testGetSetModelId) {
   RDMHandlerSettings settings = {
     .default_model = MODEL_ONE,
@@ -218,6 +218,8 @@ class RDMResponderTest : public testing::Test {
   void InitDefinition(ResponderDefinition *def) {
     def->descriptors = nullptr;
     def->descriptor_count = 0;
+    def->set_all_descriptors = nullptr;
+    def->set_all_descriptor_count = 0;
     def->software_version_label = nullptr;
     def->manufacturer_label = nullptr;
     def->model_description = nullptr;
@@ -1045,6 +1047,80 @@ TEST_F(RDMResponderTest, ioctl) {
   EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_GET_UID, uid, arraysize(uid)));
 
   EXPECT_EQ(0, memcmp(TEST_UID, uid, UID_LENGTH));
+
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_REQUIRES_ACTION, uid, 0));
+  EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_REQUIRES_ACTION, uid, arraysize(uid)));
+
+  uint8_t other_uid[] = {0x7a, 0x70, 0x00, 0x00, 0x00, 0x01};
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_REQUIRES_ACTION, other_uid,
+                                  arraysize(other_uid)));
+
+  uint8_t broadcast_uid[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+  EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_REQUIRES_ACTION, broadcast_uid,
+                                  arraysize(broadcast_uid)));
+}
+
+TEST_F(RDMResponderTest, settingsIoctl) {
+  ResponderDefinition responder_def;
+  InitDefinition(&responder_def);
+  responder_def.default_device_label = "Test Device";
+  RDMResponder_ResetToFactoryDefaults();
+
+  ModelSettingsBlock block;
+  block.index = 0u;
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_GET_SETTINGS,
+                                  reinterpret_cast<uint8_t*>(&block), 0));
+  EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_GET_SETTINGS,
+                                  reinterpret_cast<uint8_t*>(&block),
+                                  sizeof(block)));
+  const uint8_t expected[] = {1, 0, 1, 'T', 'e', 's', 't', ' ', 'D', 'e',
+                              'v', 'i', 'c', 'e'};
+  EXPECT_THAT(ArrayTuple(block.data, block.length),
+              DataIs(expected, arraysize(expected)));
+
+  // Restoring the current settings doesn't clear the factory defaults flag.
+  EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_SET_SETTINGS,
+                                  reinterpret_cast<uint8_t*>(&block),
+                                  sizeof(block)));
+  EXPECT_TRUE(g_responder->using_factory_defaults);
+
+  const uint8_t new_settings[] = {2, 1, 0x10, 'L', 'a', 'b', 'e', 'l'};
+  memcpy(block.data, new_settings, arraysize(new_settings));
+  block.length = arraysize(new_settings);
+  EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_SET_SETTINGS,
+                                  reinterpret_cast<uint8_t*>(&block),
+                                  sizeof(block)));
+  EXPECT_FALSE(g_responder->using_factory_defaults);
+  EXPECT_EQ(2, g_responder->current_personality);
+  EXPECT_EQ(0x110, g_responder->dmx_start_address);
+  EXPECT_STREQ("Label", g_responder->device_label);
+
+  // Invalid settings are rejected.
+  const uint8_t bad_personality[] = {3, 0, 1};
+  memcpy(block.data, bad_personality, arraysize(bad_personality));
+  block.length = arraysize(bad_personality);
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_SET_SETTINGS,
+                                  reinterpret_cast<uint8_t*>(&block),
+                                  sizeof(block)));
+
+  const uint8_t bad_address[] = {1, 2, 1};
+  memcpy(block.data, bad_address, arraysize(bad_address));
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_SET_SETTINGS,
+                                  reinterpret_cast<uint8_t*>(&block),
+                                  sizeof(block)));
+
+  block.length = 2u;
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_SET_SETTINGS,
+                                  reinterpret_cast<uint8_t*>(&block),
+                                  sizeof(block)));
+
+  // Only block 0 is handled by the responder.
+  block.index = 1u;
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_GET_SETTINGS,
+                                  reinterpret_cast<uint8_t*>(&block),
+                                  sizeof(block)));
+  EXPECT_EQ(2, g_responder->current_personality);
+  EXPECT_EQ(0x110, g_responder->dmx_start_address);
 }
 
 TEST_F(RDMResponderTest, paramDescription) {
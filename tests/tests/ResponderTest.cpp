@@ -23,31 +23,57 @@
 #include <algorithm>
 #include <memory>
 
+#include "dmx_input.h"
 #include "responder.h"
 #include "receiver_counters.h"
 #include "Array.h"
 #include "Matchers.h"
 #include "RDMHandlerMock.h"
-#include "SPIRGBMock.h"
+#include "TransceiverMock.h"
 
-using ::testing::IgnoreResult;
+using ::testing::AnyNumber;
+using ::testing::InSequence;
 using ::testing::Return;
+using ::testing::SetArgPointee;
 using ::testing::StrictMock;
-using ::testing::WithArgs;
 using ::testing::_;
 
 class ResponderTest : public testing::Test {
  public:
   void SetUp() {
     RDMHandler_SetMock(&handler_mock);
-    SPIRGB_SetMock(&spi_mock);
+    Transceiver_SetMock(&transceiver_mock);
     Responder_Initialize();
     ReceiverCounters_ResetCounters();
+
+    SetDMXWindow(0, 512);
+    EXPECT_CALL(handler_mock, BeginDMXFrame()).Times(AnyNumber());
+    EXPECT_CALL(handler_mock, HandleDMXData(_, _)).Times(AnyNumber());
+  }
+
+  void SetDMXWindow(uint16_t start_slot, uint16_t footprint) {
+    const DMXWindow window = {
+      .start_slot = start_slot,
+      .footprint = footprint
+    };
+    EXPECT_CALL(handler_mock, GetDMXWindow(_))
+      .WillRepeatedly(SetArgPointee<0>(window));
   }
 
   void TearDown() {
     RDMHandler_SetMock(nullptr);
-    SPIRGB_SetMock(nullptr);
+    Transceiver_SetMock(nullptr);
+  }
+
+  void SendFrameTimeout(const uint8_t *frame, unsigned int size) {
+    TransceiverEvent event;
+    event.token = 0;
+    event.op = T_OP_RX;
+    event.result = T_RESULT_RX_FRAME_TIMEOUT;
+    event.data = frame;
+    event.length = size;
+    event.timing = NULL;
+    Responder_Receive(&event);
   }
 
   void SendFrame(const uint8_t *frame, unsigned int size,
@@ -69,7 +95,7 @@ class ResponderTest : public testing::Test {
 
  protected:
   StrictMock<MockRDMHandler> handler_mock;
-  MockSPIRGB spi_mock;
+  StrictMock<MockTransceiver> transceiver_mock;
 
   static const uint8_t TEST_UID[];
   static const uint8_t ASC_FRAME[];
@@ -110,6 +136,9 @@ const uint8_t ResponderTest::RDM_FRAME[] = {
 TEST_F(ResponderTest, rxSequence) {
   // The important bit here is that by interleaving different frames, the RDM
   // handler continues to be called when appropriate.
+  EXPECT_CALL(handler_mock, RequiresAction(RDM_FRAME + 3))
+    .Times(4)
+    .WillRepeatedly(Return(true));
   EXPECT_CALL(handler_mock, HandleRequest(
         reinterpret_cast<const RDMHeader*>(RDM_FRAME), NULL))
     .Times(4);
@@ -176,8 +205,8 @@ TEST_F(ResponderTest, rxSequence) {
 }
 
 TEST_F(ResponderTest, rdmChecksumMismatch) {
-  EXPECT_CALL(handler_mock, GetUID(_))
-    .WillOnce(WithArgs<0>(IgnoreResult(CopyUID(TEST_UID))));
+  EXPECT_CALL(handler_mock, RequiresAction(_))
+    .WillOnce(Return(true));
 
   const uint8_t bad_frame[] = {
     0xcc, 0x01, 0x18, 0x7a, 0x70, 0xff, 0xff, 0xff, 0xff, 0x7a, 0x70, 0x12,
@@ -189,6 +218,28 @@ TEST_F(ResponderTest, rdmChecksumMismatch) {
   EXPECT_EQ(1, ReceiverCounters_RDMChecksumInvalidCounter());
 }
 
+TEST_F(ResponderTest, rdmOtherDestination) {
+  EXPECT_CALL(handler_mock, RequiresAction(_))
+    .Times(2)
+    .WillRepeatedly(Return(false));
+  EXPECT_CALL(transceiver_mock, DiscardRXFrame()).Times(2);
+
+  SendFrame(RDM_FRAME, arraysize(RDM_FRAME));
+  EXPECT_EQ(1, ReceiverCounters_RDMFrames());
+  EXPECT_EQ(1, ReceiverCounters_RDMOtherDestination());
+
+  // Once the frame is discarded, the checksum isn't examined.
+  const uint8_t bad_frame[] = {
+    0xcc, 0x01, 0x18, 0x7a, 0x70, 0x00, 0x00, 0x00, 0x00, 0x7a, 0x70, 0x12,
+    0x34, 0x56, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x02, 0x00,
+    0xAB, 0xCD
+  };
+  SendFrame(bad_frame, arraysize(bad_frame), 4);
+  EXPECT_EQ(2, ReceiverCounters_RDMFrames());
+  EXPECT_EQ(2, ReceiverCounters_RDMOtherDestination());
+  EXPECT_EQ(0, ReceiverCounters_RDMChecksumInvalidCounter());
+}
+
 TEST_F(ResponderTest, badSubStartCode) {
   const uint8_t frame[] = {
     0xcc, 0x02, 0x18, 0x7a, 0x70, 0x00, 0x00, 0x00, 0x00, 0x7a, 0x70, 0x12,
@@ -210,6 +261,10 @@ TEST_F(ResponderTest, msgLenTooShort) {
 }
 
 TEST_F(ResponderTest, paramDataLenMismatch) {
+  EXPECT_CALL(handler_mock, RequiresAction(_))
+    .Times(2)
+    .WillRepeatedly(Return(true));
+
   const uint8_t frame[] = {
     0xcc, 0x01, 0x18, 0x7a, 0x70, 0x00, 0x00, 0x00, 0x00, 0x7a, 0x70, 0x12,
     0x34, 0x56, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x02, 0x01,
@@ -282,23 +337,107 @@ TEST_F(ResponderTest, dmxCounters) {
   EXPECT_EQ(45, ReceiverCounters_DMXMaximumSlotCount());
 }
 
-TEST_F(ResponderTest, SPIOutput) {
-  SPIRGBConfiguration spi_config;
-  spi_config.module_id = SPI_ID_1;
-  spi_config.baud_rate = 2000000;
-  spi_config.use_enhanced_buffering = false;
-  SPIRGB_Init(&spi_config);
-
-  EXPECT_CALL(spi_mock, BeginUpdate())
-    .Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(0, RED, 1)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(0, GREEN, 2)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(0, BLUE, 3)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(1, RED, 4)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(1, GREEN, 5)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(1, BLUE, 6)).Times(1);
-  EXPECT_CALL(spi_mock, CompleteUpdate())
-    .Times(1);
+TEST_F(ResponderTest, dmxData) {
+  {
+    InSequence seq;
+    EXPECT_CALL(handler_mock, BeginDMXFrame()).Times(1);
+    for (unsigned int i = 1; i < arraysize(DMX_FRAME); i++) {
+      EXPECT_CALL(handler_mock, HandleDMXData(DMX_FRAME + 1, i)).Times(1);
+    }
+  }
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+}
 
+TEST_F(ResponderTest, dmxDataChunked) {
+  {
+    InSequence seq;
+    EXPECT_CALL(handler_mock, HandleDMXData(LONG_DMX_FRAME + 1, 15)).Times(1);
+    EXPECT_CALL(handler_mock, HandleDMXData(LONG_DMX_FRAME + 1, 31)).Times(1);
+    EXPECT_CALL(handler_mock, HandleDMXData(LONG_DMX_FRAME + 1, 45)).Times(1);
+  }
+  SendFrame(LONG_DMX_FRAME, arraysize(LONG_DMX_FRAME), 16);
+
+  // Non-DMX frames aren't passed to the model.
+  EXPECT_CALL(handler_mock, BeginDMXFrame()).Times(0);
+  EXPECT_CALL(handler_mock, HandleDMXData(ASC_FRAME + 1, _)).Times(0);
+  SendFrame(ASC_FRAME, arraysize(ASC_FRAME));
+}
+
+TEST_F(ResponderTest, dmxWindow) {
+  // Slots 5 - 7.
+  SetDMXWindow(4, 3);
+  {
+    InSequence seq;
+    EXPECT_CALL(handler_mock, HandleDMXData(DMX_FRAME + 5, 1)).Times(1);
+    EXPECT_CALL(handler_mock, HandleDMXData(DMX_FRAME + 5, 2)).Times(1);
+    EXPECT_CALL(handler_mock, HandleDMXData(DMX_FRAME + 5, 3)).Times(1);
+  }
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+
+  // The counters still cover the whole frame.
+  EXPECT_EQ(55, ReceiverCounters_DMXLastChecksum());
+  EXPECT_EQ(10, ReceiverCounters_DMXLastSlotCount());
+
+  // A single chunk delivers the window once.
+  EXPECT_CALL(handler_mock, HandleDMXData(DMX_FRAME + 5, 3)).Times(1);
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME), arraysize(DMX_FRAME));
+
+  // A window that runs past the end of the frame.
+  SetDMXWindow(8, 10);
+  {
+    InSequence seq;
+    EXPECT_CALL(handler_mock, HandleDMXData(DMX_FRAME + 9, 1)).Times(1);
+    EXPECT_CALL(handler_mock, HandleDMXData(DMX_FRAME + 9, 2)).Times(1);
+  }
   SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+
+  // A window past the end of the frame, or with no footprint, is never
+  // delivered.
+  EXPECT_CALL(handler_mock, HandleDMXData(_, _)).Times(0);
+  SetDMXWindow(10, 10);
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+  SetDMXWindow(0, 0);
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+}
+
+TEST_F(ResponderTest, dmxInput) {
+  EXPECT_EQ(0u, DMXInput_GetFrame()->sequence);
+
+  // A DMX frame is published when the next frame starts.
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+  EXPECT_EQ(0u, DMXInput_LatestSequence());
+  SendFrame(ASC_FRAME, arraysize(ASC_FRAME));
+
+  const DMXInputFrame *frame = DMXInput_GetFrame();
+  EXPECT_EQ(1u, frame->sequence);
+  EXPECT_THAT(ArrayTuple(frame->slots, frame->slot_count),
+              DataIs(DMX_FRAME + 1, arraysize(DMX_FRAME) - 1));
+
+  // Non-DMX frames don't publish anything.
+  SendFrame(ASC_FRAME, arraysize(ASC_FRAME));
+  EXPECT_EQ(1u, DMXInput_LatestSequence());
+
+  // Or when the frame times out.
+  SendFrame(LONG_DMX_FRAME, arraysize(LONG_DMX_FRAME), 16);
+  SendFrameTimeout(LONG_DMX_FRAME, arraysize(LONG_DMX_FRAME));
+  frame = DMXInput_GetFrame();
+  EXPECT_EQ(2u, frame->sequence);
+  EXPECT_THAT(ArrayTuple(frame->slots, frame->slot_count),
+              DataIs(LONG_DMX_FRAME + 1, arraysize(LONG_DMX_FRAME) - 1));
+
+  // A full frame is published as soon as the last slot arrives.
+  uint8_t full_frame[DMX_FRAME_SIZE + 1];
+  for (unsigned int i = 0; i < arraysize(full_frame); i++) {
+    full_frame[i] = i;
+  }
+  full_frame[0] = NULL_START_CODE;
+  SendFrame(full_frame, arraysize(full_frame), 100);
+  EXPECT_EQ(3u, DMXInput_LatestSequence());
+  frame = DMXInput_GetFrame();
+  EXPECT_EQ(DMX_FRAME_SIZE, frame->slot_count);
+  EXPECT_EQ(255u, frame->slots[254]);
+
+  // And isn't published again when the next frame starts.
+  SendFrame(ASC_FRAME, arraysize(ASC_FRAME));
+  EXPECT_EQ(3u, DMXInput_LatestSequence());
 }
@@ -21,12 +21,16 @@
 #include <gtest/gtest.h>
 #include <vector>
 
+#include "coarse_timer.h"
 #include "spi_rgb.h"
 #include "Array.h"
 #include "Matchers.h"
+#include "plib_dma_mock.h"
 #include "plib_spi_mock.h"
 
 using ::testing::ElementsAreArray;
+using ::testing::InSequence;
+using ::testing::NiceMock;
 using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::StrictMock;
@@ -37,19 +41,49 @@ class SPIRGBTest : public testing::Test {
  public:
   void SetUp() {
     PLIB_SPI_SetMock(&spi_mock);
+    PLIB_DMA_SetMock(&dma_mock);
+    CoarseTimer_SetCounter(0);
   }
 
   void TearDown() {
     PLIB_SPI_SetMock(NULL);
+    PLIB_DMA_SetMock(NULL);
   }
 
   void AppendByte(uint8_t byte) {
     m_spi_data.push_back(byte);
   }
 
+  // Let the clock idle long enough for a WS2801 to latch the last frame.
+  void WaitForLatch() {
+    SPIRGB_Tasks();
+    CoarseTimer_SetCounter(CoarseTimer_GetTime() + WS2801_LATCH_TIME);
+  }
+
+  // Init in simple mode and capture everything written to the SPI module.
+  void InitSimpleMode() {
+    SPIRGBConfiguration config;
+    config.module_id = SPI_ID_1;
+    config.baud_rate = 2000000;
+    config.use_enhanced_buffering = false;
+    config.use_dma = false;
+
+    EXPECT_CALL(nice_spi_mock, IsBusy(SPI_ID_1))
+      .WillRepeatedly(Return(false));
+    EXPECT_CALL(nice_spi_mock, BufferWrite(SPI_ID_1, _))
+      .WillRepeatedly(WithArgs<1>(Invoke(this, &SPIRGBTest::AppendByte)));
+    PLIB_SPI_SetMock(&nice_spi_mock);
+    SPIRGB_Init(&config);
+  }
+
  protected:
   StrictMock<MockPeripheralSPI> spi_mock;
+  NiceMock<MockPeripheralSPI> nice_spi_mock;
+  StrictMock<MockPeripheralDMA> dma_mock;
   std::vector<uint8_t> m_spi_data;
+
+  // 500uS, plus one tick.
+  static const uint32_t WS2801_LATCH_TIME = 6;
 };
 
 TEST_F(SPIRGBTest, testSimpleMode) {
@@ -57,6 +91,7 @@ TEST_F(SPIRGBTest, testSimpleMode) {
   config.module_id = SPI_ID_1;
   config.baud_rate = 2000000;
   config.use_enhanced_buffering = false;
+  config.use_dma = false;
 
   EXPECT_CALL(spi_mock, BaudRateSet(SPI_ID_1, _, 2000000))
     .Times(1);
@@ -116,6 +151,7 @@ TEST_F(SPIRGBTest, testEnhancedMode) {
   config.module_id = SPI_ID_1;
   config.baud_rate = 4000000;
   config.use_enhanced_buffering = true;
+  config.use_dma = false;
 
   EXPECT_CALL(spi_mock, BaudRateSet(SPI_ID_1, _, 4000000))
     .Times(1);
@@ -171,3 +207,318 @@ TEST_F(SPIRGBTest, testEnhancedMode) {
   };
   EXPECT_THAT(m_spi_data, ElementsAreArray(expected2));
 }
+
+TEST_F(SPIRGBTest, pixelTypes) {
+  InitSimpleMode();
+
+  const uint8_t pixels[] = {255, 128, 0, 1, 2, 3};
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetPixels(0, pixels, 2);
+  SPIRGB_CompleteUpdate();
+  SPIRGB_Tasks();
+
+  const uint8_t lpd8806[] = {
+    0xc0, 0xff, 0x80, 0x81, 0x80, 0x81, 0
+  };
+  EXPECT_THAT(m_spi_data, ElementsAreArray(lpd8806));
+  m_spi_data.clear();
+
+  // Changing the type re-sends the frame.
+  SPIRGB_SetPixelType(SPIRGB_PIXEL_WS2801);
+  SPIRGB_Tasks();
+  EXPECT_THAT(m_spi_data, ElementsAreArray(pixels));
+  m_spi_data.clear();
+
+  SPIRGB_SetPixelType(SPIRGB_PIXEL_APA102);
+  WaitForLatch();
+  SPIRGB_Tasks();
+  const uint8_t apa102[] = {
+    0, 0, 0, 0, 0xff, 0, 128, 255, 0xff, 3, 2, 1, 0
+  };
+  EXPECT_THAT(m_spi_data, ElementsAreArray(apa102));
+  m_spi_data.clear();
+
+  // Nothing changed, so nothing is sent.
+  SPIRGB_Tasks();
+  EXPECT_TRUE(m_spi_data.empty());
+}
+
+TEST_F(SPIRGBTest, pixelCount) {
+  InitSimpleMode();
+  EXPECT_EQ(2u, SPIRGB_PixelCount());
+
+  SPIRGB_SetPixelCount(SPIRGB_MAX_PIXEL_COUNT + 1);
+  EXPECT_EQ(SPIRGB_MAX_PIXEL_COUNT, SPIRGB_PixelCount());
+
+  std::vector<uint8_t> pixels(3 * SPIRGB_MAX_PIXEL_COUNT);
+  for (unsigned int i = 0; i < pixels.size(); i++) {
+    pixels[i] = i * 2;
+  }
+
+  // Out of range pixels are ignored.
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetPixels(0, pixels.data(), SPIRGB_MAX_PIXEL_COUNT + 10);
+  SPIRGB_SetPixels(SPIRGB_MAX_PIXEL_COUNT, pixels.data(), 1);
+  SPIRGB_SetPixel(SPIRGB_MAX_PIXEL_COUNT, RED, 255);
+  SPIRGB_CompleteUpdate();
+  SPIRGB_Tasks();
+
+  // 170 pixels needs 6 latch bytes.
+  ASSERT_EQ(3u * SPIRGB_MAX_PIXEL_COUNT + 6u, m_spi_data.size());
+  for (unsigned int i = 0; i < SPIRGB_MAX_PIXEL_COUNT; i++) {
+    EXPECT_EQ(0x80 | pixels[3 * i + 1] >> 1, m_spi_data[3 * i]);
+    EXPECT_EQ(0x80 | pixels[3 * i] >> 1, m_spi_data[3 * i + 1]);
+    EXPECT_EQ(0x80 | pixels[3 * i + 2] >> 1, m_spi_data[3 * i + 2]);
+  }
+  for (unsigned int i = 3 * SPIRGB_MAX_PIXEL_COUNT; i < m_spi_data.size();
+       i++) {
+    EXPECT_EQ(0, m_spi_data[i]);
+  }
+}
+
+TEST_F(SPIRGBTest, colorCorrection) {
+  InitSimpleMode();
+  SPIRGB_SetPixelType(SPIRGB_PIXEL_WS2801);
+
+  const uint8_t pixels[] = {255, 128, 64, 0, 1, 192};
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetPixels(0, pixels, 2);
+  SPIRGB_CompleteUpdate();
+  SPIRGB_Tasks();
+  EXPECT_THAT(m_spi_data, ElementsAreArray(pixels));
+  m_spi_data.clear();
+
+  // Changing the gamma re-sends the frame.
+  SPIRGB_SetGamma(SPIRGB_GAMMA_2_2);
+  WaitForLatch();
+  SPIRGB_Tasks();
+  const uint8_t gamma_2_2[] = {255, 56, 12, 0, 0, 137};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(gamma_2_2));
+  m_spi_data.clear();
+
+  SPIRGB_SetGamma(SPIRGB_GAMMA_2_8);
+  WaitForLatch();
+  SPIRGB_Tasks();
+  const uint8_t gamma_2_8[] = {255, 37, 5, 0, 0, 115};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(gamma_2_8));
+  m_spi_data.clear();
+
+  // White balance scales each color.
+  SPIRGB_SetGamma(SPIRGB_GAMMA_LINEAR);
+  SPIRGB_SetWhiteBalance(255, 128, 0);
+  WaitForLatch();
+  SPIRGB_Tasks();
+  const uint8_t balanced[] = {255, 64, 0, 0, 0, 0};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(balanced));
+  m_spi_data.clear();
+
+  // The correction applies to the 7 bit chips as well.
+  SPIRGB_SetWhiteBalance(255, 255, 255);
+  SPIRGB_SetGamma(SPIRGB_GAMMA_2_2);
+  SPIRGB_SetPixelType(SPIRGB_PIXEL_LPD8806);
+  WaitForLatch();
+  SPIRGB_Tasks();
+  const uint8_t lpd8806[] = {0x80 | 28, 0x80 | 127, 0x80 | 6,
+                             0x80, 0x80, 0x80 | 68, 0};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(lpd8806));
+}
+
+TEST_F(SPIRGBTest, dithering) {
+  InitSimpleMode();
+  SPIRGB_SetPixelType(SPIRGB_PIXEL_WS2801);
+  SPIRGB_SetPixelCount(1);
+
+  // Input 1 maps to a quarter of an output step, 2 to 2.5 steps.
+  uint16_t curve[256];
+  for (unsigned int i = 0; i < 256; i++) {
+    curve[i] = i * 257;
+  }
+  curve[1] = 0x40;
+  curve[2] = 0x280;
+  SPIRGB_SetGammaCurve(curve);
+
+  const uint8_t pixel[] = {1, 2, 255};
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetPixels(0, pixel, 1);
+  SPIRGB_CompleteUpdate();
+
+  // Without dithering the fraction is truncated.
+  SPIRGB_Tasks();
+  const uint8_t truncated[] = {0, 2, 255};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(truncated));
+  m_spi_data.clear();
+  SPIRGB_Tasks();
+  EXPECT_TRUE(m_spi_data.empty());
+
+  // With dithering, frames are sent continuously and average to the
+  // corrected value.
+  SPIRGB_SetDithering(true);
+  unsigned int totals[3] = {0, 0, 0};
+  for (unsigned int frame = 0; frame < 8; frame++) {
+    WaitForLatch();
+    SPIRGB_Tasks();
+    ASSERT_EQ(3u, m_spi_data.size());
+    for (unsigned int i = 0; i < 3; i++) {
+      totals[i] += m_spi_data[i];
+    }
+    m_spi_data.clear();
+  }
+  EXPECT_EQ(2u, totals[0]);
+  EXPECT_EQ(20u, totals[1]);
+  EXPECT_EQ(8u * 255u, totals[2]);
+
+  SPIRGB_SetDithering(false);
+  WaitForLatch();
+  SPIRGB_Tasks();
+  EXPECT_THAT(m_spi_data, ElementsAreArray(truncated));
+  m_spi_data.clear();
+  SPIRGB_Tasks();
+  EXPECT_TRUE(m_spi_data.empty());
+}
+
+TEST_F(SPIRGBTest, latchGap) {
+  InitSimpleMode();
+  SPIRGB_SetPixelType(SPIRGB_PIXEL_WS2801);
+  SPIRGB_SetPixelCount(1);
+  SPIRGB_SetDithering(true);
+
+  SPIRGB_Tasks();
+  EXPECT_EQ(3u, m_spi_data.size());
+  m_spi_data.clear();
+
+  // The idle time doesn't start until the last byte has been shifted out.
+  EXPECT_CALL(nice_spi_mock, IsBusy(SPI_ID_1))
+    .WillOnce(Return(true))
+    .WillRepeatedly(Return(false));
+  SPIRGB_Tasks();
+  CoarseTimer_SetCounter(10);
+  SPIRGB_Tasks();
+  EXPECT_TRUE(m_spi_data.empty());
+
+  // Exactly 500uS isn't enough.
+  CoarseTimer_SetCounter(15);
+  SPIRGB_Tasks();
+  EXPECT_TRUE(m_spi_data.empty());
+
+  CoarseTimer_SetCounter(16);
+  SPIRGB_Tasks();
+  EXPECT_EQ(3u, m_spi_data.size());
+  m_spi_data.clear();
+
+  // Chips with latch bytes are sent back to back.
+  SPIRGB_SetPixelType(SPIRGB_PIXEL_LPD8806);
+  WaitForLatch();
+  SPIRGB_Tasks();
+  EXPECT_EQ(4u, m_spi_data.size());
+  m_spi_data.clear();
+  SPIRGB_Tasks();
+  EXPECT_EQ(4u, m_spi_data.size());
+}
+
+TEST_F(SPIRGBTest, frameInFlight) {
+  SPIRGBConfiguration config;
+  config.module_id = SPI_ID_1;
+  config.baud_rate = 2000000;
+  config.use_enhanced_buffering = true;
+  config.use_dma = false;
+
+  EXPECT_CALL(nice_spi_mock, BufferWrite(SPI_ID_1, _))
+    .WillRepeatedly(WithArgs<1>(Invoke(this, &SPIRGBTest::AppendByte)));
+  PLIB_SPI_SetMock(&nice_spi_mock);
+  SPIRGB_Init(&config);
+
+  // The buffer fills after 4 bytes.
+  EXPECT_CALL(nice_spi_mock, TransmitBufferIsFull(SPI_ID_1))
+    .WillOnce(Return(false))
+    .WillOnce(Return(false))
+    .WillOnce(Return(false))
+    .WillOnce(Return(false))
+    .WillOnce(Return(true))
+    .WillRepeatedly(Return(false));
+  SPIRGB_Tasks();
+  EXPECT_EQ(4u, m_spi_data.size());
+
+  // Updates while a frame is being sent don't corrupt it.
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetPixel(0, GREEN, 255);
+  SPIRGB_CompleteUpdate();
+  SPIRGB_Tasks();
+
+  const uint8_t expected[] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0,
+    0xff, 0x80, 0x80, 0x80, 0x80, 0x80, 0
+  };
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected));
+}
+
+TEST_F(SPIRGBTest, testDMAMode) {
+  SPIRGBConfiguration config;
+  config.module_id = SPI_ID_2;
+  config.baud_rate = 4000000;
+  config.use_enhanced_buffering = true;
+  config.use_dma = true;
+  config.dma_channel = DMA_CHANNEL_3;
+
+  EXPECT_CALL(nice_spi_mock,
+              FIFOInterruptModeSelect(
+                  SPI_ID_2,
+                  SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_NOT_FULL))
+    .Times(1);
+  EXPECT_CALL(nice_spi_mock, BufferWrite(_, _)).Times(0);
+  PLIB_SPI_SetMock(&nice_spi_mock);
+
+  EXPECT_CALL(dma_mock, Enable(DMA_ID_0)).Times(1);
+  EXPECT_CALL(dma_mock, ChannelXTriggerEnable(
+        DMA_ID_0, DMA_CHANNEL_3, DMA_CHANNEL_TRIGGER_TRANSFER_START))
+    .Times(1);
+  EXPECT_CALL(dma_mock, ChannelXStartIRQSet(DMA_ID_0, DMA_CHANNEL_3,
+                                            DMA_TRIGGER_SPI_2_TRANSMIT))
+    .Times(1);
+  EXPECT_CALL(dma_mock,
+              ChannelXDestinationStartAddressSet(DMA_ID_0, DMA_CHANNEL_3, _))
+    .Times(1);
+  EXPECT_CALL(dma_mock, ChannelXDestinationSizeSet(DMA_ID_0, DMA_CHANNEL_3, 1))
+    .Times(1);
+  EXPECT_CALL(dma_mock, ChannelXCellSizeSet(DMA_ID_0, DMA_CHANNEL_3, 1))
+    .Times(1);
+  SPIRGB_Init(&config);
+
+  {
+    InSequence seq;
+    EXPECT_CALL(dma_mock,
+                ChannelXSourceStartAddressSet(DMA_ID_0, DMA_CHANNEL_3, _))
+      .Times(1);
+    EXPECT_CALL(dma_mock, ChannelXSourceSizeSet(DMA_ID_0, DMA_CHANNEL_3, 7))
+      .Times(1);
+    EXPECT_CALL(dma_mock, ChannelXEnable(DMA_ID_0, DMA_CHANNEL_3))
+      .Times(1);
+    EXPECT_CALL(dma_mock, StartTransferSet(DMA_ID_0, DMA_CHANNEL_3))
+      .Times(1);
+  }
+  SPIRGB_Tasks();
+
+  // A new frame waits until the transfer completes.
+  SPIRGB_SetPixelType(SPIRGB_PIXEL_APA102);
+  EXPECT_CALL(dma_mock, ChannelXINTSourceFlagGet(
+        DMA_ID_0, DMA_CHANNEL_3, DMA_INT_BLOCK_TRANSFER_COMPLETE))
+    .WillOnce(Return(false))
+    .WillOnce(Return(true));
+  SPIRGB_Tasks();
+
+  {
+    InSequence seq;
+    EXPECT_CALL(dma_mock, ChannelXINTSourceFlagClear(
+          DMA_ID_0, DMA_CHANNEL_3, DMA_INT_BLOCK_TRANSFER_COMPLETE))
+      .Times(1);
+    EXPECT_CALL(dma_mock,
+                ChannelXSourceStartAddressSet(DMA_ID_0, DMA_CHANNEL_3, _))
+      .Times(1);
+    EXPECT_CALL(dma_mock, ChannelXSourceSizeSet(DMA_ID_0, DMA_CHANNEL_3, 13))
+      .Times(1);
+    EXPECT_CALL(dma_mock, ChannelXEnable(DMA_ID_0, DMA_CHANNEL_3))
+      .Times(1);
+    EXPECT_CALL(dma_mock, StartTransferSet(DMA_ID_0, DMA_CHANNEL_3))
+      .Times(1);
+  }
+  SPIRGB_Tasks();
+}
@@ -31,6 +31,7 @@
 #include "spi.h"
 
 #include "tests/sim/InterruptController.h"
+#include "tests/sim/PeripheralDMA.h"
 #include "tests/sim/PeripheralSPI.h"
 #include "tests/sim/Simulator.h"
 
@@ -50,6 +51,8 @@ extern "C" {
 
 // Declare the ISR symbols.
 void SPI_Event(void);
+void SPI_DMAEventA(void);
+void SPI_DMAEventB(void);
 
 #ifdef __cplusplus
 }
@@ -74,19 +77,25 @@ class SPITest : public testing::Test {
   SPITest()
       : m_callback(ola::NewCallback(&SPI_Tasks)),
         m_simulator(kClockSpeed),
-        m_spi(&m_simulator, &m_interrupt_controller) {
+        m_spi(&m_simulator, &m_interrupt_controller),
+        m_dma(&m_simulator, &m_interrupt_controller, &m_spi) {
   }
 
   void SetUp() {
     m_simulator.SetClockLimit(1000000, true);  // default to 1s
     g_event_handler = &m_event_handler;
     PLIB_SPI_SetMock(&m_spi);
+    PLIB_DMA_SetMock(&m_dma);
     SYS_INT_SetMock(&m_interrupt_controller);
 
     m_interrupt_controller.RegisterISR(INT_SOURCE_SPI_2_RECEIVE,
         NewCallback(&SPI_Event));
     m_interrupt_controller.RegisterISR(INT_SOURCE_SPI_2_TRANSMIT,
         NewCallback(&SPI_Event));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_DMA_1,
+        NewCallback(&SPI_DMAEventA));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_DMA_2,
+        NewCallback(&SPI_DMAEventB));
 
     m_simulator.AddTask(m_callback.get());
 
@@ -96,6 +105,7 @@ class SPITest : public testing::Test {
   void TearDown() {
     g_event_handler = nullptr;
     PLIB_SPI_SetMock(nullptr);
+    PLIB_DMA_SetMock(nullptr);
     SYS_INT_SetMock(nullptr);
 
     m_simulator.RemoveTask(m_callback.get());
@@ -107,6 +117,7 @@ class SPITest : public testing::Test {
   Simulator m_simulator;
   InterruptController m_interrupt_controller;
   PeripheralSPI m_spi;
+  PeripheralDMA m_dma;
 
   StrictMock<MockEventHandler> m_event_handler;
 
@@ -209,16 +220,144 @@ TEST_F(SPITest, bigTransfer) {
   EXPECT_THAT(m_spi.SentBytes(SPI_ID_2), ElementsAreArray(output));
 }
 
+TEST_F(SPITest, testQueueDepth) {
+  vector<uint8_t> outputs[SPI_TRANSFER_QUEUE_SIZE];
+  vector<uint8_t> expected;
+  for (unsigned int i = 0; i < SPI_TRANSFER_QUEUE_SIZE; i++) {
+    outputs[i] = {static_cast<uint8_t>(3 * i + 1),
+                  static_cast<uint8_t>(3 * i + 2),
+                  static_cast<uint8_t>(3 * i + 3)};
+    expected.insert(expected.end(), outputs[i].begin(), outputs[i].end());
+    EXPECT_TRUE(SPI_QueueTransfer(
+        outputs[i].data(), outputs[i].size(), nullptr, 0, &EventHandler));
+  }
+  uint8_t extra[] = {0xff};
+  EXPECT_FALSE(SPI_QueueTransfer(
+      extra, arraysize(extra), nullptr, 0, &EventHandler));
+  EXPECT_EQ(SPI_TRANSFER_QUEUE_SIZE, SPI_QueuedTransfers());
+
+  InSequence seq;
+  for (unsigned int i = 0; i < SPI_TRANSFER_QUEUE_SIZE - 1; i++) {
+    EXPECT_CALL(m_event_handler, Run(SPI_BEGIN_TRANSFER)).Times(1);
+    EXPECT_CALL(m_event_handler, Run(SPI_COMPLETE_TRANSFER)).Times(1);
+  }
+  EXPECT_CALL(m_event_handler, Run(SPI_BEGIN_TRANSFER)).Times(1);
+  EXPECT_CALL(m_event_handler, Run(SPI_COMPLETE_TRANSFER))
+    .WillOnce(InvokeWithoutArgs(&m_simulator, &Simulator::Stop));
+
+  m_simulator.Run();
+  EXPECT_THAT(m_spi.SentBytes(SPI_ID_2), ElementsAreArray(expected));
+  EXPECT_EQ(0u, SPI_QueuedTransfers());
+}
+
+TEST_F(SPITest, scatterGather) {
+  const uint8_t header[] = {0x80, 0x01};
+  const uint8_t payload[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  const uint8_t trailer[] = {0xaa};
+  const SPISegment segments[] = {
+    {header, nullptr, arraysize(header)},
+    {payload, nullptr, arraysize(payload)},
+    {nullptr, nullptr, 0},
+    {trailer, nullptr, arraysize(trailer)},
+  };
+  EXPECT_TRUE(SPI_QueueSegments(segments, arraysize(segments),
+                                &EventHandler));
+
+  EXPECT_CALL(m_event_handler, Run(SPI_BEGIN_TRANSFER)).Times(1);
+  EXPECT_CALL(m_event_handler, Run(SPI_COMPLETE_TRANSFER))
+    .WillOnce(InvokeWithoutArgs(&m_simulator, &Simulator::Stop));
+
+  m_simulator.Run();
+  const uint8_t expected[] = {
+    0x80, 0x01, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 0xaa
+  };
+  EXPECT_THAT(m_spi.SentBytes(SPI_ID_2), ElementsAreArray(expected));
+
+  // Each non-empty segment is a DMA block, split across the two channels.
+  EXPECT_EQ(2u, m_dma.BlockCount(DMA_CHANNEL_1));
+  EXPECT_EQ(1u, m_dma.BlockCount(DMA_CHANNEL_2));
+}
+
+TEST_F(SPITest, chainedSegmentsHaveNoGaps) {
+  const uint8_t segment1[] = {1, 2, 3};
+  const uint8_t segment2[] = {4, 5, 6};
+  const uint8_t segment3[] = {7, 8, 9};
+  const SPISegment segments[] = {
+    {segment1, nullptr, arraysize(segment1)},
+    {segment2, nullptr, arraysize(segment2)},
+    {segment3, nullptr, arraysize(segment3)},
+  };
+  EXPECT_TRUE(SPI_QueueSegments(segments, arraysize(segments),
+                                &EventHandler));
+
+  EXPECT_CALL(m_event_handler, Run(SPI_BEGIN_TRANSFER)).Times(1);
+  EXPECT_CALL(m_event_handler, Run(SPI_COMPLETE_TRANSFER))
+    .WillOnce(InvokeWithoutArgs(&m_simulator, &Simulator::Stop));
+
+  m_simulator.Run();
+  const uint8_t expected[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_THAT(m_spi.SentBytes(SPI_ID_2), ElementsAreArray(expected));
+
+  // The bus never idles between segments, so the transfer takes one byte time
+  // per byte, plus a few ticks to start and complete.
+  const uint64_t ticks_per_byte = 8 * kClockSpeed / 1000000;
+  EXPECT_GE(arraysize(expected) * ticks_per_byte + 4, m_simulator.Clock());
+  EXPECT_EQ(2u, m_dma.BlockCount(DMA_CHANNEL_1));
+  EXPECT_EQ(1u, m_dma.BlockCount(DMA_CHANNEL_2));
+}
+
+TEST_F(SPITest, fullDuplex) {
+  const uint8_t command[] = {0x03, 0x10};
+  const uint8_t tx_data[] = {0x11, 0x22, 0x33};
+  const uint8_t rx_data[] = {0xa1, 0xa2, 0xb1, 0xb2, 0xb3, 0xc1, 0xc2};
+  AddInputBytes(rx_data, arraysize(rx_data));
+
+  uint8_t duplex_input[3];
+  uint8_t read_input[2];
+  const SPISegment segments[] = {
+    {command, nullptr, arraysize(command)},
+    {tx_data, duplex_input, arraysize(tx_data)},
+    {nullptr, read_input, arraysize(read_input)},
+  };
+  EXPECT_TRUE(SPI_QueueSegments(segments, arraysize(segments),
+                                &EventHandler));
+
+  EXPECT_CALL(m_event_handler, Run(SPI_BEGIN_TRANSFER)).Times(1);
+  EXPECT_CALL(m_event_handler, Run(SPI_COMPLETE_TRANSFER))
+    .WillOnce(InvokeWithoutArgs(&m_simulator, &Simulator::Stop));
+
+  m_simulator.Run();
+  const uint8_t expected_tx[] = {0x03, 0x10, 0x11, 0x22, 0x33, 0, 0};
+  EXPECT_THAT(m_spi.SentBytes(SPI_ID_2), ElementsAreArray(expected_tx));
+
+  ArrayTuple duplex_bytes(duplex_input, arraysize(duplex_input));
+  EXPECT_THAT(duplex_bytes, DataIs(rx_data + 2, 3));
+  ArrayTuple read_bytes(read_input, arraysize(read_input));
+  EXPECT_THAT(read_bytes, DataIs(rx_data + 5, 2));
+}
+
+TEST_F(SPITest, invalidSegments) {
+  const SPISegment no_buffers[] = {{nullptr, nullptr, 4}};
+  EXPECT_FALSE(SPI_QueueSegments(no_buffers, arraysize(no_buffers),
+                                 &EventHandler));
+
+  uint8_t data[] = {1};
+  SPISegment too_many[SPI_MAX_SEGMENTS + 1];
+  for (unsigned int i = 0; i < arraysize(too_many); i++) {
+    too_many[i] = {data, nullptr, arraysize(data)};
+  }
+  EXPECT_FALSE(SPI_QueueSegments(too_many, arraysize(too_many),
+                                 &EventHandler));
+  EXPECT_EQ(0u, SPI_QueuedTransfers());
+}
+
 TEST_F(SPITest, testDoubleTransfer) {
   uint8_t output1[] = {1, 2, 3};
   uint8_t output2[] = {4, 5, 6};
-  uint8_t output3[] = {7, 8, 9};
   EXPECT_TRUE(SPI_QueueTransfer(
       output1, arraysize(output1), nullptr, 0, &EventHandler));
   EXPECT_TRUE(SPI_QueueTransfer(
       output2, arraysize(output2), nullptr, 0, &EventHandler));
-  EXPECT_FALSE(SPI_QueueTransfer(
-      output3, arraysize(output3), nullptr, 0, &EventHandler));
 
   InSequence seq;
   EXPECT_CALL(m_event_handler, Run(SPI_BEGIN_TRANSFER)).Times(1);
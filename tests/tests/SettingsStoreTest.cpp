@@ -0,0 +1,294 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SettingsStoreTest.cpp
+ * Tests for the SettingsStore code.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "FlashMock.h"
+#include "settings_store.h"
+
+namespace {
+
+const uint32_t BASE_ADDRESS = 0x9d070000;
+const uint32_t PAGE_SIZE = 256;
+const uint8_t PAGE_COUNT = 4;
+
+/*
+ * A NOR flash chip. Writes can only clear bits, and erases are counted per
+ * page.
+ */
+class FlashChip : public FlashInterface {
+ public:
+  FlashChip()
+      : m_data(PAGE_SIZE * PAGE_COUNT, 0),
+        m_erase_counts(PAGE_COUNT, 0),
+        m_write_count(0),
+        m_writes_until_failure(-1) {
+  }
+
+  bool ErasePage(uint32_t address) {
+    if (address < BASE_ADDRESS || (address - BASE_ADDRESS) % PAGE_SIZE ||
+        address - BASE_ADDRESS >= m_data.size()) {
+      return false;
+    }
+    std::fill(m_data.begin() + (address - BASE_ADDRESS),
+              m_data.begin() + (address - BASE_ADDRESS) + PAGE_SIZE, 0xff);
+    m_erase_counts[(address - BASE_ADDRESS) / PAGE_SIZE]++;
+    return true;
+  }
+
+  bool WriteWord(uint32_t address, uint32_t data) {
+    if (!ValidWordAddress(address) || m_writes_until_failure == 0) {
+      return false;
+    }
+    if (m_writes_until_failure > 0) {
+      m_writes_until_failure--;
+    }
+    uint32_t value;
+    memcpy(&value, &m_data[address - BASE_ADDRESS], sizeof(value));
+    value &= data;
+    memcpy(&m_data[address - BASE_ADDRESS], &value, sizeof(value));
+    m_write_count++;
+    return true;
+  }
+
+  uint32_t ReadWord(uint32_t address) {
+    if (!ValidWordAddress(address)) {
+      return 0;
+    }
+    uint32_t value;
+    memcpy(&value, &m_data[address - BASE_ADDRESS], sizeof(value));
+    return value;
+  }
+
+  unsigned int WriteCount() const { return m_write_count; }
+
+  unsigned int EraseCount(unsigned int page) const {
+    return m_erase_counts[page];
+  }
+
+  void FailAfterWrites(int writes) { m_writes_until_failure = writes; }
+
+ private:
+  std::vector<uint8_t> m_data;
+  std::vector<unsigned int> m_erase_counts;
+  unsigned int m_write_count;
+  int m_writes_until_failure;
+
+  bool ValidWordAddress(uint32_t address) const {
+    return address >= BASE_ADDRESS && address % sizeof(uint32_t) == 0 &&
+           address - BASE_ADDRESS + sizeof(uint32_t) <= m_data.size();
+  }
+};
+}  // namespace
+
+class SettingsStoreTest : public testing::Test {
+ public:
+  void SetUp() {
+    Flash_SetMock(&m_flash);
+  }
+
+  void TearDown() {
+    Flash_SetMock(nullptr);
+  }
+
+  bool Initialize() {
+    SettingsStoreConfiguration config = {
+      .base_address = BASE_ADDRESS,
+      .page_size = PAGE_SIZE,
+      .page_count = PAGE_COUNT
+    };
+    return SettingsStore_Initialize(&config);
+  }
+
+  void ExpectValue(uint8_t key, const std::string &expected) {
+    uint8_t data[SETTINGS_STORE_MAX_VALUE_SIZE];
+    unsigned int length = sizeof(data);
+    EXPECT_TRUE(SettingsStore_Get(key, data, &length)) << "key " << +key;
+    EXPECT_EQ(expected,
+              std::string(reinterpret_cast<char*>(data), length));
+  }
+
+  bool Set(uint8_t key, const std::string &value) {
+    return SettingsStore_Set(
+        key, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+  }
+
+ protected:
+  FlashChip m_flash;
+};
+
+TEST_F(SettingsStoreTest, invalidConfiguration) {
+  SettingsStoreConfiguration config = {
+    .base_address = BASE_ADDRESS,
+    .page_size = PAGE_SIZE,
+    .page_count = 2
+  };
+  EXPECT_FALSE(SettingsStore_Initialize(&config));
+
+  config.page_count = PAGE_COUNT;
+  config.page_size = 64;
+  EXPECT_FALSE(SettingsStore_Initialize(&config));
+
+  uint8_t data = 1;
+  EXPECT_FALSE(SettingsStore_Set(0, &data, sizeof(data)));
+}
+
+TEST_F(SettingsStoreTest, emptyStore) {
+  EXPECT_TRUE(Initialize());
+  // The flash started as all 0s, so every page was erased.
+  for (unsigned int i = 0; i < PAGE_COUNT; i++) {
+    EXPECT_EQ(1u, m_flash.EraseCount(i));
+  }
+  EXPECT_EQ(PAGE_COUNT - 1u, SettingsStore_FreePageCount());
+
+  uint8_t data[SETTINGS_STORE_MAX_VALUE_SIZE];
+  unsigned int length = sizeof(data);
+  EXPECT_FALSE(SettingsStore_Get(0, data, &length));
+
+  // Re-initializing doesn't erase anything.
+  EXPECT_TRUE(Initialize());
+  EXPECT_EQ(1u, m_flash.EraseCount(0));
+}
+
+TEST_F(SettingsStoreTest, setAndGet) {
+  EXPECT_TRUE(Initialize());
+  EXPECT_TRUE(Set(0, "Ja Rule"));
+  EXPECT_TRUE(Set(5, "a"));
+  EXPECT_TRUE(Set(SETTINGS_STORE_MAX_KEYS - 1,
+                  std::string(SETTINGS_STORE_MAX_VALUE_SIZE, 'x')));
+
+  ExpectValue(0, "Ja Rule");
+  ExpectValue(5, "a");
+  ExpectValue(SETTINGS_STORE_MAX_KEYS - 1,
+              std::string(SETTINGS_STORE_MAX_VALUE_SIZE, 'x'));
+
+  // Buffer too small.
+  uint8_t data[2];
+  unsigned int length = sizeof(data);
+  EXPECT_FALSE(SettingsStore_Get(0, data, &length));
+
+  // Invalid arguments.
+  EXPECT_FALSE(Set(SETTINGS_STORE_MAX_KEYS, "a"));
+  EXPECT_FALSE(Set(1, ""));
+  EXPECT_FALSE(Set(1, std::string(SETTINGS_STORE_MAX_VALUE_SIZE + 1, 'x')));
+
+  // The values survive a reset.
+  EXPECT_TRUE(Initialize());
+  ExpectValue(0, "Ja Rule");
+  ExpectValue(5, "a");
+  ExpectValue(SETTINGS_STORE_MAX_KEYS - 1,
+              std::string(SETTINGS_STORE_MAX_VALUE_SIZE, 'x'));
+}
+
+TEST_F(SettingsStoreTest, overwriteAndDelete) {
+  EXPECT_TRUE(Initialize());
+  EXPECT_TRUE(Set(1, "first"));
+  EXPECT_TRUE(Set(1, "second value"));
+  EXPECT_TRUE(Set(2, "other"));
+  ExpectValue(1, "second value");
+
+  EXPECT_TRUE(SettingsStore_Delete(2));
+  EXPECT_TRUE(SettingsStore_Delete(3));
+
+  uint8_t data[SETTINGS_STORE_MAX_VALUE_SIZE];
+  unsigned int length = sizeof(data);
+  EXPECT_FALSE(SettingsStore_Get(2, data, &length));
+
+  EXPECT_TRUE(Initialize());
+  ExpectValue(1, "second value");
+  EXPECT_FALSE(SettingsStore_Get(2, data, &length));
+}
+
+TEST_F(SettingsStoreTest, unchangedValueNotWritten) {
+  EXPECT_TRUE(Initialize());
+  EXPECT_TRUE(Set(1, "label"));
+  unsigned int writes = m_flash.WriteCount();
+  EXPECT_TRUE(Set(1, "label"));
+  EXPECT_EQ(writes, m_flash.WriteCount());
+  EXPECT_TRUE(Set(1, "label2"));
+  EXPECT_LT(writes, m_flash.WriteCount());
+}
+
+TEST_F(SettingsStoreTest, backgroundCompaction) {
+  EXPECT_TRUE(Initialize());
+
+  for (unsigned int i = 0; i < 500; i++) {
+    EXPECT_TRUE(Set(i % 4, "value " + std::to_string(i)));
+    SettingsStore_Tasks();
+    EXPECT_LE(1u, SettingsStore_FreePageCount());
+  }
+
+  for (unsigned int i = 0; i < 4; i++) {
+    ExpectValue(i, "value " + std::to_string(496 + i));
+  }
+
+  // The pages are used in a ring, so the wear is even.
+  unsigned int min_erases = m_flash.EraseCount(0);
+  unsigned int max_erases = m_flash.EraseCount(0);
+  for (unsigned int i = 1; i < PAGE_COUNT; i++) {
+    min_erases = std::min(min_erases, m_flash.EraseCount(i));
+    max_erases = std::max(max_erases, m_flash.EraseCount(i));
+  }
+  EXPECT_LT(5u, min_erases);
+  EXPECT_GE(1u, max_erases - min_erases);
+
+  EXPECT_TRUE(Initialize());
+  for (unsigned int i = 0; i < 4; i++) {
+    ExpectValue(i, "value " + std::to_string(496 + i));
+  }
+}
+
+TEST_F(SettingsStoreTest, synchronousCompaction) {
+  EXPECT_TRUE(Initialize());
+  EXPECT_TRUE(Set(10, "constant"));
+
+  // Without calling SettingsStore_Tasks(), writes compact on demand.
+  for (unsigned int i = 0; i < 200; i++) {
+    EXPECT_TRUE(Set(1, std::string(1 + i % 40, 'a' + i % 26)));
+  }
+  ExpectValue(10, "constant");
+  ExpectValue(1, std::string(1 + 199 % 40, 'a' + 199 % 26));
+
+  EXPECT_TRUE(Initialize());
+  ExpectValue(10, "constant");
+  ExpectValue(1, std::string(1 + 199 % 40, 'a' + 199 % 26));
+}
+
+TEST_F(SettingsStoreTest, interruptedWrite) {
+  EXPECT_TRUE(Initialize());
+  EXPECT_TRUE(Set(1, "original"));
+
+  // Fail after the header is written.
+  m_flash.FailAfterWrites(1);
+  EXPECT_FALSE(Set(1, "replacement"));
+  m_flash.FailAfterWrites(-1);
+
+  // The partial record is ignored after a reset.
+  EXPECT_TRUE(Initialize());
+  ExpectValue(1, "original");
+
+  // And new records are written after it.
+  EXPECT_TRUE(Set(1, "replacement"));
+  EXPECT_TRUE(Initialize());
+  ExpectValue(1, "replacement");
+}
@@ -0,0 +1,571 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *
+ * SimulatedBusTest.cpp
+ * Tests for the Transceiver with a bus of simulated responders.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "coarse_timer.h"
+#include "constants.h"
+#include "monotonic_clock.h"
+#include "rdm.h"
+#include "setting_macros.h"
+#include "transceiver.h"
+
+#include "tests/sim/CallAccounting.h"
+#include "tests/sim/InterruptController.h"
+#include "tests/sim/PeripheralCoreTimer.h"
+#include "tests/sim/PeripheralInputCapture.h"
+#include "tests/sim/PeripheralPorts.h"
+#include "tests/sim/PeripheralTimer.h"
+#include "tests/sim/PeripheralUART.h"
+#include "tests/sim/RS485Bus.h"
+#include "tests/sim/SignalGenerator.h"
+#include "tests/sim/Simulator.h"
+#include "tests/sim/Tracer.h"
+
+using ola::NewCallback;
+using std::map;
+using std::pair;
+using std::set;
+using std::string;
+using std::vector;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Declare the ISR symbols.
+void InputCaptureEvent(void);
+void Transceiver_TimerEvent();
+void Transceiver_UARTEvent();
+
+#ifdef __cplusplus
+}
+#endif
+
+// The coarse timer ISR, as in app.c.
+void TimerEvent() {
+  CoarseTimer_TimerEvent();
+  MonotonicClock_Update();
+}
+
+class SimulatedBusTest;
+
+SimulatedBusTest *g_test = nullptr;
+
+bool EventHandler(const TransceiverEvent *event);
+
+class SimulatedBusTest : public testing::Test {
+ public:
+  SimulatedBusTest()
+      : m_tx_callback(NewCallback(this, &SimulatedBusTest::GotByte)),
+        m_callback(NewCallback(this, &SimulatedBusTest::Tasks)),
+        m_simulator(kClockSpeed),
+        m_tracer(&m_simulator, kClockSpeed),
+        m_core_timer(&m_simulator),
+        m_timer(&m_simulator, &m_interrupt_controller),
+        m_ic(&m_simulator, &m_interrupt_controller),
+        m_uart(&m_simulator, &m_interrupt_controller, m_tx_callback.get()),
+        m_generator(&m_simulator, &m_ic, &m_uart, AS_IC_ID(2),
+                    AS_USART_ID(1), kClockSpeed, kBaudRate),
+        m_bus(&m_simulator, &m_generator, kClockSpeed, kBaudRate),
+        m_state_signal(m_tracer.AddSignal("state", 8, 0)),
+        m_result(T_RESULT_OK),
+        m_transaction_number(0) {
+  }
+
+  void GotByte(USART_MODULE_ID uart_id, uint8_t byte) {
+    if (uart_id == AS_USART_ID(1)) {
+      m_bus.ControllerByte(byte);
+    }
+  }
+
+  void Tasks() {
+    m_accounting.BeginTask();
+    Transceiver_Tasks();
+    m_accounting.EndTask();
+    m_tracer.SetSignal(m_state_signal, Transceiver_GetState());
+  }
+
+  void SetUp() {
+    g_test = this;
+    Harmony_SetCallObserver(&m_accounting);
+    m_interrupt_controller.SetCallAccounting(&m_accounting);
+    m_accounting.SetTracer(&m_tracer);
+    m_uart.TraceTX(AS_USART_ID(1), &m_tracer, "tx");
+    m_generator.TraceLine(&m_tracer, "rx");
+    m_ports.TracePin(PORT_CHANNEL_F, PORTS_BIT_POS_8, &m_tracer, "break");
+    m_ports.TracePin(PORT_CHANNEL_F, PORTS_BIT_POS_1, &m_tracer, "tx_enable");
+    m_ports.TracePin(PORT_CHANNEL_F, PORTS_BIT_POS_0, &m_tracer, "rx_enable");
+    PLIB_TMR_SetMock(&m_timer);
+    PLIB_IC_SetMock(&m_ic);
+    PLIB_USART_SetMock(&m_uart);
+    PLIB_PORTS_SetMock(&m_ports);
+    SYS_INT_SetMock(&m_interrupt_controller);
+    CORE_TIMER_SetMock(&m_core_timer);
+
+    m_interrupt_controller.RegisterISR(INT_SOURCE_TIMER_1,
+        NewCallback(&TimerEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_TIMER_3,
+        NewCallback(&Transceiver_TimerEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_INPUT_CAPTURE_2,
+        NewCallback(&InputCaptureEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_ERROR,
+        NewCallback(&Transceiver_UARTEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_TRANSMIT,
+        NewCallback(&Transceiver_UARTEvent));
+    m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_RECEIVE,
+        NewCallback(&Transceiver_UARTEvent));
+
+    m_simulator.AddTask(m_callback.get());
+
+    TransceiverHardwareSettings settings = {
+      .usart = AS_USART_ID(1),
+      .usart_vector = AS_USART_INTERRUPT_VECTOR(1),
+      .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(1),
+      .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(1),
+      .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(1),
+      .port = PORT_CHANNEL_F,
+      .break_bit = PORTS_BIT_POS_8,
+      .tx_enable_bit = PORTS_BIT_POS_1,
+      .rx_enable_bit = PORTS_BIT_POS_0,
+      .input_capture_module = AS_IC_ID(2),
+      .input_capture_vector = AS_IC_INTERRUPT_VECTOR(2),
+      .input_capture_source = AS_IC_INTERRUPT_SOURCE(2),
+      .timer_module_id = AS_TIMER_ID(3),
+      .timer_vector = AS_TIMER_INTERRUPT_VECTOR(3),
+      .timer_source = AS_TIMER_INTERRUPT_SOURCE(3),
+      .input_capture_timer = AS_IC_TMR_ID(3),
+    };
+    Transceiver_Initialize(&settings, &EventHandler, &EventHandler);
+
+    CoarseTimer_Settings timer_settings = {
+      .timer_id = AS_TIMER_ID(1),
+      .interrupt_source = AS_TIMER_INTERRUPT_SOURCE(1)
+    };
+    MonotonicClock_Initialize();
+    CoarseTimer_Initialize(&timer_settings);
+
+    ASSERT_TRUE(Transceiver_SetMode(T_MODE_CONTROLLER, 0));
+    Run();
+    ASSERT_EQ(T_RESULT_OK, m_result);
+    m_accounting.Reset();
+  }
+
+  void TearDown() {
+    WriteTrace();
+    g_test = nullptr;
+    Harmony_SetCallObserver(nullptr);
+    m_interrupt_controller.SetCallAccounting(nullptr);
+    PLIB_TMR_SetMock(nullptr);
+    PLIB_IC_SetMock(nullptr);
+    PLIB_USART_SetMock(nullptr);
+    PLIB_PORTS_SetMock(nullptr);
+    SYS_INT_SetMock(nullptr);
+    CORE_TIMER_SetMock(nullptr);
+    m_simulator.RemoveTask(m_callback.get());
+  }
+
+  // If SIM_TRACE_DIR is set, write the trace for each test to
+  // <test name>.vcd & <test name>.json in that directory.
+  void WriteTrace() {
+    const char *directory = getenv("SIM_TRACE_DIR");
+    if (!directory) {
+      return;
+    }
+    const string path = string(directory) + "/" +
+        testing::UnitTest::GetInstance()->current_test_info()->name();
+    std::ofstream vcd(path + ".vcd");
+    m_tracer.WriteVCD(&vcd);
+    std::ofstream json(path + ".json");
+    m_tracer.WriteChromeTrace(&json);
+  }
+
+  void Event(const TransceiverEvent *event) {
+    m_result = event->result;
+    m_response.assign(event->data, event->data + event->length);
+    m_accounting.EndFrame();
+    m_simulator.Stop();
+  }
+
+  // Run until the next transceiver event.
+  void Run() {
+    m_simulator.SetClockLimit(100000, true);
+    m_simulator.Run();
+  }
+
+  // Build a request, without the start code.
+  vector<uint8_t> BuildRequest(uint64_t dest, uint8_t command_class,
+                               uint16_t pid,
+                               const vector<uint8_t> &param_data) {
+    vector<uint8_t> frame = {RDM_START_CODE, RDM_SUB_START_CODE,
+                             static_cast<uint8_t>(24 + param_data.size())};
+    AppendUID(dest, &frame);
+    AppendUID(kControllerUID, &frame);
+    frame.push_back(m_transaction_number++);
+    frame.push_back(1);  // port ID
+    frame.push_back(0);  // message count
+    frame.push_back(0);  // sub device
+    frame.push_back(0);
+    frame.push_back(command_class);
+    frame.push_back(pid >> 8);
+    frame.push_back(pid & 0xff);
+    frame.push_back(param_data.size());
+    frame.insert(frame.end(), param_data.begin(), param_data.end());
+    uint16_t checksum = 0;
+    for (const auto &byte : frame) {
+      checksum += byte;
+    }
+    frame.push_back(checksum >> 8);
+    frame.push_back(checksum & 0xff);
+    return vector<uint8_t>(frame.begin() + 1, frame.end());
+  }
+
+  TransceiverOperationResult SendDUB(uint64_t lower, uint64_t upper) {
+    vector<uint8_t> bounds;
+    AppendUID(lower, &bounds);
+    AppendUID(upper, &bounds);
+    vector<uint8_t> request = BuildRequest(kBroadcastUID, DISCOVERY_COMMAND,
+                                           PID_DISC_UNIQUE_BRANCH, bounds);
+    EXPECT_TRUE(Transceiver_QueueRDMDUB(1, request.data(), request.size()));
+    Run();
+    return m_result;
+  }
+
+  TransceiverOperationResult SendRequest(uint64_t dest, uint8_t command_class,
+                                         uint16_t pid) {
+    vector<uint8_t> request = BuildRequest(dest, command_class, pid,
+                                           vector<uint8_t>());
+    const bool broadcast = dest == kBroadcastUID;
+    EXPECT_TRUE(Transceiver_QueueRDMRequest(1, request.data(), request.size(),
+                                            broadcast));
+    Run();
+    return m_result;
+  }
+
+  // Decode the DUB response in m_response.
+  bool DecodeDUBResponse(uint64_t *uid) const {
+    unsigned int offset = 0;
+    while (offset < m_response.size() && offset < 7 &&
+           m_response[offset] == 0xfe) {
+      offset++;
+    }
+    if (m_response.size() != offset + 17 || m_response[offset] != 0xaa) {
+      return false;
+    }
+    const uint8_t *data = m_response.data() + offset + 1;
+    uint16_t checksum = 0;
+    *uid = 0;
+    for (unsigned int i = 0; i < 6; i++) {
+      *uid = (*uid << 8) + (data[2 * i] & data[2 * i + 1]);
+      checksum += data[2 * i] + data[2 * i + 1];
+    }
+    return checksum == (((data[12] & data[13]) << 8) + (data[14] & data[15]));
+  }
+
+  // A simple binary search, as a Host would do it.
+  void Discover(uint64_t lower, uint64_t upper, set<uint64_t> *uids) {
+    while (SendDUB(lower, upper) == T_RESULT_RX_DATA) {
+      uint64_t uid;
+      if (DecodeDUBResponse(&uid)) {
+        if (SendRequest(uid, DISCOVERY_COMMAND, PID_DISC_MUTE) ==
+            T_RESULT_RX_DATA) {
+          uids->insert(uid);
+        }
+        continue;
+      }
+      if (lower == upper) {
+        return;
+      }
+      const uint64_t mid = lower + (upper - lower) / 2;
+      Discover(lower, mid, uids);
+      Discover(mid + 1, upper, uids);
+      return;
+    }
+  }
+
+ protected:
+  std::unique_ptr<PeripheralUART::TXCallback> m_tx_callback;
+  std::unique_ptr<ola::Callback0<void>> m_callback;
+
+  Simulator m_simulator;
+  Tracer m_tracer;
+  CallAccounting m_accounting;
+  InterruptController m_interrupt_controller;
+  PeripheralCoreTimer m_core_timer;
+  PeripheralTimer m_timer;
+  PeripheralInputCapture m_ic;
+  PeripheralPorts m_ports;
+  PeripheralUART m_uart;
+  SignalGenerator m_generator;
+  RS485Bus m_bus;
+  const Tracer::SignalId m_state_signal;
+
+  TransceiverOperationResult m_result;
+  vector<uint8_t> m_response;
+  uint8_t m_transaction_number;
+
+  static void AppendUID(uint64_t uid, vector<uint8_t> *output) {
+    for (int i = 5; i >= 0; i--) {
+      output->push_back((uid >> (8 * i)) & 0xff);
+    }
+  }
+
+  static const uint32_t kClockSpeed = 80000000;
+  static const uint32_t kBaudRate = 250000;
+  static const uint64_t kControllerUID = 0x7a7000000000;
+  static const uint64_t kBroadcastUID = 0xffffffffffff;
+  static const uint64_t kMaxUID = 0xfffffffffffe;
+};
+
+bool EventHandler(const TransceiverEvent *event) {
+  if (g_test) {
+    g_test->Event(event);
+  }
+  return true;
+}
+
+TEST_F(SimulatedBusTest, dubNoResponders) {
+  EXPECT_EQ(T_RESULT_RX_TIMEOUT, SendDUB(0, kMaxUID));
+  ASSERT_EQ(1u, m_bus.Transactions().size());
+  EXPECT_EQ(0u, m_bus.Transactions()[0].responders);
+}
+
+TEST_F(SimulatedBusTest, dubSingleResponder) {
+  m_bus.AddResponder(0x7a7000000001, 176, 0);
+
+  EXPECT_EQ(T_RESULT_RX_DATA, SendDUB(0, kMaxUID));
+  uint64_t uid = 0;
+  EXPECT_TRUE(DecodeDUBResponse(&uid));
+  EXPECT_EQ(0x7a7000000001u, uid);
+
+  // Out of range.
+  EXPECT_EQ(T_RESULT_RX_TIMEOUT, SendDUB(0x7a7000000002, kMaxUID));
+
+  ASSERT_EQ(2u, m_bus.Transactions().size());
+  const RS485Bus::Transaction &transaction = m_bus.Transactions()[0];
+  EXPECT_EQ(DISCOVERY_COMMAND, transaction.command_class);
+  EXPECT_EQ(PID_DISC_UNIQUE_BRANCH, transaction.param_id);
+  EXPECT_EQ(1u, transaction.responders);
+  EXPECT_FALSE(transaction.Collision());
+  // 38 slots at 44us each.
+  EXPECT_EQ(38u * 44u * 80u,
+            transaction.request_end - transaction.request_start);
+  EXPECT_EQ(176u * 80u,
+            transaction.response_start - transaction.request_end);
+  // 24 slots.
+  EXPECT_EQ(24u * 44u * 80u,
+            transaction.response_end - transaction.response_start);
+}
+
+TEST_F(SimulatedBusTest, dubCollision) {
+  m_bus.AddResponder(0x7a7000000001, 176, 0);
+  m_bus.AddResponder(0x7a7000000002, 200, 0);
+
+  EXPECT_EQ(T_RESULT_RX_DATA, SendDUB(0, kMaxUID));
+  uint64_t uid = 0;
+  EXPECT_FALSE(DecodeDUBResponse(&uid));
+
+  ASSERT_EQ(1u, m_bus.Transactions().size());
+  const RS485Bus::Transaction &transaction = m_bus.Transactions()[0];
+  EXPECT_EQ(2u, transaction.responders);
+  EXPECT_TRUE(transaction.Collision());
+  EXPECT_EQ(176u * 80u,
+            transaction.response_start - transaction.request_end);
+  EXPECT_EQ((24u * 44u + 24u) * 80u,
+            transaction.response_end - transaction.response_start);
+}
+
+TEST_F(SimulatedBusTest, muteAndGet) {
+  m_bus.AddResponder(0x7a7000000001, 176, 100);
+
+  EXPECT_EQ(T_RESULT_RX_DATA,
+            SendRequest(0x7a7000000001, DISCOVERY_COMMAND, PID_DISC_MUTE));
+  EXPECT_TRUE(m_bus.IsMuted(0x7a7000000001));
+  // The mute response, with a control field.
+  ASSERT_EQ(28u, m_response.size());
+  EXPECT_EQ(RDM_START_CODE, m_response[0]);
+  EXPECT_EQ(DISCOVERY_COMMAND_RESPONSE, m_response[20]);
+
+  // Muted responders don't reply to a DUB.
+  EXPECT_EQ(T_RESULT_RX_TIMEOUT, SendDUB(0, kMaxUID));
+
+  EXPECT_EQ(T_RESULT_RX_DATA,
+            SendRequest(0x7a7000000001, GET_COMMAND, PID_DEVICE_INFO));
+  ASSERT_EQ(26u, m_response.size());
+  EXPECT_EQ(GET_COMMAND_RESPONSE, m_response[20]);
+
+  // Broadcast un-mute, there is no response.
+  EXPECT_EQ(T_RESULT_RX_TIMEOUT,
+            SendRequest(kBroadcastUID, DISCOVERY_COMMAND, PID_DISC_UN_MUTE));
+  EXPECT_FALSE(m_bus.IsMuted(0x7a7000000001));
+
+  // Nothing responds to another UID.
+  EXPECT_EQ(T_RESULT_RX_TIMEOUT,
+            SendRequest(0x7a7000000002, GET_COMMAND, PID_DEVICE_INFO));
+}
+
+TEST_F(SimulatedBusTest, discovery) {
+  // UIDs which differ in the upper bits keep the number of branches, and the
+  // test run time, down.
+  const set<uint64_t> expected = {
+    0x1a7000000001, 0x5a7000000002, 0x9a7000000003, 0xda7000000004
+  };
+  m_bus.SetSeed(1);
+  for (const auto &uid : expected) {
+    m_bus.AddResponder(uid, 176, 400);
+  }
+
+  set<uint64_t> uids;
+  Discover(0, kMaxUID, &uids);
+  EXPECT_EQ(expected, uids);
+  for (const auto &uid : expected) {
+    EXPECT_TRUE(m_bus.IsMuted(uid));
+  }
+}
+
+TEST_F(SimulatedBusTest, callAccounting) {
+  m_bus.AddResponder(0x7a7000000001, 176, 0);
+  m_accounting.SetCost("PLIB_USART_TransmitterByteSend", 10);
+
+  EXPECT_EQ(T_RESULT_RX_DATA,
+            SendRequest(0x7a7000000001, GET_COMMAND, PID_DEVICE_INFO));
+  EXPECT_EQ(T_RESULT_RX_TIMEOUT,
+            SendRequest(0x7a7000000002, GET_COMMAND, PID_DEVICE_INFO));
+
+  // One frame per transaction.
+  ASSERT_EQ(2u, m_accounting.Frames().size());
+  for (const auto &frame : m_accounting.Frames()) {
+    const CallAccounting::Totals isrs = frame.ISRTotals();
+    EXPECT_LT(0u, isrs.invocations);
+    EXPECT_LT(0u, isrs.calls);
+    EXPECT_LT(0u, frame.tasks.invocations);
+    EXPECT_LT(0u, frame.tasks.calls);
+    EXPECT_LE(frame.tasks.max_cycles, frame.tasks.cycles);
+
+    unsigned int calls = 0;
+    for (const auto &iter : frame.function_calls) {
+      calls += iter.second;
+    }
+    EXPECT_EQ(isrs.calls + frame.tasks.calls, calls);
+
+    // Everything costs 1 cycle, apart from PLIB_USART_TransmitterByteSend.
+    const auto iter = frame.function_calls.find(
+        "PLIB_USART_TransmitterByteSend");
+    ASSERT_NE(frame.function_calls.end(), iter);
+    EXPECT_EQ(calls + 9u * iter->second, isrs.cycles + frame.tasks.cycles);
+  }
+
+  // The request is 26 slots. The response is received in the UART ISR.
+  const CallAccounting::FrameCost &frame = m_accounting.Frames()[0];
+  EXPECT_EQ(26u, frame.function_calls.at("PLIB_USART_TransmitterByteSend"));
+  EXPECT_LT(0u, frame.isrs.at(INT_SOURCE_USART_1_RECEIVE).invocations);
+}
+
+// Parse a VCD into the changes for each signal, as (time in ps, value).
+map<string, vector<pair<uint64_t, uint32_t>>> ParseVCD(const string &vcd) {
+  map<string, string> names;
+  map<string, vector<pair<uint64_t, uint32_t>>> signals;
+  std::istringstream input(vcd);
+  string line;
+  uint64_t time = 0;
+  while (std::getline(input, line)) {
+    std::istringstream tokens(line);
+    string token, width, identifier, name;
+    tokens >> token;
+    if (token == "$var") {
+      tokens >> token >> width >> identifier >> name;
+      names[identifier] = name;
+    } else if (token[0] == '#') {
+      time = std::stoull(token.substr(1));
+    } else if (token[0] == 'b') {
+      tokens >> identifier;
+      signals[names[identifier]].push_back(
+          std::make_pair(time, std::stoul(token.substr(1), nullptr, 2)));
+    } else if (token[0] == '0' || token[0] == '1') {
+      signals[names[token.substr(1)]].push_back(
+          std::make_pair(time, token[0] == '1'));
+    }
+  }
+  return signals;
+}
+
+TEST_F(SimulatedBusTest, trace) {
+  m_bus.AddResponder(0x7a7000000001, 176, 0);
+  EXPECT_EQ(T_RESULT_RX_DATA,
+            SendRequest(0x7a7000000001, GET_COMMAND, PID_DEVICE_INFO));
+
+  std::ostringstream vcd;
+  m_tracer.WriteVCD(&vcd);
+  auto signals = ParseVCD(vcd.str());
+  // Each signal has an initial value.
+  for (const auto &name : {"tx", "rx", "break", "tx_enable", "rx_enable",
+                           "state"}) {
+    EXPECT_LT(0u, signals[name].size()) << name;
+  }
+
+  // VCD times are in ps, so each clock cycle is 12.5ns. The simulator runs
+  // the peripherals & tracer in no particular order, so times can be a cycle
+  // out.
+  const uint64_t kCycle = 12500;
+
+  // The last break is the request. The transceiver shortens the 176us break
+  // & 12us mark by 140 & 270 cycles, to allow for the ISR latency on the
+  // hardware.
+  const auto &breaks = signals["break"];
+  ASSERT_LE(3u, breaks.size());
+  const auto &start = breaks[breaks.size() - 2];
+  const auto &end = breaks[breaks.size() - 1];
+  EXPECT_EQ(0u, start.second);
+  EXPECT_EQ(1u, end.second);
+  EXPECT_NEAR((176u * 80u - 140u) * kCycle, end.first - start.first, kCycle);
+
+  // The response break starts 176us after the request, which is the mark &
+  // 26 slots.
+  const auto &rx = signals["rx"];
+  ASSERT_LE(2u, rx.size());
+  EXPECT_EQ(0u, rx[1].second);
+  EXPECT_NEAR(((12u + 26u * 44u + 176u) * 80u - 270u) * kCycle,
+              rx[1].first - end.first, 2 * kCycle);
+
+  // The state machine went through a number of states.
+  EXPECT_LT(4u, signals["state"].size());
+
+  std::ostringstream json;
+  m_tracer.WriteChromeTrace(&json);
+  const string trace = json.str();
+  EXPECT_NE(string::npos,
+            trace.find("\"name\": \"Tasks\", \"ph\": \"X\""));
+  std::ostringstream rx_isr;
+  rx_isr << "\"args\": {\"name\": \"ISR " << INT_SOURCE_USART_1_RECEIVE
+         << "\"}";
+  EXPECT_NE(string::npos, trace.find(rx_isr.str()));
+  EXPECT_NE(string::npos,
+            trace.find("\"name\": \"break\", \"ph\": \"C\""));
+}
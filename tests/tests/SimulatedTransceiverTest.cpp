@@ -18,6 +18,7 @@
  * Copyright (C) 2015 Simon Newton
  */
 
+#include <string.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <ola/rdm/UID.h>
@@ -31,10 +32,12 @@
 #include "coarse_timer.h"
 #include "constants.h"
 #include "dmx_spec.h"
+#include "monotonic_clock.h"
 #include "setting_macros.h"
 #include "transceiver.h"
 
 #include "tests/sim/InterruptController.h"
+#include "tests/sim/PeripheralCoreTimer.h"
 #include "tests/sim/PeripheralInputCapture.h"
 #include "tests/sim/PeripheralTimer.h"
 #include "tests/sim/PeripheralUART.h"
@@ -82,6 +85,12 @@ uint8_t Transceiver_FreeBufferCount();
 }
 #endif
 
+// The coarse timer ISR, as in app.c.
+void TimerEvent() {
+  CoarseTimer_TimerEvent();
+  MonotonicClock_Update();
+}
+
 // Teach gmock how to print TransceiverEvents.
 ::std::ostream& operator<<(::std::ostream& os, const TransceiverEvent* event) {
     return os << "Event(token: " << event->token << ", op: " << event->op
@@ -180,6 +189,7 @@ class TransceiverTest : public testing::Test {
       : m_tx_callback(NewCallback(this, &TransceiverTest::GotByte)),
         m_callback(ola::NewCallback(&Transceiver_Tasks)),
         m_simulator(kClockSpeed),  // limit to 1s of CPU runtime.
+        m_core_timer(&m_simulator),
         m_timer(&m_simulator, &m_interrupt_controller),
         m_ic(&m_simulator, &m_interrupt_controller),
         m_uart(&m_simulator, &m_interrupt_controller, m_tx_callback.get()),
@@ -207,9 +217,10 @@ class TransceiverTest : public testing::Test {
     PLIB_IC_SetMock(&m_ic);
     PLIB_USART_SetMock(&m_uart);
     SYS_INT_SetMock(&m_interrupt_controller);
+    CORE_TIMER_SetMock(&m_core_timer);
 
     m_interrupt_controller.RegisterISR(INT_SOURCE_TIMER_1,
-        NewCallback(&CoarseTimer_TimerEvent));
+        NewCallback(&TimerEvent));
     m_interrupt_controller.RegisterISR(INT_SOURCE_TIMER_3,
         NewCallback(&Transceiver_TimerEvent));
     m_interrupt_controller.RegisterISR(INT_SOURCE_INPUT_CAPTURE_2,
@@ -230,6 +241,7 @@ class TransceiverTest : public testing::Test {
       .timer_id = AS_TIMER_ID(1),
       .interrupt_source = AS_TIMER_INTERRUPT_SOURCE(1)
     };
+    MonotonicClock_Initialize();
     CoarseTimer_Initialize(&timer_settings);
   }
 
@@ -252,6 +264,7 @@ class TransceiverTest : public testing::Test {
     PLIB_IC_SetMock(nullptr);
     PLIB_USART_SetMock(nullptr);
     SYS_INT_SetMock(nullptr);
+    CORE_TIMER_SetMock(nullptr);
 
     m_simulator.RemoveTask(m_callback.get());
   }
@@ -288,6 +301,7 @@ class TransceiverTest : public testing::Test {
 
   Simulator m_simulator;
   InterruptController m_interrupt_controller;
+  PeripheralCoreTimer m_core_timer;
   PeripheralTimer m_timer;
   PeripheralInputCapture m_ic;
   PeripheralUART m_uart;
@@ -912,8 +926,7 @@ TEST_F(TransceiverTest, responderRxInterSlotDelay) {
   m_generator.AddByte(40);
   m_generator.AddDelay(999999);  // 0.999999s
   m_generator.AddByte(50);
-  // This must be long enough for the coarse timer, which operates on 10s of
-  // millisecond.
+  // Longer than the 1s timeout, plus the allowance for the slot time.
   m_generator.AddDelay(1010000);  // 1.01s
   m_generator.AddByte(60);
 
@@ -1129,6 +1142,51 @@ TEST_F(TransceiverTest, responderRDMRequest) {
   EXPECT_THAT(m_tx_bytes, MatchesFrame(kRDMResponse, arraysize(kRDMResponse)));
 }
 
+TEST_F(TransceiverTest, responderRDMRequestInPlace) {
+  vector<uint8_t> rx_data;
+
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, _, Lt(arraysize(kRDMRequest)))))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(
+      m_event_handler,
+      Run(EventIs(0, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                  arraysize(kRDMRequest))))
+    .WillOnce(AppendTo(&rx_data));
+
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kRDMRequest, arraysize(kRDMRequest));
+
+  m_simulator.Run();
+
+  EXPECT_THAT(rx_data, ElementsAreArray(kRDMRequest, arraysize(kRDMRequest)));
+
+  // Only a single buffer can be leased at once.
+  uint8_t *buffer = Transceiver_AcquireRDMResponseBuffer();
+  ASSERT_TRUE(buffer != NULL);
+  EXPECT_TRUE(Transceiver_AcquireRDMResponseBuffer() == NULL);
+
+  // Releasing the buffer returns it to the pool.
+  Transceiver_ReleaseRDMResponseBuffer();
+  EXPECT_FALSE(Transceiver_CommitRDMResponse(true, arraysize(kRDMResponse)));
+  buffer = Transceiver_AcquireRDMResponseBuffer();
+  ASSERT_TRUE(buffer != NULL);
+
+  // Build the response in the TX buffer.
+  memcpy(buffer, kRDMResponse, arraysize(kRDMResponse));
+  EXPECT_TRUE(Transceiver_CommitRDMResponse(true, arraysize(kRDMResponse)));
+
+  m_generator.Reset();
+  m_generator.SetStopOnComplete(false);
+  StopAfter(arraysize(kRDMResponse));
+  m_simulator.Run();
+
+  EXPECT_THAT(m_tx_bytes, MatchesFrame(kRDMResponse, arraysize(kRDMResponse)));
+}
+
 TEST_F(TransceiverTest, responderRDMDUB) {
   vector<uint8_t> rx_data;
 
@@ -0,0 +1,91 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * StackMonitorTest.cpp
+ * Tests for the stack monitor.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include "stack_monitor.h"
+
+class StackMonitorTest : public testing::Test {
+ public:
+  void SetUp() {
+    StackMonitor_Settings settings = {
+      .limit = m_stack,
+      .top = m_stack + STACK_WORDS
+    };
+    StackMonitor_Initialize(&settings);
+  }
+
+  void Scan() {
+    // Enough calls to cover the whole stack.
+    for (unsigned int i = 0; i < STACK_WORDS; i++) {
+      StackMonitor_Tasks();
+    }
+  }
+
+ protected:
+  enum { STACK_WORDS = 256 };
+
+  static uint32_t m_stack[STACK_WORDS];
+};
+
+uint32_t StackMonitorTest::m_stack[STACK_WORDS];
+
+TEST_F(StackMonitorTest, unused) {
+  EXPECT_EQ(STACK_WORDS * 4u, StackMonitor_StackSize());
+  Scan();
+  EXPECT_EQ(0u, StackMonitor_PeakUsage());
+  EXPECT_EQ(STACK_WORDS * 4u, StackMonitor_FreeBytes());
+}
+
+TEST_F(StackMonitorTest, growth) {
+  m_stack[200] = 0;
+  Scan();
+  EXPECT_EQ(56u * 4u, StackMonitor_PeakUsage());
+  EXPECT_EQ(200u * 4u, StackMonitor_FreeBytes());
+
+  // Using less than the peak doesn't change anything.
+  m_stack[200] = 0xdeadbeef;
+  m_stack[220] = 0;
+  Scan();
+  EXPECT_EQ(56u * 4u, StackMonitor_PeakUsage());
+
+  // A single word written deep in the stack is found.
+  m_stack[3] = 1;
+  Scan();
+  EXPECT_EQ(253u * 4u, StackMonitor_PeakUsage());
+  EXPECT_EQ(3u * 4u, StackMonitor_FreeBytes());
+
+  // Reaching the limit.
+  m_stack[0] = 1;
+  Scan();
+  EXPECT_EQ(STACK_WORDS * 4u, StackMonitor_PeakUsage());
+  EXPECT_EQ(0u, StackMonitor_FreeBytes());
+}
+
+TEST_F(StackMonitorTest, incrementalScan) {
+  m_stack[100] = 0;
+
+  // Each call checks a fixed number of words.
+  StackMonitor_Tasks();
+  EXPECT_EQ(0u, StackMonitor_PeakUsage());
+
+  Scan();
+  EXPECT_EQ(156u * 4u, StackMonitor_PeakUsage());
+}
@@ -0,0 +1,126 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * StatsTest.cpp
+ * Tests for the statistics counters.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "stats.h"
+
+namespace {
+
+uint32_t g_value = 0;
+bool g_value_reset = false;
+
+uint32_t ReadValue(bool reset) {
+  g_value_reset = reset;
+  return g_value;
+}
+
+}  // namespace
+
+class StatsTest : public testing::Test {
+ public:
+  void SetUp() {
+    Stats_Initialize();
+    g_value = 0;
+    g_value_reset = false;
+  }
+};
+
+TEST_F(StatsTest, increment) {
+  StatsCounter tx_frames = 5;
+  StatsCounter queue_full;
+  EXPECT_TRUE(Stats_AddCounter("test.tx_frames", &tx_frames));
+  EXPECT_TRUE(Stats_AddCounter("test.queue_full", &queue_full));
+  EXPECT_EQ(2u, Stats_Count());
+  EXPECT_EQ(std::string("test.tx_frames"), Stats_Name(0));
+  EXPECT_EQ(std::string("test.queue_full"), Stats_Name(1));
+
+  // Counters are reset when they're added.
+  EXPECT_EQ(0u, Stats_Get("test.tx_frames"));
+
+  Stats_Increment(&tx_frames);
+  Stats_Increment(&tx_frames);
+  Stats_Increment(&queue_full);
+  EXPECT_EQ(2u, Stats_Get("test.tx_frames"));
+  EXPECT_EQ(1u, Stats_Get("test.queue_full"));
+  EXPECT_EQ(0u, Stats_Get("test.missing"));
+
+  Stats_Initialize();
+  EXPECT_EQ(0u, Stats_Count());
+}
+
+TEST_F(StatsTest, readAndReset) {
+  StatsCounter counter;
+  Stats_AddCounter("test.counter", &counter);
+  Stats_Increment(&counter);
+  Stats_Increment(&counter);
+
+  // Reading doesn't change the counter.
+  EXPECT_EQ(2u, Stats_Read(0, false));
+  EXPECT_EQ(2u, Stats_Read(0, false));
+
+  EXPECT_EQ(2u, Stats_Read(0, true));
+  EXPECT_EQ(0u, Stats_Read(0, false));
+
+  Stats_Increment(&counter);
+  EXPECT_EQ(1u, Stats_Read(0, true));
+}
+
+TEST_F(StatsTest, values) {
+  EXPECT_TRUE(Stats_AddValue("test.value", ReadValue));
+  g_value = 42;
+  EXPECT_EQ(42u, Stats_Read(0, false));
+  EXPECT_FALSE(g_value_reset);
+  EXPECT_EQ(42u, Stats_Read(0, true));
+  EXPECT_TRUE(g_value_reset);
+}
+
+TEST_F(StatsTest, reRegister) {
+  StatsCounter first, second;
+  Stats_AddCounter("test.counter", &first);
+  Stats_Increment(&first);
+
+  // A module which is re-initialized replaces its counter.
+  EXPECT_TRUE(Stats_AddCounter("test.counter", &second));
+  EXPECT_EQ(1u, Stats_Count());
+  Stats_Increment(&second);
+  Stats_Increment(&second);
+  EXPECT_EQ(2u, Stats_Get("test.counter"));
+}
+
+TEST_F(StatsTest, limits) {
+  StatsCounter counters[STATS_MAX_COUNTERS + 1];
+  std::string names[STATS_MAX_COUNTERS + 1];
+  for (unsigned int i = 0; i < STATS_MAX_COUNTERS; i++) {
+    names[i] = "test.counter" + std::to_string(i);
+    EXPECT_TRUE(Stats_AddCounter(names[i].c_str(), &counters[i]));
+  }
+  names[STATS_MAX_COUNTERS] = "test.extra";
+  EXPECT_FALSE(Stats_AddCounter(names[STATS_MAX_COUNTERS].c_str(),
+                                &counters[STATS_MAX_COUNTERS]));
+  EXPECT_EQ(static_cast<unsigned int>(STATS_MAX_COUNTERS), Stats_Count());
+
+  Stats_Initialize();
+  const std::string long_name(STATS_MAX_NAME_LENGTH + 1, 'x');
+  EXPECT_FALSE(Stats_AddCounter(long_name.c_str(), &counters[0]));
+  EXPECT_TRUE(Stats_AddCounter(long_name.substr(1).c_str(), &counters[0]));
+}
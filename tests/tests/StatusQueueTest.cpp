@@ -0,0 +1,162 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * StatusQueueTest.cpp
+ * Tests for the StatusQueue code.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include "rdm.h"
+#include "status_queue.h"
+
+namespace {
+
+const uint8_t RING_SIZE = 3;
+
+StatusMessage BuildMessage(uint16_t sub_device, uint8_t status_type,
+                           uint16_t message_id) {
+  StatusMessage message = {
+    .sub_device = sub_device,
+    .message_id = message_id,
+    .data_value1 = 0,
+    .data_value2 = 0,
+    .status_type = status_type
+  };
+  return message;
+}
+}  // namespace
+
+class StatusQueueTest : public testing::Test {
+ public:
+  void SetUp() {
+    StatusQueue_Initialize(&m_queue, m_storage, RING_SIZE);
+  }
+
+  bool Enqueue(uint16_t sub_device, uint8_t status_type, uint16_t message_id,
+               uint8_t threshold = STATUS_ADVISORY) {
+    StatusMessage message = BuildMessage(sub_device, status_type, message_id);
+    return StatusQueue_Enqueue(&m_queue, &message, threshold);
+  }
+
+ protected:
+  StatusMessage m_storage[STATUS_QUEUE_TYPE_COUNT * RING_SIZE];
+  StatusQueue m_queue;
+};
+
+TEST_F(StatusQueueTest, emptyQueue) {
+  StatusMessage message;
+  EXPECT_EQ(0u, StatusQueue_Count(&m_queue));
+  EXPECT_FALSE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+  EXPECT_FALSE(StatusQueue_Dequeue(&m_queue, STATUS_NONE, &message));
+  EXPECT_FALSE(StatusQueue_Dequeue(&m_queue, STATUS_GET_LAST_MESSAGE,
+                                   &message));
+}
+
+TEST_F(StatusQueueTest, priorityOrder) {
+  EXPECT_TRUE(Enqueue(1, STATUS_ADVISORY, 1));
+  EXPECT_TRUE(Enqueue(2, STATUS_WARNING_CLEARED, 2));
+  EXPECT_TRUE(Enqueue(3, STATUS_ERROR, 3));
+  EXPECT_TRUE(Enqueue(4, STATUS_ADVISORY, 4));
+  EXPECT_TRUE(Enqueue(5, STATUS_ERROR, 5));
+  EXPECT_EQ(5u, StatusQueue_Count(&m_queue));
+
+  // Errors first, in FIFO order, then warnings, then advisory.
+  const uint16_t expected[] = {3, 5, 2, 1, 4};
+  for (unsigned int i = 0; i < sizeof(expected) / sizeof(uint16_t); i++) {
+    StatusMessage message;
+    EXPECT_TRUE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+    EXPECT_EQ(expected[i], message.message_id);
+    EXPECT_EQ(expected[i], message.sub_device);
+  }
+  EXPECT_EQ(0u, StatusQueue_Count(&m_queue));
+}
+
+TEST_F(StatusQueueTest, requestedType) {
+  EXPECT_TRUE(Enqueue(1, STATUS_ADVISORY, 1));
+  EXPECT_TRUE(Enqueue(2, STATUS_WARNING, 2));
+
+  StatusMessage message;
+  EXPECT_FALSE(StatusQueue_Dequeue(&m_queue, STATUS_ERROR, &message));
+  EXPECT_TRUE(StatusQueue_Dequeue(&m_queue, STATUS_WARNING, &message));
+  EXPECT_EQ(2u, message.message_id);
+  EXPECT_FALSE(StatusQueue_Dequeue(&m_queue, STATUS_WARNING, &message));
+  EXPECT_TRUE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+  EXPECT_EQ(1u, message.message_id);
+}
+
+TEST_F(StatusQueueTest, threshold) {
+  EXPECT_FALSE(Enqueue(1, STATUS_ADVISORY, 1, STATUS_NONE));
+  EXPECT_FALSE(Enqueue(1, STATUS_ERROR, 1, STATUS_NONE));
+  EXPECT_FALSE(Enqueue(1, STATUS_ADVISORY, 1, STATUS_WARNING));
+  EXPECT_TRUE(Enqueue(1, STATUS_WARNING_CLEARED, 1, STATUS_WARNING));
+  EXPECT_TRUE(Enqueue(1, STATUS_ERROR, 1, STATUS_WARNING));
+  EXPECT_FALSE(Enqueue(1, STATUS_WARNING, 1, STATUS_ERROR));
+
+  // Invalid status types are never queued.
+  EXPECT_FALSE(Enqueue(1, STATUS_NONE, 1));
+  EXPECT_FALSE(Enqueue(1, STATUS_GET_LAST_MESSAGE, 1));
+  EXPECT_FALSE(Enqueue(1, 0x05, 1));
+  EXPECT_EQ(2u, StatusQueue_Count(&m_queue));
+}
+
+TEST_F(StatusQueueTest, overflow) {
+  for (unsigned int i = 0; i < RING_SIZE + 2; i++) {
+    EXPECT_TRUE(Enqueue(1, STATUS_WARNING, i));
+  }
+  EXPECT_TRUE(Enqueue(1, STATUS_ERROR, 100));
+  EXPECT_EQ(RING_SIZE + 1u, StatusQueue_Count(&m_queue));
+  EXPECT_EQ(2u, m_queue.overflow_count);
+
+  StatusMessage message;
+  EXPECT_TRUE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+  EXPECT_EQ(100u, message.message_id);
+
+  // The oldest warnings were dropped.
+  for (unsigned int i = 2; i < RING_SIZE + 2; i++) {
+    EXPECT_TRUE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+    EXPECT_EQ(i, message.message_id);
+  }
+  EXPECT_FALSE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+}
+
+TEST_F(StatusQueueTest, removeSubDevices) {
+  // Wrap the ring before removing.
+  EXPECT_TRUE(Enqueue(9, STATUS_ADVISORY, 0));
+  StatusMessage message;
+  EXPECT_TRUE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+
+  EXPECT_TRUE(Enqueue(1, STATUS_ADVISORY, 1));
+  EXPECT_TRUE(Enqueue(3, STATUS_ADVISORY, 2));
+  EXPECT_TRUE(Enqueue(5, STATUS_ADVISORY, 3));
+  EXPECT_TRUE(Enqueue(3, STATUS_ERROR, 4));
+
+  EXPECT_EQ(2u, StatusQueue_RemoveSubDevices(&m_queue, 2, 4));
+  EXPECT_EQ(0u, StatusQueue_RemoveSubDevices(&m_queue, 2, 4));
+  EXPECT_EQ(2u, StatusQueue_Count(&m_queue));
+
+  EXPECT_TRUE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+  EXPECT_EQ(1u, message.sub_device);
+  EXPECT_TRUE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+  EXPECT_EQ(5u, message.sub_device);
+  EXPECT_FALSE(StatusQueue_Dequeue(&m_queue, STATUS_ADVISORY, &message));
+
+  // Space is reclaimed.
+  for (unsigned int i = 0; i < RING_SIZE; i++) {
+    EXPECT_TRUE(Enqueue(1, STATUS_ADVISORY, i));
+  }
+  EXPECT_EQ(0u, m_queue.overflow_count);
+}
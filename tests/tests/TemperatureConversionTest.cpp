@@ -0,0 +1,67 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TemperatureConversionTest.cpp
+ * Tests for the temperature conversion code.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include "temperature_conversion.h"
+
+TEST(TemperatureConversionTest, decimate) {
+  uint16_t samples[TEMPERATURE_OVERSAMPLE_COUNT + 1];
+  for (unsigned int i = 0; i < TEMPERATURE_OVERSAMPLE_COUNT; i++) {
+    samples[i] = 1023;
+  }
+  // Only TEMPERATURE_OVERSAMPLE_COUNT samples are used.
+  samples[TEMPERATURE_OVERSAMPLE_COUNT] = 1023;
+  EXPECT_EQ(4092u, TemperatureConversion_Decimate(samples));
+
+  for (unsigned int i = 0; i < TEMPERATURE_OVERSAMPLE_COUNT; i++) {
+    samples[i] = 0;
+  }
+  EXPECT_EQ(0u, TemperatureConversion_Decimate(samples));
+
+  // The fractional part is dropped.
+  samples[0] = 3;
+  EXPECT_EQ(0u, TemperatureConversion_Decimate(samples));
+  samples[1] = 1;
+  EXPECT_EQ(1u, TemperatureConversion_Decimate(samples));
+}
+
+TEST(TemperatureConversionTest, boundaries) {
+  EXPECT_EQ(-205, TemperatureConversion_ToDeciDegrees(0));
+  EXPECT_EQ(641, TemperatureConversion_ToDeciDegrees(2048));
+  EXPECT_EQ(1487, TemperatureConversion_ToDeciDegrees(4095));
+}
+
+TEST(TemperatureConversionTest, rounding) {
+  // 42.77 & -163.81, truncating would give 42 & -163.
+  EXPECT_EQ(43, TemperatureConversion_ToDeciDegrees(600));
+  EXPECT_EQ(-164, TemperatureConversion_ToDeciDegrees(100));
+
+  // Either side of 0 degrees: -0.20 & 0.21.
+  EXPECT_EQ(0, TemperatureConversion_ToDeciDegrees(496));
+  EXPECT_EQ(0, TemperatureConversion_ToDeciDegrees(497));
+  EXPECT_EQ(84, TemperatureConversion_ToDeciDegrees(700));
+}
+
+TEST(TemperatureConversionTest, negativeSamples) {
+  // Once the calibration offset is removed, the sample may be negative.
+  EXPECT_EQ(-246, TemperatureConversion_ToDeciDegrees(-100));
+  EXPECT_EQ(-1897, TemperatureConversion_ToDeciDegrees(-4095));
+}
@@ -0,0 +1,299 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimerWheelTest.cpp
+ * Tests for the timer wheel.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <vector>
+
+#include "coarse_timer.h"
+#include "stats.h"
+#include "sys_int_mock.h"
+#include "timer_wheel.h"
+
+namespace {
+
+// Records when a timer fired.
+struct Recorder {
+  Recorder() : timer(), fire_count(0), fired_at(0), reschedule(0),
+               cancel(nullptr) {}
+
+  TimerWheel_Timer timer;
+  unsigned int fire_count;
+  uint32_t fired_at;
+  uint32_t reschedule;  // If non-0, reschedule with this delay.
+  TimerWheel_Timer *cancel;  // If set, cancel this timer.
+};
+
+void Fired(void *data) {
+  Recorder *recorder = static_cast<Recorder*>(data);
+  recorder->fire_count++;
+  recorder->fired_at = CoarseTimer_GetTime();
+  if (recorder->reschedule) {
+    TimerWheel_Schedule(&recorder->timer, recorder->reschedule, Fired,
+                        recorder);
+  }
+  if (recorder->cancel) {
+    TimerWheel_Cancel(recorder->cancel);
+  }
+}
+
+}  // namespace
+
+class TimerWheelTest : public testing::TestWithParam<uint32_t> {
+ public:
+  void SetUp() {
+    SYS_INT_SetMock(&m_sys_int_mock);
+    CoarseTimer_Settings timer_settings = {
+      .timer_id = TMR_ID_2,
+      .interrupt_source = INT_SOURCE_TIMER_2
+    };
+    CoarseTimer_Initialize(&timer_settings);
+    CoarseTimer_SetCounter(GetParam());
+    Stats_Initialize();
+    TimerWheel_Initialize();
+  }
+
+  void TearDown() {
+    SYS_INT_SetMock(nullptr);
+  }
+
+  void Schedule(Recorder *recorder, uint32_t delay) {
+    TimerWheel_Schedule(&recorder->timer, delay, Fired, recorder);
+  }
+
+  // Advance the clock by one tick at a time, running the tasks after each.
+  void Advance(uint32_t ticks) {
+    for (uint32_t i = 0; i < ticks; i++) {
+      CoarseTimer_TimerEvent();
+      TimerWheel_Tasks();
+    }
+  }
+
+  // Read the timer_wheel.max_lateness stat.
+  uint32_t MaxLateness(bool reset = false) {
+    for (unsigned int i = 0; i < Stats_Count(); i++) {
+      if (strcmp(Stats_Name(i), "timer_wheel.max_lateness") == 0) {
+        return Stats_Read(i, reset);
+      }
+    }
+    ADD_FAILURE() << "timer_wheel.max_lateness isn't registered";
+    return 0;
+  }
+
+  uint32_t Elapsed(uint32_t time) const {
+    return time - GetParam();
+  }
+
+ protected:
+  testing::NiceMock<MockSysInt> m_sys_int_mock;
+};
+
+TEST_P(TimerWheelTest, neverEarly) {
+  Recorder recorder;
+  EXPECT_FALSE(TimerWheel_IsScheduled(&recorder.timer));
+
+  Schedule(&recorder, 10);
+  EXPECT_TRUE(TimerWheel_IsScheduled(&recorder.timer));
+
+  TimerWheel_Tasks();
+  Advance(10);
+  EXPECT_EQ(0u, recorder.fire_count);
+
+  // Like CoarseTimer_HasElapsed, the timer fires once more than the delay has
+  // passed.
+  Advance(1);
+  EXPECT_EQ(1u, recorder.fire_count);
+  EXPECT_EQ(11u, Elapsed(recorder.fired_at));
+  EXPECT_FALSE(TimerWheel_IsScheduled(&recorder.timer));
+
+  Advance(100);
+  EXPECT_EQ(1u, recorder.fire_count);
+  EXPECT_EQ(0u, MaxLateness());
+}
+
+TEST_P(TimerWheelTest, initializeCancels) {
+  Recorder first, second;
+  Schedule(&first, 10);
+  Schedule(&second, 10);
+
+  TimerWheel_Initialize();
+  EXPECT_FALSE(TimerWheel_IsScheduled(&first.timer));
+  EXPECT_FALSE(TimerWheel_IsScheduled(&second.timer));
+
+  // The timers can be scheduled again.
+  Schedule(&second, 10);
+  Advance(11);
+  EXPECT_EQ(0u, first.fire_count);
+  EXPECT_EQ(1u, second.fire_count);
+}
+
+TEST_P(TimerWheelTest, zeroDelay) {
+  Recorder recorder;
+  Schedule(&recorder, 0);
+  TimerWheel_Tasks();
+  EXPECT_EQ(0u, recorder.fire_count);
+  Advance(1);
+  EXPECT_EQ(1u, recorder.fire_count);
+}
+
+TEST_P(TimerWheelTest, cancel) {
+  Recorder first, second;
+  // Both timers share a slot.
+  Schedule(&first, 20);
+  Schedule(&second, 20);
+  TimerWheel_Cancel(&first.timer);
+  EXPECT_FALSE(TimerWheel_IsScheduled(&first.timer));
+  // Cancelling twice is fine.
+  TimerWheel_Cancel(&first.timer);
+
+  Advance(100);
+  EXPECT_EQ(0u, first.fire_count);
+  EXPECT_EQ(1u, second.fire_count);
+}
+
+TEST_P(TimerWheelTest, reschedule) {
+  Recorder recorder;
+  Schedule(&recorder, 20);
+  Advance(10);
+  Schedule(&recorder, 20);
+  Advance(20);
+  EXPECT_EQ(0u, recorder.fire_count);
+  Advance(1);
+  EXPECT_EQ(1u, recorder.fire_count);
+  EXPECT_EQ(31u, Elapsed(recorder.fired_at));
+}
+
+TEST_P(TimerWheelTest, longDelays) {
+  // Delays which start in each level of the wheel.
+  const std::vector<uint32_t> delays = {
+    63, 64, 65, 100, 4095, 4096, 5000, 262143, 262144, 300000
+  };
+  std::vector<Recorder> recorders(delays.size());
+  for (unsigned int i = 0; i < delays.size(); i++) {
+    Schedule(&recorders[i], delays[i]);
+  }
+
+  // Step through the wheel a tick at a time.
+  uint32_t elapsed = 0;
+  while (elapsed < 300001) {
+    Advance(1);
+    elapsed++;
+    for (unsigned int i = 0; i < delays.size(); i++) {
+      ASSERT_EQ(elapsed > delays[i] ? 1u : 0u, recorders[i].fire_count)
+          << "Delay " << delays[i] << " at " << elapsed;
+    }
+  }
+  for (unsigned int i = 0; i < delays.size(); i++) {
+    EXPECT_EQ(delays[i] + 1, Elapsed(recorders[i].fired_at));
+  }
+}
+
+TEST_P(TimerWheelTest, maxDelay) {
+  Recorder recorder;
+  Schedule(&recorder, 0xffffffff);
+  CoarseTimer_SetCounter(GetParam() + TIMER_WHEEL_MAX_DELAY);
+  TimerWheel_Tasks();
+  EXPECT_EQ(0u, recorder.fire_count);
+  Advance(1);
+  EXPECT_EQ(1u, recorder.fire_count);
+}
+
+TEST_P(TimerWheelTest, catchUp) {
+  Recorder first, second, third;
+  Schedule(&first, 10);
+  Schedule(&second, 5000);
+  Schedule(&third, 6000);
+
+  // The main loop stalls, the overdue timers all run on the next pass.
+  CoarseTimer_SetCounter(GetParam() + 5500);
+  TimerWheel_Tasks();
+  EXPECT_EQ(1u, first.fire_count);
+  EXPECT_EQ(1u, second.fire_count);
+  EXPECT_EQ(0u, third.fire_count);
+
+  // The first timer was the latest.
+  EXPECT_EQ(5500u - 11u, MaxLateness(true));
+  EXPECT_EQ(0u, MaxLateness());
+
+  Advance(500);
+  EXPECT_EQ(0u, third.fire_count);
+  Advance(1);
+  EXPECT_EQ(1u, third.fire_count);
+  EXPECT_EQ(0u, MaxLateness());
+}
+
+TEST_P(TimerWheelTest, longStall) {
+  Recorder first, second, third, fourth;
+  Schedule(&first, 10);
+  Schedule(&second, 100000);
+  Schedule(&third, 300000);
+
+  // The wheel isn't run for 20s, e.g. while in controller mode.
+  CoarseTimer_SetCounter(GetParam() + 200000);
+  TimerWheel_Tasks();
+  EXPECT_EQ(1u, first.fire_count);
+  EXPECT_EQ(1u, second.fire_count);
+  EXPECT_EQ(0u, third.fire_count);
+  EXPECT_EQ(200000u - 11u, MaxLateness());
+
+  // The remaining timers still run on time.
+  Schedule(&fourth, 100);
+  Advance(100);
+  EXPECT_EQ(0u, fourth.fire_count);
+  Advance(1);
+  EXPECT_EQ(1u, fourth.fire_count);
+
+  Advance(100000 - 101);
+  EXPECT_EQ(0u, third.fire_count);
+  Advance(1);
+  EXPECT_EQ(1u, third.fire_count);
+  EXPECT_EQ(300001u, Elapsed(third.fired_at));
+}
+
+TEST_P(TimerWheelTest, periodic) {
+  Recorder recorder;
+  recorder.reschedule = 9;
+  Schedule(&recorder, 9);
+  Advance(100);
+  EXPECT_EQ(10u, recorder.fire_count);
+  EXPECT_EQ(100u, Elapsed(recorder.fired_at));
+  EXPECT_TRUE(TimerWheel_IsScheduled(&recorder.timer));
+
+  TimerWheel_Cancel(&recorder.timer);
+  Advance(100);
+  EXPECT_EQ(10u, recorder.fire_count);
+}
+
+TEST_P(TimerWheelTest, cancelFromCallback) {
+  Recorder first, second;
+  first.cancel = &second.timer;
+  // Both expire on the same tick, whichever runs first cancels the other.
+  Schedule(&second, 10);
+  Schedule(&first, 10);
+  Advance(20);
+  EXPECT_EQ(1u, first.fire_count);
+  EXPECT_EQ(0u, second.fire_count);
+}
+
+INSTANTIATE_TEST_CASE_P(InstantiationName,
+                        TimerWheelTest,
+                        ::testing::Values(0, 1, 63, 64, 4095, 0xfffffff0,
+                                          0xffffffff));
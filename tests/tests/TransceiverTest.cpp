@@ -22,13 +22,36 @@
 #include <gtest/gtest.h>
 
 #include "Array.h"
-#include "transceiver.h"
+#include "core_timer_mock.h"
+#include "monotonic_clock.h"
+#include "plib_ic_mock.h"
+#include "plib_tmr_mock.h"
+#include "plib_usart_mock.h"
 #include "setting_macros.h"
+#include "stats.h"
+#include "sys_int_mock.h"
+#include "transceiver.h"
+#include "transceiver_timing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Declare the ISR symbols.
+void InputCaptureEvent(void);
+void Transceiver_TimerEvent();
+void Transceiver_UARTEvent();
+
+#ifdef __cplusplus
+}
+#endif
 
 using ::testing::Args;
+using ::testing::NiceMock;
 using ::testing::StrictMock;
 using ::testing::Return;
 using ::testing::Field;
+using ::testing::Mock;
 using ::testing::_;
 
 MATCHER_P3(EventIs, token, op, result, "") {
@@ -127,6 +150,8 @@ TEST_F(TransceiverTest, testModeChanges) {
 
   // In controller mode the follow are not permitted
   EXPECT_FALSE(Transceiver_QueueRDMResponse(token, NULL, 0));
+  EXPECT_TRUE(Transceiver_AcquireRDMResponseBuffer() == NULL);
+  EXPECT_FALSE(Transceiver_CommitRDMResponse(true, 0));
   EXPECT_FALSE(Transceiver_QueueSelfTest(token));
 
   // Switch to self test mode.
@@ -152,6 +177,42 @@ TEST_F(TransceiverTest, testModeChanges) {
   EXPECT_FALSE(Transceiver_SetMode(T_MODE_CONTROLLER, ++token));
 }
 
+TEST_F(TransceiverTest, testIsIdle) {
+  TransceiverHardwareSettings settings = DefaultSettings();
+  Transceiver_Initialize(&settings, &EventHandler, &EventHandler);
+  NiceMock<MockCoreTimer> core_timer;
+  CORE_TIMER_SetMock(&core_timer);
+  MonotonicClock_Initialize();
+
+  // Waiting for a break, the line is idle once nothing has been received for
+  // the interval.
+  Transceiver_Tasks();
+  EXPECT_CALL(core_timer, CounterGet())
+      .WillRepeatedly(Return(MonotonicClock_MicroSecondsToTicks(99999)));
+  EXPECT_FALSE(Transceiver_IsIdle(1000));
+  EXPECT_CALL(core_timer, CounterGet())
+      .WillRepeatedly(Return(MonotonicClock_MicroSecondsToTicks(100000)));
+  EXPECT_TRUE(Transceiver_IsIdle(1000));
+
+  uint8_t token = 1;
+  EXPECT_TRUE(Transceiver_SetMode(T_MODE_CONTROLLER, token));
+  EXPECT_FALSE(Transceiver_IsIdle(0));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_MODE_CHANGE, T_RESULT_OK)))
+    .WillOnce(Return(true));
+  Transceiver_Tasks();
+  Transceiver_Tasks();
+  EXPECT_TRUE(Transceiver_IsIdle(0));
+
+  // Once a frame is queued, the line is busy until it's been sent.
+  const uint8_t dmx[] = {1, 2, 3};
+  EXPECT_TRUE(Transceiver_QueueDMX(++token, dmx, arraysize(dmx)));
+  EXPECT_FALSE(Transceiver_IsIdle(0));
+  Transceiver_Tasks();
+  EXPECT_FALSE(Transceiver_IsIdle(0));
+  CORE_TIMER_SetMock(nullptr);
+}
+
 TEST_F(TransceiverTest, testSetBreakTime) {
   TransceiverHardwareSettings settings = DefaultSettings();
   Transceiver_Initialize(&settings, NULL, NULL);
@@ -263,3 +324,138 @@ TEST_F(TransceiverTest, testSetResponderJitter) {
   EXPECT_EQ(11000, Transceiver_GetRDMResponderDelay());
   EXPECT_EQ(9000, Transceiver_GetRDMResponderJitter());
 }
+
+/*
+ * Drive the controller through an RDM request with the Harmony mocks.
+ */
+class TransceiverControllerTest : public TransceiverTest {
+ public:
+  void SetUp() {
+    TransceiverTest::SetUp();
+    SYS_INT_SetMock(&m_sys_int);
+    PLIB_IC_SetMock(&m_ic);
+    PLIB_TMR_SetMock(&m_timer);
+    PLIB_USART_SetMock(&m_usart);
+    m_settings = DefaultSettings();
+  }
+
+  void TearDown() {
+    SYS_INT_SetMock(nullptr);
+    PLIB_IC_SetMock(nullptr);
+    PLIB_TMR_SetMock(nullptr);
+    PLIB_USART_SetMock(nullptr);
+    TransceiverTest::TearDown();
+  }
+
+  /*
+   * @brief Send a GET request and receive the break & mark of the response.
+   *
+   * Once this returns the transceiver is waiting for the response data.
+   */
+  void SendRequest(uint8_t token) {
+    Stats_Initialize();
+    Transceiver_Initialize(&m_settings, &EventHandler, &EventHandler);
+
+    EXPECT_TRUE(Transceiver_SetMode(T_MODE_CONTROLLER, token));
+    EXPECT_CALL(m_event_handler,
+                Run(EventIs(token, T_OP_MODE_CHANGE, T_RESULT_OK)))
+      .WillOnce(Return(true));
+    Transceiver_Tasks();
+
+    const uint8_t request[] = {0xcc, 0x01, 0x18};
+    EXPECT_TRUE(Transceiver_QueueRDMRequest(token, request,
+                                            arraysize(request), false));
+    Transceiver_Tasks();
+    Transceiver_TimerEvent();  // break -> mark
+    Transceiver_TimerEvent();  // mark -> data
+
+    ON_CALL(m_sys_int, SourceStatusGet(m_settings.usart_tx_source))
+        .WillByDefault(Return(true));
+    Transceiver_UARTEvent();  // data -> drain
+    Transceiver_UARTEvent();  // drain -> wait for break
+    ON_CALL(m_sys_int, SourceStatusGet(m_settings.usart_tx_source))
+        .WillByDefault(Return(false));
+
+    // The responder sends a break & mark.
+    EXPECT_CALL(m_ic, BufferIsEmpty(m_settings.input_capture_module))
+        .WillOnce(Return(false))
+        .WillOnce(Return(false))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+    EXPECT_CALL(m_ic, Buffer16BitGet(m_settings.input_capture_module))
+        .WillOnce(Return(0))
+        .WillOnce(Return(CONTROLLER_RX_BREAK_TIME_MIN))
+        .WillOnce(Return(CONTROLLER_RX_BREAK_TIME_MIN + 100));
+    InputCaptureEvent();
+
+    ON_CALL(m_sys_int, SourceStatusGet(m_settings.usart_rx_source))
+        .WillByDefault(Return(true));
+  }
+
+ protected:
+  TransceiverHardwareSettings m_settings;
+  NiceMock<MockSysInt> m_sys_int;
+  NiceMock<MockPeripheralInputCapture> m_ic;
+  NiceMock<MockPeripheralTimer> m_timer;
+  NiceMock<MockPeripheralUSART> m_usart;
+};
+
+TEST_F(TransceiverControllerTest, testRXComplete) {
+  const uint8_t token = 1;
+  SendRequest(token);
+
+  // The first 3 bytes of the response give us the expected length.
+  EXPECT_CALL(m_usart, ReceiverDataIsAvailable(m_settings.usart))
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+  EXPECT_CALL(m_usart, ReceiverByteReceive(m_settings.usart))
+      .WillOnce(Return(0xcc))
+      .WillOnce(Return(0x01))
+      .WillOnce(Return(0x18));
+  EXPECT_CALL(m_timer, Stop(_)).Times(0);
+  Transceiver_UARTEvent();
+  Mock::VerifyAndClearExpectations(&m_timer);
+  Mock::VerifyAndClearExpectations(&m_usart);
+
+  // Once the rest of the response arrives, the timer must be stopped so the
+  // next request doesn't change the prescaler on a running timer.
+  EXPECT_CALL(m_usart, ReceiverDataIsAvailable(m_settings.usart))
+      .WillRepeatedly(Return(false));
+  for (unsigned int i = 0; i < 0x18 + 2 - 3; i++) {
+    EXPECT_CALL(m_usart, ReceiverDataIsAvailable(m_settings.usart))
+        .WillOnce(Return(true))
+        .RetiresOnSaturation();
+  }
+  EXPECT_CALL(m_timer, Stop(m_settings.timer_module_id));
+  EXPECT_CALL(m_usart, ReceiverDisable(m_settings.usart));
+  Transceiver_UARTEvent();
+  Mock::VerifyAndClearExpectations(&m_timer);
+  Mock::VerifyAndClearExpectations(&m_usart);
+  EXPECT_EQ(0u, Stats_Get("transceiver.rx_overflows"));
+
+  EXPECT_CALL(m_event_handler, Run(Field(&TransceiverEvent::token, token)))
+    .WillOnce(Return(true));
+  Transceiver_Tasks();
+}
+
+TEST_F(TransceiverControllerTest, testRXOverflow) {
+  const uint8_t token = 1;
+  SendRequest(token);
+
+  // The responder sends more data than fits in the buffer, without a valid
+  // RDM header. The timer must be stopped along with the UART.
+  ON_CALL(m_usart, ReceiverDataIsAvailable(m_settings.usart))
+      .WillByDefault(Return(true));
+  EXPECT_CALL(m_timer, Stop(m_settings.timer_module_id));
+  EXPECT_CALL(m_usart, ReceiverDisable(m_settings.usart));
+  Transceiver_UARTEvent();
+  Mock::VerifyAndClearExpectations(&m_timer);
+  Mock::VerifyAndClearExpectations(&m_usart);
+  EXPECT_EQ(1u, Stats_Get("transceiver.rx_overflows"));
+
+  EXPECT_CALL(m_event_handler, Run(Field(&TransceiverEvent::token, token)))
+    .WillOnce(Return(true));
+  Transceiver_Tasks();
+}
@@ -19,7 +19,7 @@
  * "Copyright (C) 1986 Gary S. Brown. You may use this program, or code or
  * tables extracted from it, as desired without restriction."
  *
- * The updcrc macro (referred to here as CalculateCRC) is derived from an
+ * The updcrc macro (referred to here as DFU_CalculateCRC) is derived from an
  * article copyright 1986 by Stephen Satchell.
  *
  * Remainder portions of the code are copyright (C) 2015 Simon Newton.
@@ -43,8 +43,6 @@
 
 static const uint32_t HEADER_VERSION = 1u;
 
-static const uint32_t INITIAL_CRC = 0xffffffff;
-
 /**
  * @brief The manufacturer defined firmware-data header.
  *
@@ -106,11 +104,8 @@ static const uint32_t CRC_POLYNOMIAL[] = {
   0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
 };
 
-/**
- * @brief Calculate the DFU CRC.
- */
-static uint32_t CalculateCRC(uint32_t crc, const uint8_t *data,
-                             unsigned int size) {
+uint32_t DFU_CalculateCRC(uint32_t crc, const uint8_t *data,
+                          unsigned int size) {
   unsigned int i = 0;
   for (; i < size; i++) {
     crc = CRC_POLYNOMIAL[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
@@ -139,7 +134,7 @@ bool WriteDFUFile(const FirmwareOptions *options,
   }
 
   // Calculate Data CRC
-  uint32_t data_crc = CalculateCRC(INITIAL_CRC, data, size);
+  uint32_t data_crc = DFU_CalculateCRC(DFU_INITIAL_CRC, data, size);
 
   struct FirmwareHeaderV1Struct firmware_header = {
     .header_version = htonl(HEADER_VERSION),
@@ -162,9 +157,10 @@ bool WriteDFUFile(const FirmwareOptions *options,
   printf("Wrote %d bytes of data to %s\n", size, file);
 
   // Calculate the DFU suffix CRC
-  uint32_t crc = CalculateCRC(INITIAL_CRC, (uint8_t*) &firmware_header,
-                              sizeof(firmware_header));
-  crc = CalculateCRC(crc, data, size);
+  uint32_t crc = DFU_CalculateCRC(DFU_INITIAL_CRC,
+                                  (uint8_t*) &firmware_header,
+                                  sizeof(firmware_header));
+  crc = DFU_CalculateCRC(crc, data, size);
 
   // The DFU suffix, without the CRC.
   struct {
@@ -187,7 +183,7 @@ bool WriteDFUFile(const FirmwareOptions *options,
   const uint8_t *suffix_ptr = (const uint8_t*) &suffix;
   int i = sizeof(suffix) - 1;
   for (; i >= 0; i--) {
-    crc = CalculateCRC(crc, suffix_ptr + i, 1);
+    crc = DFU_CalculateCRC(crc, suffix_ptr + i, 1);
     if (!Write(fd, suffix_ptr + i, 1)) {
       close(fd);
       return false;
@@ -23,6 +23,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @brief Options used for constructing the firmware blob.
  */
@@ -32,6 +36,23 @@ typedef struct {
   uint16_t model_id;  //!< The hardware model this firmware is for.
 } FirmwareOptions;
 
+/**
+ * @brief The initial value to use with DFU_CalculateCRC().
+ */
+#define DFU_INITIAL_CRC 0xffffffffu
+
+/**
+ * @brief Calculate the DFU CRC.
+ * @param crc The CRC so far, use DFU_INITIAL_CRC for new data.
+ * @param data The data to add to the CRC.
+ * @param size The size of the data.
+ * @returns The updated CRC.
+ *
+ * This is the same CRC used for the DFU suffix.
+ */
+uint32_t DFU_CalculateCRC(uint32_t crc, const uint8_t *data,
+                          unsigned int size);
+
 /**
  * @brief Write data to a DFU file.
  * @param options The firmware options.
@@ -51,4 +72,8 @@ bool WriteDFUFile(const FirmwareOptions *options,
                   unsigned int size,
                   const char *file);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif  // TOOLS_DFU_H_
@@ -17,7 +17,6 @@
  * Copyright (C) 2015 Simon Newton.
  */
 
-#include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
@@ -68,47 +67,6 @@ static const char DFU_SUFFIX[] = ".dfu";
 uint8_t *g_data = NULL;
 unsigned int g_data_size = 0;
 
-uint8_t DigitToInt(char ch) {
-  int d = ch - '0';
-  if ((unsigned) d < 10) {
-    return d;
-  }
-  d = ch - 'a';
-  if ((unsigned) d < 6) {
-    return d + 10;
-  }
-  d = ch - 'A';
-  if ((unsigned) d < 6) {
-    return d + 10;
-  }
-  return -1;
-}
-
-/**
- * @brief Convert a pair of characters to a byte.
- */
-bool HexToUInt8(const char *str, uint8_t *output) {
-  *output = 0;
-  if (!isxdigit(str[0]) || !isxdigit(str[1])) {
-    return false;
-  }
-
-  *output = (DigitToInt(str[0]) * 16) + DigitToInt(str[1]);
-  return true;
-}
-
-/**
- * @brief Convert 4 characters to a uint16_t.
- */
-bool HexToUInt16(const char *str, uint16_t *output) {
-  uint8_t upper, lower;
-  if (!HexToUInt8(str, &upper) || !HexToUInt8(str + 2, &lower)) {
-    return false;
-  }
-  *output = (upper << 8) + lower;
-  return true;
-}
-
 /**
  * @brief Process a block of data at the given address.
  */
@@ -19,8 +19,25 @@
 
 #include "utils.h"
 
+#include <ctype.h>
 #include <stdlib.h>
 
+static uint8_t DigitToInt(char ch) {
+  int d = ch - '0';
+  if ((unsigned) d < 10) {
+    return d;
+  }
+  d = ch - 'a';
+  if ((unsigned) d < 6) {
+    return d + 10;
+  }
+  d = ch - 'A';
+  if ((unsigned) d < 6) {
+    return d + 10;
+  }
+  return -1;
+}
+
 bool StringToUInt16(const char *input, uint16_t *output) {
   long i = strtol(input, NULL, 0);  // NOLINT(runtime/int)
   if (i < 0 || i > UINT16_MAX) {
@@ -38,3 +55,22 @@ bool StringToUInt32(const char *input, uint32_t *output) {
   *output = (uint32_t) i;
   return true;
 }
+
+bool HexToUInt8(const char *str, uint8_t *output) {
+  *output = 0;
+  if (!isxdigit(str[0]) || !isxdigit(str[1])) {
+    return false;
+  }
+
+  *output = (DigitToInt(str[0]) * 16) + DigitToInt(str[1]);
+  return true;
+}
+
+bool HexToUInt16(const char *str, uint16_t *output) {
+  uint8_t upper, lower;
+  if (!HexToUInt8(str, &upper) || !HexToUInt8(str + 2, &lower)) {
+    return false;
+  }
+  *output = (upper << 8) + lower;
+  return true;
+}
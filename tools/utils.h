@@ -23,6 +23,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @brief Convert a string to a uint16_t.
  * @returns true if the input was within range, false otherwise.
@@ -39,4 +43,20 @@ bool StringToUInt16(const char *input, uint16_t *output);
  */
 bool StringToUInt32(const char *input, uint32_t *output);
 
+/**
+ * @brief Convert a pair of hex characters to a byte.
+ * @returns true if both characters were hex digits, false otherwise.
+ */
+bool HexToUInt8(const char *str, uint8_t *output);
+
+/**
+ * @brief Convert 4 hex characters to a uint16_t.
+ * @returns true if all characters were hex digits, false otherwise.
+ */
+bool HexToUInt16(const char *str, uint16_t *output);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif  // TOOLS_UTILS_H_
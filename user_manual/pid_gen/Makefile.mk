@@ -18,6 +18,8 @@ user_manual_pid_gen_pid_gen_LDADD = $(OLA_LIBS) \
                                     firmware/src/librdmutil.la \
                                     firmware/src/libreceivercounters.la \
                                     firmware/src/libsensormodel.la \
+                                    firmware/src/libtimerwheel.la \
                                     firmware/src/libcoarsetimer.la \
+                                    firmware/src/libstats.la \
                                     tests/harmony/mocks/libharmonymock.la \
                                     $(GMOCK_LIBS) $(GTEST_LIBS)